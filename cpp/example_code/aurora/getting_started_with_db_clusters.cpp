@@ -61,6 +61,7 @@
 #include <aws/rds/model/DescribeDBClusterParametersRequest.h>
 #include <aws/rds/model/ModifyDBClusterParameterGroupRequest.h>
 #include <aws/core/utils/UUID.h>
+#include "awsdoc/waiter.h"
 #include "aurora_samples.h"
 
 
@@ -522,38 +523,37 @@ bool AwsDoc::Aurora::gettingStartedWithDBClusters(
 
     std::cout << "Waiting for the DB cluster to become available." << std::endl;
 
-    int counter = 0;
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(15);
+    Aws::String status;
     // 11. Wait for the DB cluster to become available.
-    do {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        ++counter;
-        if (counter > 900) {
-            std::cerr << "Wait for cluster to become available timed out ofter "
-                      << counter
-                      << " seconds." << std::endl;
-            cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                             DB_CLUSTER_IDENTIFIER, "", client);
-            return false;
-        }
-
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         dbCluster = Aws::RDS::Model::DBCluster();
         if (!describeDBCluster(DB_CLUSTER_IDENTIFIER, dbCluster, client)) {
-            cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                             DB_CLUSTER_IDENTIFIER, "", client);
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
 
-        if ((counter % 20) == 0) {
-            std::cout << "Current DB cluster status is '"
-                      << dbCluster.GetStatus()
-                      << "' after " << counter << " seconds." << std::endl;
+        if (dbCluster.GetStatus() != status) {
+            status = dbCluster.GetStatus();
+            std::cout << "Current DB cluster status is '" << status << "'." << std::endl;
         }
-    } while (dbCluster.GetStatus() != "available");
 
-    if (dbCluster.GetStatus() == "available") {
-        std::cout << "The DB cluster has been created." << std::endl;
+        return status == "available" ? AwsDoc::WaiterState::SUCCESS
+                                     : AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
+
+    if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+        if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+            std::cerr << "Wait for cluster to become available timed out."
+                      << std::endl;
+        }
+        cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
+                         DB_CLUSTER_IDENTIFIER, "", client);
+        return false;
     }
 
+    std::cout << "The DB cluster has been created." << std::endl;
+
     printAsterisksLine();
     Aws::RDS::Model::DBInstance dbInstance;
     // 11.  Check if the DB instance already exists.
@@ -612,38 +612,35 @@ bool AwsDoc::Aurora::gettingStartedWithDBClusters(
 
     std::cout << "Waiting for the DB instance to become available." << std::endl;
 
-    counter = 0;
+    status.clear();
     // 14. Wait for the DB instance to become available.
-    do {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        ++counter;
-        if (counter > 900) {
-            std::cerr << "Wait for instance to become available timed out ofter "
-                      << counter
-                      << " seconds." << std::endl;
-            cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                             DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
-            return false;
-        }
-
+    waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         dbInstance = Aws::RDS::Model::DBInstance();
         if (!describeDBInstance(DB_INSTANCE_IDENTIFIER, dbInstance, client)) {
-            cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                             DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
 
-        if ((counter % 20) == 0) {
-            std::cout << "Current DB instance status is '"
-                      << dbInstance.GetDBInstanceStatus()
-                      << "' after " << counter << " seconds." << std::endl;
+        if (dbInstance.GetDBInstanceStatus() != status) {
+            status = dbInstance.GetDBInstanceStatus();
+            std::cout << "Current DB instance status is '" << status << "'." << std::endl;
         }
-    } while (dbInstance.GetDBInstanceStatus() != "available");
 
-    if (dbInstance.GetDBInstanceStatus() == "available") {
-        std::cout << "The DB instance has been created." << std::endl;
+        return status == "available" ? AwsDoc::WaiterState::SUCCESS
+                                     : AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
+
+    if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+        if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+            std::cerr << "Wait for instance to become available timed out."
+                      << std::endl;
+        }
+        cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
+                         DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
+        return false;
     }
 
+    std::cout << "The DB instance has been created." << std::endl;
+
     // 15. Display the connection string that can be used to connect a 'mysql' shell to the database.
     displayConnection(dbCluster);
 
@@ -684,19 +681,9 @@ bool AwsDoc::Aurora::gettingStartedWithDBClusters(
         std::cout << "Waiting for the snapshot to become available." << std::endl;
 
         Aws::RDS::Model::DBClusterSnapshot snapshot;
-        counter = 0;
-        do {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            ++counter;
-            if (counter > 600) {
-                std::cerr << "Wait for snapshot to be available timed out ofter "
-                          << counter
-                          << " seconds." << std::endl;
-                cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                                 DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
-                return false;
-            }
-
+        waiterOptions.mTimeout = std::chrono::minutes(10);
+        status.clear();
+        waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
             // 17. Wait for the snapshot to become available.
             // snippet-start:[cpp.example_code.aurora.DescribeDBClusterSnapshots]
             Aws::RDS::Model::DescribeDBClusterSnapshotsRequest request;
@@ -712,22 +699,30 @@ bool AwsDoc::Aurora::gettingStartedWithDBClusters(
                 std::cerr << "Error with Aurora::DescribeDBClusterSnapshots. "
                           << outcome.GetError().GetMessage()
                           << std::endl;
-                cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
-                                 DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
-                return false;
+                return AwsDoc::WaiterState::FAILURE;
             }
             // snippet-end:[cpp.example_code.aurora.DescribeDBClusterSnapshots]
 
-            if ((counter % 20) == 0) {
-                std::cout << "Current snapshot status is '"
-                          << snapshot.GetStatus()
-                          << "' after " << counter << " seconds." << std::endl;
+            if (snapshot.GetStatus() != status) {
+                status = snapshot.GetStatus();
+                std::cout << "Current snapshot status is '" << status << "'." << std::endl;
             }
-        } while (snapshot.GetStatus() != "available");
 
-        if (snapshot.GetStatus() != "available") {
-            std::cout << "A snapshot has been created." << std::endl;
+            return status == "available" ? AwsDoc::WaiterState::SUCCESS
+                                         : AwsDoc::WaiterState::RETRY;
+        }, waiterOptions);
+
+        if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+            if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+                std::cerr << "Wait for snapshot to be available timed out."
+                          << std::endl;
+            }
+            cleanUpResources(CLUSTER_PARAMETER_GROUP_NAME,
+                             DB_CLUSTER_IDENTIFIER, DB_INSTANCE_IDENTIFIER, client);
+            return false;
         }
+
+        std::cout << "A snapshot has been created." << std::endl;
     }
 
     printAsterisksLine();
@@ -982,6 +977,32 @@ bool AwsDoc::Aurora::chooseDBInstanceClass(const Aws::String &engine,
 }
 // snippet-end:[cpp.example_code.aurora.DescribeOrderableDBInstanceOptions]
 
+//! Routine which checks whether a describe outcome shows that a resource was deleted.
+/*!
+\sa deletedState()
+\param outcome: The outcome of a describe request.
+\param notFoundError: The error returned when the resource does not exist.
+\param operation: The operation name used in error messages.
+\return WaiterState: SUCCESS if the resource was deleted, RETRY if it still exists.
+*/
+template<typename OUTCOME_TYPE>
+static AwsDoc::WaiterState deletedState(const OUTCOME_TYPE &outcome,
+                                        Aws::RDS::RDSErrors notFoundError,
+                                        const char *operation) {
+    if (outcome.IsSuccess()) {
+        return AwsDoc::WaiterState::RETRY;
+    }
+    else if (outcome.GetError().GetErrorType() == notFoundError) {
+        return AwsDoc::WaiterState::SUCCESS;
+    }
+    else {
+        std::cerr << "Error with " << operation << ". "
+                  << outcome.GetError().GetMessage()
+                  << std::endl;
+        return AwsDoc::WaiterState::FAILURE;
+    }
+}
+
 //! Routine which deletes resources created by the scenario.
 /*!
 \sa cleanUpResources()
@@ -1056,46 +1077,62 @@ bool AwsDoc::Aurora::cleanUpResources(const Aws::String &parameterGroupName,
             // snippet-end:[cpp.example_code.aurora.DeleteDBCluster]
         }
     }
-    int counter = 0;
-
-    while (clusterDeleting || instanceDeleting) {
-        // 20. Wait for the DB cluster and instance to be deleted.
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        ++counter;
-        if (counter > 800) {
-            std::cerr << "Wait for instance to delete timed out ofter " << counter
-                      << " seconds." << std::endl;
-            return false;
-        }
-
-        Aws::RDS::Model::DBInstance dbInstance = Aws::RDS::Model::DBInstance();
-        if (instanceDeleting) {
-            if (!describeDBInstance(dbInstanceIdentifier, dbInstance, client)) {
-                return false;
-            }
-            instanceDeleting = dbInstance.DBInstanceIdentifierHasBeenSet();
-        }
-
-        Aws::RDS::Model::DBCluster dbCluster = Aws::RDS::Model::DBCluster();
-        if (clusterDeleting) {
-            if (!describeDBCluster(dbClusterIdentifier, dbCluster, client)) {
-                return false;
-            }
-
-            clusterDeleting = dbCluster.DBClusterIdentifierHasBeenSet();
-        }
+    // 20. Wait for the DB cluster and instance to be deleted. The two waits run
+    // at the same time on the threads of the executor.
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(15);
+    AwsDoc::WaiterExecutor waiterExecutor(2);
+
+    std::future<AwsDoc::WaiterState> instanceDeleted;
+    if (instanceDeleting) {
+        Aws::RDS::Model::DescribeDBInstancesRequest request;
+        request.SetDBInstanceIdentifier(dbInstanceIdentifier);
+
+        AwsDoc::Waiter<Aws::RDS::Model::DescribeDBInstancesRequest,
+                Aws::RDS::Model::DescribeDBInstancesOutcome> waiter(
+                [&client](const Aws::RDS::Model::DescribeDBInstancesRequest &request) {
+                    return client.DescribeDBInstances(request);
+                },
+                [](const Aws::RDS::Model::DescribeDBInstancesOutcome &outcome) {
+                    return deletedState(outcome,
+                                        Aws::RDS::RDSErrors::D_B_INSTANCE_NOT_FOUND_FAULT,
+                                        "Aurora::DescribeDBInstances");
+                },
+                waiterOptions);
+        instanceDeleted = waiter.waitAsync(request, waiterExecutor);
+    }
 
-        if ((counter % 20) == 0) {
-            if (instanceDeleting) {
-                std::cout << "Current DB instance status is '"
-                          << dbInstance.GetDBInstanceStatus() << "." << std::endl;
-            }
+    std::future<AwsDoc::WaiterState> clusterDeleted;
+    if (clusterDeleting) {
+        Aws::RDS::Model::DescribeDBClustersRequest request;
+        request.SetDBClusterIdentifier(dbClusterIdentifier);
+
+        AwsDoc::Waiter<Aws::RDS::Model::DescribeDBClustersRequest,
+                Aws::RDS::Model::DescribeDBClustersOutcome> waiter(
+                [&client](const Aws::RDS::Model::DescribeDBClustersRequest &request) {
+                    return client.DescribeDBClusters(request);
+                },
+                [](const Aws::RDS::Model::DescribeDBClustersOutcome &outcome) {
+                    return deletedState(outcome,
+                                        Aws::RDS::RDSErrors::D_B_CLUSTER_NOT_FOUND_FAULT,
+                                        "Aurora::DescribeDBClusters");
+                },
+                waiterOptions);
+        clusterDeleted = waiter.waitAsync(request, waiterExecutor);
+    }
 
-            if (clusterDeleting) {
-                std::cout << "Current DB cluster status is '"
-                          << dbCluster.GetStatus() << "." << std::endl;
-            }
-        }
+    AwsDoc::WaiterState instanceState = instanceDeleted.valid() ? instanceDeleted.get()
+                                                                : AwsDoc::WaiterState::SUCCESS;
+    AwsDoc::WaiterState clusterState = clusterDeleted.valid() ? clusterDeleted.get()
+                                                              : AwsDoc::WaiterState::SUCCESS;
+    if (instanceState == AwsDoc::WaiterState::TIMEOUT ||
+        clusterState == AwsDoc::WaiterState::TIMEOUT) {
+        std::cerr << "Wait for the DB cluster and instance to delete timed out."
+                  << std::endl;
+    }
+    if (instanceState != AwsDoc::WaiterState::SUCCESS ||
+        clusterState != AwsDoc::WaiterState::SUCCESS) {
+        return false;
     }
 
     if (!parameterGroupName.empty()) {
@@ -56,6 +56,7 @@
 #include <aws/monitoring/CloudWatchClient.h>
 #include <aws/monitoring/model/GetMetricStatisticsRequest.h>
 #include <aws/monitoring/model/ListMetricsRequest.h>
+#include "awsdoc/waiter.h"
 #include "autoscaling_samples.h"
 
 namespace AwsDoc {
@@ -640,23 +641,18 @@ bool AwsDoc::AutoScaling::groupsAndInstancesScenario(
 bool AwsDoc::AutoScaling::waitForInstances(const Aws::String &groupName,
                                            Aws::Vector<Aws::AutoScaling::Model::AutoScalingGroup> &autoScalingGroups,
                                            const Aws::AutoScaling::AutoScalingClient &client) {
-    bool ready = false;
     const std::vector<Aws::String> READY_STATES = {"InService", "Terminated"};
 
-    int count = 0;
-    int desiredCapacity = 0;
-    std::this_thread::sleep_for(std::chrono::seconds(4));
-    while (!ready) {
-        if (WAIT_FOR_INSTANCES_TIMEOUT < count) {
-            std::cerr << "Wait for instance timed out." << std::endl;
-            return false;
-        }
-
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        ++count;
+    // Instances take tens of seconds to change state, so the first poll is delayed.
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mInitialDelay = std::chrono::seconds(4);
+    waiterOptions.mDelayFirstPoll = true;
+    waiterOptions.mTimeout = std::chrono::seconds(WAIT_FOR_INSTANCES_TIMEOUT);
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         if (!describeGroup(groupName, autoScalingGroups, client)) {
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
+        int desiredCapacity = 0;
         Aws::Vector<Aws::String> instanceIDs;
         if (!autoScalingGroups.empty()) {
             instanceIDs = instancesToInstanceIDs(autoScalingGroups[0].GetInstances());
@@ -665,14 +661,11 @@ bool AwsDoc::AutoScaling::waitForInstances(const Aws::String &groupName,
 
         if (instanceIDs.empty()) {
             if (desiredCapacity == 0) {
-                break;
+                return AwsDoc::WaiterState::SUCCESS;
             }
             else {
-                if ((count % 5) == 0) {
-                    std::cout << "No instance IDs returned for group." << std::endl;
-                }
-
-                continue;
+                std::cout << "No instance IDs returned for group." << std::endl;
+                return AwsDoc::WaiterState::RETRY;
             }
         }
 
@@ -688,7 +681,7 @@ bool AwsDoc::AutoScaling::waitForInstances(const Aws::String &groupName,
             const Aws::Vector<Aws::AutoScaling::Model::AutoScalingInstanceDetails> &instancesDetails =
                     outcome.GetResult().GetAutoScalingInstances();
             // snippet-end:[cpp.example_code.autoscaling.describe_autoscaling_instances1]
-            ready = instancesDetails.size() >= desiredCapacity;
+            bool ready = instancesDetails.size() >= desiredCapacity;
             for (const Aws::AutoScaling::Model::AutoScalingInstanceDetails &details: instancesDetails) {
                 if (!stringInVector(details.GetLifecycleState(), READY_STATES)) {
                     ready = false;
@@ -696,18 +689,25 @@ bool AwsDoc::AutoScaling::waitForInstances(const Aws::String &groupName,
                 }
             }
             // Log the status while waiting.
-            if (((count % 5) == 1) || ready) {
-                logInstancesLifecycleState(instancesDetails);
-            }
+            logInstancesLifecycleState(instancesDetails);
+            return ready ? AwsDoc::WaiterState::SUCCESS : AwsDoc::WaiterState::RETRY;
             // snippet-start:[cpp.example_code.autoscaling.describe_autoscaling_instances2]
         }
         else {
             std::cerr << "Error with AutoScaling::DescribeAutoScalingInstances. "
                       << outcome.GetError().GetMessage()
                       << std::endl;
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
         // snippet-end:[cpp.example_code.autoscaling.describe_autoscaling_instances2]
+    }, waiterOptions);
+
+    if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+        std::cerr << "Wait for instance timed out." << std::endl;
+        return false;
+    }
+    else if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+        return false;
     }
 
     if (!describeGroup(groupName, autoScalingGroups, client)) {
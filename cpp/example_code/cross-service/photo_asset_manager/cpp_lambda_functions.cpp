@@ -14,6 +14,7 @@
 
 #include "cpp_lambda_functions.h"
 #include <aws/core/Aws.h>
+#include <aws/core/utils/HashingUtils.h>
 #include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/BatchGetItemRequest.h>
 #include <aws/dynamodb/model/BatchWriteItemRequest.h>
@@ -24,13 +25,25 @@
 #include <aws/rekognition/model/S3Object.h>
 #include <aws/rekognition/model/Image.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
-#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
+#include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/sns/SNSClient.h>
 #include <aws/sns/model/PublishRequest.h>
-#include <zip.h>
+#include <aws/dynamodb/DynamoDBErrors.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <random>
 #include <set>
-#include <fstream>
+#include <thread>
+#include <utility>
 
 namespace AwsDoc {
     namespace PAM {
@@ -38,22 +51,74 @@ namespace AwsDoc {
         static const char COUNT_KEY[] = "count";
         static const char IMAGES_KEY[] = "images";
 
-        struct image_zip_data {
-            image_zip_data() : mIOStream(nullptr) {}
+        // Number of times unprocessed items of a batch write are retried.
+        static const int BATCH_WRITE_MAX_RETRIES = 8;
 
-            Aws::IOStream *mIOStream;
-        };
-
-        //! A libzip callback routine for an Aws::IOStream as a data source.
+        //! Routine which writes a batch of requests to a DynamoDB table, retrying
+        //! unprocessed items with jittered exponential backoff.
         /*!
-         \param userdata: The image_zip_data user data.
-         \param data: A pointer for returning data.
-         \param len: The length of data to return.
-         \param cmd: A zip source command.
-         \return zip_int64_t: A zip_source result.
-        */
-        zip_int64_t my_zip_source(void *userdata, void *data, zip_uint64_t len,
-                                  zip_source_cmd_t cmd);
+          \param databaseName: A DynamoDB table name.
+          \param writeRequests: Up to 25 write requests.
+          \param errStream: An std::iostream for error messaging.
+          \param dbClient: A DynamoDB client.
+          \return bool: Function succeeded.
+         */
+        bool batchWriteWithRetries(const std::string &databaseName,
+                                   const Aws::Vector<Aws::DynamoDB::Model::WriteRequest> &writeRequests,
+                                   std::ostream &errStream,
+                                   const Aws::DynamoDB::DynamoDBClient &dbClient);
+
+        // Number of images downloaded at the same time while building a zip archive.
+        static const size_t ZIP_FETCH_CONCURRENCY = 8;
+        // Size of each multipart upload part of a zip archive. The minimum
+        // part size for S3 is 5 MB.
+        static const size_t ZIP_UPLOAD_PART_SIZE = 8 * 1024 * 1024;
+
+        //! A sink which uploads data to S3 as a multipart upload, one part at a time.
+        class MultipartUploadSink {
+        public:
+            MultipartUploadSink(const Aws::S3::S3Client &s3Client,
+                                const std::string &bucket, const std::string &key,
+                                std::ostream &errStream);
+
+            //! Routine which starts the multipart upload.
+            /*!
+             \return bool: Function succeeded.
+            */
+            bool start();
+
+            //! Routine which adds data, uploading a part whenever a part is full.
+            /*!
+             \param data: The data.
+             \param length: The length of the data.
+             \return bool: Function succeeded.
+            */
+            bool write(const char *data, size_t length);
+
+            //! Routine which uploads the last part and completes the multipart upload.
+            /*!
+             \return bool: Function succeeded.
+            */
+            bool complete();
+
+            //! Routine which aborts the multipart upload, deleting the uploaded parts.
+            /*!
+             \return void:
+            */
+            void abort();
+
+        private:
+            bool uploadPart();
+
+            const Aws::S3::S3Client &mS3Client;
+            std::string mBucket;
+            std::string mKey;
+            std::ostream &mErrStream;
+            Aws::String mUploadId;
+            std::vector<char> mPart;
+            size_t mPartLength = 0;
+            Aws::S3::Model::CompletedMultipartUpload mCompletedParts;
+        };
     } // PAM
 } // AwsDoc
 
@@ -68,6 +133,19 @@ std::string
 AwsDoc::PAM::getPreSignedS3UploadURL(const std::string &bucket, const std::string &key,
                                      const Aws::Client::ClientConfiguration &clientConfiguration) {
     Aws::S3::S3Client s3Client(clientConfiguration);
+    return getPreSignedS3UploadURL(bucket, key, s3Client);
+}
+
+//! Routine that returns a presigned Amazon S3 upload URL, using an existing client.
+/*!
+  \param bucket: An S3 bucket name.
+  \param key: An S3 object key.
+  \param s3Client: An S3 client, which can be shared between calls.
+  \return std::string: The URL as a string.
+ */
+std::string
+AwsDoc::PAM::getPreSignedS3UploadURL(const std::string &bucket, const std::string &key,
+                                     Aws::S3::S3Client &s3Client) {
     return s3Client.GeneratePresignedUrl(bucket, key, Aws::Http::HttpMethod::HTTP_PUT,
                                          300 // expirationInSeconds
     );
@@ -130,12 +208,30 @@ bool AwsDoc::PAM::updateLabelsInDatabase(const std::string &databaseName,
                                          const std::string &bucketKey,
                                          std::ostream &errStream,
                                          const Aws::Client::ClientConfiguration &clientConfiguration) {
-    // Retrieve the existing entries
     Aws::DynamoDB::DynamoDBClient dbClient(clientConfiguration);
 
+    return updateLabelsInDatabase(databaseName, labels, bucketKey, errStream, dbClient);
+}
+
+//! Routine that updates a DynamoDB table with labels and the associated S3 object key
+//! of the image, using an existing client.
+/*!
+  \param databaseName: A DynamoDB table name.
+  \param labels: A vector of labels as DynamoDB table keys.
+  \param bucketKey: The S3 object key for the image.
+  \param errStream: An std::iostream for error messaging.
+  \param dbClient: A DynamoDB client, which can be shared between calls.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::PAM::updateLabelsInDatabase(const std::string &databaseName,
+                                         const std::vector<std::string> &labels,
+                                         const std::string &bucketKey,
+                                         std::ostream &errStream,
+                                         const Aws::DynamoDB::DynamoDBClient &dbClient) {
+    // Retrieve the existing entries
     AttributeValueMap mapOfImageKeys;
     if (!getKeysForLabelsFromDatabase(databaseName, labels, mapOfImageKeys,
-                                      errStream, clientConfiguration)) {
+                                      errStream, dbClient)) {
         return false;
     }
 
@@ -170,18 +266,65 @@ bool AwsDoc::PAM::updateLabelsInDatabase(const std::string &databaseName,
                     Aws::DynamoDB::Model::WriteRequest().WithPutRequest(putRequest));
         }
 
+        if (!batchWriteWithRetries(databaseName, writeRequests, errStream, dbClient)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//! Routine which writes a batch of requests to a DynamoDB table, retrying
+//! unprocessed items with jittered exponential backoff.
+/*!
+  \param databaseName: A DynamoDB table name.
+  \param writeRequests: Up to 25 write requests.
+  \param errStream: An std::iostream for error messaging.
+  \param dbClient: A DynamoDB client.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::PAM::batchWriteWithRetries(const std::string &databaseName,
+                                        const Aws::Vector<Aws::DynamoDB::Model::WriteRequest> &writeRequests,
+                                        std::ostream &errStream,
+                                        const Aws::DynamoDB::DynamoDBClient &dbClient) {
+    Aws::Map<Aws::String, Aws::Vector<Aws::DynamoDB::Model::WriteRequest>> requestItems;
+    requestItems[databaseName] = writeRequests;
+
+    std::mt19937 random(std::random_device{}());
+    for (int attempt = 0; !requestItems.empty(); ++attempt) {
+        if (attempt > BATCH_WRITE_MAX_RETRIES) {
+            errStream << "Error with DynamoDB::BatchWriteItem. Items were still unprocessed after "
+                      << BATCH_WRITE_MAX_RETRIES << " retries." << std::endl;
+            return false;
+        }
+
+        if (attempt > 0) {
+            // Full jitter: a random delay up to an exponentially growing cap.
+            int cap = std::min(5000, 50 << std::min(attempt, 10));
+            std::uniform_int_distribution<int> distribution(25, cap);
+            std::this_thread::sleep_for(std::chrono::milliseconds(distribution(random)));
+        }
+
         Aws::DynamoDB::Model::BatchWriteItemRequest batchWriteItemRequest;
-        batchWriteItemRequest.AddRequestItems(databaseName, writeRequests);
+        batchWriteItemRequest.SetRequestItems(requestItems);
 
         Aws::DynamoDB::Model::BatchWriteItemOutcome outcome = dbClient.BatchWriteItem(
                 batchWriteItemRequest);
 
         if (!outcome.IsSuccess()) {
+            if (outcome.GetError().GetErrorType() ==
+                Aws::DynamoDB::DynamoDBErrors::PROVISIONED_THROUGHPUT_EXCEEDED) {
+                continue;
+            }
+
             errStream << "Error with DynamoDB::BatchWriteItem. "
                       << outcome.GetError().GetMessage()
                       << std::endl;
             return false;
         }
+
+        // Only the unprocessed items are sent again.
+        requestItems = outcome.GetResult().GetUnprocessedItems();
     }
 
     return true;
@@ -288,6 +431,25 @@ bool AwsDoc::PAM::getKeysForLabelsFromDatabase(const std::string &databaseName,
                                                const Aws::Client::ClientConfiguration &clientConfiguration) {
     Aws::DynamoDB::DynamoDBClient dbClient(clientConfiguration);
 
+    return getKeysForLabelsFromDatabase(databaseName, labels, mapOfImageKeys, errStream,
+                                        dbClient);
+}
+
+//! Routine that retrieves the S3 bucket keys for images associated with labels by querying
+//! an Amazon DynamoDB table, using an existing client.
+/*!
+  \param databaseName: A DynamoDB table name.
+  \param labels: A vector of labels as DynamoDB table keys.
+  \param mapOfImageKeys: A map to receive the S3 object keys for images associated with labels.
+  \param errStream: An std::iostream for error messaging.
+  \param dbClient: A DynamoDB client, which can be shared between calls.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::PAM::getKeysForLabelsFromDatabase(const std::string &databaseName,
+                                               const std::vector<std::string> &labels,
+                                               AttributeValueMap &mapOfImageKeys,
+                                               std::ostream &errStream,
+                                               const Aws::DynamoDB::DynamoDBClient &dbClient) {
     Aws::DynamoDB::Model::KeysAndAttributes tableKeysAndAttributes;
     tableKeysAndAttributes.SetProjectionExpression("#l, #c,  #i");
 
@@ -352,59 +514,279 @@ bool AwsDoc::PAM::getKeysForLabelsFromDatabase(const std::string &databaseName,
     return batchGetOutcome.IsSuccess();
 }
 
-//! A libzip callback routine for an Aws::IOStream as a data source.
+//! Routine which writes an entry from a seekable stream.
 /*!
- \param userdata: The image_zip_data user data.
- \param data: A pointer for returning data.
- \param len: The length of data to return.
- \param cmd: A zip source command.
- \return zip_int64_t: A zip_source result.
+ \param name: The name of the entry.
+ \param stream: The entry contents. The stream is read twice.
+ \return bool: Function succeeded.
 */
-zip_int64_t AwsDoc::PAM::my_zip_source(void *userdata, void *data, zip_uint64_t len,
-                                       zip_source_cmd_t cmd) {
-    auto imageZipData = static_cast<image_zip_data *>(userdata);
-    zip_int64_t result;
-    switch (cmd) {
-        case ZIP_SOURCE_READ: {
-            if (imageZipData->mIOStream == nullptr) {
-                std::cerr << "AwsDoc::PAM::my_zip_source - IO stream is null. cmd  "
-                          << cmd << std::endl;
-                return ZIP_ER_INVAL;
-            }
-            imageZipData->mIOStream->read(static_cast<char *>(data),
-                                          static_cast<std::streamsize>(len));
-            auto bytesRead = imageZipData->mIOStream->gcount();
-            result = bytesRead;
+bool AwsDoc::PAM::ZipStreamWriter::addEntry(const std::string &name,
+                                             Aws::IOStream &stream) {
+    if (!mTimeSet) {
+        time_t now = time(nullptr);
+        struct tm localTime;
+        localtime_r(&now, &localTime);
+        mDosTime = static_cast<uint16_t>((localTime.tm_hour << 11) |
+                                         (localTime.tm_min << 5) |
+                                         (localTime.tm_sec / 2));
+        mDosDate = static_cast<uint16_t>(((localTime.tm_year - 80) << 9) |
+                                         ((localTime.tm_mon + 1) << 5) |
+                                         localTime.tm_mday);
+        mTimeSet = true;
+    }
+
+    // The local header holds the checksum and size, so they are computed before the
+    // entry is written. The SDK returns the checksum in big-endian byte order.
+    const Aws::Utils::ByteBuffer checksum = Aws::Utils::HashingUtils::CalculateCRC32(stream);
+    stream.clear();
+    stream.seekg(0, std::ios::end);
+    const std::streamoff size = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+    if (checksum.GetLength() != 4 || size < 0) {
+        mErrStream << "ZipStreamWriter::addEntry - unable to read the entry '" << name
+                   << "'." << std::endl;
+        return false;
+    }
+
+    if (mEntries.size() >= 0xFFFF || static_cast<uint64_t>(size) >= 0xFFFFFFFFu ||
+        mOffset + static_cast<uint64_t>(size) + 30 + name.size() >= 0xFFFFFFFFu) {
+        mErrStream << "ZipStreamWriter::addEntry - the archive is too large for the zip format."
+                   << std::endl;
+        return false;
+    }
+
+    CentralEntry entry;
+    entry.mName = name;
+    entry.mCrc = (static_cast<uint32_t>(checksum[0]) << 24) |
+                 (static_cast<uint32_t>(checksum[1]) << 16) |
+                 (static_cast<uint32_t>(checksum[2]) << 8) |
+                 static_cast<uint32_t>(checksum[3]);
+    entry.mSize = static_cast<uint32_t>(size);
+    entry.mOffset = static_cast<uint32_t>(mOffset);
+
+    std::string header;
+    appendUInt32(header, 0x04034b50);  // Local file header signature.
+    appendUInt16(header, 20);  // Version needed to extract.
+    appendUInt16(header, 0x0800);  // Flags, UTF-8 file name.
+    appendUInt16(header, 0);  // Compression method, stored.
+    appendUInt16(header, mDosTime);
+    appendUInt16(header, mDosDate);
+    appendUInt32(header, entry.mCrc);
+    appendUInt32(header, entry.mSize);  // Compressed size.
+    appendUInt32(header, entry.mSize);  // Uncompressed size.
+    appendUInt16(header, static_cast<uint16_t>(name.size()));
+    appendUInt16(header, 0);  // Extra field length.
+    header += name;
+    if (!write(header)) {
+        return false;
+    }
+
+    char buffer[64 * 1024];
+    do {
+        stream.read(buffer, sizeof(buffer));
+        if (stream.gcount() > 0 &&
+            !mSink(buffer, static_cast<size_t>(stream.gcount()))) {
+            return false;
         }
-            break;
-        case ZIP_SOURCE_STAT : {
-            if (imageZipData->mIOStream == nullptr) {
-                std::cerr << "AwsDoc::PAM::my_zip_source - IO stream is null. cmd  "
-                          << cmd << std::endl;
-                return ZIP_ER_INVAL;
-            }
-            auto stat = static_cast<struct zip_stat *>(data);
-            stat->mtime = time(nullptr);
-            auto currentPos = imageZipData->mIOStream->tellg();
-            imageZipData->mIOStream->seekg(0, std::ios::end);
-            stat->size = imageZipData->mIOStream->tellg();
-            imageZipData->mIOStream->seekg(currentPos);
-            result = 0;
+        mOffset += static_cast<uint64_t>(stream.gcount());
+    } while (stream);
+
+    mEntries.push_back(entry);
+    return true;
+}
+
+//! Routine which writes the central directory. No entries can be added after this call.
+/*!
+ \return bool: Function succeeded.
+*/
+bool AwsDoc::PAM::ZipStreamWriter::finish() {
+    const uint64_t centralDirectoryOffset = mOffset;
+    std::string centralDirectory;
+    for (const CentralEntry &entry: mEntries) {
+        appendUInt32(centralDirectory, 0x02014b50);  // Central directory header signature.
+        appendUInt16(centralDirectory, 20);  // Version made by.
+        appendUInt16(centralDirectory, 20);  // Version needed to extract.
+        appendUInt16(centralDirectory, 0x0800);  // Flags, UTF-8 file name.
+        appendUInt16(centralDirectory, 0);  // Compression method, stored.
+        appendUInt16(centralDirectory, mDosTime);
+        appendUInt16(centralDirectory, mDosDate);
+        appendUInt32(centralDirectory, entry.mCrc);
+        appendUInt32(centralDirectory, entry.mSize);  // Compressed size.
+        appendUInt32(centralDirectory, entry.mSize);  // Uncompressed size.
+        appendUInt16(centralDirectory, static_cast<uint16_t>(entry.mName.size()));
+        appendUInt16(centralDirectory, 0);  // Extra field length.
+        appendUInt16(centralDirectory, 0);  // File comment length.
+        appendUInt16(centralDirectory, 0);  // Disk number start.
+        appendUInt16(centralDirectory, 0);  // Internal file attributes.
+        appendUInt32(centralDirectory, 0);  // External file attributes.
+        appendUInt32(centralDirectory, entry.mOffset);
+        centralDirectory += entry.mName;
+    }
+
+    if (centralDirectoryOffset + centralDirectory.size() >= 0xFFFFFFFFu) {
+        mErrStream << "ZipStreamWriter::finish - the archive is too large for the zip format."
+                   << std::endl;
+        return false;
+    }
+
+    std::string endRecord;
+    appendUInt32(endRecord, 0x06054b50);  // End of central directory signature.
+    appendUInt16(endRecord, 0);  // Number of this disk.
+    appendUInt16(endRecord, 0);  // Disk where the central directory starts.
+    appendUInt16(endRecord, static_cast<uint16_t>(mEntries.size()));
+    appendUInt16(endRecord, static_cast<uint16_t>(mEntries.size()));
+    appendUInt32(endRecord, static_cast<uint32_t>(centralDirectory.size()));
+    appendUInt32(endRecord, static_cast<uint32_t>(centralDirectoryOffset));
+    appendUInt16(endRecord, 0);  // Comment length.
+
+    return write(centralDirectory) && write(endRecord);
+}
+
+bool AwsDoc::PAM::ZipStreamWriter::write(const std::string &data) {
+    mOffset += data.size();
+    return data.empty() || mSink(data.data(), data.size());
+}
+
+void AwsDoc::PAM::ZipStreamWriter::appendUInt16(std::string &buffer, uint16_t value) {
+    buffer.push_back(static_cast<char>(value & 0xFF));
+    buffer.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void AwsDoc::PAM::ZipStreamWriter::appendUInt32(std::string &buffer, uint32_t value) {
+    appendUInt16(buffer, static_cast<uint16_t>(value & 0xFFFF));
+    appendUInt16(buffer, static_cast<uint16_t>((value >> 16) & 0xFFFF));
+}
+
+AwsDoc::PAM::MultipartUploadSink::MultipartUploadSink(
+        const Aws::S3::S3Client &s3Client, const std::string &bucket,
+        const std::string &key, std::ostream &errStream) :
+        mS3Client(s3Client), mBucket(bucket), mKey(key), mErrStream(errStream),
+        mPart(ZIP_UPLOAD_PART_SIZE) {
+}
+
+//! Routine which starts the multipart upload.
+/*!
+ \return bool: Function succeeded.
+*/
+bool AwsDoc::PAM::MultipartUploadSink::start() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.SetBucket(mBucket);
+    request.SetKey(mKey);
+    request.SetContentType("application/zip");
+
+    Aws::S3::Model::CreateMultipartUploadOutcome outcome =
+            mS3Client.CreateMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+        mErrStream << "AwsDoc::PAM::MultipartUploadSink - error with CreateMultipartUpload. "
+                   << outcome.GetError().GetMessage() << std::endl;
+        return false;
+    }
+
+    mUploadId = outcome.GetResult().GetUploadId();
+    return true;
+}
+
+//! Routine which adds data, uploading a part whenever a part is full.
+/*!
+ \param data: The data.
+ \param length: The length of the data.
+ \return bool: Function succeeded.
+*/
+bool AwsDoc::PAM::MultipartUploadSink::write(const char *data, size_t length) {
+    while (length > 0) {
+        size_t count = std::min(length, mPart.size() - mPartLength);
+        std::memcpy(mPart.data() + mPartLength, data, count);
+        mPartLength += count;
+        data += count;
+        length -= count;
+
+        if (mPartLength == mPart.size() && !uploadPart()) {
+            return false;
         }
-            break;
+    }
+
+    return true;
+}
 
-        case ZIP_SOURCE_SUPPORTS :
-            result = zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ,
-                                                    ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT,
-                                                    ZIP_SOURCE_ERROR);
-            break;
+//! Routine which uploads the last part and completes the multipart upload.
+/*!
+ \return bool: Function succeeded.
+*/
+bool AwsDoc::PAM::MultipartUploadSink::complete() {
+    if ((mPartLength > 0 || mCompletedParts.GetParts().empty()) && !uploadPart()) {
+        return false;
+    }
 
-        default :
-            result = 0;
-            break;
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(mBucket);
+    request.SetKey(mKey);
+    request.SetUploadId(mUploadId);
+    request.SetMultipartUpload(mCompletedParts);
+
+    Aws::S3::Model::CompleteMultipartUploadOutcome outcome =
+            mS3Client.CompleteMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+        mErrStream << "AwsDoc::PAM::MultipartUploadSink - error with CompleteMultipartUpload. "
+                   << outcome.GetError().GetMessage() << std::endl;
+        return false;
     }
 
-    return result;
+    return true;
+}
+
+//! Routine which aborts the multipart upload, deleting the uploaded parts.
+/*!
+ \return void:
+*/
+void AwsDoc::PAM::MultipartUploadSink::abort() {
+    if (mUploadId.empty()) {
+        return;
+    }
+
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(mBucket);
+    request.SetKey(mKey);
+    request.SetUploadId(mUploadId);
+
+    Aws::S3::Model::AbortMultipartUploadOutcome outcome =
+            mS3Client.AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+        mErrStream << "AwsDoc::PAM::MultipartUploadSink - error with AbortMultipartUpload. "
+                   << outcome.GetError().GetMessage() << std::endl;
+    }
+}
+
+bool AwsDoc::PAM::MultipartUploadSink::uploadPart() {
+    const int partNumber = static_cast<int>(mCompletedParts.GetParts().size()) + 1;
+
+    // Upload the part buffer without copying it.
+    Aws::Utils::Stream::PreallocatedStreamBuf streamBuf(
+            reinterpret_cast<unsigned char *>(mPart.data()), mPartLength);
+    std::shared_ptr<Aws::IOStream> body = Aws::MakeShared<Aws::IOStream>(
+            "MultipartUploadSink", &streamBuf);
+
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(mBucket);
+    request.SetKey(mKey);
+    request.SetUploadId(mUploadId);
+    request.SetPartNumber(partNumber);
+    request.SetContentLength(static_cast<long long>(mPartLength));
+    request.SetBody(body);
+
+    Aws::S3::Model::UploadPartOutcome outcome = mS3Client.UploadPart(request);
+    if (!outcome.IsSuccess()) {
+        mErrStream << "AwsDoc::PAM::MultipartUploadSink - error with UploadPart. "
+                   << outcome.GetError().GetMessage() << std::endl;
+        return false;
+    }
+
+    Aws::S3::Model::CompletedPart completedPart;
+    completedPart.SetPartNumber(partNumber);
+    completedPart.SetETag(outcome.GetResult().GetETag());
+    mCompletedParts.AddParts(completedPart);
+    mPartLength = 0;
+
+    return true;
 }
 
 //! Routine which uploads a zip file of images associated with a list of labels to an S3 bucket.
@@ -445,82 +827,72 @@ bool AwsDoc::PAM::zipAndUploadImages(const std::string &databaseName,
 
 
     Aws::S3::S3Client s3Client(clientConfiguration);
-    std::string tempZipFileName("/tmp/temp.zip");
-    bool firstTime = true;
-    for (const auto &imageKey: imageKeys) {
-        Aws::S3::Model::GetObjectRequest request;
-        request.SetBucket(sourceBucket);
-        request.SetKey(imageKey);
+    MultipartUploadSink uploadSink(s3Client, destinationBucket, destinationKey,
+                                   errStream);
+    if (!uploadSink.start()) {
+        return false;
+    }
 
-        Aws::S3::Model::GetObjectOutcome outcome = s3Client.GetObject(request);
+    // The archive is streamed into the multipart upload as it is built, so
+    // neither a temporary file nor the whole archive is needed.
+    ZipStreamWriter zipWriter([&uploadSink](const char *data, size_t length) {
+        return uploadSink.write(data, length);
+    }, errStream);
+
+    // Keep up to ZIP_FETCH_CONCURRENCY downloads in flight, and add the images
+    // to the archive in key order as their downloads complete. The callable
+    // uses the request while the download runs, so each request is kept with
+    // its future. Adding to or removing from the ends of a deque does not move
+    // the other requests.
+    std::vector<std::string> keys(imageKeys.begin(), imageKeys.end());
+    std::deque<std::pair<Aws::S3::Model::GetObjectRequest,
+            Aws::S3::Model::GetObjectOutcomeCallable>> downloads;
+    size_t nextDownload = 0;
+    auto startDownloads = [&]() {
+        while (nextDownload < keys.size() && downloads.size() < ZIP_FETCH_CONCURRENCY) {
+            downloads.emplace_back();
+            Aws::S3::Model::GetObjectRequest &request = downloads.back().first;
+            request.SetBucket(sourceBucket);
+            request.SetKey(keys[nextDownload++]);
+            downloads.back().second = s3Client.GetObjectCallable(request);
+        }
+    };
+
+    bool result = true;
+    startDownloads();
+    for (size_t i = 0; i < keys.size() && result; ++i) {
+        Aws::S3::Model::GetObjectOutcome outcome = downloads.front().second.get();
+        downloads.pop_front();
+        startDownloads();
 
         if (!outcome.IsSuccess()) {
             errStream << "AwsDoc::PAM::zipAndUploadImages - error with GetObject. "
                       << outcome.GetError().GetMessage() << std::endl;
-            return false;
+            result = false;
         }
-        else {
-            int zipError = 0;
-
-            zip_t *zipFile = zip_open(tempZipFileName.c_str(),
-                                      firstTime ? (ZIP_CREATE | ZIP_TRUNCATE) : 0,
-                                      &zipError);
-            firstTime = false;
-            if (zipFile == nullptr) {
-                errStream << "AwsDoc::PAM::zipAndUploadImages - error with zip_open. "
-                          << zipError << std::endl;
-                return false;
-            }
-
-            image_zip_data imageZipData;
-            imageZipData.mIOStream = &outcome.GetResult().GetBody();
-            zip_error_t zipErrorType;
-            zip_error_init(&zipErrorType);
-            zip_source_t *zipSource = zip_source_function_create(my_zip_source,
-                                                                 &imageZipData,
-                                                                 &zipErrorType);
-            if (zipSource == nullptr) {
-                errStream
-                        << "AwsDoc::PAM::zipAndUploadImages - error with zip_source_function_create. "
-                        << zipErrorType.str << std::endl;
-                zip_close(zipFile);
-                return false;
-            }
-            auto err = zip_file_add(zipFile, imageKey.c_str(), zipSource,
-                                    ZIP_FL_ENC_GUESS);
-            if (err == -1) {
-                errStream
-                        << "AwsDoc::PAM::zipAndUploadImages - error with zip_file_add. "
-                        << err << std::endl;
-                zip_source_free(zipSource);
-                zip_close(zipFile);
-                return false;
-            }
-            zip_close(
-                    zipFile);  // "zip_close" must be called on every iteration to add the data.
+        else if (!zipWriter.addEntry(keys[i], outcome.GetResult().GetBody())) {
+            errStream << "AwsDoc::PAM::zipAndUploadImages - error adding '" << keys[i]
+                      << "' to the zip archive." << std::endl;
+            result = false;
         }
     }
 
-    Aws::S3::Model::PutObjectRequest putObjectRequest;
-    putObjectRequest.SetKey(destinationKey);
-    putObjectRequest.SetBucket(destinationBucket);
-    std::shared_ptr<Aws::IOStream> inputData =
-            Aws::MakeShared<Aws::FStream>("SampleAllocationTag",
-                                          tempZipFileName.c_str(),
-                                          std::ios_base::in | std::ios_base::binary);
-
-    putObjectRequest.SetBody(inputData);
+    // Let any remaining downloads finish before the client is destroyed.
+    for (auto &download: downloads) {
+        download.second.wait();
+    }
 
-    auto putObjectOutcome = s3Client.PutObject(putObjectRequest);
-    if (putObjectOutcome.IsSuccess()) {
-        std::cout << "Zip file upload was successful." << std::endl;
+    if (result) {
+        result = zipWriter.finish() && uploadSink.complete();
     }
-    else {
-        errStream << "Error uploading zip file. "
-                  << putObjectOutcome.GetError().GetMessage() << std::endl;
+
+    if (!result) {
+        uploadSink.abort();
         return false;
     }
 
+    std::cout << "Zip file upload was successful." << std::endl;
+
     preSignedURL = s3Client.GeneratePresignedUrl(destinationBucket, destinationKey,
                                                  Aws::Http::HttpMethod::HTTP_GET,
                                                  600 // expirationInSeconds
@@ -5,11 +5,14 @@
 #ifndef PAM_EXAMPLES_GTESTS_CPP_LAMBDA_FUNCTIONS_H
 #define PAM_EXAMPLES_GTESTS_CPP_LAMBDA_FUNCTIONS_H
 
+#include <functional>
 #include <string>
 #include <map>
 #include <vector>
 #include <iostream>
+#include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/AttributeValue.h>
+#include <aws/s3/S3Client.h>
 #include <aws/core/client/ClientConfiguration.h>
 
 namespace AwsDoc {
@@ -38,6 +41,17 @@ namespace AwsDoc {
         getPreSignedS3UploadURL(const std::string &bucket, const std::string &key,
                                 const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Routine that returns a presigned Amazon S3 upload URL, using an existing client.
+        /*!
+          \param bucket: An S3 bucket name.
+          \param key: An S3 object key.
+          \param s3Client: An S3 client, which can be shared between calls.
+          \return std::string: The URL as a string.
+         */
+        std::string
+        getPreSignedS3UploadURL(const std::string &bucket, const std::string &key,
+                                Aws::S3::S3Client &s3Client);
+
         //! Routine that analyzes an image and returns labels using Amazon Rekognition.
         /*!
           \param bucket: An S3 bucket name which contains the image.
@@ -68,6 +82,22 @@ namespace AwsDoc {
                                           std::ostream &errStream,
                                           const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Routine that retrieves the S3 bucket keys for images associated with labels by querying
+        //! an Amazon DynamoDB table, using an existing client.
+        /*!
+          \param databaseName: A DynamoDB table name.
+          \param labels: A vector of labels as DynamoDB table keys.
+          \param mapOfImageKeys: A map to receive the S3 object keys for images associated with labels.
+          \param errStream: An std::iostream for error messaging.
+          \param dbClient: A DynamoDB client, which can be shared between calls.
+          \return bool: Function succeeded.
+         */
+        bool getKeysForLabelsFromDatabase(const std::string &databaseName,
+                                          const std::vector<std::string> &labels,
+                                          AttributeValueMap &mapOfImageKeys,
+                                          std::ostream &errStream,
+                                          const Aws::DynamoDB::DynamoDBClient &dbClient);
+
         //! Routine that updates a DynamoDB table with labels and the associated S3 object key of the image.
         /*!
           \param databaseName: A DynamoDB table name.
@@ -83,6 +113,22 @@ namespace AwsDoc {
                                     std::ostream &errStream,
                                     const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Routine that updates a DynamoDB table with labels and the associated S3 object key
+        //! of the image, using an existing client.
+        /*!
+          \param databaseName: A DynamoDB table name.
+          \param labels: A vector of labels as DynamoDB table keys.
+          \param bucketKey: The S3 object key for the image.
+          \param errStream: An std::iostream for error messaging.
+          \param dbClient: A DynamoDB client, which can be shared between calls.
+          \return bool: Function succeeded.
+         */
+        bool updateLabelsInDatabase(const std::string &databaseName,
+                                    const std::vector<std::string> &labels,
+                                    const std::string &bucketKey,
+                                    std::ostream &errStream,
+                                    const Aws::DynamoDB::DynamoDBClient &dbClient);
+
         //! Routine which returns the labels and their associated counts from a DynamoDB table.
         /*!
           \param databaseName: A DynamoDB table name.
@@ -130,6 +176,57 @@ namespace AwsDoc {
                                  const std::string &preSignedURL,
                                  std::ostream &errStream,
                                  const Aws::Client::ClientConfiguration &clientConfiguration);
+
+        //! A writer which streams a zip archive to a sink, one entry at a time.
+        /*!
+          Entries are stored without compression, because images are already
+          compressed. Only the central directory entries are kept in memory.
+          The archive is limited to 65535 entries and 4 GB, the limits of the zip
+          format without the Zip64 extensions.
+         */
+        class ZipStreamWriter {
+        public:
+            typedef std::function<bool(const char *data, size_t length)> Sink;
+
+            ZipStreamWriter(const Sink &sink, std::ostream &errStream) :
+                    mSink(sink), mErrStream(errStream) {}
+
+            //! Routine which writes an entry from a seekable stream.
+            /*!
+             \param name: The name of the entry.
+             \param stream: The entry contents. The stream is read twice.
+             \return bool: Function succeeded.
+            */
+            bool addEntry(const std::string &name, Aws::IOStream &stream);
+
+            //! Routine which writes the central directory. No entries can be added after this call.
+            /*!
+             \return bool: Function succeeded.
+            */
+            bool finish();
+
+        private:
+            struct CentralEntry {
+                std::string mName;
+                uint32_t mCrc = 0;
+                uint32_t mSize = 0;
+                uint32_t mOffset = 0;
+            };
+
+            bool write(const std::string &data);
+
+            static void appendUInt16(std::string &buffer, uint16_t value);
+
+            static void appendUInt32(std::string &buffer, uint32_t value);
+
+            Sink mSink;
+            std::ostream &mErrStream;
+            std::vector<CentralEntry> mEntries;
+            uint64_t mOffset = 0;
+            uint16_t mDosTime = 0;
+            uint16_t mDosDate = 0;
+            bool mTimeSet = false;
+        };
     } // namespace PAM
 } // namespace AwsDoc
 #endif //PAM_EXAMPLES_GTESTS_CPP_LAMBDA_FUNCTIONS_H
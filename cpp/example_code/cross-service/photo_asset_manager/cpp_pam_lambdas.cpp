@@ -18,6 +18,8 @@
 #include <aws/core/Aws.h>
 #include <aws/core/utils/UUID.h>
 #include <aws/core/utils/StringUtils.h>
+#include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/s3/S3Client.h>
 #include <json/json.h>
 #include "cpp_lambda_functions.h"
 
@@ -44,6 +46,13 @@ char const LABELS_KEY[] = "labels";
 
 char const TAG[] = "LAMBDA_LOG";
 
+// A DynamoDB client which is reused across invocations of a warm Lambda instance.
+// It is created after InitAPI and released before ShutdownAPI.
+static std::shared_ptr<Aws::DynamoDB::DynamoDBClient> s_dynamoDBClient;
+
+// An S3 client for signing upload URLs, reused in the same way.
+static std::shared_ptr<Aws::S3::S3Client> s_s3Client;
+
 //! Routine which parses a json string for the bucket and object names.
 /*!
   \param jsonString: A JSON string as input.
@@ -119,9 +128,12 @@ uploadHandler(aws::lambda_runtime::invocation_request const &request) {
     }
 
     Aws::String bucketName(env_var);
-    Aws::Client::ClientConfiguration clientConfiguration;
+    if (!s_s3Client) {
+        Aws::Client::ClientConfiguration clientConfiguration;
+        s_s3Client = Aws::MakeShared<Aws::S3::S3Client>(TAG, clientConfiguration);
+    }
     std::string presignedURL = AwsDoc::PAM::getPreSignedS3UploadURL(bucketName, key,
-                                                                    clientConfiguration);
+                                                                    *s_s3Client);
     if (presignedURL.empty()) {
         return aws::lambda_runtime::invocation_response::success(R"({
 	"statusCode": 400,
@@ -186,8 +198,13 @@ detectLabelsHandler(aws::lambda_runtime::invocation_request const &request) {
                 "Error detecting image labels" + errStream.str(), "420");
     }
 
+    if (!s_dynamoDBClient) {
+        s_dynamoDBClient = Aws::MakeShared<Aws::DynamoDB::DynamoDBClient>(TAG,
+                                                                         clientConfiguration);
+    }
+
     if (!AwsDoc::PAM::updateLabelsInDatabase(databaseName, imageLabels, object,
-                                             errStream, clientConfiguration)) {
+                                             errStream, *s_dynamoDBClient)) {
         return aws::lambda_runtime::invocation_response::failure(
                 "Error updating database" + errStream.str(), "420");
     }
@@ -353,6 +370,8 @@ int main(int argc, char **argv) {
         result = 1;
     }
 
+    s_dynamoDBClient.reset();
+    s_s3Client.reset();
     ShutdownAPI(options);
 
     return result;
@@ -17,6 +17,7 @@
 #include <aws/s3/S3Client.h>
 #include <aws/core/http/HttpClient.h>
 #include <fstream>
+#include <sstream>
 
 const char STORAGE_BUCKET_NAME[] = "PAM_STORAGE_BUCKET_NAME";
 const char WORKING_BUCKET_NAME[] = "PAM_WORKING_BUCKET_NAME";
@@ -235,4 +236,72 @@ namespace AwsDocTest {
                                     << std::endl;
     }
 
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(PAM_GTests, zip_stream_writer_3_) {
+        std::string archive;
+        std::stringstream errors;
+        AwsDoc::PAM::ZipStreamWriter zipWriter([&archive](const char *data, size_t length) {
+            archive.append(data, length);
+            return true;
+        }, errors);
+
+        // The CRC-32 check value of "123456789" is 0xCBF43926.
+        const std::vector<std::pair<std::string, std::string>> entries = {
+                {"first.jpg",  "123456789"},
+                {"second.jpg", std::string(100000, 'x')},
+                {"empty.jpg",  ""}
+        };
+        for (const auto &entry: entries) {
+            Aws::StringStream stream(entry.second);
+            ASSERT_TRUE(zipWriter.addEntry(entry.first, stream)) << errors.str();
+        }
+        ASSERT_TRUE(zipWriter.finish()) << errors.str();
+
+        auto readUInt16 = [&archive](size_t offset) {
+            return static_cast<uint32_t>(static_cast<unsigned char>(archive.at(offset))) |
+                   (static_cast<uint32_t>(static_cast<unsigned char>(archive.at(offset + 1)))
+                           << 8);
+        };
+        auto readUInt32 = [&readUInt16](size_t offset) {
+            return readUInt16(offset) | (readUInt16(offset + 2) << 16);
+        };
+
+        // The end of central directory record is the last 22 bytes.
+        ASSERT_GE(archive.size(), 22u);
+        const size_t endRecord = archive.size() - 22;
+        ASSERT_EQ(readUInt32(endRecord), 0x06054b50u);
+        ASSERT_EQ(readUInt16(endRecord + 8), entries.size());
+        ASSERT_EQ(readUInt16(endRecord + 10), entries.size());
+        const size_t centralDirectorySize = readUInt32(endRecord + 12);
+        size_t centralEntry = readUInt32(endRecord + 16);
+        ASSERT_EQ(centralEntry + centralDirectorySize, endRecord);
+
+        size_t localEntry = 0;
+        for (const auto &entry: entries) {
+            // Central directory header.
+            ASSERT_EQ(readUInt32(centralEntry), 0x02014b50u);
+            const uint32_t crc = readUInt32(centralEntry + 16);
+            ASSERT_EQ(readUInt32(centralEntry + 20), entry.second.size());
+            ASSERT_EQ(readUInt32(centralEntry + 24), entry.second.size());
+            const size_t nameLength = readUInt16(centralEntry + 28);
+            ASSERT_EQ(archive.substr(centralEntry + 46, nameLength), entry.first);
+            ASSERT_EQ(readUInt32(centralEntry + 42), localEntry);
+            centralEntry += 46 + nameLength;
+
+            // Local file header, followed by the stored contents.
+            ASSERT_EQ(readUInt32(localEntry), 0x04034b50u);
+            ASSERT_EQ(readUInt16(localEntry + 8), 0u);  // Stored.
+            ASSERT_EQ(readUInt32(localEntry + 14), crc);
+            ASSERT_EQ(readUInt32(localEntry + 18), entry.second.size());
+            ASSERT_EQ(readUInt16(localEntry + 26), nameLength);
+            ASSERT_EQ(archive.substr(localEntry + 30, nameLength), entry.first);
+            const size_t dataOffset = localEntry + 30 + nameLength;
+            ASSERT_EQ(archive.substr(dataOffset, entry.second.size()), entry.second);
+            localEntry = dataOffset + entry.second.size();
+        }
+        ASSERT_EQ(localEntry, readUInt32(endRecord + 16));
+
+        // The checksum in the first local header.
+        ASSERT_EQ(readUInt32(14), 0xCBF43926u);
+    }
 } // namespace AwsDocTest
@@ -4,8 +4,10 @@
 #ifndef AWSDOC_CROSSSERVICE_HTTPRECEIVER_H
 #define AWSDOC_CROSSSERVICE_HTTPRECEIVER_H
 
-#include <string>
+#include <istream>
 #include <ostream>
+#include <sstream>
+#include <string>
 
 namespace AwsDoc {
     namespace CrossService {
@@ -23,18 +25,39 @@ namespace AwsDoc {
         public:
             //! Routine which handles HTTP server requests.
             /*!
+              The response can be sent while content is written to responseStream,
+              so responseContentType must be set before any content is written.
              \sa handleHTTP()
              \param method: Method of HTTP request.
              \param uri: Uri of HTTP request.
-             \param requestContent Content of HTTP request.
+             \param requestStream Content of HTTP request, read from the connection.
              \param responseContentType Content type of response, if any.
              \param responseStream Content of response, if any.
              \return bool: Successful completion.
             */
             virtual bool handleHTTP(const std::string &method, const std::string &uri,
-                                    const std::string &requestContent,
+                                    std::istream &requestStream,
                                     std::string &responseContentType,
                                     std::ostream &responseStream) = 0;
+
+            //! Routine which handles HTTP server requests with content in a string.
+            /*!
+             \sa handleHTTP()
+             \param method: Method of HTTP request.
+             \param uri: Uri of HTTP request.
+             \param requestContent Content of HTTP request.
+             \param responseContentType Content type of response, if any.
+             \param responseStream Content of response, if any.
+             \return bool: Successful completion.
+            */
+            bool handleHTTP(const std::string &method, const std::string &uri,
+                            const std::string &requestContent,
+                            std::string &responseContentType,
+                            std::ostream &responseStream) {
+                std::istringstream requestStream(requestContent);
+                return handleHTTP(method, uri, requestStream, responseContentType,
+                                  responseStream);
+            }
         };
     }  // namespace CrossService
 } // namespace AwsDoc
@@ -69,6 +69,83 @@ namespace AwsDoc {
             return result;
         }
 
+        //! Routine which writes a string to a stream as a JSON string.
+        /*!
+         \sa writeJsonString()
+         \param stream: Output stream.
+         \param string: String to write, escaped as required by JSON.
+         \return void:
+         */
+        void writeJsonString(std::ostream &stream, const Aws::String &string) {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+
+            stream.put('"');
+            const char *data = string.data();
+            size_t runStart = 0;
+            for (size_t i = 0; i < string.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(data[i]);
+                if (c >= 0x20 && c != '"' && c != '\\') {
+                    continue;
+                }
+
+                // Write the characters which need no escape in one call.
+                stream.write(data + runStart, i - runStart);
+                runStart = i + 1;
+                switch (c) {
+                    case '"':
+                        stream.write("\\\"", 2);
+                        break;
+                    case '\\':
+                        stream.write("\\\\", 2);
+                        break;
+                    case '\n':
+                        stream.write("\\n", 2);
+                        break;
+                    case '\r':
+                        stream.write("\\r", 2);
+                        break;
+                    case '\t':
+                        stream.write("\\t", 2);
+                        break;
+                    case '\b':
+                        stream.write("\\b", 2);
+                        break;
+                    case '\f':
+                        stream.write("\\f", 2);
+                        break;
+                    default: {
+                        const char escape[] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4],
+                                               HEX_DIGITS[c & 0xf]};
+                        stream.write(escape, sizeof(escape));
+                    }
+                }
+            }
+            stream.write(data + runStart, string.size() - runStart);
+            stream.put('"');
+        }
+
+        //! Routine which writes a work item to a stream as a compact JSON object.
+        /*!
+         \sa writeWorkItemJson()
+         \param stream: Output stream.
+         \param workItem: Work item struct.
+         \return void:
+         */
+        void writeWorkItemJson(std::ostream &stream, const WorkItem &workItem) {
+            stream << "{\"" << HTTP_ID_KEY << "\":";
+            writeJsonString(stream, workItem.mID);
+            stream << ",\"" << HTTP_NAME_KEY << "\":";
+            writeJsonString(stream, workItem.mName);
+            stream << ",\"" << HTTP_GUIDE_KEY << "\":";
+            writeJsonString(stream, workItem.mGuide);
+            stream << ",\"" << HTTP_DESCRIPTION_KEY << "\":";
+            writeJsonString(stream, workItem.mDescription);
+            stream << ",\"" << HTTP_STATUS_KEY << "\":";
+            writeJsonString(stream, workItem.mStatus);
+            stream << ",\"" << HTTP_ARCHIVED_KEY << "\":"
+                   << (workItem.mArchived ? "true}" : "false}");
+        }
+
     }  // namespace CrossService
 } // namespace AwsDoc
 
@@ -77,25 +154,56 @@ namespace AwsDoc {
  \sa ItemTrackerHTTPHandler::ItemTrackerHTTPHandler()
  \param rdsDataReceiver: Handler for Amazon Relational Database Service (Amazon RDS).
  \param emailReceiver: Handler for Amazon Simple Email Service (Amazon SES).
+ \param streamingPageSize: If not 0, work item lists are written to the
+                           response one page of this size at a time.
 */
 AwsDoc::CrossService::ItemTrackerHTTPHandler::ItemTrackerHTTPHandler(
         AwsDoc::CrossService::RDSDataReceiver &rdsDataReceiver,
-        SESEmailReceiver &emailReceiver) :
+        SESEmailReceiver &emailReceiver,
+        size_t streamingPageSize) :
         mRdsDataReceiver(rdsDataReceiver),
-        mEmailReceiver(emailReceiver) {
+        mEmailReceiver(emailReceiver),
+        mStreamingPageSize(streamingPageSize) {
 }
 
-//! Routine which retrieves a list of work items from Amazon RDS as an HTTP response
-//! JSON string.
+//! Routine which retrieves a list of work items from Amazon RDS and writes it
+//! to an HTTP response as JSON.
 /*!
  \sa ItemTrackerHTTPHandler::getWorkItemJSON()
  \param status: Status filter for work items.
- \param jsonString: HTTP response JSON string.
+ \param responseStream: HTTP response stream.
  \return bool: Successful completion.
 */
 bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemJSON(
-        AwsDoc::CrossService::WorkItemStatus status, std::string &jsonString) {
+        AwsDoc::CrossService::WorkItemStatus status, std::ostream &responseStream) {
     bool result;
+    if (mStreamingPageSize > 0) {
+        // Write each work item as it is retrieved, without holding the whole list.
+        // The lock is not held, because writing to the response waits for the
+        // client, and a slow client would block every other request. The RDS
+        // Data client is thread safe, and a completed post is already visible to
+        // a new select.
+        bool first = true;
+        responseStream.put('[');
+        result = mRdsDataReceiver.streamWorkItems(
+                status, mStreamingPageSize,
+                [&responseStream, &first](const WorkItem &workItem) {
+                    if (!first) {
+                        responseStream.put(',');
+                    }
+                    first = false;
+                    writeWorkItemJson(responseStream, workItem);
+                });
+
+        // A failure is not hidden behind a complete array. If part of the list
+        // has been sent, the HTTP server aborts the response.
+        if (result) {
+            responseStream.put(']');
+        }
+
+        return result;
+    }
+
     std::vector<WorkItem> workItems;
     {
         std::lock_guard<std::mutex> lock(mHTTPMutex);
@@ -103,24 +211,14 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemJSON(
     }
 
     if (result) {
-        std::stringstream jsonStringStream;
-        jsonStringStream << "[";
+        responseStream.put('[');
         for (size_t i = 0; i < workItems.size(); ++i) {
-            WorkItem workItem = workItems[i];
-            Aws::Utils::Json::JsonValue jsonWorkItem;
-            jsonWorkItem.WithString(HTTP_ID_KEY, workItem.mID);
-            jsonWorkItem.WithString(HTTP_NAME_KEY, workItem.mName);
-            jsonWorkItem.WithString(HTTP_GUIDE_KEY, workItem.mGuide);
-            jsonWorkItem.WithString(HTTP_DESCRIPTION_KEY, workItem.mDescription);
-            jsonWorkItem.WithString(HTTP_STATUS_KEY, workItem.mStatus);
-            jsonWorkItem.WithBool(HTTP_ARCHIVED_KEY, workItem.mArchived);
-            jsonStringStream << jsonWorkItem.View().WriteReadable();
+            writeWorkItemJson(responseStream, workItems[i]);
             if (i < workItems.size() - 1) {
-                jsonStringStream << ",";
+                responseStream.put(',');
             }
         }
-        jsonStringStream << "]";
-        jsonString = jsonStringStream.str();
+        responseStream.put(']');
     }
 
     return result;
@@ -129,11 +227,11 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemJSON(
 //! Routine which adds a work item to Amazon RDS.
 /*!
  \sa ItemTrackerHTTPHandler::addWorkItem()
- \param workItemJson: Content of HTTP request as JSON string.
+ \param workItemJson: Content of HTTP request as JSON.
  \return bool: Successful completion.
 */
 bool AwsDoc::CrossService::ItemTrackerHTTPHandler::addWorkItem(
-        const std::string &workItemJson) {
+        std::istream &workItemJson) {
 
     bool result;
     WorkItem workItem = jsonToWorkItem(workItemJson);
@@ -145,17 +243,17 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::addWorkItem(
     return result;
 }
 
-//! Routine which converts a JSON string to a WorkItem struct.
+//! Routine which converts JSON to a WorkItem struct.
 /*!
  \sa ItemTrackerHTTPHandler::jsonToWorkItem()
- \param workItemJson: Content of HTTP request as JSON string.
+ \param workItemJson: Content of HTTP request as JSON.
  \return WorkItem: WorkItem struct.
 */
 AwsDoc::CrossService::WorkItem
 AwsDoc::CrossService::ItemTrackerHTTPHandler::jsonToWorkItem(
-        const std::string &jsonString) {
+        std::istream &workItemJson) {
     WorkItem result;
-    Aws::Utils::Json::JsonValue document(jsonString);
+    Aws::Utils::Json::JsonValue document(workItemJson);
     Aws::Utils::Json::JsonView view(document);
     result.mName = safeGetJsonString(view, HTTP_NAME_KEY);
     result.mGuide = safeGetJsonString(view, HTTP_GUIDE_KEY);
@@ -169,11 +267,11 @@ AwsDoc::CrossService::ItemTrackerHTTPHandler::jsonToWorkItem(
 //! Routine which sends an email using Amazon SES.
 /*!
  \sa ItemTrackerHTTPHandler::sendEmail()
- \param emailJson: HTTP request JSON string containing an email.
+ \param emailJson: HTTP request JSON containing an email.
  \return bool: Successful completion.
 */
 bool
-AwsDoc::CrossService::ItemTrackerHTTPHandler::sendEmail(const std::string &emailJson) {
+AwsDoc::CrossService::ItemTrackerHTTPHandler::sendEmail(std::istream &emailJson) {
     Aws::Utils::Json::JsonValue document(emailJson);
     Aws::Utils::Json::JsonView view(document);
     Aws::String email = safeGetJsonString(view, HTTP_EMAIL_KEY);
@@ -191,15 +289,16 @@ AwsDoc::CrossService::ItemTrackerHTTPHandler::sendEmail(const std::string &email
     return result;
 }
 
-//! Routine which retrieves a work item from Amazon RDS with the specified ID.
+//! Routine which retrieves a work item from Amazon RDS with the specified ID and
+//! writes it to an HTTP response as JSON.
 /*!
  \sa ItemTrackerHTTPHandler::getWorkItemWithIdJson()
  \param id: Work item id.
- \param jsonString: String with JSON response.
+ \param responseStream: HTTP response stream.
  \return bool: Successful completion.
 */
 bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemWithIdJson(
-        const Aws::String &id, std::string &jsonString) {
+        const Aws::String &id, std::ostream &responseStream) {
     WorkItem workItem;
     bool result;
     {
@@ -208,20 +307,11 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemWithIdJson(
     }
 
     if (result) {
-        std::stringstream jsonStringStream;
-        jsonStringStream << "[";
+        responseStream.put('[');
         if (!workItem.mID.empty()) {
-            Aws::Utils::Json::JsonValue jsonWorkItem;
-            jsonWorkItem.WithString(HTTP_ID_KEY, workItem.mID);
-            jsonWorkItem.WithString(HTTP_NAME_KEY, workItem.mName);
-            jsonWorkItem.WithString(HTTP_GUIDE_KEY, workItem.mGuide);
-            jsonWorkItem.WithString(HTTP_DESCRIPTION_KEY, workItem.mDescription);
-            jsonWorkItem.WithString(HTTP_STATUS_KEY, workItem.mStatus);
-            jsonWorkItem.WithBool(HTTP_ARCHIVED_KEY, workItem.mArchived);
-            jsonStringStream << jsonWorkItem.View().WriteReadable();
+            writeWorkItemJson(responseStream, workItem);
         }
-        jsonStringStream << "]";
-        jsonString = jsonStringStream.str();
+        responseStream.put(']');
     }
 
     return result;
@@ -232,58 +322,47 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::getWorkItemWithIdJson(
  \sa ItemTrackerHTTPHandler::handleHTTP()
  \param method: Method of HTTP request.
  \param uri: Uri of HTTP request.
- \param requestContent Content of HTTP request.
+ \param requestStream Content of HTTP request, read from the connection.
  \param responseContentType Content type of response, if any.
  \param responseStream Content of response, if any.
  \return bool: Successful completion.
 */
 bool AwsDoc::CrossService::ItemTrackerHTTPHandler::handleHTTP(const std::string &method,
                                                               const std::string &uri,
-                                                              const std::string &requestContent,
+                                                              std::istream &requestStream,
                                                               std::string &responseContentType,
                                                               std::ostream &responseStream) {
     bool result = false;
+    const bool hasContent =
+            requestStream.peek() != std::istream::traits_type::eof();
     if (method == "GET") {
         if (uri == "/api/items") {
-            std::string responseString;
+            // The content type is set first, because the response can be sent
+            // while it is written.
+            responseContentType = "application/json";
             result = getWorkItemJSON(AwsDoc::CrossService::WorkItemStatus::BOTH,
-                                     responseString);
-
-            if (result) {
-                responseContentType = "application/json";
-                responseStream << responseString;
-            }
+                                     responseStream);
         }
         else if (uri == "/api/items?archived=true") {
-            std::string responseString;
+            // The content type is set first, because the response can be sent
+            // while it is written.
+            responseContentType = "application/json";
             result = getWorkItemJSON(AwsDoc::CrossService::WorkItemStatus::ARCHIVED,
-                                     responseString);
-
-            if (result) {
-                responseContentType = "application/json";
-                responseStream << responseString;
-            }
+                                     responseStream);
         }
         else if (uri == "/api/items?archived=false") {
-            std::string responseString;
+            // The content type is set first, because the response can be sent
+            // while it is written.
+            responseContentType = "application/json";
             result = getWorkItemJSON(AwsDoc::CrossService::WorkItemStatus::NOT_ARCHIVED,
-                                     responseString);
-
-            if (result) {
-                responseContentType = "application/json";
-                responseStream << responseString;
-            }
+                                     responseStream);
         }
         else if (uri.find("/api/items/") == 0) {
             size_t startPos = strlen("/api/items/");
             Aws::String itemID = uri.substr(startPos, uri.length() - startPos);
 
-            Aws::String responseString;
-            result = getWorkItemWithIdJson(itemID, responseString);
-            if (result) {
-                responseContentType = "application/json";
-                responseStream << responseString;
-            }
+            responseContentType = "application/json";
+            result = getWorkItemWithIdJson(itemID, responseStream);
         }
         else {
             std::cerr << "Unhandled GET uri " << uri << std::endl;
@@ -291,16 +370,16 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::handleHTTP(const std::string
     }
     else if ((method == "POST")) {
         if (uri == "/api/items") {
-            if (!requestContent.empty()) {
-                result = addWorkItem(requestContent);
+            if (hasContent) {
+                result = addWorkItem(requestStream);
             }
             else {
                 std::cerr << "No content in Post /api/items" << std::endl;
             }
         }
         else if (uri == "/api/items:report") {
-            if (!requestContent.empty()) {
-                result = sendEmail(requestContent);
+            if (hasContent) {
+                result = sendEmail(requestStream);
             }
             else {
                 std::cerr << "No content in Post /api/items" << std::endl;
@@ -324,7 +403,7 @@ bool AwsDoc::CrossService::ItemTrackerHTTPHandler::handleHTTP(const std::string
                 result = mRdsDataReceiver.setWorkItemToArchive(itemId);
             }
             else {
-                WorkItem workItem = jsonToWorkItem(requestContent);
+                WorkItem workItem = jsonToWorkItem(requestStream);
                 workItem.mID = itemId;
                 result = mRdsDataReceiver.updateWorkItem(workItem);
             }
@@ -14,6 +14,7 @@
 #define SERVERLESSAURORA_ITEMTRACKERSERVER_H
 
 #include <aws/core/Aws.h>
+#include <functional>
 #include "HTTPReceiver.h"
 
 namespace AwsDoc {
@@ -63,6 +64,29 @@ namespace AwsDoc {
         extern const Aws::String HTTP_ARCHIVED_KEY;
         extern const Aws::String HTTP_EMAIL_KEY;
 
+        //! Routine which writes a string to a stream as a JSON string.
+        /*!
+         \sa writeJsonString()
+         \param stream: Output stream.
+         \param string: String to write, escaped as required by JSON.
+         \return void:
+         */
+        void writeJsonString(std::ostream &stream, const Aws::String &string);
+
+        //! Routine which writes a work item to a stream as a compact JSON object.
+        /*!
+          The object is written directly to the stream, without building a
+          JSON document or a string.
+         \sa writeWorkItemJson()
+         \param stream: Output stream.
+         \param workItem: Work item struct.
+         \return void:
+         */
+        void writeWorkItemJson(std::ostream &stream, const WorkItem &workItem);
+
+        // Called for each work item retrieved by RDSDataReceiver::streamWorkItems.
+        typedef std::function<void(const WorkItem &workItem)> WorkItemHandler;
+
         /**
          * RDSDataReceiver
          *
@@ -89,6 +113,18 @@ namespace AwsDoc {
             virtual bool
             getWorkItems(WorkItemStatus status, std::vector<WorkItem> &workItems) = 0;
 
+            //! Routine which retrieves work items one page at a time, and passes
+            //! each work item to a handler, without holding the whole list.
+            /*!
+             \sa RDSDataReceiver::streamWorkItems()
+             \param status: Filter for work item status.
+             \param pageSize: Number of work items retrieved with each request.
+             \param handler: Called for each work item.
+             \return bool: Successful completion.
+             */
+            virtual bool streamWorkItems(WorkItemStatus status, size_t pageSize,
+                                         const WorkItemHandler &handler) = 0;
+
             //! Routine which retrieves one work item.
             /*!
              \sa RDSDataReceiver::getWorkItemWithId()
@@ -148,75 +184,82 @@ namespace AwsDoc {
              \sa ItemTrackerHTTPHandler::ItemTrackerHTTPHandler()
              \param rdsDataReceiver: Handler for Amazon Relational Database Service (Amazon RDS).
              \param emailReceiver: Handler for Amazon Simple Email Service (Amazon SES).
+             \param streamingPageSize: If not 0, work item lists are written to the
+                                       response one page of this size at a time.
             */
             explicit ItemTrackerHTTPHandler(RDSDataReceiver &rdsDataReceiver,
-                                            SESEmailReceiver &emailReceiver);
+                                            SESEmailReceiver &emailReceiver,
+                                            size_t streamingPageSize = 0);
 
             //! Override of HTTPReceiver::handleHTTP routine which handles HTTP server requests.
             /*!
              \sa ItemTrackerHTTPHandler::handleHTTP()
              \param method: Method of HTTP request.
              \param uri: Uri of HTTP request.
-             \param requestContent Content of HTTP request.
+             \param requestStream Content of HTTP request, read from the connection.
              \param responseContentType Content type of response, if any.
              \param responseStream Content of response, if any.
              \return bool: Successful completion.
             */
             bool handleHTTP(const std::string &method, const std::string &uri,
-                            const std::string &requestContent,
+                            std::istream &requestStream,
                             std::string &responseContentType,
                             std::ostream &responseStream) override;
 
+            using HTTPReceiver::handleHTTP;
+
             //! Routine which adds a work item to Amazon RDS.
             /*!
              \sa ItemTrackerHTTPHandler::addWorkItem()
-             \param workItemJson: Content of HTTP request as JSON string.
+             \param workItemJson: Content of HTTP request as JSON.
              \return bool: Successful completion.
             */
-            bool addWorkItem(const std::string &workItemJson);
+            bool addWorkItem(std::istream &workItemJson);
 
             //! Routine which sends an email using Amazon SES.
             /*!
              \sa ItemTrackerHTTPHandler::sendEmail()
-             \param emailJson: HTTP request JSON string containing an email.
+             \param emailJson: HTTP request JSON containing an email.
              \return bool: Successful completion.
             */
-            bool sendEmail(const std::string &emailJson);
+            bool sendEmail(std::istream &emailJson);
 
         private:
 
-            //! Routine which retrieves a work item from Amazon RDS with the specified ID.
+            //! Routine which retrieves a work item from Amazon RDS with the specified ID and
+            //! writes it to an HTTP response as JSON.
             /*!
              \sa ItemTrackerHTTPHandler::getWorkItemWithIdJson()
              \param id: Work item id.
-             \param jsonString: String with JSON response.
+             \param responseStream: HTTP response stream.
              \return bool: Successful completion.
             */
             bool getWorkItemWithIdJson(
-                    const Aws::String &id, std::string &jsonString);
+                    const Aws::String &id, std::ostream &responseStream);
 
-            //! Routine which retrieves a list of work items from Amazon RDS as an HTTP response
-            //! JSON string.
+            //! Routine which retrieves a list of work items from Amazon RDS and writes it
+            //! to an HTTP response as JSON.
             /*!
              \sa ItemTrackerHTTPHandler::getWorkItemJSON()
              \param status: Status filter for work items.
-             \param jsonString: HTTP response JSON string.
+             \param responseStream: HTTP response stream.
              \return bool: Successful completion.
             */
             bool getWorkItemJSON(
                     AwsDoc::CrossService::WorkItemStatus status,
-                    std::string &jsonString);
+                    std::ostream &responseStream);
 
-            //! Routine which converts a JSON string to a WorkItem struct.
+            //! Routine which converts JSON to a WorkItem struct.
             /*!
              \sa ItemTrackerHTTPHandler::jsonToWorkItem()
-             \param workItemJson: Content of HTTP request as JSON string.
+             \param workItemJson: Content of HTTP request as JSON.
              \return WorkItem: WorkItem struct.
             */
-            static WorkItem jsonToWorkItem(const std::string &jsonString);
+            static WorkItem jsonToWorkItem(std::istream &workItemJson);
 
             RDSDataReceiver &mRdsDataReceiver;
             SESEmailReceiver &mEmailReceiver;
+            const size_t mStreamingPageSize;
             std::mutex mHTTPMutex;  // HTTP is received asynchronously.
             // The lock ensures the get items following
             // a post item contains the posted record.
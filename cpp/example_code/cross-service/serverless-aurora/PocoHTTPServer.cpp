@@ -17,24 +17,276 @@
 #include <Poco/Net/HTTPRequestHandlerFactory.h>
 #include <Poco/Net/HTTPResponse.h>
 #include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerRequestImpl.h>
 #include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Exception.h>
+#include <Poco/ThreadPool.h>
+#include <Poco/Timespan.h>
 
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <limits>
+#include <mutex>
+#include <streambuf>
+#include <vector>
 
 namespace AwsDoc {
     namespace PocoImpl {
+        /**
+         *  ResponseStreamBuffer
+         *
+         *  Stream buffer which writes the content of an HTTP response. Content which
+         *  fits in the buffer is sent with a Content-Length header when the request
+         *  has been handled. When more content is written, the headers are sent and
+         *  the content is sent with chunked transfer encoding while it is written.
+         *
+         *  If the request fails after the headers have been sent, the connection is
+         *  closed without the terminating chunk, so the client sees an incomplete
+         *  response instead of a truncated one.
+         *
+         */
+        class ResponseStreamBuffer : public std::streambuf {
+        public:
+            ResponseStreamBuffer(Poco::Net::HTTPServerRequest &request,
+                                 Poco::Net::HTTPServerResponse &response,
+                                 const std::string &contentType) :
+                    mRequest(request), mResponse(response), mContentType(contentType) {
+                setp(mBuffer, mBuffer + sizeof(mBuffer));
+            }
+
+            //! Routine which sends the rest of the response.
+            /*!
+             \param result: Result of the request, used for the status if the
+                            headers have not been sent. If they have been sent, a
+                            failed request aborts the response.
+             \return void:
+             */
+            void finish(bool result) {
+                if (mResponseStream == nullptr) {
+                    mResponse.setStatus(result ? Poco::Net::HTTPResponse::HTTP_OK :
+                                        Poco::Net::HTTPResponse::HTTP_NOT_ACCEPTABLE);
+                    if (!mContentType.empty()) {
+                        mResponse.setContentType(mContentType);
+                    }
+                    mResponse.setContentLength(pptr() - pbase());
+                    mResponse.send().write(pbase(), pptr() - pbase());
+                }
+                else if (result) {
+                    writeBuffer();
+                }
+                else {
+                    std::cerr << "Error with ResponseStreamBuffer::finish. The "
+                              << "request failed after the response headers "
+                              << "were sent. The response is aborted." << std::endl;
+                    abort();
+                }
+                setp(mBuffer, mBuffer + sizeof(mBuffer));
+            }
+
+            //! Routine which discards the buffered content and sends an empty
+            //! response with a status instead.
+            /*!
+             \param status: The response status.
+             \return bool: False if the headers had already been sent.
+             */
+            bool sendStatus(Poco::Net::HTTPResponse::HTTPStatus status) {
+                if (mResponseStream != nullptr) {
+                    return false;
+                }
+                setp(mBuffer, mBuffer + sizeof(mBuffer));
+                mResponse.setStatus(status);
+                mResponse.setContentLength(0);
+                mResponse.send();
+                return true;
+            }
+
+        protected:
+            int overflow(int c) override {
+                if (!writeBuffer()) {
+                    return traits_type::eof();
+                }
+                if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                    *pptr() = traits_type::to_char_type(c);
+                    pbump(1);
+                }
+                return traits_type::not_eof(c);
+            }
+
+        private:
+            // Close the connection before the chunked stream is closed, so the
+            // terminating chunk is not sent.
+            void abort() {
+                mResponse.setKeepAlive(false);
+                try {
+                    static_cast<Poco::Net::HTTPServerRequestImpl &>(mRequest).socket().shutdown();
+                }
+                catch (const Poco::Exception &e) {
+                    std::cerr << "Error with ResponseStreamBuffer::abort. "
+                              << e.displayText() << std::endl;
+                }
+            }
+
+            bool writeBuffer() {
+                if (mResponseStream == nullptr) {
+                    // The status is not known yet, and the request has not failed.
+                    mResponse.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+                    if (!mContentType.empty()) {
+                        mResponse.setContentType(mContentType);
+                    }
+                    mResponse.setChunkedTransferEncoding(true);
+                    mResponseStream = &mResponse.send();
+                }
+                mResponseStream->write(pbase(), pptr() - pbase());
+                setp(mBuffer, mBuffer + sizeof(mBuffer));
+                return mResponseStream->good();
+            }
+
+            Poco::Net::HTTPServerRequest &mRequest;
+            Poco::Net::HTTPServerResponse &mResponse;
+            const std::string &mContentType;
+            std::ostream *mResponseStream = nullptr;
+            char mBuffer[16 * 1024];
+        };
+
+        /**
+         *  RequestStreamBuffer
+         *
+         *  Stream buffer which reads the content of an HTTP request, and ends the
+         *  content when more than the maximum number of bytes has been read. This
+         *  limits requests which do not declare their length, such as chunked
+         *  requests.
+         *
+         */
+        class RequestStreamBuffer : public std::streambuf {
+        public:
+            RequestStreamBuffer(std::istream &source, std::streamsize maxBytes) :
+                    mSource(source), mMaxBytes(maxBytes) {
+                setg(mBuffer, mBuffer, mBuffer);
+            }
+
+            //! Routine which returns whether the content was longer than the maximum.
+            /*!
+             \return bool: True if the maximum was exceeded.
+             */
+            bool exceeded() const {
+                return mExceeded;
+            }
+
+        protected:
+            int_type underflow() override {
+                if (mExceeded || !mSource.good()) {
+                    return traits_type::eof();
+                }
+
+                // Read one byte past the maximum, to detect longer content.
+                const std::streamsize count = std::min<std::streamsize>(
+                        sizeof(mBuffer), mMaxBytes - mBytesRead + 1);
+                mSource.read(mBuffer, count);
+                std::streamsize bytesRead = mSource.gcount();
+                mBytesRead += bytesRead;
+                if (mBytesRead > mMaxBytes) {
+                    mExceeded = true;
+                    return traits_type::eof();
+                }
+                if (bytesRead == 0) {
+                    return traits_type::eof();
+                }
+
+                setg(mBuffer, mBuffer, mBuffer + bytesRead);
+                return traits_type::to_int_type(*gptr());
+            }
+
+        private:
+            std::istream &mSource;
+            const std::streamsize mMaxBytes;
+            std::streamsize mBytesRead = 0;
+            bool mExceeded = false;
+            char mBuffer[16 * 1024];
+        };
+
+        /**
+         *  RequestHandlerPool
+         *
+         *  Poco creates a request handler for each request, and deletes it after the
+         *  request is handled. MyRequestHandler objects are allocated from this pool,
+         *  so each request reuses the storage of a finished handler, without a heap
+         *  allocation.
+         *
+         */
+        class RequestHandlerPool {
+        public:
+            explicit RequestHandlerPool(size_t maxIdle) : mMaxIdle(maxIdle) {
+                mIdle.reserve(maxIdle);
+            }
+
+            ~RequestHandlerPool() {
+                for (void *handler: mIdle) {
+                    ::operator delete(handler);
+                }
+            }
+
+            void *allocate(std::size_t size) {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (!mIdle.empty()) {
+                        void *handler = mIdle.back();
+                        mIdle.pop_back();
+                        return handler;
+                    }
+                }
+                return ::operator new(size);
+            }
+
+            void release(void *handler) {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (mIdle.size() < mMaxIdle) {
+                        mIdle.push_back(handler);
+                        return;
+                    }
+                }
+                ::operator delete(handler);
+            }
+
+            static RequestHandlerPool &instance() {
+                static RequestHandlerPool pool(256);
+                return pool;
+            }
+
+        private:
+            const size_t mMaxIdle;
+            std::mutex mMutex;
+            std::vector<void *> mIdle;
+        };
+
         class MyRequestHandler : public Poco::Net::HTTPRequestHandler {
         public:
-            explicit MyRequestHandler(
-                    AwsDoc::CrossService::HTTPReceiver &httpReceiver) :
-                    mHttpReceiver(httpReceiver) {}
+            MyRequestHandler(AwsDoc::CrossService::HTTPReceiver &httpReceiver,
+                             std::streamsize maxRequestBytes) :
+                    mHttpReceiver(httpReceiver), mMaxRequestBytes(maxRequestBytes) {}
+
+            // The pool holds storage of the size of this class only.
+            static void *operator new(std::size_t size) {
+                return size == sizeof(MyRequestHandler) ?
+                       RequestHandlerPool::instance().allocate(size) :
+                       ::operator new(size);
+            }
+
+            static void operator delete(void *handler, std::size_t size) {
+                if (size == sizeof(MyRequestHandler)) {
+                    RequestHandlerPool::instance().release(handler);
+                }
+                else {
+                    ::operator delete(handler);
+                }
+            }
 
-            virtual void
+            void
             handleRequest(Poco::Net::HTTPServerRequest &req,
-                          Poco::Net::HTTPServerResponse &resp) {
-                std::string method = req.getMethod();
-                std::string uri = req.getURI();
+                          Poco::Net::HTTPServerResponse &resp) override {
+                const std::string &method = req.getMethod();
+                const std::string &uri = req.getURI();
 
                 resp.set("Access-Control-Allow-Origin", "*");
                 if (method == "OPTIONS") {
@@ -43,64 +295,106 @@ namespace AwsDoc {
                     resp.add("Access-Control-Allow-Headers",
                              "X-PINGOTHER, Content-Type");
                     resp.add("Access-Control-Max-Age", "86400");
+                    resp.setContentLength(0);
+                    resp.send();
+                }
+                else if (req.getContentLength() > mMaxRequestBytes) {
+                    // A request which declares its length is refused before it is
+                    // read. The content is not read, so the connection cannot be reused.
+                    resp.setStatus(Poco::Net::HTTPResponse::HTTP_REQUEST_ENTITY_TOO_LARGE);
+                    resp.setKeepAlive(false);
+                    resp.setContentLength(0);
                     resp.send();
                 }
                 else {
+                    // Without a length or chunked encoding, a request has no content.
+                    // Poco would read such a request stream until the connection closes.
+                    const bool hasContent = req.getContentLength() > 0 ||
+                                            req.getChunkedTransferEncoding();
+                    std::istream noContent(nullptr);
+                    // Chunked requests are limited while they are read.
+                    RequestStreamBuffer requestBuffer(hasContent ? req.stream() : noContent,
+                                                      mMaxRequestBytes);
+                    std::istream requestStream(&requestBuffer);
+
                     std::string contentType;
-                    std::stringstream responseStream;
-                    std::string requestContent;
-                    if (req.getContentLength() > 0) {
-                        std::vector<char> body(req.getContentLength() + 1);
-                        req.stream().read(body.data(), body.size() - 1);
-                        body[body.size() - 1] = 0;
-                        requestContent = body.data();
-                    }
+                    ResponseStreamBuffer responseBuffer(req, resp, contentType);
+                    std::ostream responseStream(&responseBuffer);
 
-                    bool result = mHttpReceiver.handleHTTP(method, uri, requestContent,
+                    bool result = mHttpReceiver.handleHTTP(method, uri, requestStream,
                                                            contentType,
                                                            responseStream);
-                    resp.setStatus(result ? Poco::Net::HTTPResponse::HTTP_OK :
-                                   Poco::Net::HTTPResponse::HTTP_NOT_ACCEPTABLE);
-                    if (!contentType.empty()) {
-                        resp.setContentType(contentType);
+
+                    // Content which was not read would be taken as the next request
+                    // on a keep-alive connection.
+                    if (hasContent) {
+                        requestStream.ignore(std::numeric_limits<std::streamsize>::max());
+                    }
+
+                    if (requestBuffer.exceeded()) {
+                        // The rest of the content is not read, so the connection
+                        // cannot be reused.
+                        resp.setKeepAlive(false);
+                        if (!responseBuffer.sendStatus(
+                                Poco::Net::HTTPResponse::HTTP_REQUEST_ENTITY_TOO_LARGE)) {
+                            responseBuffer.finish(false);
+                        }
+                    }
+                    else {
+                        responseBuffer.finish(result);
                     }
-                    std::ostream &ostream = resp.send();
-                    ostream << responseStream.str() << std::endl;
                 }
             }
 
         private :
             AwsDoc::CrossService::HTTPReceiver &mHttpReceiver;
+            const std::streamsize mMaxRequestBytes;
         };
 
         class MyRequestHandlerFactory : public Poco::Net::HTTPRequestHandlerFactory {
         public:
-            explicit MyRequestHandlerFactory(
-                    AwsDoc::CrossService::HTTPReceiver &httpReceiver) :
-                    mHttpReceiver(httpReceiver) {}
+            MyRequestHandlerFactory(AwsDoc::CrossService::HTTPReceiver &httpReceiver,
+                                    std::streamsize maxRequestBytes) :
+                    mHttpReceiver(httpReceiver), mMaxRequestBytes(maxRequestBytes) {}
 
-            virtual Poco::Net::HTTPRequestHandler *
-            createRequestHandler(const Poco::Net::HTTPServerRequest &) {
-                return new MyRequestHandler(mHttpReceiver);
+            Poco::Net::HTTPRequestHandler *
+            createRequestHandler(const Poco::Net::HTTPServerRequest &) override {
+                return new MyRequestHandler(mHttpReceiver, mMaxRequestBytes);
             }
 
         private:
             AwsDoc::CrossService::HTTPReceiver &mHttpReceiver;
+            const std::streamsize mMaxRequestBytes;
         };
     }  // namespace PocoImpl
 } // namespace AwsDoc
 
 
 AwsDoc::PocoImpl::PocoHTTPServer::PocoHTTPServer(
-        AwsDoc::CrossService::HTTPReceiver &httpReceiver) :
-        mHttpReceiver(httpReceiver) {
+        AwsDoc::CrossService::HTTPReceiver &httpReceiver,
+        const Options &options) :
+        mHttpReceiver(httpReceiver), mOptions(options) {
 }
 
 int AwsDoc::PocoImpl::PocoHTTPServer::main(const std::vector<std::string> &) {
+    Poco::Net::HTTPServerParams *params = new Poco::Net::HTTPServerParams;
+    params->setMaxThreads(mOptions.mMaxThreads);
+    params->setMaxQueued(mOptions.mMaxQueued);
+    params->setKeepAlive(mOptions.mKeepAlive);
+    params->setMaxKeepAliveRequests(mOptions.mMaxKeepAliveRequests);
+    params->setKeepAliveTimeout(
+            Poco::Timespan(static_cast<long>(mOptions.mKeepAliveTimeout.count()), 0));
+    params->setTimeout(Poco::Timespan(static_cast<long>(mOptions.mTimeout.count()), 0));
+
+    // The default thread pool holds 16 threads, so the server has its own pool
+    // with room for the maximum threads.
+    Poco::ThreadPool threadPool(std::min(2, mOptions.mMaxThreads), mOptions.mMaxThreads);
+
     Poco::Net::HTTPServer pocoHTTPServer(
-            new MyRequestHandlerFactory(mHttpReceiver),
-            Poco::Net::ServerSocket(8080),
-            new Poco::Net::HTTPServerParams);
+            new MyRequestHandlerFactory(mHttpReceiver, mOptions.mMaxRequestBytes),
+            threadPool,
+            Poco::Net::ServerSocket(mOptions.mPort, mOptions.mMaxQueued),
+            params);
 
     pocoHTTPServer.start();
     std::cout << "\nPoco HTTP server started" << std::endl;
@@ -14,10 +14,30 @@
 #define SERVERLESSAURORA_POCOHTTPSERVER_H
 
 #include <Poco/Util/ServerApplication.h>
+#include <chrono>
+#include <ios>
 #include "HTTPReceiver.h"
 
 namespace AwsDoc {
     namespace PocoImpl {
+        // Options for PocoHTTPServer.
+        struct PocoHTTPServerOptions {
+            unsigned short mPort = 8080;
+            // The threads which handle connections.
+            int mMaxThreads = 16;
+            // Connections which wait for a thread before new connections are refused.
+            int mMaxQueued = 64;
+            bool mKeepAlive = true;
+            // Requests on one connection before it is closed, or 0 for no limit.
+            int mMaxKeepAliveRequests = 0;
+            // The time an idle keep-alive connection is held open.
+            std::chrono::seconds mKeepAliveTimeout = std::chrono::seconds(10);
+            // The time allowed to receive a request.
+            std::chrono::seconds mTimeout = std::chrono::seconds(60);
+            // The largest request body accepted.
+            std::streamsize mMaxRequestBytes = 1024 * 1024;
+        };
+
         /**
           *  PocoHTTPServer
           *
@@ -29,17 +49,22 @@ namespace AwsDoc {
           */
         class PocoHTTPServer : public Poco::Util::ServerApplication {
         public:
+            typedef PocoHTTPServerOptions Options;
+
             //! PocoHTTPServer constructor.
             /*!
              \sa PocoHTTPServer::PocoHTTPServer()
              \param httpReceiver: Handler for HTTP requests.
+             \param options: Server options.
              */
-            explicit PocoHTTPServer(AwsDoc::CrossService::HTTPReceiver &httpReceiver);
+            explicit PocoHTTPServer(AwsDoc::CrossService::HTTPReceiver &httpReceiver,
+                                    const Options &options = Options());
 
         protected:
             int main(const std::vector<std::string> &) override;
 
             AwsDoc::CrossService::HTTPReceiver &mHttpReceiver;
+            const Options mOptions;
         };
     }  // namespace PocoImpl
 } // namespace AwsDoc
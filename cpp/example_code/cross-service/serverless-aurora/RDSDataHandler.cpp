@@ -12,11 +12,17 @@
 
 #include "RDSDataHandler.h"
 #include <aws/rds-data/RDSDataServiceClient.h>
+#include <aws/rds-data/model/BatchExecuteStatementRequest.h>
+#include <aws/rds-data/model/BeginTransactionRequest.h>
+#include <aws/rds-data/model/CommitTransactionRequest.h>
 #include <aws/rds-data/model/ExecuteStatementRequest.h>
+#include <aws/rds-data/model/RollbackTransactionRequest.h>
 #include <aws/rds/RDSClient.h>
 #include <aws/core/utils/UUID.h>
 #include <aws/core/utils/Document.h>
+#include <algorithm>
 #include <array>
+#include <iterator>
 
 /**
  *  RDSDataHandler
@@ -33,32 +39,246 @@ namespace AwsDoc {
           *  Constants for database column names.
           *
           */
-        static const Aws::String ID_COLUMN("iditem");
-        static const Aws::String NAME_COLUMN("username");
-        static const Aws::String DESCRIPTION_COLUMN("description");
-        static const Aws::String GUIDE_COLUMN("guide");
-        static const Aws::String STATUS_COLUMN("status");
-        static const Aws::String ARCHIVED_COLUMN("archived");
-
-        //! Utility routine to get index of string in vector of strings.
+        static constexpr char ID_COLUMN[] = "iditem";
+        static constexpr char NAME_COLUMN[] = "username";
+        static constexpr char DESCRIPTION_COLUMN[] = "description";
+        static constexpr char GUIDE_COLUMN[] = "guide";
+        static constexpr char STATUS_COLUMN[] = "status";
+        static constexpr char ARCHIVED_COLUMN[] = "archived";
+
+        // The work item columns, in the order used by the SQL statements. A SELECT
+        // statement lists the columns in this order, so the position of each
+        // column in a record is known at compile time.
+        static constexpr const char *COLUMNS[] = {ID_COLUMN, NAME_COLUMN,
+                                                  DESCRIPTION_COLUMN,
+                                                  GUIDE_COLUMN, STATUS_COLUMN,
+                                                  ARCHIVED_COLUMN};
+        static constexpr size_t COLUMN_COUNT = sizeof(COLUMNS) / sizeof(COLUMNS[0]);
+
+        // The parameter for the LIMIT clause of a paged SELECT statement.
+        static constexpr char PAGE_SIZE_PARAMETER[] = "pagesize";
+
+        //! Utility routine to compare two strings at compile time.
         /*!
-         \sa getIndexOf()
-         \param vector: Vector of strings.
-         \param string: Search string.
-         \return size_t: Index of string or zero.
+         \sa sameName()
+         \param name1: First string.
+         \param name2: Second string.
+         \return bool: True if the strings are equal.
          */
-        static size_t getIndexOf(std::vector<Aws::String> vector,
-                                 const Aws::String &string) {
-            auto it = find(vector.begin(), vector.end(), string);
-            size_t result = 0;
-            if (it != vector.end()) {
-                result = it - vector.begin();
+        static constexpr bool sameName(const char *name1, const char *name2) {
+            return *name1 == *name2 && (*name1 == '\0' || sameName(name1 + 1, name2 + 1));
+        }
+
+        //! Utility routine to get the index of a column in COLUMNS at compile time.
+        /*!
+         \sa columnIndex()
+         \param column: Column name.
+         \param index: Index at which to start searching.
+         \return size_t: Index of the column, or COLUMN_COUNT if not found.
+         */
+        static constexpr size_t columnIndex(const char *column, size_t index = 0) {
+            return index == COLUMN_COUNT ? COLUMN_COUNT :
+                   sameName(COLUMNS[index], column) ? index :
+                   columnIndex(column, index + 1);
+        }
+
+        static constexpr size_t ID_INDEX = columnIndex(ID_COLUMN);
+        static constexpr size_t NAME_INDEX = columnIndex(NAME_COLUMN);
+        static constexpr size_t DESCRIPTION_INDEX = columnIndex(DESCRIPTION_COLUMN);
+        static constexpr size_t GUIDE_INDEX = columnIndex(GUIDE_COLUMN);
+        static constexpr size_t STATUS_INDEX = columnIndex(STATUS_COLUMN);
+        static constexpr size_t ARCHIVED_INDEX = columnIndex(ARCHIVED_COLUMN);
+
+        static_assert(ID_INDEX == 0, "The ID column must be first in COLUMNS.");
+        static_assert(NAME_INDEX < COLUMN_COUNT && DESCRIPTION_INDEX < COLUMN_COUNT &&
+                      GUIDE_INDEX < COLUMN_COUNT && STATUS_INDEX < COLUMN_COUNT &&
+                      ARCHIVED_INDEX < COLUMN_COUNT,
+                      "Every work item column must be in COLUMNS.");
+
+        //! Utility routine to decode a record of the work item columns.
+        /*!
+         \sa recordToWorkItem()
+         \param record: Record with the fields in COLUMNS order.
+         \param workItem: Work item struct to receive the fields.
+         \return bool: Successful completion.
+         */
+        static bool recordToWorkItem(
+                const std::vector<Aws::RDSDataService::Model::Field> &record,
+                WorkItem &workItem) {
+            if (record.size() < COLUMN_COUNT) {
+                std::cerr << "recordToWorkItem Error: record has " << record.size()
+                          << " fields." << std::endl;
+                return false;
             }
-            else {
-                std::cerr << "getIndexOf Error '" << string <<
-                          "' not found." << std::endl;
+
+            workItem.mID = record[ID_INDEX].GetStringValue();
+            workItem.mName = record[NAME_INDEX].GetStringValue();
+            workItem.mDescription = record[DESCRIPTION_INDEX].GetStringValue();
+            workItem.mGuide = record[GUIDE_INDEX].GetStringValue();
+            workItem.mStatus = record[STATUS_INDEX].GetStringValue();
+            workItem.mArchived = record[ARCHIVED_INDEX].GetLongValue() > 0;
+            return true;
+        }
+
+        //! Utility routine to create an INSERT statement for the work item columns.
+        /*!
+         \sa insertStatement()
+         \param tableName: Table name.
+         \return Aws::String: SQL statement with a named parameter for each column.
+         */
+        static Aws::String insertStatement(const Aws::String &tableName) {
+            std::stringstream sqlStream;
+            sqlStream << "INSERT INTO " << tableName << " (";
+            for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+                sqlStream << COLUMNS[i];
+                if (i < COLUMN_COUNT - 1) {
+                    sqlStream << ", ";
+                }
+            }
+            sqlStream << ") VALUES (";
+            for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+                sqlStream << ":" << COLUMNS[i];
+                if (i < COLUMN_COUNT - 1) {
+                    sqlStream << ", ";
+                }
             }
-            return result;
+            sqlStream << ")";
+
+            return sqlStream.str();
+        }
+
+        //! Utility routine to create an UPDATE statement for the work item columns.
+        /*!
+         \sa updateStatement()
+         \param tableName: Table name.
+         \return Aws::String: SQL statement with a named parameter for each column.
+         */
+        static Aws::String updateStatement(const Aws::String &tableName) {
+            std::stringstream sqlStream;
+            sqlStream << "UPDATE " << tableName << " SET ";
+            // Skip the ID column, which selects the row.
+            for (size_t i = 1; i < COLUMN_COUNT; ++i) {
+                sqlStream << COLUMNS[i] << "=:" << COLUMNS[i];
+                if (i < COLUMN_COUNT - 1) {
+                    sqlStream << ", ";
+                }
+            }
+            sqlStream << " WHERE " << ID_COLUMN << "=:" << ID_COLUMN;
+
+            return sqlStream.str();
+        }
+
+        //! Utility routine to create a SELECT statement which returns one page of work
+        //! items, ordered by ID.
+        /*!
+         \sa selectPageStatement()
+         \param tableName: Table name.
+         \param filterArchived: If true, compare the archived column with a parameter.
+         \return Aws::String: SQL statement.
+         */
+        static Aws::String selectPageStatement(const Aws::String &tableName,
+                                               bool filterArchived) {
+            std::stringstream sqlStream;
+            sqlStream << "SELECT ";
+            for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+                sqlStream << COLUMNS[i];
+                if (i < COLUMN_COUNT - 1) {
+                    sqlStream << ", ";
+                }
+            }
+            // Keyset pagination: each page starts after the last ID of the previous
+            // page, so a page is found with the primary key index, unlike OFFSET.
+            sqlStream << " FROM " << tableName << " WHERE ";
+            if (filterArchived) {
+                sqlStream << ARCHIVED_COLUMN << " = :" << ARCHIVED_COLUMN << " AND ";
+            }
+            sqlStream << ID_COLUMN << " > :" << ID_COLUMN
+                      << " ORDER BY " << ID_COLUMN << " LIMIT :" << PAGE_SIZE_PARAMETER;
+
+            return sqlStream.str();
+        }
+
+        //! Utility routine to create a SELECT statement for the work item columns.
+        /*!
+         \sa selectStatement()
+         \param tableName: Table name.
+         \param whereColumn: Column compared with a named parameter, or empty.
+         \return Aws::String: SQL statement.
+         */
+        static Aws::String selectStatement(const Aws::String &tableName,
+                                           const Aws::String &whereColumn) {
+            std::stringstream sqlStream;
+            sqlStream << "SELECT ";
+            for (size_t i = 0; i < COLUMN_COUNT; ++i) {
+                sqlStream << COLUMNS[i];
+                if (i < COLUMN_COUNT - 1) {
+                    sqlStream << ", ";
+                }
+            }
+            sqlStream << " FROM " << tableName;
+            if (!whereColumn.empty()) {
+                sqlStream << " WHERE " << whereColumn << " = :" << whereColumn;
+            }
+
+            return sqlStream.str();
+        }
+
+        //! Utility routine to create a string SQL parameter.
+        /*!
+         \sa stringParameter()
+         \param name: Parameter name.
+         \param value: Parameter value.
+         \return SqlParameter: The parameter.
+         */
+        static Aws::RDSDataService::Model::SqlParameter
+        stringParameter(const Aws::String &name, const Aws::String &value) {
+            Aws::RDSDataService::Model::Field field;
+            field.SetStringValue(value);
+
+            Aws::RDSDataService::Model::SqlParameter parameter;
+            parameter.SetName(name);
+            parameter.SetValue(field);
+            return parameter;
+        }
+
+        //! Utility routine to create an integer SQL parameter.
+        /*!
+         \sa longParameter()
+         \param name: Parameter name.
+         \param value: Parameter value.
+         \return SqlParameter: The parameter.
+         */
+        static Aws::RDSDataService::Model::SqlParameter
+        longParameter(const Aws::String &name, long long value) {
+            Aws::RDSDataService::Model::Field field;
+            field.SetLongValue(value);
+
+            Aws::RDSDataService::Model::SqlParameter parameter;
+            parameter.SetName(name);
+            parameter.SetValue(field);
+            return parameter;
+        }
+
+        //! Utility routine to create the parameters for every work item column.
+        /*!
+         \sa workItemParameters()
+         \param workItem: Work item struct.
+         \param id: ID of work item.
+         \return std::vector<SqlParameter>: The parameters.
+         */
+        static std::vector<Aws::RDSDataService::Model::SqlParameter>
+        workItemParameters(const WorkItem &workItem, const Aws::String &id) {
+            std::vector<Aws::RDSDataService::Model::SqlParameter> parameters;
+            parameters.reserve(COLUMN_COUNT);
+            parameters.push_back(stringParameter(ID_COLUMN, id));
+            parameters.push_back(stringParameter(NAME_COLUMN, workItem.mName));
+            parameters.push_back(
+                    stringParameter(DESCRIPTION_COLUMN, workItem.mDescription));
+            parameters.push_back(stringParameter(GUIDE_COLUMN, workItem.mGuide));
+            parameters.push_back(stringParameter(STATUS_COLUMN, workItem.mStatus));
+            parameters.push_back(
+                    longParameter(ARCHIVED_COLUMN, workItem.mArchived ? 1 : 0));
+            return parameters;
         }
     }  // namespace CrossService
 } // namespace AwsDoc
@@ -82,7 +302,16 @@ AwsDoc::CrossService::RDSDataHandler::RDSDataHandler(const Aws::String &database
         mResourceArn(resourceArn),
         mSecretArn(secretArn),
         mTableName(tableName),
-        mClientConfiguration(clientConfiguration) {
+        mClient(clientConfiguration),
+        mInsertSql(insertStatement(tableName)),
+        mUpdateSql(updateStatement(tableName)),
+        mArchiveSql("UPDATE " + tableName + " SET " + ARCHIVED_COLUMN + "=1 WHERE " +
+                    ID_COLUMN + "=:" + ID_COLUMN),
+        mSelectSql(selectStatement(tableName, "")),
+        mSelectWithArchivedSql(selectStatement(tableName, ARCHIVED_COLUMN)),
+        mSelectWithIdSql(selectStatement(tableName, ID_COLUMN)),
+        mSelectPageSql(selectPageStatement(tableName, false)),
+        mSelectPageWithArchivedSql(selectPageStatement(tableName, true)) {
 }
 
 //! Routine which executes a statement on an Amazon RDS database.
@@ -90,13 +319,13 @@ AwsDoc::CrossService::RDSDataHandler::RDSDataHandler(const Aws::String &database
  \sa RDSDataHandler::executeStatement()
  \param sqlStatement: Sql statement as string.
  \param parameters: Vector of sql parameters.
+ \param transactionId: A transaction to run in, or empty.
  \return ExecuteStatementOutcome: Execute statement outcome.
  */
 Aws::RDSDataService::Model::ExecuteStatementOutcome
 AwsDoc::CrossService::RDSDataHandler::executeStatement(const Aws::String &sqlStatement,
-                                                       std::vector<Aws::RDSDataService::Model::SqlParameter> parameters) {
-    Aws::RDSDataService::RDSDataServiceClient client(mClientConfiguration);
-
+                                                       const std::vector<Aws::RDSDataService::Model::SqlParameter> &parameters,
+                                                       const Aws::String &transactionId) {
     Aws::RDSDataService::Model::ExecuteStatementRequest request;
     request.SetDatabase(mDatabase);
     request.SetSecretArn(mSecretArn);
@@ -108,76 +337,166 @@ AwsDoc::CrossService::RDSDataHandler::executeStatement(const Aws::String &sqlSta
         request.SetParameters(parameters);
     }
 
-    return client.ExecuteStatement(request);
+    if (!transactionId.empty()) {
+        request.SetTransactionId(transactionId);
+    }
+
+    return mClient.ExecuteStatement(request);
 }
 
-//! Routine which adds one work item.
+//! Routine which executes a statement once for each parameter set, with
+//! BatchExecuteStatement requests of up to MAX_BATCH_PARAMETER_SETS sets.
 /*!
- \sa RDSDataHandler::addWorkItem()
- \param workItem: Work item struct.
+ \sa RDSDataHandler::batchExecuteStatement()
+ \param sqlStatement: Sql statement as string.
+ \param parameterSets: Vector of parameter sets.
+ \param transactionId: A transaction to run in. If empty, and more than one
+                       request is needed, the requests run in a new transaction.
  \return bool: Successful completion.
  */
-bool AwsDoc::CrossService::RDSDataHandler::addWorkItem(
-        const AwsDoc::CrossService::WorkItem &workItem) {
-    std::vector<Aws::String> COLUMNS = {ID_COLUMN, NAME_COLUMN,
-                                              DESCRIPTION_COLUMN,
-                                              GUIDE_COLUMN, STATUS_COLUMN,
-                                              ARCHIVED_COLUMN};
+bool AwsDoc::CrossService::RDSDataHandler::batchExecuteStatement(
+        const Aws::String &sqlStatement,
+        std::vector<std::vector<Aws::RDSDataService::Model::SqlParameter>> parameterSets,
+        const Aws::String &transactionId) {
+    Aws::String requestTransactionId(transactionId);
+    bool ownTransaction = false;
+    if (requestTransactionId.empty() &&
+        parameterSets.size() > MAX_BATCH_PARAMETER_SETS) {
+        // Either all the batches are applied or none of them are.
+        if (!beginTransaction(requestTransactionId)) {
+            return false;
+        }
+        ownTransaction = true;
+    }
 
-    // Create a sql statement.
-    std::stringstream sqlStream;
-    sqlStream << "INSERT INTO " << mTableName << " (";
-    for (size_t i = 0; i < COLUMNS.size(); ++i) {
-        sqlStream << COLUMNS[i];
-        if (i < COLUMNS.size() - 1) {
-            sqlStream << ", ";
+    bool result = true;
+    for (size_t start = 0; result && start < parameterSets.size();
+         start += MAX_BATCH_PARAMETER_SETS) {
+        size_t end = std::min(parameterSets.size(),
+                              start + size_t(MAX_BATCH_PARAMETER_SETS));
+
+        Aws::RDSDataService::Model::BatchExecuteStatementRequest request;
+        request.SetDatabase(mDatabase);
+        request.SetSecretArn(mSecretArn);
+        request.SetResourceArn(mResourceArn);
+        request.SetSql(sqlStatement);
+        request.SetParameterSets(
+                std::vector<std::vector<Aws::RDSDataService::Model::SqlParameter>>(
+                        std::make_move_iterator(parameterSets.begin() + start),
+                        std::make_move_iterator(parameterSets.begin() + end)));
+
+        if (!requestTransactionId.empty()) {
+            request.SetTransactionId(requestTransactionId);
+        }
+
+        Aws::RDSDataService::Model::BatchExecuteStatementOutcome outcome =
+                mClient.BatchExecuteStatement(request);
+
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Error with RDSDataService::BatchExecuteStatement. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            result = false;
         }
     }
-    sqlStream << ") VALUES (";
-    for (size_t i = 0; i < COLUMNS.size(); ++i) {
-        sqlStream << ":" << COLUMNS[i];
-        if (i < COLUMNS.size() - 1) {
-            sqlStream << ", ";
+
+    if (ownTransaction) {
+        if (result) {
+            result = commitTransaction(requestTransactionId);
+        }
+        else {
+            rollbackTransaction(requestTransactionId);
         }
     }
-    sqlStream << ")";
 
-    // Create a parameters vector and set the paramaters.
-    std::string idItem = Aws::Utils::UUID::RandomUUID();
+    return result;
+}
+
+//! Routine which starts a transaction.
+/*!
+ \sa RDSDataHandler::beginTransaction()
+ \param transactionId: String to receive the transaction ID.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::RDSDataHandler::beginTransaction(Aws::String &transactionId) {
+    Aws::RDSDataService::Model::BeginTransactionRequest request;
+    request.SetDatabase(mDatabase);
+    request.SetSecretArn(mSecretArn);
+    request.SetResourceArn(mResourceArn);
+
+    Aws::RDSDataService::Model::BeginTransactionOutcome outcome =
+            mClient.BeginTransaction(request);
 
-    // Add strings to parameters.
-    std::vector<std::string> parameterNames =
-            {ID_COLUMN, NAME_COLUMN, DESCRIPTION_COLUMN, GUIDE_COLUMN, STATUS_COLUMN};
-    std::vector<std::string> parameterValues =
-            {idItem, workItem.mName, workItem.mDescription, workItem.mGuide,
-             workItem.mStatus};
+    if (outcome.IsSuccess()) {
+        transactionId = outcome.GetResult().GetTransactionId();
+    }
+    else {
+        std::cerr << "Error with RDSDataService::BeginTransaction. "
+                  << outcome.GetError().GetMessage() << std::endl;
+    }
 
-    std::vector<Aws::RDSDataService::Model::SqlParameter> parameters;
-    for (size_t i = 0; i < parameterNames.size(); ++i) {
-        Aws::RDSDataService::Model::SqlParameter parameter;
+    return outcome.IsSuccess();
+}
 
-        parameter.SetName(parameterNames[i]);
+//! Routine which commits a transaction.
+/*!
+ \sa RDSDataHandler::commitTransaction()
+ \param transactionId: The transaction ID.
+ \return bool: Successful completion.
+ */
+bool
+AwsDoc::CrossService::RDSDataHandler::commitTransaction(const Aws::String &transactionId) {
+    Aws::RDSDataService::Model::CommitTransactionRequest request;
+    request.SetSecretArn(mSecretArn);
+    request.SetResourceArn(mResourceArn);
+    request.SetTransactionId(transactionId);
 
-        Aws::RDSDataService::Model::Field field;
-        field.SetStringValue(parameterValues[i]);
-        parameter.SetValue(field);
+    Aws::RDSDataService::Model::CommitTransactionOutcome outcome =
+            mClient.CommitTransaction(request);
 
-        parameters.push_back(parameter);
+    if (!outcome.IsSuccess()) {
+        std::cerr << "Error with RDSDataService::CommitTransaction. "
+                  << outcome.GetError().GetMessage() << std::endl;
     }
 
-    // Add 'archived' Boolean to parameters.
-    Aws::RDSDataService::Model::SqlParameter parameter;
+    return outcome.IsSuccess();
+}
+
+//! Routine which rolls back a transaction.
+/*!
+ \sa RDSDataHandler::rollbackTransaction()
+ \param transactionId: The transaction ID.
+ \return bool: Successful completion.
+ */
+bool
+AwsDoc::CrossService::RDSDataHandler::rollbackTransaction(const Aws::String &transactionId) {
+    Aws::RDSDataService::Model::RollbackTransactionRequest request;
+    request.SetSecretArn(mSecretArn);
+    request.SetResourceArn(mResourceArn);
+    request.SetTransactionId(transactionId);
+
+    Aws::RDSDataService::Model::RollbackTransactionOutcome outcome =
+            mClient.RollbackTransaction(request);
 
-    parameter.SetName(ARCHIVED_COLUMN);
+    if (!outcome.IsSuccess()) {
+        std::cerr << "Error with RDSDataService::RollbackTransaction. "
+                  << outcome.GetError().GetMessage() << std::endl;
+    }
 
-    Aws::RDSDataService::Model::Field field;
-    field.SetLongValue(0);
-    parameter.SetValue(field);
+    return outcome.IsSuccess();
+}
 
-    parameters.push_back(parameter);
+//! Routine which adds one work item.
+/*!
+ \sa RDSDataHandler::addWorkItem()
+ \param workItem: Work item struct.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::RDSDataHandler::addWorkItem(
+        const AwsDoc::CrossService::WorkItem &workItem) {
+    Aws::String idItem = Aws::Utils::UUID::RandomUUID();
 
     Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
-            executeStatement(sqlStream.str(), parameters);
+            executeStatement(mInsertSql, workItemParameters(workItem, idItem));
 
     if (outcome.IsSuccess()) {
         std::cout << "Successfully inserted '" << workItem.mName << "' into the table"
@@ -191,6 +510,44 @@ bool AwsDoc::CrossService::RDSDataHandler::addWorkItem(
     return outcome.IsSuccess();
 }
 
+//! Routine which adds work items with BatchExecuteStatement.
+/*!
+ \sa RDSDataHandler::addWorkItems()
+ \param workItems: Vector of work items.
+ \param ids: Vector to receive the IDs of the added work items.
+ \param transactionId: A transaction to run in. If empty, a request
+                       which spans several batches runs in its own transaction.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::RDSDataHandler::addWorkItems(
+        const std::vector<WorkItem> &workItems,
+        std::vector<Aws::String> &ids,
+        const Aws::String &transactionId) {
+    std::vector<Aws::String> newIds;
+    newIds.reserve(workItems.size());
+    std::vector<std::vector<Aws::RDSDataService::Model::SqlParameter>> parameterSets;
+    parameterSets.reserve(workItems.size());
+    for (const WorkItem &workItem: workItems) {
+        newIds.push_back(Aws::Utils::UUID::RandomUUID());
+        parameterSets.push_back(workItemParameters(workItem, newIds.back()));
+    }
+
+    bool result = batchExecuteStatement(mInsertSql, std::move(parameterSets),
+                                        transactionId);
+
+    if (result) {
+        ids.insert(ids.end(), newIds.begin(), newIds.end());
+        std::cout << "Successfully inserted " << workItems.size()
+                  << " work items into the table" << std::endl;
+    }
+    else {
+        std::cerr << "Error inserting " << workItems.size()
+                  << " work items into the table" << std::endl;
+    }
+
+    return result;
+}
+
 //! Routine which retrieves a list of work items.
 /*!
  \sa RDSDataHandler::getWorkItems()
@@ -201,32 +558,17 @@ bool AwsDoc::CrossService::RDSDataHandler::addWorkItem(
 bool
 AwsDoc::CrossService::RDSDataHandler::getWorkItems(WorkItemStatus status,
                                                    std::vector<WorkItem> &workItems) {
-    std::vector<Aws::String> COLUMNS = {ID_COLUMN, NAME_COLUMN,
-                                              DESCRIPTION_COLUMN,
-                                              GUIDE_COLUMN, STATUS_COLUMN,
-                                              ARCHIVED_COLUMN};
-
-    // Create a sql statement.
-    std::stringstream sqlStream;
-    sqlStream << "SELECT ";
-    for (size_t i = 0; i < COLUMNS.size(); ++i) {
-        sqlStream << COLUMNS[i];
-        if (i < COLUMNS.size() - 1) {
-            sqlStream << ", ";
-        }
+    Aws::RDSDataService::Model::ExecuteStatementOutcome outcome;
+    if (status == WorkItemStatus::BOTH) {
+        outcome = executeStatement(mSelectSql);
     }
-    sqlStream << " FROM " << mTableName;
-
-    if (status == WorkItemStatus::ARCHIVED) {
-        sqlStream << " WHERE " << ARCHIVED_COLUMN << " = 1";
-    }
-    else if (status == WorkItemStatus::NOT_ARCHIVED) {
-        sqlStream << " WHERE " << ARCHIVED_COLUMN << " = 0";
+    else {
+        std::vector<Aws::RDSDataService::Model::SqlParameter> parameters = {
+                longParameter(ARCHIVED_COLUMN,
+                              status == WorkItemStatus::ARCHIVED ? 1 : 0)};
+        outcome = executeStatement(mSelectWithArchivedSql, parameters);
     }
 
-    Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
-            executeStatement(sqlStream.str());
-
     if (outcome.IsSuccess()) {
         const std::vector<std::vector<Aws::RDSDataService::Model::Field>> &records =
                 outcome.GetResult().GetRecords();
@@ -245,17 +587,12 @@ AwsDoc::CrossService::RDSDataHandler::getWorkItems(WorkItemStatus status,
         }
         std::cout << std::endl;
 
+        workItems.reserve(workItems.size() + records.size());
         for (const std::vector<Aws::RDSDataService::Model::Field> &record: records) {
             WorkItem item;
-            item.mID = record[getIndexOf(COLUMNS, ID_COLUMN)].GetStringValue();
-            item.mName = record[getIndexOf(COLUMNS, NAME_COLUMN)].GetStringValue();
-            item.mDescription = record[getIndexOf(COLUMNS,
-                                                  DESCRIPTION_COLUMN)].GetStringValue();
-            item.mGuide = record[getIndexOf(COLUMNS, GUIDE_COLUMN)].GetStringValue();
-            item.mStatus = record[getIndexOf(COLUMNS, STATUS_COLUMN)].GetStringValue();
-            item.mArchived =
-                    record[getIndexOf(COLUMNS, ARCHIVED_COLUMN)].GetLongValue() > 0;
-            workItems.push_back(item);
+            if (recordToWorkItem(record, item)) {
+                workItems.push_back(std::move(item));
+            }
         }
     }
     else {
@@ -266,33 +603,83 @@ AwsDoc::CrossService::RDSDataHandler::getWorkItems(WorkItemStatus status,
     return outcome.IsSuccess();
 }
 
-//! Routine which updates a work item, setting it as archived.
+//! Routine which retrieves work items one page at a time, and passes each work
+//! item to a handler.
 /*!
- \sa RDSDataHandler::setWorkItemToArchive()
- \param id: ID of work item.
+ \sa RDSDataHandler::streamWorkItems()
+ \param status: Filter for work item status.
+ \param pageSize: Number of work items retrieved with each statement.
+ \param handler: Called for each work item, in ID order.
  \return bool: Successful completion.
  */
-bool AwsDoc::CrossService::RDSDataHandler::setWorkItemToArchive(const Aws::String &id) {
-    // Create a sql statement.
-    std::stringstream sqlStream;
-    sqlStream << "UPDATE " << mTableName << " SET " << ARCHIVED_COLUMN << "=:"
-              << ARCHIVED_COLUMN << " WHERE " << ID_COLUMN << "='" << id << "';";
+bool AwsDoc::CrossService::RDSDataHandler::streamWorkItems(WorkItemStatus status,
+                                                           size_t pageSize,
+                                                           const WorkItemHandler &handler) {
+    if (pageSize == 0) {
+        std::cerr << "Error with RDSDataHandler::streamWorkItems. The page size is 0."
+                  << std::endl;
+        return false;
+    }
 
     std::vector<Aws::RDSDataService::Model::SqlParameter> parameters;
+    parameters.push_back(stringParameter(ID_COLUMN, ""));
+    parameters.push_back(longParameter(PAGE_SIZE_PARAMETER,
+                                       static_cast<long long>(pageSize)));
+    if (status != WorkItemStatus::BOTH) {
+        parameters.push_back(longParameter(ARCHIVED_COLUMN,
+                                           status == WorkItemStatus::ARCHIVED ? 1 : 0));
+    }
+    const Aws::String &sqlStatement = status == WorkItemStatus::BOTH ? mSelectPageSql :
+                                      mSelectPageWithArchivedSql;
+
+    size_t itemCount = 0;
+    WorkItem item;
+    while (true) {
+        Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
+                executeStatement(sqlStatement, parameters);
+
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Error retrieving workItems.\n"
+                      << "Error: " << outcome.GetError().GetMessage() << std::endl;
+            return false;
+        }
 
-    // Add 'archived' Boolean to parameters.
-    Aws::RDSDataService::Model::SqlParameter parameter;
+        const std::vector<std::vector<Aws::RDSDataService::Model::Field>> &records =
+                outcome.GetResult().GetRecords();
 
-    parameter.SetName(ARCHIVED_COLUMN);
+        for (const std::vector<Aws::RDSDataService::Model::Field> &record: records) {
+            if (recordToWorkItem(record, item)) {
+                handler(item);
+            }
+        }
+        itemCount += records.size();
 
-    Aws::RDSDataService::Model::Field field;
-    field.SetLongValue(1);
-    parameter.SetValue(field);
+        if (records.size() < pageSize || records.back().empty()) {
+            break;
+        }
+
+        // The next page starts after the last ID of this page.
+        parameters[0] = stringParameter(ID_COLUMN,
+                                        records.back()[ID_INDEX].GetStringValue());
+    }
 
-    parameters.push_back(parameter);
+    std::cout << itemCount << " items streamed." << std::endl;
+
+    return true;
+}
+
+//! Routine which updates a work item, setting it as archived.
+/*!
+ \sa RDSDataHandler::setWorkItemToArchive()
+ \param id: ID of work item.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::RDSDataHandler::setWorkItemToArchive(const Aws::String &id) {
+    std::vector<Aws::RDSDataService::Model::SqlParameter> parameters = {
+            stringParameter(ID_COLUMN, id)};
 
     Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
-            executeStatement(sqlStream.str(), parameters);
+            executeStatement(mArchiveSql, parameters);
 
     if (outcome.IsSuccess()) {
         std::cout << "Successfully updated work item with id '" << id
@@ -315,55 +702,8 @@ bool AwsDoc::CrossService::RDSDataHandler::setWorkItemToArchive(const Aws::Strin
  */
 bool AwsDoc::CrossService::RDSDataHandler::updateWorkItem(
         const AwsDoc::CrossService::WorkItem &workItem) {
-    std::vector<Aws::String> COLUMNS = {NAME_COLUMN,
-                                              DESCRIPTION_COLUMN,
-                                              GUIDE_COLUMN, STATUS_COLUMN,
-                                              ARCHIVED_COLUMN};
-
-    // Create a sql statement.
-    std::stringstream sqlStream;
-    sqlStream << "UPDATE " << mTableName << " SET ";
-    for (size_t i = 0; i < COLUMNS.size(); ++i) {
-        sqlStream << COLUMNS[i] << "=:" << COLUMNS[i];
-        if (i < COLUMNS.size() - 1) {
-            sqlStream << ", ";
-        }
-    }
-    sqlStream << " WHERE " << ID_COLUMN << "='" << workItem.mID << "';";
-
-    // Add strings to parameters.
-    std::vector<std::string> parameterNames =
-            {NAME_COLUMN, DESCRIPTION_COLUMN, GUIDE_COLUMN, STATUS_COLUMN};
-    std::vector<std::string> parameterValues =
-            {workItem.mName, workItem.mDescription, workItem.mGuide,
-             workItem.mStatus};
-
-    std::vector<Aws::RDSDataService::Model::SqlParameter> parameters;
-    for (size_t i = 0; i < parameterNames.size(); ++i) {
-        Aws::RDSDataService::Model::SqlParameter parameter;
-
-        parameter.SetName(parameterNames[i]);
-
-        Aws::RDSDataService::Model::Field field;
-        field.SetStringValue(parameterValues[i]);
-        parameter.SetValue(field);
-
-        parameters.push_back(parameter);
-    }
-
-    // Add 'archived' Boolean to parameters.
-    Aws::RDSDataService::Model::SqlParameter parameter;
-
-    parameter.SetName(ARCHIVED_COLUMN);
-
-    Aws::RDSDataService::Model::Field field;
-    field.SetLongValue(workItem.mArchived ? 1 : 0);
-    parameter.SetValue(field);
-
-    parameters.push_back(parameter);
-
     Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
-            executeStatement(sqlStream.str(), parameters);
+            executeStatement(mUpdateSql, workItemParameters(workItem, workItem.mID));
 
     if (outcome.IsSuccess()) {
         std::cout << "Successfully updated '" << workItem.mName << "' in the table"
@@ -377,6 +717,38 @@ bool AwsDoc::CrossService::RDSDataHandler::updateWorkItem(
     return outcome.IsSuccess();
 }
 
+//! Routine which updates the columns of work items with BatchExecuteStatement.
+/*!
+ \sa RDSDataHandler::updateWorkItems()
+ \param workItems: Vector of work items, identified by their IDs.
+ \param transactionId: A transaction to run in. If empty, a request
+                       which spans several batches runs in its own transaction.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::RDSDataHandler::updateWorkItems(
+        const std::vector<WorkItem> &workItems,
+        const Aws::String &transactionId) {
+    std::vector<std::vector<Aws::RDSDataService::Model::SqlParameter>> parameterSets;
+    parameterSets.reserve(workItems.size());
+    for (const WorkItem &workItem: workItems) {
+        parameterSets.push_back(workItemParameters(workItem, workItem.mID));
+    }
+
+    bool result = batchExecuteStatement(mUpdateSql, std::move(parameterSets),
+                                        transactionId);
+
+    if (result) {
+        std::cout << "Successfully updated " << workItems.size()
+                  << " work items in the table" << std::endl;
+    }
+    else {
+        std::cerr << "Error updating " << workItems.size()
+                  << " work items in the table" << std::endl;
+    }
+
+    return result;
+}
+
 //! Routine which retrieves one work item.
 /*!
  \sa RDSDataHandler::getWorkItemWithId()
@@ -387,24 +759,11 @@ bool AwsDoc::CrossService::RDSDataHandler::updateWorkItem(
 bool
 AwsDoc::CrossService::RDSDataHandler::getWorkItemWithId(const Aws::String &id,
                                                         WorkItem &workItem) {
-    std::vector<Aws::String> COLUMNS = {ID_COLUMN, NAME_COLUMN,
-                                              DESCRIPTION_COLUMN,
-                                              GUIDE_COLUMN, STATUS_COLUMN,
-                                              ARCHIVED_COLUMN};
-    // Create a sql statement.
-    std::stringstream sqlStream;
-    sqlStream << "SELECT ";
-    for (size_t i = 0; i < COLUMNS.size(); ++i) {
-        sqlStream << COLUMNS[i];
-        if (i < COLUMNS.size() - 1) {
-            sqlStream << ", ";
-        }
-    }
-    sqlStream << " FROM " << mTableName
-              << " WHERE " << ID_COLUMN << " = '" << id << "'";
+    std::vector<Aws::RDSDataService::Model::SqlParameter> parameters = {
+            stringParameter(ID_COLUMN, id)};
 
     Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
-            executeStatement(sqlStream.str());
+            executeStatement(mSelectWithIdSql, parameters);
 
     if (outcome.IsSuccess()) {
         const std::vector<std::vector<Aws::RDSDataService::Model::Field>> &records =
@@ -412,17 +771,7 @@ AwsDoc::CrossService::RDSDataHandler::getWorkItemWithId(const Aws::String &id,
 
         std::cout << records.size() << " items retrieved." << std::endl;
         if (records.size() > 0) {
-            const std::vector<Aws::RDSDataService::Model::Field> &record = records[0];
-            workItem.mID = record[getIndexOf(COLUMNS, ID_COLUMN)].GetStringValue();
-            workItem.mName = record[getIndexOf(COLUMNS, NAME_COLUMN)].GetStringValue();
-            workItem.mDescription = record[getIndexOf(COLUMNS,
-                                                      DESCRIPTION_COLUMN)].GetStringValue();
-            workItem.mGuide = record[getIndexOf(COLUMNS,
-                                                GUIDE_COLUMN)].GetStringValue();
-            workItem.mStatus = record[getIndexOf(COLUMNS,
-                                                 STATUS_COLUMN)].GetStringValue();
-            workItem.mArchived =
-                    record[getIndexOf(COLUMNS, ARCHIVED_COLUMN)].GetLongValue() > 0;
+            recordToWorkItem(records[0], workItem);
         }
         else {
             std::cerr << "Error no items retrieved for iD " << id << std::endl;
@@ -512,7 +861,8 @@ bool AwsDoc::CrossService::RDSDataHandler::createTable(const Aws::String &tableN
               << DESCRIPTION_COLUMN << " VARCHAR(400), "
               << GUIDE_COLUMN << " VARCHAR(45), "
               << STATUS_COLUMN << " VARCHAR(400), "
-              << ARCHIVED_COLUMN << "  TINYINT(4));";
+              << ARCHIVED_COLUMN << "  TINYINT(4), "
+              << "PRIMARY KEY (" << ID_COLUMN << "));";
 
     Aws::RDSDataService::Model::ExecuteStatementOutcome outcome =
             executeStatement(sqlStream.str());
@@ -97,6 +97,69 @@ namespace AwsDoc {
             virtual bool getWorkItems(WorkItemStatus status,
                                       std::vector<WorkItem> &workItems) override;
 
+            //! Routine which retrieves work items one page at a time, and passes
+            //! each work item to a handler.
+            /*!
+             \sa RDSDataHandler::streamWorkItems()
+             \param status: Filter for work item status.
+             \param pageSize: Number of work items retrieved with each statement.
+             \param handler: Called for each work item, in ID order.
+             \return bool: Successful completion.
+             */
+            bool streamWorkItems(WorkItemStatus status, size_t pageSize,
+                                 const WorkItemHandler &handler) override;
+
+            //! Routine which adds work items with BatchExecuteStatement.
+            /*!
+             \sa RDSDataHandler::addWorkItems()
+             \param workItems: Vector of work items.
+             \param ids: Vector to receive the IDs of the added work items.
+             \param transactionId: A transaction to run in. If empty, a request
+                                   which spans several batches runs in its own transaction.
+             \return bool: Successful completion.
+             */
+            bool addWorkItems(const std::vector<WorkItem> &workItems,
+                              std::vector<Aws::String> &ids,
+                              const Aws::String &transactionId = "");
+
+            //! Routine which updates the columns of work items with BatchExecuteStatement.
+            /*!
+             \sa RDSDataHandler::updateWorkItems()
+             \param workItems: Vector of work items, identified by their IDs.
+             \param transactionId: A transaction to run in. If empty, a request
+                                   which spans several batches runs in its own transaction.
+             \return bool: Successful completion.
+             */
+            bool updateWorkItems(const std::vector<WorkItem> &workItems,
+                                 const Aws::String &transactionId = "");
+
+            //! Routine which starts a transaction.
+            /*!
+             \sa RDSDataHandler::beginTransaction()
+             \param transactionId: String to receive the transaction ID.
+             \return bool: Successful completion.
+             */
+            bool beginTransaction(Aws::String &transactionId);
+
+            //! Routine which commits a transaction.
+            /*!
+             \sa RDSDataHandler::commitTransaction()
+             \param transactionId: The transaction ID.
+             \return bool: Successful completion.
+             */
+            bool commitTransaction(const Aws::String &transactionId);
+
+            //! Routine which rolls back a transaction.
+            /*!
+             \sa RDSDataHandler::rollbackTransaction()
+             \param transactionId: The transaction ID.
+             \return bool: Successful completion.
+             */
+            bool rollbackTransaction(const Aws::String &transactionId);
+
+            // The parameter sets sent in one BatchExecuteStatement request.
+            static const size_t MAX_BATCH_PARAMETER_SETS = 200;
+
         private:
 
             bool tableExists(const Aws::String &tableName);
@@ -107,14 +170,33 @@ namespace AwsDoc {
 
             Aws::RDSDataService::Model::ExecuteStatementOutcome executeStatement(
                     const Aws::String &sqlStatement,
-                    std::vector<Aws::RDSDataService::Model::SqlParameter> parameters =
-                    std::vector<Aws::RDSDataService::Model::SqlParameter>());
+                    const std::vector<Aws::RDSDataService::Model::SqlParameter> &parameters =
+                    std::vector<Aws::RDSDataService::Model::SqlParameter>(),
+                    const Aws::String &transactionId = "");
+
+            bool batchExecuteStatement(
+                    const Aws::String &sqlStatement,
+                    std::vector<std::vector<Aws::RDSDataService::Model::SqlParameter>> parameterSets,
+                    const Aws::String &transactionId);
 
             Aws::String mDatabase;
             Aws::String mResourceArn;
             Aws::String mSecretArn;
             Aws::String mTableName;
-            Aws::Client::ClientConfiguration mClientConfiguration;
+
+            // The client is thread safe, and it is shared by all statements, so
+            // its connections are reused.
+            Aws::RDSDataService::RDSDataServiceClient mClient;
+
+            // SQL text for each operation, created once with named parameters.
+            const Aws::String mInsertSql;
+            const Aws::String mUpdateSql;
+            const Aws::String mArchiveSql;
+            const Aws::String mSelectSql;
+            const Aws::String mSelectWithArchivedSql;
+            const Aws::String mSelectWithIdSql;
+            const Aws::String mSelectPageSql;
+            const Aws::String mSelectPageWithArchivedSql;
         };
     }  // namespace CrossService
 } // namespace AwsDoc
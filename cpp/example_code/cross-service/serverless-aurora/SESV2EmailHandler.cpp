@@ -13,15 +13,117 @@
  */
 
 #include "SESV2EmailHandler.h"
-#include <aws/sesv2/SESV2Client.h>
 #include <aws/sesv2/model/SendEmailRequest.h>
-#include <aws/core/utils/base64/Base64.h>
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <ctime>
+#include <iostream>
 
 namespace AwsDoc {
     namespace CrossService {
         static const Aws::String MIME_BOUNDARY("--MIME_boundary_2A837DD77556CFB3");
+
+        // Encoded lines in a MIME body are at most 76 characters.
+        static const size_t BASE64_LINE_LENGTH = 76;
+
+        /**
+         *  MimeWriter
+         *
+         *  Writes a raw email message into a buffer. A writer without a buffer only
+         *  counts the bytes, so a message is written twice: once to size its buffer,
+         *  and once into the buffer. The attachment is Base64 encoded as it is
+         *  written, without a copy of the unencoded attachment.
+         *
+         */
+        class MimeWriter {
+        public:
+            explicit MimeWriter(unsigned char *buffer) : mBuffer(buffer) {}
+
+            void write(const char *data, size_t length) {
+                if (mBuffer != nullptr) {
+                    std::memcpy(mBuffer + mLength, data, length);
+                }
+                mLength += length;
+            }
+
+            MimeWriter &operator<<(const Aws::String &text) {
+                write(text.data(), text.size());
+                return *this;
+            }
+
+            MimeWriter &operator<<(const char *text) {
+                write(text, std::strlen(text));
+                return *this;
+            }
+
+            //! Routine which Base64 encodes data. Up to 2 bytes are held until the
+            //! next call or finishBase64.
+            void writeBase64(const char *data, size_t length) {
+                for (size_t i = 0; i < length; ++i) {
+                    mPending[mPendingCount++] = static_cast<unsigned char>(data[i]);
+                    if (mPendingCount == 3) {
+                        writeBase64Group();
+                    }
+                }
+            }
+
+            void writeBase64(const Aws::String &text) {
+                writeBase64(text.data(), text.size());
+            }
+
+            void writeBase64(const char *text) {
+                writeBase64(text, std::strlen(text));
+            }
+
+            //! Routine which writes the held bytes with padding and ends the last line.
+            void finishBase64() {
+                if (mPendingCount > 0) {
+                    writeBase64Group();
+                }
+                if (mLineLength > 0) {
+                    write("\n", 1);
+                    mLineLength = 0;
+                }
+            }
+
+            size_t length() const {
+                return mLength;
+            }
+
+        private:
+            void writeBase64Group() {
+                static const char BASE64_CHARACTERS[] =
+                        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                uint32_t group = static_cast<uint32_t>(mPending[0]) << 16;
+                if (mPendingCount > 1) {
+                    group |= static_cast<uint32_t>(mPending[1]) << 8;
+                }
+                if (mPendingCount > 2) {
+                    group |= mPending[2];
+                }
+
+                char encoded[4];
+                encoded[0] = BASE64_CHARACTERS[(group >> 18) & 0x3f];
+                encoded[1] = BASE64_CHARACTERS[(group >> 12) & 0x3f];
+                encoded[2] = mPendingCount > 1 ? BASE64_CHARACTERS[(group >> 6) & 0x3f] : '=';
+                encoded[3] = mPendingCount > 2 ? BASE64_CHARACTERS[group & 0x3f] : '=';
+                write(encoded, sizeof(encoded));
+                mPendingCount = 0;
+
+                mLineLength += sizeof(encoded);
+                if (mLineLength == BASE64_LINE_LENGTH) {
+                    write("\n", 1);
+                    mLineLength = 0;
+                }
+            }
+
+            unsigned char *const mBuffer;
+            size_t mLength = 0;
+            unsigned char mPending[3] = {0, 0, 0};
+            size_t mPendingCount = 0;
+            size_t mLineLength = 0;
+        };
     }  // namespace CrossService
 } // namespace AwsDoc
 
@@ -30,157 +132,317 @@ namespace AwsDoc {
  \sa SESV2EmailHandler::SESV2EmailHandler()
  \param fromEmailAddress: Verified mail address enabled in Amazon SES.
  \param clientConfiguration: Aws client configuration.
+ \param options: The handler options.
  */
 AwsDoc::CrossService::SESV2EmailHandler::SESV2EmailHandler(
         const Aws::String &fromEmailAddress,
-        const Aws::Client::ClientConfiguration &clientConfiguration) :
-        mClientConfiguration(clientConfiguration),
-        mFromEmailAddress(fromEmailAddress) {
+        const Aws::Client::ClientConfiguration &clientConfiguration,
+        const Options &options) :
+        mClient(clientConfiguration),
+        mFromEmailAddress(fromEmailAddress),
+        mOptions(options),
+        mTokens(std::max(options.mMaxBurst, 1.0)),
+        mLastRefill(std::chrono::steady_clock::now()) {
+    for (size_t i = 0; i < mOptions.mWorkerThreads; ++i) {
+        mWorkers.emplace_back(&SESV2EmailHandler::workerLoop, this);
+    }
+}
+
+//! SESV2EmailHandler destructor.
+/*!
+ \sa SESV2EmailHandler::~SESV2EmailHandler()
+ */
+AwsDoc::CrossService::SESV2EmailHandler::~SESV2EmailHandler() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mQueueChanged.notify_all();
 
+    for (std::thread &worker: mWorkers) {
+        worker.join();
+    }
 }
 
-//! Routine which sends an email.
+//! Routine which queues an email.
 /*!
  \sa SESV2EmailHandler::sendEmail()
  \param emailAddress: The destination email address.
  \param workItems: List of work items for the email content.
- \return bool: Successful completion.
+ \return bool: Successful completion. With worker threads, the email was queued.
  */
 bool AwsDoc::CrossService::SESV2EmailHandler::sendEmail(const Aws::String emailAddress,
                                                         const std::vector<WorkItem> &workItems) {
-    Aws::SESV2::SESV2Client client(mClientConfiguration);
-
-    auto currentTime = std::chrono::system_clock::to_time_t(
-            std::chrono::system_clock::now());
-    Aws::String dateString = ctime(&currentTime);
-    Aws::String emailSubject("Greetings from AWS Example Code!");
-    std::stringstream plainTextStream;
-    plainTextStream << "This is a report for you.\n"
-                    << "It contains " << workItems.size() << " items.\n"
-                    << "Generated on " << dateString << ".\n";
-
-    std::stringstream rawMessageStream;
-    writeMultipartHeader(emailAddress, emailSubject, "" /* returnPath */,
-                         rawMessageStream);
-    writePlainTextPart(plainTextStream.str(), rawMessageStream);
-
-    std::stringstream httpTextStream;
-    httpTextStream << "<html>\n"
-                   << "  <body>\n"
-                   << "<h1>This is a report for you.</h1>\n"
-                   << "<b>It contains " << workItems.size() << " items.</b>\n"
-                   << "Generated on " << dateString << ".\n"
-                   << "  </body>\n"
-                   << "</html>\n";
-    writeHtmlTextPart(httpTextStream.str(), rawMessageStream);
-
-    std::stringstream csvStream;
-    csvStream << "ID,Name,Guide,Description,Status,Archived\n";
-    for (const WorkItem &item: workItems) {
-        csvStream << item.mID << "," << item.mName << "," << item.mGuide << ","
-                  << item.mDescription << "," << item.mStatus << ","
-                  << (item.mArchived ? "yes" : "no") << "\n";
+    EmailJob job;
+    job.mEmailAddress = emailAddress;
+    job.mWorkItems = workItems;
+    job.mQueuedTime = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // ctime is not thread safe.
+        auto currentTime = std::chrono::system_clock::to_time_t(
+                std::chrono::system_clock::now());
+        job.mDateString = ctime(&currentTime);
+
+        if (!mWorkers.empty()) {
+            if (mQueue.size() >= mOptions.mMaxQueued) {
+                ++mMetrics.mRejected;
+                std::cerr << "Error with SESV2EmailHandler::sendEmail. The email queue is full."
+                          << std::endl;
+                return false;
+            }
+
+            mQueue.push_back(std::move(job));
+            ++mMetrics.mQueued;
+        }
     }
 
-    std::string csvString = csvStream.str();
-    std::vector<unsigned char> csvVector(
-            reinterpret_cast<const unsigned char *>(csvString.c_str()),
-            reinterpret_cast<const unsigned char *>(csvString.c_str()) +
-            csvString.length());
+    if (mWorkers.empty()) {
+        return sendJob(job);
+    }
 
-    writeAttachmentPart("text/csv", "report.csv", csvVector, rawMessageStream);
-    std::string rawMessageString = rawMessageStream.str();
+    mQueueChanged.notify_one();
+    std::cout << "Queued email to '" << emailAddress << "'" << std::endl;
+    return true;
+}
 
-    Aws::Utils::ByteBuffer buffer(
-            reinterpret_cast<const unsigned char *>(rawMessageString.c_str()),
-            rawMessageString.length());
+//! Routine which returns a snapshot of the handler metrics.
+/*!
+ \sa SESV2EmailHandler::getMetrics()
+ \return Metrics: The metrics.
+ */
+AwsDoc::CrossService::SESV2EmailHandler::Metrics
+AwsDoc::CrossService::SESV2EmailHandler::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metrics metrics = mMetrics;
+    metrics.mQueueDepth = mQueue.size();
+    return metrics;
+}
+
+//! Routine which runs a worker thread.
+/*!
+ \sa SESV2EmailHandler::workerLoop()
+ \return void:
+ */
+void AwsDoc::CrossService::SESV2EmailHandler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mQueueChanged.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+        // The queued emails are sent before the workers stop.
+        if (mQueue.empty()) {
+            return;
+        }
+
+        EmailJob job(std::move(mQueue.front()));
+        mQueue.pop_front();
+
+        lock.unlock();
+        sendJob(job);
+        lock.lock();
+    }
+}
 
+//! Routine which waits until the token bucket allows a send.
+/*!
+ \sa SESV2EmailHandler::acquireSendToken()
+ \return void:
+ */
+void AwsDoc::CrossService::SESV2EmailHandler::acquireSendToken() {
+    if (mOptions.mSendsPerSecond <= 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mTokenMutex);
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed = now - mLastRefill;
+        mTokens = std::min(std::max(mOptions.mMaxBurst, 1.0),
+                           mTokens + elapsed.count() * mOptions.mSendsPerSecond);
+        mLastRefill = now;
+
+        if (mTokens >= 1.0) {
+            mTokens -= 1.0;
+            return;
+        }
+
+        std::chrono::duration<double> wait((1.0 - mTokens) / mOptions.mSendsPerSecond);
+        lock.unlock();
+        std::this_thread::sleep_for(wait);
+        lock.lock();
+    }
+}
+
+//! Routine which builds and sends an email.
+/*!
+ \sa SESV2EmailHandler::sendJob()
+ \param job: The email.
+ \return bool: Successful completion.
+ */
+bool AwsDoc::CrossService::SESV2EmailHandler::sendJob(const EmailJob &job) {
     Aws::SESV2::Model::RawMessage rawMessage;
-    rawMessage.SetData(buffer);
+    rawMessage.SetData(buildRawMessage(job.mEmailAddress, job.mWorkItems,
+                                       job.mDateString));
 
     Aws::SESV2::Model::EmailContent emailContent;
-    emailContent.SetRaw(rawMessage);
+    emailContent.SetRaw(std::move(rawMessage));
     Aws::SESV2::Model::SendEmailRequest request;
-    request.SetContent(emailContent);
+    request.SetContent(std::move(emailContent));
 
     Aws::SESV2::Model::Destination destination;
-    destination.AddToAddresses(emailAddress);
+    destination.AddToAddresses(job.mEmailAddress);
     request.SetDestination(destination);
     request.SetFromEmailAddress(mFromEmailAddress);
 
-    Aws::SESV2::Model::SendEmailOutcome outcome = client.SendEmail(request);
+    acquireSendToken();
+
+    auto requestStart = std::chrono::steady_clock::now();
+    Aws::SESV2::Model::SendEmailOutcome outcome = mClient.SendEmail(request);
+    auto requestEnd = std::chrono::steady_clock::now();
 
     if (outcome.IsSuccess()) {
-        std::cout << "Successfully sent email to '" << emailAddress << "'" << std::endl;
+        std::cout << "Successfully sent email to '" << job.mEmailAddress << "'" << std::endl;
     }
     else {
-        std::cerr << "Error sending email to '" << emailAddress << "'\n"
+        std::cerr << "Error sending email to '" << job.mEmailAddress << "'\n"
                   << outcome.GetError().GetMessage() << std::endl;
     }
 
+    auto sendLatency = std::chrono::duration_cast<std::chrono::microseconds>(
+            requestEnd - job.mQueuedTime);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (outcome.IsSuccess()) {
+            ++mMetrics.mSent;
+        }
+        else {
+            ++mMetrics.mFailed;
+        }
+        mMetrics.mTotalSendLatency += sendLatency;
+        mMetrics.mMaxSendLatency = std::max(mMetrics.mMaxSendLatency, sendLatency);
+        mMetrics.mTotalRequestLatency +=
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                        requestEnd - requestStart);
+    }
+
     return outcome.IsSuccess();
 }
 
+//! Routine which builds a raw email message with a work item report.
+/*!
+ \sa SESV2EmailHandler::buildRawMessage()
+ \param emailAddress: The destination email address.
+ \param workItems: List of work items for the email content.
+ \param dateString: The date written in the report.
+ \return ByteBuffer: The raw message.
+ */
+Aws::Utils::ByteBuffer
+AwsDoc::CrossService::SESV2EmailHandler::buildRawMessage(
+        const Aws::String &emailAddress,
+        const std::vector<WorkItem> &workItems,
+        const Aws::String &dateString) const {
+    MimeWriter sizer(nullptr);
+    writeRawMessage(emailAddress, workItems, dateString, sizer);
+
+    Aws::Utils::ByteBuffer buffer(sizer.length());
+    MimeWriter writer(buffer.GetUnderlyingData());
+    writeRawMessage(emailAddress, workItems, dateString, writer);
+
+    return buffer;
+}
+
+//! Routine which writes a raw email message with a work item report.
+/*!
+ \sa SESV2EmailHandler::writeRawMessage()
+ \param emailAddress: The destination email address.
+ \param workItems: List of work items for the email content.
+ \param dateString: The date written in the report.
+ \param writer: The message writer.
+ \return void:
+ */
+void AwsDoc::CrossService::SESV2EmailHandler::writeRawMessage(
+        const Aws::String &emailAddress,
+        const std::vector<WorkItem> &workItems,
+        const Aws::String &dateString,
+        MimeWriter &writer) const {
+    const Aws::String itemCount = std::to_string(workItems.size());
+    writeMultipartHeader(emailAddress, "Greetings from AWS Example Code!",
+                         "" /* returnPath */, writer);
+
+    writePlainTextPart("This is a report for you.\n"
+                       "It contains " + itemCount + " items.\n"
+                       "Generated on " + dateString + ".\n", writer);
+
+    writeHtmlTextPart("<html>\n"
+                      "  <body>\n"
+                      "<h1>This is a report for you.</h1>\n"
+                      "<b>It contains " + itemCount + " items.</b>\n"
+                      "Generated on " + dateString + ".\n"
+                      "  </body>\n"
+                      "</html>\n", writer);
+
+    writeAttachmentPart("text/csv", "report.csv", workItems, writer);
+}
 //! Routine which writes the header of a multipart raw email message.
 /*!
  \sa SESV2EmailHandler::writeMultipartHeader()
  \param toEmail: The destination email address.
  \param subject: The email subject.
  \param returnPath: Optional return email address.
- \param ostream: An output stream.
+ \param writer: The message writer.
  \return void:
  */
 void AwsDoc::CrossService::SESV2EmailHandler::writeMultipartHeader(
         const Aws::String &toEmail, const Aws::String &subject,
-        const Aws::String &returnPath, std::ostream &ostream) {
-    ostream << "From: " << mFromEmailAddress << "\n"
-            << "To: " << toEmail << "\n"
-            << "Subject: " << subject << "\n";
+        const Aws::String &returnPath, MimeWriter &writer) const {
+    writer << "From: " << mFromEmailAddress << "\n"
+           << "To: " << toEmail << "\n"
+           << "Subject: " << subject << "\n";
 
     if (!returnPath.empty()) {
-        ostream << "Return-Path: " << returnPath << "\n";
+        writer << "Return-Path: " << returnPath << "\n";
     }
 
-    ostream << "Content-Type: multipart/alternative;\n"
-            << "\tboundary=\"" << MIME_BOUNDARY << "\"\n"
-            << "\n"
-            << "--" << MIME_BOUNDARY << "\n";
+    writer << "Content-Type: multipart/alternative;\n"
+           << "\tboundary=\"" << MIME_BOUNDARY << "\"\n"
+           << "\n"
+           << "--" << MIME_BOUNDARY << "\n";
 }
 
 //! Routine which writes the plain text part of a multipart raw email message.
 /*!
  \sa SESV2EmailHandler::writePlainTextPart()
  \param plainText: Plain text content.
- \param ostream: An output stream.
+ \param writer: The message writer.
  \return void:
  */
 void
 AwsDoc::CrossService::SESV2EmailHandler::writePlainTextPart(const Aws::String &plainText,
-                                                            std::ostream &ostream) {
-    ostream << "Content-Type: text/plain; charset=UTF-8\n"
-            << "Content-Transfer-Encoding: 7bit\n"
-            << "\n"
-            << "\n"
-            << plainText << "\n"
-            << "--" << MIME_BOUNDARY << "\n";
+                                                            MimeWriter &writer) {
+    writer << "Content-Type: text/plain; charset=UTF-8\n"
+           << "Content-Transfer-Encoding: 7bit\n"
+           << "\n"
+           << "\n"
+           << plainText << "\n"
+           << "--" << MIME_BOUNDARY << "\n";
 }
 
 //! Routine which writes the HTML text part of a multipart raw email message.
 /*!
  \sa SESV2EmailHandler::writeHtmlTextPart()
  \param htmlText: Content in HTML text format.
- \param ostream: An output stream.
+ \param writer: The message writer.
  \return void:
  */
 void
 AwsDoc::CrossService::SESV2EmailHandler::writeHtmlTextPart(const Aws::String &htmlText,
-                                                           std::ostream &ostream) {
-    ostream << "Content-Type: text/html; charset=UTF-8\n"
-            << "Content-Transfer-Encoding: 7bit\n"
-            << "\n"
-            << "\n"
-            << htmlText << "\n"
-            << "--" << MIME_BOUNDARY << "\n";
+                                                           MimeWriter &writer) {
+    writer << "Content-Type: text/html; charset=UTF-8\n"
+           << "Content-Transfer-Encoding: 7bit\n"
+           << "\n"
+           << "\n"
+           << htmlText << "\n"
+           << "--" << MIME_BOUNDARY << "\n";
 }
 
 //! Routine which writes the file attachment part of a multipart raw email message.
@@ -188,23 +450,32 @@ AwsDoc::CrossService::SESV2EmailHandler::writeHtmlTextPart(const Aws::String &ht
  \sa SESV2EmailHandler::writeAttachmentPart()
  \param contentType: The MIME content type.
  \param name: The file name.
- \param attachmentBuffer: Buffer containing the file contents.
- \param ostream: An output stream.
+ \param workItems: The work items written to the attachment as CSV.
+ \param writer: The message writer.
  \return void:
  */
 void AwsDoc::CrossService::SESV2EmailHandler::writeAttachmentPart(
         const Aws::String &contentType, const Aws::String &name,
-        const std::vector<unsigned char> &attachmentBuffer, std::ostream &ostream) {
-    Aws::Utils::ByteBuffer encodeBuffer(attachmentBuffer.data(),
-                                        attachmentBuffer.size());
-    Aws::Utils::Base64::Base64 base64;
-    Aws::String encodedAttachment = base64.Encode(encodeBuffer);
-
-    ostream << "Content-Type: " << contentType << "; name=" << name << "\n"
-            << "Content-Transfer-Encoding: base64\n"
-            << "Content-Disposition: attachment\n"
-            << "\n"
-            << encodedAttachment << "\n"
-            << "--" << MIME_BOUNDARY << "\n";
-}
+        const std::vector<WorkItem> &workItems, MimeWriter &writer) {
+    writer << "Content-Type: " << contentType << "; name=" << name << "\n"
+           << "Content-Transfer-Encoding: base64\n"
+           << "Content-Disposition: attachment\n"
+           << "\n";
 
+    writer.writeBase64("ID,Name,Guide,Description,Status,Archived\n");
+    for (const WorkItem &item: workItems) {
+        writer.writeBase64(item.mID);
+        writer.writeBase64(",", 1);
+        writer.writeBase64(item.mName);
+        writer.writeBase64(",", 1);
+        writer.writeBase64(item.mGuide);
+        writer.writeBase64(",", 1);
+        writer.writeBase64(item.mDescription);
+        writer.writeBase64(",", 1);
+        writer.writeBase64(item.mStatus);
+        writer.writeBase64(item.mArchived ? ",yes\n" : ",no\n");
+    }
+    writer.finishBase64();
+
+    writer << "--" << MIME_BOUNDARY << "\n";
+}
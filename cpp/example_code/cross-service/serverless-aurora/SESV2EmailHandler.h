@@ -17,38 +17,154 @@
 
 #include "ItemTrackerHTTPHandler.h"
 #include <aws/core/client/ClientConfiguration.h>
+#include <aws/core/utils/Array.h>
+#include <aws/sesv2/SESV2Client.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace AwsDoc {
     namespace CrossService {
+        class MimeWriter;
+
+        // Options for SESV2EmailHandler.
+        struct SESV2EmailHandlerOptions {
+            // The threads which build and send queued emails. If 0, sendEmail
+            // sends the email before it returns.
+            size_t mWorkerThreads = 2;
+            // Emails which wait for a worker before sendEmail refuses new ones.
+            size_t mMaxQueued = 100;
+            // The sustained sending rate. Set it to the account's SES maximum send
+            // rate, which is 1 per second in the SES sandbox.
+            double mSendsPerSecond = 1.0;
+            // Emails which can be sent at once after the handler has been idle.
+            double mMaxBurst = 1.0;
+        };
+
+        // Metrics for a SESV2EmailHandler.
+        struct SESV2EmailHandlerMetrics {
+            size_t mQueueDepth = 0;
+            uint64_t mQueued = 0;
+            uint64_t mSent = 0;
+            uint64_t mFailed = 0;
+            // Emails refused because the queue was full.
+            uint64_t mRejected = 0;
+            // The time from sendEmail to the end of the SendEmail request, for the
+            // emails sent or failed.
+            std::chrono::microseconds mTotalSendLatency = std::chrono::microseconds(0);
+            std::chrono::microseconds mMaxSendLatency = std::chrono::microseconds(0);
+            // The time spent in SendEmail requests.
+            std::chrono::microseconds mTotalRequestLatency = std::chrono::microseconds(0);
+        };
+
         /**
          *  SESV2EmailHandler
          *
          *  Implementation of SESEmailReceiver which sends emails using Amazon SES.
          *
+         *  sendEmail adds the email to a bounded queue and returns, so a report does
+         *  not hold the HTTP request thread. Worker threads build each raw message
+         *  and send it, and a token bucket keeps the sends within the SES send rate.
+         *
          */
         class SESV2EmailHandler : public SESEmailReceiver {
         public :
+            typedef SESV2EmailHandlerOptions Options;
+            typedef SESV2EmailHandlerMetrics Metrics;
 
             //! SESV2EmailHandler constructor.
             /*!
              \sa SESV2EmailHandler::SESV2EmailHandler()
              \param fromEmailAddress: Verified mail address enabled in Amazon SES.
              \param clientConfiguration: Aws client configuration.
+             \param options: The handler options.
              */
             explicit SESV2EmailHandler(const Aws::String &fromEmailAddress,
-                                       const Aws::Client::ClientConfiguration &clientConfiguration);
+                                       const Aws::Client::ClientConfiguration &clientConfiguration,
+                                       const Options &options = Options());
 
-            //! Routine which sends an email.
+            SESV2EmailHandler(const SESV2EmailHandler &) = delete;
+
+            SESV2EmailHandler &operator=(const SESV2EmailHandler &) = delete;
+
+            //! SESV2EmailHandler destructor. Sends the queued emails and stops the workers.
+            ~SESV2EmailHandler();
+
+            //! Routine which queues an email.
             /*!
              \sa SESV2EmailHandler::sendEmail()
              \param emailAddress: The destination email address.
              \param workItems: List of work items for the email content.
-             \return bool: Successful completion.
+             \return bool: Successful completion. With worker threads, the email was queued.
              */
             virtual bool sendEmail(const Aws::String emailAddress,
                                    const std::vector<WorkItem> &workItems) override;
 
+            //! Routine which returns a snapshot of the handler metrics.
+            /*!
+             \sa SESV2EmailHandler::getMetrics()
+             \return Metrics: The metrics.
+             */
+            Metrics getMetrics() const;
+
+            //! Routine which builds a raw email message with a work item report.
+            /*!
+             \sa SESV2EmailHandler::buildRawMessage()
+             \param emailAddress: The destination email address.
+             \param workItems: List of work items for the email content.
+             \param dateString: The date written in the report.
+             \return ByteBuffer: The raw message.
+             */
+            Aws::Utils::ByteBuffer buildRawMessage(const Aws::String &emailAddress,
+                                                   const std::vector<WorkItem> &workItems,
+                                                   const Aws::String &dateString) const;
+
         private:
+            struct EmailJob {
+                Aws::String mEmailAddress;
+                std::vector<WorkItem> mWorkItems;
+                Aws::String mDateString;
+                std::chrono::steady_clock::time_point mQueuedTime;
+            };
+
+            //! Routine which builds and sends an email.
+            /*!
+             \sa SESV2EmailHandler::sendJob()
+             \param job: The email.
+             \return bool: Successful completion.
+             */
+            bool sendJob(const EmailJob &job);
+
+            //! Routine which runs a worker thread.
+            /*!
+             \sa SESV2EmailHandler::workerLoop()
+             \return void:
+             */
+            void workerLoop();
+
+            //! Routine which waits until the token bucket allows a send.
+            /*!
+             \sa SESV2EmailHandler::acquireSendToken()
+             \return void:
+             */
+            void acquireSendToken();
+
+            //! Routine which writes a raw email message with a work item report.
+            /*!
+             \sa SESV2EmailHandler::writeRawMessage()
+             \param emailAddress: The destination email address.
+             \param workItems: List of work items for the email content.
+             \param dateString: The date written in the report.
+             \param writer: The message writer.
+             \return void:
+             */
+            void writeRawMessage(const Aws::String &emailAddress,
+                                 const std::vector<WorkItem> &workItems,
+                                 const Aws::String &dateString,
+                                 MimeWriter &writer) const;
 
             //! Routine which writes the header of a multipart raw email message.
             /*!
@@ -62,43 +178,55 @@ namespace AwsDoc {
             void writeMultipartHeader(const Aws::String &toEmail,
                                       const Aws::String &subject,
                                       const Aws::String &returnPath,
-                                      std::ostream &ostream);
+                                      MimeWriter &writer) const;
 
             //! Routine which writes the plain text part of a multipart raw email message.
             /*!
              \sa SESV2EmailHandler::writePlainTextPart()
              \param plainText: Plain text content.
-             \param ostream: An output stream.
+             \param writer: The message writer.
              \return void:
              */
             static void
-            writePlainTextPart(const Aws::String &plainText, std::ostream &ostream);
+            writePlainTextPart(const Aws::String &plainText, MimeWriter &writer);
 
             //! Routine which writes the HTML text part of a multipart raw email message.
             /*!
              \sa SESV2EmailHandler::writeHtmlTextPart()
              \param htmlText: Content in HTML text format.
-             \param ostream: An output stream.
+             \param writer: The message writer.
              \return void:
              */
-            static void writeHtmlTextPart(const Aws::String &htmlText, std::ostream &ostream);
+            static void writeHtmlTextPart(const Aws::String &htmlText, MimeWriter &writer);
 
             //! Routine which writes the file attachment part of a multipart raw email message.
             /*!
              \sa SESV2EmailHandler::writeAttachmentPart()
              \param contentType: The MIME content type.
              \param name: The file name.
-             \param attachmentBuffer: Buffer containing the file contents                                             cv f.
-             \param ostream: An output stream.
+             \param workItems: The work items written to the attachment as CSV.
+             \param writer: The message writer.
              \return void:
              */
             static void
             writeAttachmentPart(const Aws::String &contentType, const Aws::String &name,
-                                const std::vector<unsigned char> &attachmentBuffer,
-                                std::ostream &ostream);
+                                const std::vector<WorkItem> &workItems,
+                                MimeWriter &writer);
 
-            Aws::Client::ClientConfiguration mClientConfiguration;
+            Aws::SESV2::SESV2Client mClient;
             Aws::String mFromEmailAddress;
+            const Options mOptions;
+
+            mutable std::mutex mMutex;
+            std::condition_variable mQueueChanged;
+            std::deque<EmailJob> mQueue;
+            std::vector<std::thread> mWorkers;
+            bool mStopping = false;
+            Metrics mMetrics;
+
+            std::mutex mTokenMutex;
+            double mTokens;
+            std::chrono::steady_clock::time_point mLastRefill;
         };
     }  // namespace CrossService
 } // namespace AwsDoc
@@ -0,0 +1,157 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ *  http_load_generator.cpp
+ *
+ *  The code in this file sends requests to the item tracker HTTP server from several
+ *  connections, and reports the requests per second and the request latencies.
+ *
+ * To run the example, refer to the instructions in the README.
+ *
+ */
+
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/Exception.h>
+#include <Poco/URI.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Routine which sends requests on one keep-alive connection, and records the
+//! latency of each request.
+/*!
+ \sa runConnection()
+ \param uri: The request URI.
+ \param postBody: The content of POST requests. If empty, GET requests are sent.
+ \param requestCount: Number of requests.
+ \param latencies: Vector to receive the latency of each successful request.
+ \param errors: Counter of failed requests.
+ \return void:
+ */
+static void runConnection(const Poco::URI &uri,
+                          const std::string &postBody,
+                          size_t requestCount,
+                          std::vector<std::chrono::microseconds> &latencies,
+                          std::atomic<size_t> &errors) {
+    Poco::Net::HTTPClientSession session(uri.getHost(), uri.getPort());
+    session.setKeepAlive(true);
+    const std::string path = uri.getPathAndQuery().empty() ? "/" : uri.getPathAndQuery();
+    latencies.reserve(requestCount);
+
+    for (size_t i = 0; i < requestCount; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        try {
+            Poco::Net::HTTPRequest request(
+                    postBody.empty() ? Poco::Net::HTTPRequest::HTTP_GET
+                                     : Poco::Net::HTTPRequest::HTTP_POST,
+                    path, Poco::Net::HTTPMessage::HTTP_1_1);
+            request.setKeepAlive(true);
+            if (!postBody.empty()) {
+                request.setContentType("application/json");
+                request.setContentLength(static_cast<std::streamsize>(postBody.size()));
+            }
+            session.sendRequest(request) << postBody;
+
+            Poco::Net::HTTPResponse response;
+            std::istream &responseStream = session.receiveResponse(response);
+            responseStream.ignore(std::numeric_limits<std::streamsize>::max());
+
+            if (response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK) {
+                ++errors;
+                continue;
+            }
+        }
+        catch (const Poco::Exception &e) {
+            std::cerr << "Error with runConnection. " << e.displayText() << std::endl;
+            session.reset();
+            ++errors;
+            continue;
+        }
+
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start));
+    }
+}
+
+//! Routine which returns a percentile of sorted latencies.
+/*!
+ \sa percentile()
+ \param sortedLatencies: The latencies, in ascending order.
+ \param fraction: The percentile, from 0 to 1.
+ \return double: The latency in milliseconds.
+ */
+static double percentile(const std::vector<std::chrono::microseconds> &sortedLatencies,
+                         double fraction) {
+    if (sortedLatencies.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(fraction * (sortedLatencies.size() - 1) + 0.5);
+    return sortedLatencies[index].count() / 1000.0;
+}
+
+/*
+ *
+ *  main function
+ *
+ *  Prerequisites: A running item tracker HTTP server. See the accompanying README.
+ *
+ * Usage: 'run_http_load_generator <url> [connections] [requests_per_connection] [post_body]'
+ *
+ */
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 5) {
+        std::cout << "Usage: run_http_load_generator <url> [connections] "
+                  << "[requests_per_connection] [post_body]" << std::endl;
+        return 1;
+    }
+
+    Poco::URI uri(argv[1]);
+    size_t connections = std::max<size_t>(argc > 2 ? std::stoul(argv[2]) : 8, 1);
+    size_t requestsPerConnection = argc > 3 ? std::stoul(argv[3]) : 1000;
+    std::string postBody = argc > 4 ? argv[4] : "";
+
+    std::vector<std::vector<std::chrono::microseconds>> latencies(connections);
+    std::atomic<size_t> errors(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < connections; ++i) {
+        threads.emplace_back(runConnection, std::cref(uri), std::cref(postBody),
+                             requestsPerConnection, std::ref(latencies[i]),
+                             std::ref(errors));
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::chrono::microseconds> allLatencies;
+    allLatencies.reserve(connections * requestsPerConnection);
+    for (const std::vector<std::chrono::microseconds> &connectionLatencies: latencies) {
+        allLatencies.insert(allLatencies.end(), connectionLatencies.begin(),
+                            connectionLatencies.end());
+    }
+    std::sort(allLatencies.begin(), allLatencies.end());
+
+    std::cout << std::fixed << std::setprecision(2)
+              << allLatencies.size() << " requests succeeded and " << errors
+              << " failed in " << elapsed.count() << " s on " << connections
+              << " connections.\n"
+              << "Requests per second: "
+              << (elapsed.count() > 0 ? allLatencies.size() / elapsed.count() : 0.0)
+              << "\n"
+              << "Latency p50: " << percentile(allLatencies, 0.50) << " ms, p99: "
+              << percentile(allLatencies, 0.99) << " ms, max: "
+              << percentile(allLatencies, 1.0) << " ms" << std::endl;
+
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ *  list_response_benchmark.cpp
+ *
+ *  The code in this file compares the time taken to build the work item list
+ *  response of the HTTP server with one JsonValue for each work item, as the
+ *  handler did before, with the streaming JSON writer. No AWS resources are used.
+ *
+ * To run the example, refer to the instructions in the README.
+ *
+ */
+
+#include "ItemTrackerHTTPHandler.h"
+#include <aws/core/Aws.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+/**
+ *  An RDSDataReceiver which returns generated work items.
+ */
+class GeneratedWorkItems : public AwsDoc::CrossService::RDSDataReceiver {
+public:
+    explicit GeneratedWorkItems(size_t count) {
+        mWorkItems.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            mWorkItems.emplace_back(std::to_string(100000 + i),
+                                    "Item " + std::to_string(i), "cpp",
+                                    "A generated work item for the benchmark",
+                                    "In Progress", i % 2 == 0);
+        }
+    }
+
+    bool addWorkItem(const AwsDoc::CrossService::WorkItem &) override {
+        return false;
+    }
+
+    bool getWorkItems(AwsDoc::CrossService::WorkItemStatus,
+                      std::vector<AwsDoc::CrossService::WorkItem> &workItems) override {
+        workItems = mWorkItems;
+        return true;
+    }
+
+    bool streamWorkItems(AwsDoc::CrossService::WorkItemStatus, size_t,
+                         const AwsDoc::CrossService::WorkItemHandler &handler) override {
+        for (const AwsDoc::CrossService::WorkItem &workItem: mWorkItems) {
+            handler(workItem);
+        }
+        return true;
+    }
+
+    bool getWorkItemWithId(const Aws::String &,
+                           AwsDoc::CrossService::WorkItem &) override {
+        return false;
+    }
+
+    bool setWorkItemToArchive(const Aws::String &) override {
+        return false;
+    }
+
+    bool updateWorkItem(const AwsDoc::CrossService::WorkItem &) override {
+        return false;
+    }
+
+private:
+    std::vector<AwsDoc::CrossService::WorkItem> mWorkItems;
+};
+
+/**
+ *  An SESEmailReceiver which sends no email.
+ */
+class NoEmail : public AwsDoc::CrossService::SESEmailReceiver {
+public:
+    bool sendEmail(const Aws::String,
+                   const std::vector<AwsDoc::CrossService::WorkItem> &) override {
+        return false;
+    }
+};
+
+//! Routine which times building a work item list response in three ways.
+/*!
+ \sa runBenchmark()
+ \param itemCount: Number of work items in the list.
+ \return bool: True if the responses are the same valid JSON.
+ */
+bool runBenchmark(size_t itemCount) {
+    GeneratedWorkItems generatedWorkItems(itemCount);
+    NoEmail noEmail;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string jsonValueResponse;
+    {
+        std::vector<AwsDoc::CrossService::WorkItem> workItems;
+        generatedWorkItems.getWorkItems(AwsDoc::CrossService::WorkItemStatus::BOTH,
+                                        workItems);
+        std::stringstream jsonStringStream;
+        jsonStringStream << "[";
+        for (size_t i = 0; i < workItems.size(); ++i) {
+            AwsDoc::CrossService::WorkItem workItem = workItems[i];
+            Aws::Utils::Json::JsonValue jsonWorkItem;
+            jsonWorkItem.WithString(AwsDoc::CrossService::HTTP_ID_KEY, workItem.mID);
+            jsonWorkItem.WithString(AwsDoc::CrossService::HTTP_NAME_KEY, workItem.mName);
+            jsonWorkItem.WithString(AwsDoc::CrossService::HTTP_GUIDE_KEY, workItem.mGuide);
+            jsonWorkItem.WithString(AwsDoc::CrossService::HTTP_DESCRIPTION_KEY,
+                                    workItem.mDescription);
+            jsonWorkItem.WithString(AwsDoc::CrossService::HTTP_STATUS_KEY,
+                                    workItem.mStatus);
+            jsonWorkItem.WithBool(AwsDoc::CrossService::HTTP_ARCHIVED_KEY,
+                                  workItem.mArchived);
+            jsonStringStream << jsonWorkItem.View().WriteReadable();
+            if (i < workItems.size() - 1) {
+                jsonStringStream << ",";
+            }
+        }
+        jsonStringStream << "]";
+        std::string jsonString = jsonStringStream.str();
+        std::stringstream responseStream;
+        responseStream << jsonString;
+        jsonValueResponse = responseStream.str();
+    }
+    std::chrono::duration<double> jsonValueTime =
+            std::chrono::steady_clock::now() - start;
+
+    std::string responseContentType;
+    std::stringstream responseStream;
+    AwsDoc::CrossService::ItemTrackerHTTPHandler listHandler(generatedWorkItems,
+                                                             noEmail);
+    start = std::chrono::steady_clock::now();
+    if (!listHandler.handleHTTP("GET", "/api/items", "",
+                                responseContentType, responseStream)) {
+        std::cerr << "Error with runBenchmark. The list request failed." << std::endl;
+        return false;
+    }
+    std::chrono::duration<double> writerTime =
+            std::chrono::steady_clock::now() - start;
+    std::string writerResponse = responseStream.str();
+
+    responseStream.str("");
+    AwsDoc::CrossService::ItemTrackerHTTPHandler streamingHandler(
+            generatedWorkItems, noEmail, 1000);
+    start = std::chrono::steady_clock::now();
+    if (!streamingHandler.handleHTTP("GET", "/api/items", "",
+                                     responseContentType, responseStream)) {
+        std::cerr << "Error with runBenchmark. The streamed list request failed."
+                  << std::endl;
+        return false;
+    }
+    std::chrono::duration<double> streamingTime =
+            std::chrono::steady_clock::now() - start;
+
+    std::cout << "List response with " << itemCount << " work items\n"
+              << "  JsonValue and WriteReadable: " << jsonValueTime.count() << " s, "
+              << jsonValueResponse.size() << " bytes\n"
+              << "  JSON writer:                 " << writerTime.count() << " s, "
+              << writerResponse.size() << " bytes\n"
+              << "  JSON writer, streamed:       " << streamingTime.count() << " s"
+              << std::endl;
+
+    Aws::Utils::Json::JsonValue jsonValue(writerResponse);
+    if (responseStream.str() != writerResponse || !jsonValue.WasParseSuccessful() ||
+        jsonValue.View().AsArray().GetLength() != itemCount) {
+        std::cerr << "Error with runBenchmark. The responses do not match." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ *
+ *  main function
+ *
+ *  Prerequisites: None.
+ *
+ * Usage: 'run_list_response_benchmark [item_count]'
+ *
+ */
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        std::cout << "Usage: run_list_response_benchmark [item_count]" << std::endl;
+        return 1;
+    }
+
+    Aws::SDKOptions options;
+    Aws::InitAPI(options);
+    bool result;
+    {
+        size_t itemCount = argc > 1 ? std::stoul(argv[1]) : 100000;
+        result = runBenchmark(itemCount);
+    }
+
+    ShutdownAPI(options);
+
+    return result ? 0 : 1;
+}
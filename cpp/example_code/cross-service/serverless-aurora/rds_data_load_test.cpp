@@ -0,0 +1,214 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ *  rds_data_load_test.cpp
+ *
+ *  The code in this file measures the throughput of the RDSDataHandler add, get, and
+ *  update operations against an Amazon Aurora Serverless database.
+ *
+ * To run the example, refer to the instructions in the README.
+ *
+ */
+
+#include "RDSDataHandler.h"
+#include <aws/core/Aws.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+static const Aws::String LOAD_TEST_TABLE_NAME("items_load_test");
+
+/**
+ *  A stream buffer which discards its output. It silences the messages
+ *  RDSDataHandler writes to std::cout for each operation.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+
+    std::streamsize xsputn(const char *, std::streamsize count) override {
+        return count;
+    }
+};
+
+//! Routine which runs an operation for each index from 0 to count - 1 on several
+//! threads, and reports the throughput.
+/*!
+ \sa runPhase()
+ \param name: Name of the operation.
+ \param count: Number of operations.
+ \param threadCount: Number of threads.
+ \param operation: Callable taking an index and returning true on success.
+ \return size_t: Number of failed operations.
+ */
+template<typename Operation>
+static size_t runPhase(const char *name, size_t count, size_t threadCount,
+                       Operation operation) {
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<size_t> failures(0);
+
+    NullBuffer nullBuffer;
+    std::streambuf *savedBuffer = std::cout.rdbuf(&nullBuffer);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t index = nextIndex++; index < count; index = nextIndex++) {
+                if (!operation(index)) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout.rdbuf(savedBuffer);
+
+    std::cout << std::left << std::setw(14) << name << std::right
+              << std::setw(8) << count << " operations in "
+              << std::fixed << std::setprecision(2) << elapsed.count() << " s, "
+              << std::setw(10) << (elapsed.count() > 0 ? count / elapsed.count() : 0.0)
+              << " per second, " << failures << " failed." << std::endl;
+
+    return failures;
+}
+
+//! Routine which measures the throughput of RDSDataHandler operations.
+/*!
+ \sa runLoadTest()
+ \param database: The Amazon Relational Database Service (Amazon RDS) database name.
+ \param resourceArn: The Amazon RDS database Amazon Resource Name (ARN).
+ \param secretArn: The AWS Secrets Manager database ARN.
+ \param itemCount: Number of work items for each phase.
+ \param threadCount: Number of threads calling the handler.
+ \param clientConfiguration: Aws client configuration.
+ \return bool: True if no operation failed.
+ */
+bool runLoadTest(const Aws::String &database,
+                 const Aws::String &resourceArn,
+                 const Aws::String &secretArn,
+                 size_t itemCount,
+                 size_t threadCount,
+                 Aws::Client::ClientConfiguration clientConfiguration) {
+    // Let each thread have a connection.
+    clientConfiguration.maxConnections = static_cast<unsigned>(threadCount);
+
+    AwsDoc::CrossService::RDSDataHandler rdsDataHandler(database, resourceArn,
+                                                        secretArn,
+                                                        LOAD_TEST_TABLE_NAME,
+                                                        clientConfiguration);
+
+    rdsDataHandler.initializeTable(true); // bool: Recreate table.
+
+    std::vector<AwsDoc::CrossService::WorkItem> workItems;
+    workItems.reserve(itemCount);
+    for (size_t i = 0; i < itemCount; ++i) {
+        workItems.emplace_back("", "Load test " + std::to_string(i), "cpp",
+                               "Load test item", "In Progress", false);
+    }
+
+    size_t failures = 0;
+    failures += runPhase("add", itemCount, threadCount,
+                         [&](size_t index) {
+                             return rdsDataHandler.addWorkItem(workItems[index]);
+                         });
+
+    // A batch phase makes one call, which sends MAX_BATCH_PARAMETER_SETS items in
+    // each request. Its rate is reported in items.
+    std::vector<Aws::String> ids;
+    failures += runPhase("batch add", itemCount, 1,
+                         [&](size_t index) {
+                             return index > 0 ||
+                                    rdsDataHandler.addWorkItems(workItems, ids);
+                         });
+
+    if (ids.size() < itemCount) {
+        std::cerr << "Error with runLoadTest. The batch add failed." << std::endl;
+        return false;
+    }
+
+    failures += runPhase("get", itemCount, threadCount,
+                         [&](size_t index) {
+                             AwsDoc::CrossService::WorkItem workItem;
+                             return rdsDataHandler.getWorkItemWithId(ids[index],
+                                                                     workItem) &&
+                                    workItem.mID == ids[index];
+                         });
+
+    for (size_t i = 0; i < itemCount; ++i) {
+        workItems[i].mID = ids[i];
+        workItems[i].mStatus = "Updated";
+    }
+
+    failures += runPhase("update", itemCount, threadCount,
+                         [&](size_t index) {
+                             return rdsDataHandler.updateWorkItem(workItems[index]);
+                         });
+
+    for (AwsDoc::CrossService::WorkItem &workItem: workItems) {
+        workItem.mArchived = true;
+    }
+
+    failures += runPhase("batch update", itemCount, 1,
+                         [&](size_t index) {
+                             return index > 0 ||
+                                    rdsDataHandler.updateWorkItems(workItems);
+                         });
+
+    failures += runPhase("list", 1, 1,
+                         [&](size_t) {
+                             std::vector<AwsDoc::CrossService::WorkItem> allItems;
+                             return rdsDataHandler.getWorkItems(
+                                     AwsDoc::CrossService::WorkItemStatus::BOTH,
+                                     allItems) && allItems.size() == 2 * itemCount;
+                         });
+
+    return failures == 0;
+}
+
+/*
+ *
+ *  main function
+ *
+ *  Prerequisites: See the accompanying README.
+ *
+ * Usage: 'run_rds_data_load_test <database> <resource_arn> <secret_arn> [item_count] [thread_count]'
+ *
+ */
+
+int main(int argc, char **argv) {
+    if (argc < 4 || argc > 6) {
+        std::cout << "Usage: run_rds_data_load_test <database> <resource_arn> "
+                  << "<secret_arn> [item_count] [thread_count]" << std::endl;
+        return 1;
+    }
+
+    Aws::SDKOptions options;
+    Aws::InitAPI(options);
+    bool result;
+    {
+        Aws::String database = argv[1];
+        Aws::String resourceArn = argv[2];
+        Aws::String secretArn = argv[3];
+        size_t itemCount = argc > 4 ? std::stoul(argv[4]) : 1000;
+        size_t threadCount = argc > 5 ? std::stoul(argv[5]) : 8;
+        Aws::Client::ClientConfiguration clientConfig;
+        // Optional: Set to the AWS Region in which the bucket was created (overrides config file).
+        // clientConfig.region = "us-east-1";
+        result = runLoadTest(database, resourceArn, secretArn, itemCount,
+                             std::max<size_t>(threadCount, 1), clientConfig);
+    }
+
+    ShutdownAPI(options);
+
+    return result ? 0 : 1;
+}
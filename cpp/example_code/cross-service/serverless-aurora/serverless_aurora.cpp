@@ -16,6 +16,9 @@
 
 static const Aws::String TABLE_NAME("items");
 
+// Work item lists are written to HTTP responses in pages of this size.
+static const size_t STREAMING_PAGE_SIZE = 1000;
+
 //! Routine which runs the Amazon Aurora Serverless example as an HTTP server using the Poco library.
 /*!
  \sa runServerLessAurora
@@ -37,17 +40,40 @@ void runServerLessAurora(const Aws::String &database,
 
     rdsDataHandler.initializeTable(false); // bool: Recreate table.
 
+    AwsDoc::CrossService::SESV2EmailHandler::Options emailOptions;
+    // The Amazon SES sandbox allows 1 email per second.
+    emailOptions.mSendsPerSecond = 1.0;
     AwsDoc::CrossService::SESV2EmailHandler sesEmailHandler(sesEmailAddress,
-                                                            clientConfiguration);
+                                                            clientConfiguration,
+                                                            emailOptions);
 
     AwsDoc::CrossService::ItemTrackerHTTPHandler itemTrackerHttpServer(rdsDataHandler,
-                                                                       sesEmailHandler);
+                                                                       sesEmailHandler,
+                                                                       STREAMING_PAGE_SIZE);
     char *argv[1];
     char app_name[256];
     strncpy(app_name, "run_aurora_serverless", sizeof(app_name));
     argv[0] = app_name;
-    AwsDoc::PocoImpl::PocoHTTPServer myServerApp(itemTrackerHttpServer);
+    AwsDoc::PocoImpl::PocoHTTPServer::Options serverOptions;
+    // Each request holds a server thread while it calls Aurora, so the server
+    // needs more threads than CPU cores.
+    serverOptions.mMaxThreads = 32;
+    AwsDoc::PocoImpl::PocoHTTPServer myServerApp(itemTrackerHttpServer, serverOptions);
     myServerApp.run(1, argv);
+
+    AwsDoc::CrossService::SESV2EmailHandler::Metrics metrics = sesEmailHandler.getMetrics();
+    uint64_t completed = metrics.mSent + metrics.mFailed;
+    std::cout << "Emails sent: " << metrics.mSent << ", failed: " << metrics.mFailed
+              << ", rejected: " << metrics.mRejected << ", still queued: "
+              << metrics.mQueueDepth << std::endl;
+    if (completed > 0) {
+        std::cout << "Average send latency: "
+                  << metrics.mTotalSendLatency.count() / completed / 1000
+                  << " ms, maximum: " << metrics.mMaxSendLatency.count() / 1000
+                  << " ms, average SendEmail request: "
+                  << metrics.mTotalRequestLatency.count() / completed / 1000 << " ms"
+                  << std::endl;
+    }
 }
 
 /*
@@ -0,0 +1,158 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <limits>
+#include "ItemTrackerHTTPHandler.h"
+#include "serverless_aurora_gtests.h"
+
+namespace AwsDocTest {
+    // An RDSDataReceiver which returns generated work items.
+    class GeneratedWorkItems : public AwsDoc::CrossService::RDSDataReceiver {
+    public:
+        explicit GeneratedWorkItems(size_t count) {
+            mWorkItems.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                mWorkItems.emplace_back(std::to_string(100000 + i),
+                                        "Item " + std::to_string(i), "cpp",
+                                        "A generated work item",
+                                        "In Progress", i % 2 == 0);
+            }
+        }
+
+        bool addWorkItem(const AwsDoc::CrossService::WorkItem &) override {
+            return false;
+        }
+
+        bool getWorkItems(AwsDoc::CrossService::WorkItemStatus,
+                          std::vector<AwsDoc::CrossService::WorkItem> &workItems) override {
+            workItems = mWorkItems;
+            return true;
+        }
+
+        bool streamWorkItems(AwsDoc::CrossService::WorkItemStatus, size_t,
+                             const AwsDoc::CrossService::WorkItemHandler &handler) override {
+            for (size_t i = 0; i < mWorkItems.size(); ++i) {
+                if (i == mFailAt) {
+                    return false;
+                }
+                handler(mWorkItems[i]);
+            }
+            return true;
+        }
+
+        bool getWorkItemWithId(const Aws::String &,
+                               AwsDoc::CrossService::WorkItem &) override {
+            return false;
+        }
+
+        bool setWorkItemToArchive(const Aws::String &) override {
+            return false;
+        }
+
+        bool updateWorkItem(const AwsDoc::CrossService::WorkItem &) override {
+            return false;
+        }
+
+        std::vector<AwsDoc::CrossService::WorkItem> mWorkItems;
+        // streamWorkItems fails at this work item, as if a later page failed.
+        size_t mFailAt = std::numeric_limits<size_t>::max();
+    };
+
+    class NoEmail : public AwsDoc::CrossService::SESEmailReceiver {
+    public:
+        bool sendEmail(const Aws::String,
+                       const std::vector<AwsDoc::CrossService::WorkItem> &) override {
+            return false;
+        }
+    };
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, write_work_item_json_3_) {
+        AwsDoc::CrossService::WorkItem workItem("id-1", "Quote \" and \\ backslash",
+                                                "tab\tnewline\n",
+                                                std::string("control \x01 and \x1f") +
+                                                " UTF-8 \xc3\xa9",
+                                                "", true);
+
+        std::stringstream stream;
+        AwsDoc::CrossService::writeWorkItemJson(stream, workItem);
+
+        Aws::Utils::Json::JsonValue jsonValue(stream.str());
+        ASSERT_TRUE(jsonValue.WasParseSuccessful()) << stream.str();
+        Aws::Utils::Json::JsonView view = jsonValue.View();
+        EXPECT_EQ(view.GetString(AwsDoc::CrossService::HTTP_ID_KEY), workItem.mID);
+        EXPECT_EQ(view.GetString(AwsDoc::CrossService::HTTP_NAME_KEY), workItem.mName);
+        EXPECT_EQ(view.GetString(AwsDoc::CrossService::HTTP_GUIDE_KEY), workItem.mGuide);
+        EXPECT_EQ(view.GetString(AwsDoc::CrossService::HTTP_DESCRIPTION_KEY),
+                  workItem.mDescription);
+        EXPECT_EQ(view.GetString(AwsDoc::CrossService::HTTP_STATUS_KEY), workItem.mStatus);
+        EXPECT_TRUE(view.GetBool(AwsDoc::CrossService::HTTP_ARCHIVED_KEY));
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, list_response_3_) {
+        const size_t ITEM_COUNT = 25;
+        GeneratedWorkItems generatedWorkItems(ITEM_COUNT);
+        NoEmail noEmail;
+
+        std::string responseContentType;
+        std::stringstream responseStream;
+        AwsDoc::CrossService::ItemTrackerHTTPHandler listHandler(generatedWorkItems,
+                                                                 noEmail);
+        ASSERT_TRUE(listHandler.handleHTTP("GET", "/api/items", "",
+                                           responseContentType, responseStream));
+        std::string writerResponse = responseStream.str();
+
+        // The streamed response, written in pages, is the same.
+        responseStream.str("");
+        AwsDoc::CrossService::ItemTrackerHTTPHandler streamingHandler(
+                generatedWorkItems, noEmail, 10);
+        ASSERT_TRUE(streamingHandler.handleHTTP("GET", "/api/items", "",
+                                                responseContentType, responseStream));
+        ASSERT_EQ(responseStream.str(), writerResponse);
+
+        Aws::Utils::Json::JsonValue jsonValue(writerResponse);
+        ASSERT_TRUE(jsonValue.WasParseSuccessful()) << writerResponse;
+        Aws::Utils::Array<Aws::Utils::Json::JsonView> items = jsonValue.View().AsArray();
+        ASSERT_EQ(items.GetLength(), ITEM_COUNT);
+        for (size_t i = 0; i < ITEM_COUNT; ++i) {
+            const AwsDoc::CrossService::WorkItem &workItem = generatedWorkItems.mWorkItems[i];
+            EXPECT_EQ(items[i].GetString(AwsDoc::CrossService::HTTP_ID_KEY), workItem.mID);
+            EXPECT_EQ(items[i].GetString(AwsDoc::CrossService::HTTP_NAME_KEY),
+                      workItem.mName);
+            EXPECT_EQ(items[i].GetBool(AwsDoc::CrossService::HTTP_ARCHIVED_KEY),
+                      workItem.mArchived);
+        }
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, list_response_failure_3_) {
+        GeneratedWorkItems generatedWorkItems(25);
+        generatedWorkItems.mFailAt = 15;
+        NoEmail noEmail;
+
+        std::string responseContentType;
+        std::stringstream responseStream;
+        AwsDoc::CrossService::ItemTrackerHTTPHandler streamingHandler(
+                generatedWorkItems, noEmail, 10);
+        EXPECT_FALSE(streamingHandler.handleHTTP("GET", "/api/items", "",
+                                                 responseContentType, responseStream));
+
+        // The items already written are not closed into a valid array.
+        std::string response = responseStream.str();
+        ASSERT_FALSE(response.empty());
+        EXPECT_NE(response.back(), ']');
+        Aws::Utils::Json::JsonValue jsonValue(response);
+        EXPECT_FALSE(jsonValue.WasParseSuccessful());
+    }
+} // namespace AwsDocTest
@@ -10,6 +10,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <aws/core/utils/base64/Base64.h>
 #include "ItemTrackerHTTPHandler.h"
 #include "RDSDataHandler.h"
 #include "SESV2EmailHandler.h"
@@ -233,4 +237,127 @@ namespace AwsDocTest {
                                                   responseContentType, responseStream);
         ASSERT_TRUE(result);
     }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, build_raw_message_3_) {
+        AwsDoc::CrossService::SESV2EmailHandler::Options options;
+        options.mWorkerThreads = 0;
+        Aws::Client::ClientConfiguration clientConfig;
+        AwsDoc::CrossService::SESV2EmailHandler sesEmailHandler("from@example.com",
+                                                               clientConfig, options);
+
+        std::vector<AwsDoc::CrossService::WorkItem> workItems;
+        Aws::String expectedCsv("ID,Name,Guide,Description,Status,Archived\n");
+        for (int i = 0; i < 100; ++i) {
+            Aws::String id = std::to_string(i);
+            Aws::String name(i % 7, 'n');
+            workItems.emplace_back(id, name, "cpp", "Description", "Status", i % 2 == 0);
+            expectedCsv += id + "," + name + ",cpp,Description,Status," +
+                           (i % 2 == 0 ? "yes" : "no") + "\n";
+        }
+
+        Aws::Utils::ByteBuffer buffer = sesEmailHandler.buildRawMessage(
+                "to@example.com", workItems, "today");
+        Aws::String message(reinterpret_cast<const char *>(buffer.GetUnderlyingData()),
+                            buffer.GetLength());
+        ASSERT_EQ(message.find("From: from@example.com\nTo: to@example.com\n"), 0u);
+        ASSERT_NE(message.find("It contains 100 items."), Aws::String::npos);
+
+        const Aws::String attachmentHeader("Content-Disposition: attachment\n\n");
+        size_t start = message.find(attachmentHeader);
+        ASSERT_NE(start, Aws::String::npos);
+        start += attachmentHeader.size();
+        size_t end = message.find("\n--", start);
+        ASSERT_NE(end, Aws::String::npos);
+
+        Aws::String encoded;
+        std::istringstream lines(message.substr(start, end - start));
+        for (Aws::String line; std::getline(lines, line);) {
+            ASSERT_LE(line.size(), 76u);
+            encoded += line;
+        }
+
+        Aws::Utils::Base64::Base64 base64;
+        Aws::Utils::ByteBuffer decoded = base64.Decode(encoded);
+        ASSERT_EQ(Aws::String(reinterpret_cast<const char *>(decoded.GetUnderlyingData()),
+                              decoded.GetLength()), expectedCsv);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, email_queue_full_3_) {
+        MockSESV2Service mockSESV2Service;
+        AwsDoc::CrossService::SESV2EmailHandler::Options options;
+        options.mWorkerThreads = 1;
+        options.mMaxQueued = 2;
+        options.mSendsPerSecond = 0;
+        AwsDoc::CrossService::SESV2EmailHandler sesEmailHandler("from@example.com",
+                                                               *s_clientConfig, options);
+        std::vector<AwsDoc::CrossService::WorkItem> workItems;
+        workItems.emplace_back("0", "name", "cpp", "Description", "Status", false);
+
+        // The worker holds the first email in its SendEmail request, so the next
+        // two emails fill the queue, and the fourth is rejected.
+        mockSESV2Service.holdSendEmail();
+        EXPECT_TRUE(sesEmailHandler.sendEmail("to0@example.com", workItems));
+        EXPECT_TRUE(mockSESV2Service.waitForSendEmail(1, std::chrono::seconds(10)));
+        EXPECT_TRUE(sesEmailHandler.sendEmail("to1@example.com", workItems));
+        EXPECT_TRUE(sesEmailHandler.sendEmail("to2@example.com", workItems));
+        EXPECT_FALSE(sesEmailHandler.sendEmail("to3@example.com", workItems));
+
+        AwsDoc::CrossService::SESV2EmailHandler::Metrics metrics = sesEmailHandler.getMetrics();
+        mockSESV2Service.releaseSendEmail();
+        EXPECT_EQ(metrics.mQueueDepth, 2u);
+        EXPECT_EQ(metrics.mQueued, 3u);
+        EXPECT_EQ(metrics.mRejected, 1u);
+        EXPECT_EQ(metrics.mSent, 0u);
+
+        // The queued emails are sent once SendEmail is released.
+        const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (sesEmailHandler.getMetrics().mSent < 3 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        metrics = sesEmailHandler.getMetrics();
+        EXPECT_EQ(metrics.mQueueDepth, 0u);
+        EXPECT_EQ(metrics.mSent, 3u);
+        EXPECT_EQ(metrics.mFailed, 0u);
+        EXPECT_EQ(metrics.mRejected, 1u);
+        EXPECT_EQ(mockSESV2Service.getSendEmailTimes().size(), 3u);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(ServerlessAurora_GTests, email_send_pacing_3_) {
+        const size_t EMAIL_COUNT = 11;
+        const double SENDS_PER_SECOND = 50.0;
+
+        MockSESV2Service mockSESV2Service;
+        {
+            AwsDoc::CrossService::SESV2EmailHandler::Options options;
+            options.mWorkerThreads = 2;
+            options.mSendsPerSecond = SENDS_PER_SECOND;
+            options.mMaxBurst = 1.0;
+            AwsDoc::CrossService::SESV2EmailHandler sesEmailHandler("from@example.com",
+                                                                   *s_clientConfig,
+                                                                   options);
+            std::vector<AwsDoc::CrossService::WorkItem> workItems;
+            workItems.emplace_back("0", "name", "cpp", "Description", "Status", false);
+            for (size_t i = 0; i < EMAIL_COUNT; ++i) {
+                ASSERT_TRUE(sesEmailHandler.sendEmail("to@example.com", workItems));
+            }
+            // The destructor sends the queued emails.
+        }
+
+        std::vector<std::chrono::steady_clock::time_point> sendTimes =
+                mockSESV2Service.getSendEmailTimes();
+        ASSERT_EQ(sendTimes.size(), EMAIL_COUNT);
+        std::sort(sendTimes.begin(), sendTimes.end());
+
+        // The first email uses the burst token, and each of the others waits
+        // 1 / SENDS_PER_SECOND for a token. At 1 per second, they would take 10 seconds.
+        const double expectedSeconds = (EMAIL_COUNT - 1) / SENDS_PER_SECOND;
+        std::chrono::duration<double> elapsed = sendTimes.back() - sendTimes.front();
+        EXPECT_GE(elapsed.count(), expectedSeconds * 0.9);
+        EXPECT_LT(elapsed.count(), expectedSeconds + 2.0);
+    }
 } // namespace AwsDocTest
\ No newline at end of file
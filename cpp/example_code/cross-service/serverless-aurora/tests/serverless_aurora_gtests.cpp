@@ -19,10 +19,74 @@
 #include <aws/iam/model/CreatePolicyRequest.h>
 #include <aws/iam/model/CreateAccountAliasRequest.h>
 #include <aws/core/utils/UUID.h>
+#include <aws/core/http/standard/StandardHttpResponse.h>
+#include <aws/testing/mocks/http/MockHttpClient.h>
+#include <condition_variable>
+#include <mutex>
+
+static const char ALLOCATION_TAG[] = "SERVERLESS_AURORA_GTEST";
 
 Aws::SDKOptions AwsDocTest::ServerlessAurora_GTests::s_options;
 std::unique_ptr<Aws::Client::ClientConfiguration> AwsDocTest::ServerlessAurora_GTests::s_clientConfig;
 
+/*
+ * Subclass MockHttpClient to generate SendEmail responses, instead of returning
+ * stored responses, so a test can make any number of requests. Other requests,
+ * for example for instance credentials, are answered with NOT_FOUND.
+ */
+class AwsDocTest::SESV2ServiceMockHTTPClient : public MockHttpClient {
+public:
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->AddHeader("Content-Type", "application/json");
+
+        if (request->GetURIString().find("/v2/email/outbound-emails") == Aws::String::npos) {
+            response->SetResponseCode(Aws::Http::HttpResponseCode::NOT_FOUND);
+            return response;
+        }
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSendEmailTimes.push_back(std::chrono::steady_clock::now());
+        size_t messageNumber = mSendEmailTimes.size();
+        mChanged.notify_all();
+        mChanged.wait(lock, [this]() { return !mHolding; });
+
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+        response->GetResponseBody() << R"({"MessageId":"message-)" << messageNumber << "\"}";
+        return response;
+    }
+
+    void setHolding(bool holding) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mHolding = holding;
+        }
+        mChanged.notify_all();
+    }
+
+    bool waitForSendEmail(size_t count, std::chrono::milliseconds timeout) const {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mChanged.wait_for(lock, timeout, [this, count]() {
+            return mSendEmailTimes.size() >= count;
+        });
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> getSendEmailTimes() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSendEmailTimes;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mChanged;
+    bool mHolding = false;
+    mutable std::vector<std::chrono::steady_clock::time_point> mSendEmailTimes;
+};
+
 void AwsDocTest::ServerlessAurora_GTests::SetUpTestSuite() {
     InitAPI(s_options);
 
@@ -72,3 +136,34 @@ bool AwsDocTest::ServerlessAurora_GTests::suppressStdOut() {
     return std::getenv("EXAMPLE_TESTS_LOG_ON") == nullptr;
 }
 
+
+AwsDocTest::MockSESV2Service::MockSESV2Service() {
+    mockHttpClient = Aws::MakeShared<SESV2ServiceMockHTTPClient>(ALLOCATION_TAG);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockSESV2Service::~MockSESV2Service() {
+    mockHttpClient->setHolding(false);
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
+
+void AwsDocTest::MockSESV2Service::holdSendEmail() {
+    mockHttpClient->setHolding(true);
+}
+
+void AwsDocTest::MockSESV2Service::releaseSendEmail() {
+    mockHttpClient->setHolding(false);
+}
+
+bool AwsDocTest::MockSESV2Service::waitForSendEmail(size_t count,
+                                                    std::chrono::milliseconds timeout) const {
+    return mockHttpClient->waitForSendEmail(count, timeout);
+}
+
+std::vector<std::chrono::steady_clock::time_point>
+AwsDocTest::MockSESV2Service::getSendEmailTimes() const {
+    return mockHttpClient->getSendEmailTimes();
+}
@@ -6,10 +6,14 @@
 #define S3_EXAMPLES_S3_GTESTS_H
 
 #include <aws/core/Aws.h>
+#include <chrono>
 #include <memory>
+#include <vector>
 #include <gtest/gtest.h>
 #include "ItemTrackerHTTPHandler.h"
 
+class MockHttpClientFactory;
+
 namespace AwsDocTest {
 
     class ServerlessAurora_GTests : public testing::Test {
@@ -41,6 +45,36 @@ namespace AwsDocTest {
         std::stringbuf m_coutBuffer;  // Used to silence std::cout.
         std::streambuf *m_savedBuffer = nullptr;
     };
+
+    class SESV2ServiceMockHTTPClient;
+
+    /*
+     * A mock Amazon SES service, for tests of the email queue. SendEmail succeeds,
+     * and the time of each request is recorded. While SendEmail is held, the
+     * requests wait until it is released, so a test can fill the queue.
+     */
+    class MockSESV2Service {
+    public:
+        MockSESV2Service();
+
+        virtual ~MockSESV2Service();
+
+        // Makes later SendEmail requests wait until releaseSendEmail is called.
+        void holdSendEmail();
+
+        void releaseSendEmail();
+
+        // Returns true when count SendEmail requests were received before the timeout.
+        bool waitForSendEmail(size_t count, std::chrono::milliseconds timeout) const;
+
+        // The times at which the SendEmail requests were received, in order.
+        std::vector<std::chrono::steady_clock::time_point> getSendEmailTimes() const;
+
+    private:
+
+        std::shared_ptr<SESV2ServiceMockHTTPClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockSESV2Service
 } // AwsDocTest
 
 #endif //S3_EXAMPLES_S3_GTESTS_H
@@ -39,10 +39,12 @@
 #include <aws/sqs/model/DeleteMessageBatchRequest.h>
 #include <aws/sqs/model/DeleteQueueRequest.h>
 #include <aws/sqs/model/GetQueueAttributesRequest.h>
-#include <aws/sqs/model/ReceiveMessageRequest.h>
 #include <aws/sqs/model/SetQueueAttributesRequest.h>
 #include <aws/sqs/SQSClient.h>
+#include <algorithm>
 #include <iomanip>
+#include <mutex>
+#include "awsdoc/sqs_message_consumer.h"
 #include "topics_and_queues_samples.h"
 
 namespace AwsDoc {
@@ -580,46 +582,29 @@ bool AwsDoc::TopicsAndQueues::messagingWithTopicsAndQueues(
 
     for (size_t i = 0; i < queueURLS.size(); ++i) {
         // 7.  Poll an SQS queue for its messages.
+        // The consumer long polls the queue with several receivers. The handler
+        // keeps each message's receipt handle, and returns false so that the
+        // messages are deleted below with DeleteMessageBatch.
+        std::mutex messagesMutex;
         std::vector<Aws::String> messages;
         std::vector<Aws::String> receiptHandles;
-        while (true) {
-            Aws::SQS::Model::ReceiveMessageRequest request;
-            request.SetMaxNumberOfMessages(10);
-            request.SetQueueUrl(queueURLS[i]);
-
-            // Setting WaitTimeSeconds to non-zero enables long polling.
-            // For information about long polling, see
-            // https://docs.aws.amazon.com/AWSSimpleQueueService/latest/SQSDeveloperGuide/sqs-short-and-long-polling.html
-            request.SetWaitTimeSeconds(1);
-            Aws::SQS::Model::ReceiveMessageOutcome outcome =
-                    sqsClient.ReceiveMessage(request);
-
-            if (outcome.IsSuccess()) {
-                const Aws::Vector<Aws::SQS::Model::Message> &newMessages = outcome.GetResult().GetMessages();
-                if (newMessages.empty()) {
-                    break;
-                }
-                else {
-                    for (const Aws::SQS::Model::Message &message: newMessages) {
-                        messages.push_back(message.GetBody());
-                        receiptHandles.push_back(message.GetReceiptHandle());
-                    }
-                }
-            }
-            else {
-                std::cerr << "Error with SQS::ReceiveMessage. "
-                          << outcome.GetError().GetMessage()
-                          << std::endl;
-
-                cleanUp(topicARN,
-                        queueURLS,
-                        subscriptionARNS,
-                        snsClient,
-                        sqsClient);
-
-                return false;
-            }
-        }
+        AwsDoc::SQS::MessageConsumer::Options options;
+        // Setting WaitTimeSeconds to non-zero enables long polling.
+        // For information about long polling, see
+        // https://docs.aws.amazon.com/AWSSimpleQueueService/latest/SQSDeveloperGuide/sqs-short-and-long-polling.html
+        options.mWaitTimeSeconds = 1;
+        options.mStopWhenEmpty = true;
+        AwsDoc::SQS::MessageConsumer consumer(
+                sqsClient, queueURLS[i],
+                [&messagesMutex, &messages, &receiptHandles](
+                        const Aws::SQS::Model::Message &message) {
+                    std::lock_guard<std::mutex> lock(messagesMutex);
+                    messages.push_back(message.GetBody());
+                    receiptHandles.push_back(message.GetReceiptHandle());
+                    return false;
+                }, options);
+        consumer.start();
+        consumer.wait();
 
         printAsterisksLine();
 
@@ -640,16 +625,20 @@ bool AwsDoc::TopicsAndQueues::messagingWithTopicsAndQueues(
         }
 
         // 8.  Delete a batch of messages from an SQS queue.
-        if (!receiptHandles.empty()) {
+        // A DeleteMessageBatch request accepts up to 10 entries.
+        for (size_t begin = 0; begin < receiptHandles.size();
+             begin += AwsDoc::SQS::MessageConsumer::MAX_BATCH_ENTRIES) {
+            const size_t end = std::min(receiptHandles.size(),
+                                        begin + AwsDoc::SQS::MessageConsumer::MAX_BATCH_ENTRIES);
             // snippet-start:[cpp.example_code.cross-service.topics_and_queues.sqs.DeleteMessageBatch]
             Aws::SQS::Model::DeleteMessageBatchRequest request;
             request.SetQueueUrl(queueURLS[i]);
             int id = 1; // Ids must be unique within a batch delete request.
-            for (const Aws::String &receiptHandle: receiptHandles) {
+            for (size_t j = begin; j < end; ++j) {
                 Aws::SQS::Model::DeleteMessageBatchRequestEntry entry;
                 entry.SetId(std::to_string(id));
                 ++id;
-                entry.SetReceiptHandle(receiptHandle);
+                entry.SetReceiptHandle(receiptHandles[j]);
                 request.AddEntries(entry);
             }
 
@@ -16,9 +16,12 @@
 #include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/AttributeDefinition.h>
 #include <dynamodb/model/BatchWriteItemRequest.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include "dynamodb_samples.h"
+#include "dynamodb_batch_writer.h"
 
 namespace AwsDoc {
     namespace DynamoDB {
@@ -65,6 +68,10 @@ namespace AwsDoc {
  * their input.
  *
  * This is perhaps an artificial example, but it demonstrates the APIs.
+ *
+ * The requests are written with a BatchWriter, which splits them into batches
+ * within the BatchWriteItem limits, sends the batches concurrently, and retries
+ * unprocessed items.
  */
 
 bool AwsDoc::DynamoDB::batchWriteItem(const Aws::String &jsonFilePath,
@@ -74,13 +81,17 @@ bool AwsDoc::DynamoDB::batchWriteItem(const Aws::String &jsonFilePath,
     if (!fileStream) {
         std::cerr << "Error: could not open file '" << jsonFilePath << "'."
                   << std::endl;
+        return false;
     }
 
     std::stringstream stringStream;
     stringStream << fileStream.rdbuf();
     Aws::Utils::Json::JsonValue jsonValue(stringStream);
 
-    Aws::DynamoDB::Model::BatchWriteItemRequest batchWriteItemRequest;
+    Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration);
+    BatchWriter batchWriter(dynamoClient);
+    auto start = std::chrono::steady_clock::now();
+
     Aws::Map<Aws::String, Aws::Utils::Json::JsonView> level1Map = jsonValue.View().GetAllObjects();
     for (const auto &level1Entry: level1Map) {
         const Aws::Utils::Json::JsonView &entriesView = level1Entry.second;
@@ -99,25 +110,32 @@ bool AwsDoc::DynamoDB::batchWriteItem(const Aws::String &jsonFilePath,
         Aws::Vector<Aws::DynamoDB::Model::WriteRequest> writeRequests;
         if (AwsDoc::DynamoDB::addWriteRequests(tableName, entries,
                                                writeRequests)) {
-            batchWriteItemRequest.AddRequestItems(tableName, writeRequests);
+            for (const Aws::DynamoDB::Model::WriteRequest &writeRequest: writeRequests) {
+                batchWriter.push(tableName, writeRequest);
+            }
         }
     }
 
-    Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration);
+    bool result = batchWriter.flush();
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    BatchWriter::Counters counters = batchWriter.getCounters();
 
-    Aws::DynamoDB::Model::BatchWriteItemOutcome outcome = dynamoClient.BatchWriteItem(
-            batchWriteItemRequest);
-
-    if (outcome.IsSuccess()) {
+    if (result) {
         std::cout << "DynamoDB::BatchWriteItem was successful." << std::endl;
     }
     else {
-        std::cerr << "Error with DynamoDB::BatchWriteItem. "
-                  << outcome.GetError().GetMessage()
-                  << std::endl;
+        std::cerr << "Error with DynamoDB::BatchWriteItem. " << counters.mItemsFailed
+                  << " items were not written." << std::endl;
     }
 
-    return true;
+    std::cout << counters.mItemsWritten << " items were written in "
+              << counters.mBatchesSent << " batches ("
+              << counters.mItemsWritten / std::max(seconds.count(), 0.001)
+              << " items/sec). " << counters.mThrottledBatches
+              << " batches were throttled and " << counters.mRetriedItems
+              << " items were retried." << std::endl;
+
+    return result;
 }
 
 //! Convert requests in JSON format to a vector of WriteRequest objects.
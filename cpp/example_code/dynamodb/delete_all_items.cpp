@@ -0,0 +1,195 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Before running this C++ code example, set up your development environment, including your credentials.
+ *
+ * For more information, see the following documentation topic:
+ *
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started.html
+ *
+ * For information on the structure of the code examples and how to build and run the examples, see
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started-code-examples.html.
+ *
+ **/
+
+#include <aws/core/Aws.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/DynamoDBErrors.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
+#include <aws/dynamodb/model/DeleteRequest.h>
+#include <aws/dynamodb/model/DescribeTableRequest.h>
+#include <aws/dynamodb/model/ScanRequest.h>
+#include <aws/dynamodb/model/WriteRequest.h>
+#include <algorithm>
+#include <iostream>
+#include "awsdoc/bulk_deleter.h"
+#include "dynamodb_samples.h"
+#include "dynamodb_parallel_scan.h"
+
+// snippet-start:[cpp.example_code.dynamodb.delete_all_items]
+//! Delete all the items in an Amazon DynamoDB table.
+/*!
+  The table is scanned in parallel segments for the key attributes, and the
+  items are deleted with concurrent BatchWriteItem requests of up to 25 delete
+  requests while the scan is running. Unprocessed items are retried.
+  \sa deleteAllItems()
+  \param tableName: The table name.
+  \param maxConcurrency: The most BatchWriteItem requests sent at the same time.
+  \param clientConfiguration: AWS client configuration.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::DynamoDB::deleteAllItems(const Aws::String &tableName,
+                                      size_t maxConcurrency,
+                                      const Aws::Client::ClientConfiguration &clientConfiguration) {
+    // BatchWriteItem accepts up to 25 requests.
+    const size_t MAX_BATCH_ITEMS = 25;
+    const int TOTAL_SEGMENTS = 4;
+
+    Aws::Client::ClientConfiguration clientConfiguration1(clientConfiguration);
+    // Allow one connection for each batch and each scan segment.
+    clientConfiguration1.maxConnections = std::max<unsigned>(
+            clientConfiguration1.maxConnections,
+            static_cast<unsigned>(maxConcurrency + TOTAL_SEGMENTS));
+    Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration1);
+
+    // Only the key attributes are needed to delete an item.
+    Aws::DynamoDB::Model::DescribeTableRequest describeRequest;
+    describeRequest.SetTableName(tableName);
+    const Aws::DynamoDB::Model::DescribeTableOutcome &describeOutcome =
+            dynamoClient.DescribeTable(describeRequest);
+    if (!describeOutcome.IsSuccess()) {
+        std::cerr << "Failed to describe table: "
+                  << describeOutcome.GetError().GetMessage() << std::endl;
+        return false;
+    }
+
+    Aws::DynamoDB::Model::ScanRequest scanRequest;
+    scanRequest.SetTableName(tableName);
+    Aws::String projectionExpression;
+    int keyIndex = 0;
+    for (const Aws::DynamoDB::Model::KeySchemaElement &keyElement:
+            describeOutcome.GetResult().GetTable().GetKeySchema()) {
+        // Placeholders allow key names which are reserved words, such as "year".
+        Aws::String placeholder = "#k" + Aws::Utils::StringUtils::to_string(keyIndex++);
+        scanRequest.AddExpressionAttributeNames(placeholder,
+                                                keyElement.GetAttributeName());
+        if (!projectionExpression.empty()) {
+            projectionExpression += ", ";
+        }
+        projectionExpression += placeholder;
+    }
+    scanRequest.SetProjectionExpression(projectionExpression);
+
+    BulkDeleterOptions options;
+    options.mMaxConcurrency = maxConcurrency;
+    options.mBatchSize = MAX_BATCH_ITEMS;
+    options.mResourceName = "items";
+
+    BulkDeleter<ScanItem> deleter(
+            [&dynamoClient, &tableName](const std::vector<ScanItem> &keys) {
+                BulkDeleteResult<ScanItem> result;
+
+                Aws::Vector<Aws::DynamoDB::Model::WriteRequest> writeRequests;
+                for (const ScanItem &key: keys) {
+                    writeRequests.push_back(Aws::DynamoDB::Model::WriteRequest().WithDeleteRequest(
+                            Aws::DynamoDB::Model::DeleteRequest().WithKey(key)));
+                }
+                Aws::DynamoDB::Model::BatchWriteItemRequest request;
+                request.AddRequestItems(tableName, writeRequests);
+
+                Aws::DynamoDB::Model::BatchWriteItemOutcome outcome =
+                        dynamoClient.BatchWriteItem(request);
+                if (!outcome.IsSuccess()) {
+                    const Aws::DynamoDB::DynamoDBError &error = outcome.GetError();
+                    bool throttled = error.GetErrorType() ==
+                                     Aws::DynamoDB::DynamoDBErrors::PROVISIONED_THROUGHPUT_EXCEEDED ||
+                                     isThrottlingError(error);
+                    if (throttled || error.ShouldRetry()) {
+                        result.mRetryKeys = keys;
+                        result.mThrottled = throttled;
+                    }
+                    else {
+                        std::cerr << "Error with DynamoDB::BatchWriteItem. "
+                                  << error.GetMessage() << std::endl;
+                        result.mFailed = keys.size();
+                    }
+                    return result;
+                }
+
+                // Items are returned unprocessed when the table's throughput is exceeded.
+                const auto &unprocessed = outcome.GetResult().GetUnprocessedItems();
+                auto tableRequests = unprocessed.find(tableName);
+                if (tableRequests != unprocessed.end()) {
+                    for (const Aws::DynamoDB::Model::WriteRequest &writeRequest:
+                            tableRequests->second) {
+                        result.mRetryKeys.push_back(writeRequest.GetDeleteRequest().GetKey());
+                    }
+                    result.mThrottled = !result.mRetryKeys.empty();
+                }
+                return result;
+            }, options);
+
+    CallbackScanSink sink([&deleter](int /*segment*/, const ScanItem &item) {
+        deleter.push(item);
+        return true;
+    });
+    ParallelScanOptions scanOptions;
+    scanOptions.mTotalSegments = TOTAL_SEGMENTS;
+    Aws::Vector<SegmentStats> segmentStats;
+    bool result = parallelScan(dynamoClient, scanRequest, scanOptions, sink,
+                               segmentStats);
+
+    result &= deleter.finish();
+    deleter.printSummary(std::cout);
+
+    return result;
+}
+// snippet-end:[cpp.example_code.dynamodb.delete_all_items]
+
+/*
+ *
+ *  main function
+ *
+ *  Usage: 'run_delete_all_items <table_name> [max_concurrency]'
+ *
+ *  Prerequisites: Create a DynamoDB table named <table_name>.
+ *
+ */
+
+#ifndef TESTING_BUILD
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        std::cout << R"(
+Usage:
+    run_delete_all_items <table_name> [max_concurrency]
+Where:
+    table_name - The table to delete the items from.
+    max_concurrency - The most BatchWriteItem requests sent at the same time (default 8).
+Example:
+    run_delete_all_items HelloTable
+**Warning** This program will actually delete every item
+            in the table!)";
+        return 1;
+    }
+
+    Aws::SDKOptions options;
+
+    Aws::InitAPI(options);
+    {
+        const Aws::String tableName = (argv[1]);
+        size_t maxConcurrency = argc > 2 ? std::stoul(argv[2]) : 8;
+
+        Aws::Client::ClientConfiguration clientConfig;
+        // Optional: Set to the AWS Region (overrides config file).
+        // clientConfig.region = "us-east-1";
+
+        AwsDoc::DynamoDB::deleteAllItems(tableName, maxConcurrency, clientConfig);
+    }
+    Aws::ShutdownAPI(options);
+    return 0;
+}
+
+#endif // TESTING_BUILD
@@ -0,0 +1,223 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ *
+ * Purpose
+ *
+ * A writer which groups DynamoDB write requests into BatchWriteItem calls,
+ * used by multiple applications.
+ *
+ */
+
+#include "dynamodb_batch_writer.h"
+#include <aws/dynamodb/DynamoDBErrors.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
+#include <algorithm>
+#include <iostream>
+
+//! BatchWriter constructor.
+/*!
+  \param dynamoClient: A DynamoDB client. It must outlive the writer.
+  \param dispatchThreads: The number of batches sent at the same time.
+  \param maxRetries: The number of times a request is retried before it fails.
+ */
+AwsDoc::DynamoDB::BatchWriter::BatchWriter(
+        const Aws::DynamoDB::DynamoDBClient &dynamoClient, size_t dispatchThreads,
+        int maxRetries) :
+        mDynamoClient(dynamoClient), mMaxRetries(maxRetries),
+        mMaxPending(MAX_BATCH_ITEMS * std::max<size_t>(dispatchThreads, 1) * 4),
+        mItemsWritten(0), mItemsFailed(0), mBatchesSent(0), mThrottledBatches(0),
+        mRetriedItems(0), mRandom(std::random_device()()) {
+    for (size_t i = 0; i < std::max<size_t>(dispatchThreads, 1); ++i) {
+        mThreads.emplace_back(&BatchWriter::dispatchLoop, this);
+    }
+}
+
+//! BatchWriter destructor. Waits for pushed requests to be written.
+AwsDoc::DynamoDB::BatchWriter::~BatchWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+    for (std::thread &thread: mThreads) {
+        thread.join();
+    }
+}
+
+//! Queue a write request. This routine is thread safe.
+/*!
+  \sa push()
+  \param tableName: The table for the request.
+  \param writeRequest: A put or delete request.
+  \return void:
+ */
+void AwsDoc::DynamoDB::BatchWriter::push(const Aws::String &tableName,
+                                         const Aws::DynamoDB::Model::WriteRequest &writeRequest) {
+    PendingRequest pendingRequest;
+    pendingRequest.mTableName = tableName;
+    pendingRequest.mWriteRequest = writeRequest;
+    // The serialized size counts toward the 16 MB request limit.
+    pendingRequest.mBytes = writeRequest.Jsonize().View().WriteCompact().size() +
+                            tableName.size();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSpaceAvailable.wait(lock, [this] { return mPending.size() < mMaxPending; });
+    mPendingBytes += pendingRequest.mBytes;
+    mPending.push_back(std::move(pendingRequest));
+    if (mPending.size() >= MAX_BATCH_ITEMS || mPendingBytes >= MAX_BATCH_BYTES ||
+        mFlushRequests > 0) {
+        mWorkAvailable.notify_one();
+    }
+}
+
+//! Wait until all requests pushed so far have been written or have failed.
+/*!
+  \sa flush()
+  \return bool: True if no request has failed.
+ */
+bool AwsDoc::DynamoDB::BatchWriter::flush() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    // While a flush is waiting, partial batches are sent instead of waiting for
+    // more requests.
+    ++mFlushRequests;
+    mWorkAvailable.notify_all();
+    mIdle.wait(lock, [this] { return mPending.empty() && mBatchesInFlight == 0; });
+    --mFlushRequests;
+
+    return mItemsFailed == 0;
+}
+
+//! Return a snapshot of the counters.
+/*!
+  \sa getCounters()
+  \return Counters: The counters.
+ */
+AwsDoc::DynamoDB::BatchWriter::Counters
+AwsDoc::DynamoDB::BatchWriter::getCounters() const {
+    Counters counters;
+    counters.mItemsWritten = mItemsWritten;
+    counters.mItemsFailed = mItemsFailed;
+    counters.mBatchesSent = mBatchesSent;
+    counters.mThrottledBatches = mThrottledBatches;
+    counters.mRetriedItems = mRetriedItems;
+
+    return counters;
+}
+
+void AwsDoc::DynamoDB::BatchWriter::dispatchLoop() {
+    std::vector<PendingRequest> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [this] {
+                return mStopping || mPending.size() >= MAX_BATCH_ITEMS ||
+                       mPendingBytes >= MAX_BATCH_BYTES ||
+                       (mFlushRequests > 0 && !mPending.empty());
+            });
+            if (mPending.empty()) {
+                return;  // Stopping.
+            }
+
+            size_t batchBytes = 0;
+            while (!mPending.empty() && batch.size() < MAX_BATCH_ITEMS &&
+                   (batch.empty() ||
+                    batchBytes + mPending.front().mBytes <= MAX_BATCH_BYTES)) {
+                batchBytes += mPending.front().mBytes;
+                mPendingBytes -= mPending.front().mBytes;
+                batch.push_back(std::move(mPending.front()));
+                mPending.pop_front();
+            }
+            ++mBatchesInFlight;
+        }
+        mSpaceAvailable.notify_all();
+
+        writeBatch(batch);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mBatchesInFlight;
+            if (mPending.empty() && mBatchesInFlight == 0) {
+                mIdle.notify_all();
+            }
+        }
+    }
+}
+
+void AwsDoc::DynamoDB::BatchWriter::writeBatch(std::vector<PendingRequest> &batch) {
+    Aws::Map<Aws::String, Aws::Vector<Aws::DynamoDB::Model::WriteRequest>> requestItems;
+    for (PendingRequest &pendingRequest: batch) {
+        requestItems[pendingRequest.mTableName].push_back(
+                std::move(pendingRequest.mWriteRequest));
+    }
+
+    for (int attempt = 0; !requestItems.empty(); ++attempt) {
+        size_t itemCount = 0;
+        for (const auto &tableRequests: requestItems) {
+            itemCount += tableRequests.second.size();
+        }
+
+        if (attempt > mMaxRetries) {
+            std::cerr << "Error: BatchWriter gave up on " << itemCount
+                      << " items after " << mMaxRetries << " retries." << std::endl;
+            mItemsFailed += itemCount;
+            return;
+        }
+
+        if (attempt > 0) {
+            std::this_thread::sleep_for(backoffDelay(attempt));
+        }
+
+        Aws::DynamoDB::Model::BatchWriteItemRequest request;
+        request.SetRequestItems(requestItems);
+        Aws::DynamoDB::Model::BatchWriteItemOutcome outcome =
+                mDynamoClient.BatchWriteItem(request);
+        ++mBatchesSent;
+
+        if (!outcome.IsSuccess()) {
+            const Aws::DynamoDB::DynamoDBError &error = outcome.GetError();
+            if (error.GetErrorType() ==
+                Aws::DynamoDB::DynamoDBErrors::PROVISIONED_THROUGHPUT_EXCEEDED ||
+                error.ShouldRetry()) {
+                ++mThrottledBatches;
+                mRetriedItems += itemCount;
+                continue;
+            }
+
+            std::cerr << "Error with DynamoDB::BatchWriteItem. "
+                      << error.GetMessage() << std::endl;
+            mItemsFailed += itemCount;
+            return;
+        }
+
+        // Only the unprocessed items are sent again.
+        const Aws::Map<Aws::String, Aws::Vector<Aws::DynamoDB::Model::WriteRequest>> &unprocessed =
+                outcome.GetResult().GetUnprocessedItems();
+        size_t unprocessedCount = 0;
+        for (const auto &tableRequests: unprocessed) {
+            unprocessedCount += tableRequests.second.size();
+        }
+
+        mItemsWritten += itemCount - unprocessedCount;
+        if (unprocessedCount > 0) {
+            ++mThrottledBatches;
+            mRetriedItems += unprocessedCount;
+        }
+
+        requestItems = unprocessed;
+    }
+}
+
+std::chrono::milliseconds AwsDoc::DynamoDB::BatchWriter::backoffDelay(int attempt) {
+    // Full jitter: a random delay up to an exponentially growing cap.
+    const int BASE_DELAY_MS = 50;
+    const int MAX_DELAY_MS = 5000;
+    int cap = std::min(MAX_DELAY_MS, BASE_DELAY_MS << std::min(attempt, 10));
+
+    std::lock_guard<std::mutex> lock(mRandomMutex);
+    std::uniform_int_distribution<int> distribution(BASE_DELAY_MS / 2, cap);
+    return std::chrono::milliseconds(distribution(mRandom));
+}
@@ -0,0 +1,131 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DYNAMODB_EXAMPLES_DYNAMODB_BATCH_WRITER_H
+#define DYNAMODB_EXAMPLES_DYNAMODB_BATCH_WRITER_H
+
+#include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/model/WriteRequest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace AwsDoc {
+    namespace DynamoDB {
+        /**
+         * A writer which groups write requests into BatchWriteItem calls.
+         *
+         * Requests can be pushed from any number of threads. They are grouped into
+         * batches within the BatchWriteItem limits of 25 requests and 16 MB, and the
+         * batches are sent by a fixed number of dispatch threads. Unprocessed items
+         * returned by DynamoDB, and batches rejected for throttling, are retried
+         * with jittered exponential backoff.
+         */
+        class BatchWriter {
+        public:
+            // BatchWriteItem limits.
+            static const size_t MAX_BATCH_ITEMS = 25;
+            static const size_t MAX_BATCH_BYTES = 16 * 1024 * 1024;
+
+            // Counters describing the work done by a BatchWriter.
+            struct Counters {
+                uint64_t mItemsWritten = 0;
+                uint64_t mItemsFailed = 0;
+                uint64_t mBatchesSent = 0;
+                // Calls which returned unprocessed items or a throttling error.
+                uint64_t mThrottledBatches = 0;
+                // Items sent again after being returned unprocessed.
+                uint64_t mRetriedItems = 0;
+            };
+
+            //! BatchWriter constructor.
+            /*!
+              \param dynamoClient: A DynamoDB client. It must outlive the writer.
+              \param dispatchThreads: The number of batches sent at the same time.
+              \param maxRetries: The number of times a request is retried before it fails.
+             */
+            explicit BatchWriter(const Aws::DynamoDB::DynamoDBClient &dynamoClient,
+                                 size_t dispatchThreads = 4,
+                                 int maxRetries = 10);
+
+            //! BatchWriter destructor. Waits for pushed requests to be written.
+            ~BatchWriter();
+
+            BatchWriter(const BatchWriter &) = delete;
+
+            BatchWriter &operator=(const BatchWriter &) = delete;
+
+            //! Queue a write request. This routine is thread safe.
+            /*!
+              Waits while many requests are queued, so that producers cannot run
+              far ahead of DynamoDB.
+              \sa push()
+              \param tableName: The table for the request.
+              \param writeRequest: A put or delete request.
+              \return void:
+             */
+            void push(const Aws::String &tableName,
+                      const Aws::DynamoDB::Model::WriteRequest &writeRequest);
+
+            //! Wait until all requests pushed so far have been written or have failed.
+            /*!
+              \sa flush()
+              \return bool: True if no request has failed.
+             */
+            bool flush();
+
+            //! Return a snapshot of the counters.
+            /*!
+              \sa getCounters()
+              \return Counters: The counters.
+             */
+            Counters getCounters() const;
+
+        private:
+            struct PendingRequest {
+                Aws::String mTableName;
+                Aws::DynamoDB::Model::WriteRequest mWriteRequest;
+                size_t mBytes = 0;
+            };
+
+            void dispatchLoop();
+
+            void writeBatch(std::vector<PendingRequest> &batch);
+
+            std::chrono::milliseconds backoffDelay(int attempt);
+
+            const Aws::DynamoDB::DynamoDBClient &mDynamoClient;
+            const int mMaxRetries;
+            const size_t mMaxPending;
+
+            mutable std::mutex mMutex;
+            std::condition_variable mWorkAvailable;
+            std::condition_variable mSpaceAvailable;
+            std::condition_variable mIdle;
+            std::deque<PendingRequest> mPending;
+            size_t mPendingBytes = 0;
+            size_t mBatchesInFlight = 0;
+            size_t mFlushRequests = 0;
+            bool mStopping = false;
+
+            std::atomic<uint64_t> mItemsWritten;
+            std::atomic<uint64_t> mItemsFailed;
+            std::atomic<uint64_t> mBatchesSent;
+            std::atomic<uint64_t> mThrottledBatches;
+            std::atomic<uint64_t> mRetriedItems;
+
+            std::mutex mRandomMutex;
+            std::mt19937 mRandom;
+
+            std::vector<std::thread> mThreads;
+        };
+    } // DynamoDB
+} // AwsDoc
+
+#endif //DYNAMODB_EXAMPLES_DYNAMODB_BATCH_WRITER_H
@@ -0,0 +1,418 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ *
+ * Purpose
+ *
+ * A parallel segmented scan, and sinks for the scanned items,
+ * used by multiple applications.
+ *
+ */
+
+#include "dynamodb_parallel_scan.h"
+#include <aws/core/utils/HashingUtils.h>
+#include <aws/dynamodb/model/ConsumedCapacity.h>
+#include <aws/dynamodb/model/ReturnConsumedCapacity.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    void writeJsonString(const Aws::String &value, std::ostream &stream) {
+        static const char HEX_DIGITS[] = "0123456789abcdef";
+        stream << '"';
+        for (char character: value) {
+            switch (character) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+                case '\\':
+                    stream << "\\\\";
+                    break;
+                case '\n':
+                    stream << "\\n";
+                    break;
+                case '\r':
+                    stream << "\\r";
+                    break;
+                case '\t':
+                    stream << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(character) < 0x20) {
+                        stream << "\\u00" << HEX_DIGITS[(character >> 4) & 0xf]
+                               << HEX_DIGITS[character & 0xf];
+                    }
+                    else {
+                        stream << character;
+                    }
+            }
+        }
+        stream << '"';
+    }
+
+    void writeJsonObject(const AwsDoc::DynamoDB::ScanItem &item, std::ostream &stream) {
+        stream << '{';
+        bool first = true;
+        for (const auto &attribute: item) {
+            if (!first) {
+                stream << ',';
+            }
+            first = false;
+            writeJsonString(attribute.first, stream);
+            stream << ':';
+            AwsDoc::DynamoDB::writeAttributeValueJson(attribute.second, stream);
+        }
+        stream << '}';
+    }
+} // namespace
+
+//! Routine which writes an attribute value as plain JSON.
+/*!
+  \sa writeAttributeValueJson()
+  \param attributeValue: The attribute value.
+  \param stream: The output stream.
+  \return void:
+ */
+void AwsDoc::DynamoDB::writeAttributeValueJson(
+        const Aws::DynamoDB::Model::AttributeValue &attributeValue,
+        std::ostream &stream) {
+    using Aws::DynamoDB::Model::ValueType;
+    switch (attributeValue.GetType()) {
+        case ValueType::STRING:
+            writeJsonString(attributeValue.GetS(), stream);
+            break;
+        case ValueType::NUMBER:
+            // DynamoDB numbers are decimal strings, which are valid JSON numbers.
+            stream << attributeValue.GetN();
+            break;
+        case ValueType::BYTEBUFFER:
+            writeJsonString(Aws::Utils::HashingUtils::Base64Encode(attributeValue.GetB()),
+                            stream);
+            break;
+        case ValueType::STRING_SET: {
+            const char *separator = "";
+            stream << '[';
+            for (const Aws::String &value: attributeValue.GetSS()) {
+                stream << separator;
+                writeJsonString(value, stream);
+                separator = ",";
+            }
+            stream << ']';
+            break;
+        }
+        case ValueType::NUMBER_SET: {
+            const char *separator = "";
+            stream << '[';
+            for (const Aws::String &value: attributeValue.GetNS()) {
+                stream << separator << value;
+                separator = ",";
+            }
+            stream << ']';
+            break;
+        }
+        case ValueType::BYTEBUFFER_SET: {
+            const char *separator = "";
+            stream << '[';
+            for (const Aws::Utils::ByteBuffer &value: attributeValue.GetBS()) {
+                stream << separator;
+                writeJsonString(Aws::Utils::HashingUtils::Base64Encode(value), stream);
+                separator = ",";
+            }
+            stream << ']';
+            break;
+        }
+        case ValueType::ATTRIBUTE_MAP: {
+            const char *separator = "";
+            stream << '{';
+            for (const auto &entry: attributeValue.GetM()) {
+                stream << separator;
+                writeJsonString(entry.first, stream);
+                stream << ':';
+                writeAttributeValueJson(*entry.second, stream);
+                separator = ",";
+            }
+            stream << '}';
+            break;
+        }
+        case ValueType::ATTRIBUTE_LIST: {
+            const char *separator = "";
+            stream << '[';
+            for (const auto &value: attributeValue.GetL()) {
+                stream << separator;
+                writeAttributeValueJson(*value, stream);
+                separator = ",";
+            }
+            stream << ']';
+            break;
+        }
+        case ValueType::BOOL:
+            stream << (attributeValue.GetBool() ? "true" : "false");
+            break;
+        case ValueType::NULLVALUE:
+        default:
+            stream << "null";
+            break;
+    }
+}
+
+//! Routine which formats an attribute value for display.
+/*!
+  \sa attributeValueToString()
+  \param attributeValue: The attribute value.
+  \return Aws::String: The formatted value.
+ */
+Aws::String AwsDoc::DynamoDB::attributeValueToString(
+        const Aws::DynamoDB::Model::AttributeValue &attributeValue) {
+    switch (attributeValue.GetType()) {
+        case Aws::DynamoDB::Model::ValueType::STRING:
+            return attributeValue.GetS();
+        case Aws::DynamoDB::Model::ValueType::NUMBER:
+            return attributeValue.GetN();
+        default: {
+            Aws::StringStream stream;
+            writeAttributeValueJson(attributeValue, stream);
+            return stream.str();
+        }
+    }
+}
+
+bool AwsDoc::DynamoDB::CallbackScanSink::consume(int segment,
+                                                 const Aws::Vector<ScanItem> &items) {
+    for (const ScanItem &item: items) {
+        if (!mCallback(segment, item)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AwsDoc::DynamoDB::QueueScanSink::consume(int /*segment*/,
+                                              const Aws::Vector<ScanItem> &items) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (const ScanItem &item: items) {
+        mNotFull.wait(lock, [this] {
+            return mCancelled || mItems.size() < mCapacity;
+        });
+        if (mCancelled) {
+            return false;
+        }
+
+        mItems.push_back(item);
+        mNotEmpty.notify_one();
+    }
+
+    return true;
+}
+
+void AwsDoc::DynamoDB::QueueScanSink::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+    }
+    mNotEmpty.notify_all();
+}
+
+bool AwsDoc::DynamoDB::QueueScanSink::pop(ScanItem &item) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mNotEmpty.wait(lock, [this] { return mClosed || !mItems.empty(); });
+    if (mItems.empty()) {
+        return false;
+    }
+
+    item = std::move(mItems.front());
+    mItems.pop_front();
+    mNotFull.notify_one();
+    return true;
+}
+
+void AwsDoc::DynamoDB::QueueScanSink::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCancelled = true;
+        mItems.clear();
+    }
+    mNotFull.notify_all();
+}
+
+//! FileScanSink constructor.
+/*!
+  \param stream: The output stream. It must outlive the sink.
+  \param format: The output format.
+  \param columns: The CSV columns. If empty, the attribute names of the
+                  first item are used. Ignored for NDJSON.
+ */
+AwsDoc::DynamoDB::FileScanSink::FileScanSink(std::ostream &stream, Format format,
+                                             const Aws::Vector<Aws::String> &columns) :
+        mStream(stream), mFormat(format), mColumns(columns) {
+}
+
+bool AwsDoc::DynamoDB::FileScanSink::consume(int /*segment*/,
+                                             const Aws::Vector<ScanItem> &items) {
+    if (items.empty()) {
+        return true;
+    }
+
+    Aws::StringStream text;
+    if (mFormat == CSV) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mHeaderWritten) {
+            if (mColumns.empty()) {
+                for (const auto &attribute: items.front()) {
+                    mColumns.push_back(attribute.first);
+                }
+            }
+
+            for (size_t i = 0; i < mColumns.size(); ++i) {
+                if (i > 0) {
+                    mStream << ',';
+                }
+                writeCsvField(mColumns[i], mStream);
+            }
+            mStream << '\n';
+            mHeaderWritten = true;
+        }
+    }
+
+    // mColumns does not change after the header is written.
+    for (const ScanItem &item: items) {
+        if (mFormat == NDJSON) {
+            writeJsonObject(item, text);
+        }
+        else {
+            for (size_t i = 0; i < mColumns.size(); ++i) {
+                if (i > 0) {
+                    text << ',';
+                }
+                ScanItem::const_iterator attribute = item.find(mColumns[i]);
+                if (attribute != item.end()) {
+                    writeCsvField(attributeValueToString(attribute->second), text);
+                }
+            }
+        }
+        text << '\n';
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStream << text.rdbuf();
+    return mStream.good();
+}
+
+void AwsDoc::DynamoDB::FileScanSink::finish() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStream.flush();
+}
+
+void AwsDoc::DynamoDB::FileScanSink::writeCsvField(const Aws::String &field,
+                                                   std::ostream &stream) const {
+    if (field.find_first_of(",\"\r\n") == Aws::String::npos) {
+        stream << field;
+        return;
+    }
+
+    stream << '"';
+    for (char character: field) {
+        if (character == '"') {
+            stream << '"';
+        }
+        stream << character;
+    }
+    stream << '"';
+}
+
+//! Routine which scans a table using parallel segments.
+/*!
+  \sa parallelScan()
+  \param dynamoClient: A DynamoDB client.
+  \param request: The Scan request for the table.
+  \param options: The parallel scan options.
+  \param sink: The destination for the items.
+  \param segmentStats: A vector to receive the statistics for each segment.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::DynamoDB::parallelScan(const Aws::DynamoDB::DynamoDBClient &dynamoClient,
+                                    const Aws::DynamoDB::Model::ScanRequest &request,
+                                    const ParallelScanOptions &options,
+                                    ScanSink &sink,
+                                    Aws::Vector<SegmentStats> &segmentStats) {
+    const int totalSegments = std::max(options.mTotalSegments, 1);
+    segmentStats.assign(totalSegments, SegmentStats());
+
+    std::atomic<int> nextSegment(0);
+    std::atomic<bool> stop(false);
+    std::atomic<bool> result(true);
+    std::mutex errorMutex;
+
+    auto scanSegments = [&]() {
+        for (int segment = nextSegment++; segment < totalSegments && !stop;
+             segment = nextSegment++) {
+            SegmentStats &stats = segmentStats[segment];
+            stats.mSegment = segment;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            Aws::DynamoDB::Model::ScanRequest segmentRequest(request);
+            segmentRequest.SetSegment(segment);
+            segmentRequest.SetTotalSegments(totalSegments);
+            segmentRequest.SetReturnConsumedCapacity(
+                    Aws::DynamoDB::Model::ReturnConsumedCapacity::TOTAL);
+            if (options.mPageLimit > 0) {
+                segmentRequest.SetLimit(options.mPageLimit);
+            }
+
+            while (!stop) {
+                Aws::DynamoDB::Model::ScanOutcome outcome = dynamoClient.Scan(
+                        segmentRequest);
+                if (!outcome.IsSuccess()) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    std::cerr << "Failed to Scan segment " << segment << ": "
+                              << outcome.GetError().GetMessage() << std::endl;
+                    result = false;
+                    stop = true;
+                    break;
+                }
+
+                const Aws::DynamoDB::Model::ScanResult &scanResult = outcome.GetResult();
+                ++stats.mPages;
+                stats.mItems += scanResult.GetItems().size();
+                stats.mConsumedCapacity += scanResult.GetConsumedCapacity().GetCapacityUnits();
+
+                if (!sink.consume(segment, scanResult.GetItems())) {
+                    stop = true;
+                    break;
+                }
+
+                const ScanItem &lastEvaluatedKey = scanResult.GetLastEvaluatedKey();
+                if (lastEvaluatedKey.empty()) {
+                    break;
+                }
+                segmentRequest.SetExclusiveStartKey(lastEvaluatedKey);
+            }
+
+            stats.mSeconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    size_t threadCount = options.mMaxThreads > 0 ?
+                         std::min<size_t>(options.mMaxThreads, totalSegments) :
+                         static_cast<size_t>(totalSegments);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(scanSegments);
+    }
+
+    scanSegments();  // The calling thread is also a worker.
+
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    sink.finish();
+
+    return result;
+}
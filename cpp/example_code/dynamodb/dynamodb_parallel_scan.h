@@ -0,0 +1,208 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DYNAMODB_EXAMPLES_DYNAMODB_PARALLEL_SCAN_H
+#define DYNAMODB_EXAMPLES_DYNAMODB_PARALLEL_SCAN_H
+
+#include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/model/AttributeValue.h>
+#include <aws/dynamodb/model/ScanRequest.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+
+namespace AwsDoc {
+    namespace DynamoDB {
+        typedef Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> ScanItem;
+
+        //! Routine which writes an attribute value as plain JSON.
+        /*!
+          Numbers are written as JSON numbers, binary values as base64 strings,
+          sets and lists as arrays, and maps as objects.
+          \sa writeAttributeValueJson()
+          \param attributeValue: The attribute value.
+          \param stream: The output stream.
+          \return void:
+         */
+        void writeAttributeValueJson(const Aws::DynamoDB::Model::AttributeValue &attributeValue,
+                                     std::ostream &stream);
+
+        //! Routine which formats an attribute value for display.
+        /*!
+          Strings and numbers are returned unquoted. Other types are returned as JSON.
+          \sa attributeValueToString()
+          \param attributeValue: The attribute value.
+          \return Aws::String: The formatted value.
+         */
+        Aws::String
+        attributeValueToString(const Aws::DynamoDB::Model::AttributeValue &attributeValue);
+
+        /**
+         * The destination for the items returned by a parallel scan.
+         *
+         * consume() is called with each page of items, from as many threads as
+         * there are segments being scanned, so implementations must be thread safe.
+         */
+        class ScanSink {
+        public:
+            virtual ~ScanSink() = default;
+
+            //! Receive one page of items from a segment.
+            /*!
+              \param segment: The segment which returned the page.
+              \param items: The items in the page.
+              \return bool: False to stop the scan.
+             */
+            virtual bool consume(int segment, const Aws::Vector<ScanItem> &items) = 0;
+
+            //! Called once after every segment has finished.
+            virtual void finish() {}
+        };
+
+        /**
+         * A sink which calls a function for each item.
+         */
+        class CallbackScanSink : public ScanSink {
+        public:
+            typedef std::function<bool(int segment, const ScanItem &item)> Callback;
+
+            //! CallbackScanSink constructor.
+            /*!
+              \param callback: Called for each item. It must be thread safe, and
+                               it returns false to stop the scan.
+             */
+            explicit CallbackScanSink(const Callback &callback) : mCallback(callback) {}
+
+            bool consume(int segment, const Aws::Vector<ScanItem> &items) override;
+
+        private:
+            Callback mCallback;
+        };
+
+        /**
+         * A sink which hands items to a consumer thread through a bounded queue.
+         *
+         * Segment threads wait while the queue is full, so a slow consumer
+         * throttles the scan instead of buffering the table in memory.
+         */
+        class QueueScanSink : public ScanSink {
+        public:
+            //! QueueScanSink constructor.
+            /*!
+              \param capacity: The maximum number of items in the queue.
+             */
+            explicit QueueScanSink(size_t capacity = 1000) : mCapacity(capacity) {}
+
+            bool consume(int segment, const Aws::Vector<ScanItem> &items) override;
+
+            //! Close the queue. pop() returns false once the queue is empty.
+            void finish() override;
+
+            //! Remove the next item, waiting for one if the queue is empty.
+            /*!
+              \param item: The item.
+              \return bool: False if the scan has finished and the queue is empty.
+             */
+            bool pop(ScanItem &item);
+
+            //! Stop the scan. Segment threads stop after their current page.
+            void cancel();
+
+        private:
+            const size_t mCapacity;
+            std::mutex mMutex;
+            std::condition_variable mNotEmpty;
+            std::condition_variable mNotFull;
+            std::deque<ScanItem> mItems;
+            bool mClosed = false;
+            bool mCancelled = false;
+        };
+
+        /**
+         * A sink which writes items to a stream as NDJSON or CSV.
+         *
+         * Each page is formatted by the segment thread which returned it, and
+         * only the finished text is written under the stream lock.
+         */
+        class FileScanSink : public ScanSink {
+        public:
+            enum Format {
+                NDJSON,  // One JSON object per line.
+                CSV      // A header row, then one row per item.
+            };
+
+            //! FileScanSink constructor.
+            /*!
+              \param stream: The output stream. It must outlive the sink.
+              \param format: The output format.
+              \param columns: The CSV columns. If empty, the attribute names of the
+                              first item are used. Attributes not in the columns
+                              are not written. Ignored for NDJSON.
+             */
+            FileScanSink(std::ostream &stream, Format format,
+                         const Aws::Vector<Aws::String> &columns = Aws::Vector<Aws::String>());
+
+            bool consume(int segment, const Aws::Vector<ScanItem> &items) override;
+
+            void finish() override;
+
+        private:
+            void writeCsvField(const Aws::String &field, std::ostream &stream) const;
+
+            std::ostream &mStream;
+            const Format mFormat;
+            std::mutex mMutex;
+            Aws::Vector<Aws::String> mColumns;
+            bool mHeaderWritten = false;
+        };
+
+        // Options for parallelScan().
+        struct ParallelScanOptions {
+            // The number of segments the table is divided into.
+            int mTotalSegments = 8;
+            // The number of segments scanned at the same time, or 0 for all of them.
+            size_t mMaxThreads = 0;
+            // The maximum number of items evaluated for each Scan request,
+            // or 0 for the DynamoDB limit of 1 MB of data.
+            int mPageLimit = 0;
+        };
+
+        // Statistics for one segment of a parallel scan.
+        struct SegmentStats {
+            int mSegment = 0;
+            uint64_t mItems = 0;
+            uint64_t mPages = 0;
+            double mConsumedCapacity = 0.0;
+            double mSeconds = 0.0;
+
+            double itemsPerSecond() const {
+                return mSeconds > 0.0 ? static_cast<double>(mItems) / mSeconds : 0.0;
+            }
+        };
+
+        //! Routine which scans a table using parallel segments.
+        /*!
+          The table is divided into options.mTotalSegments segments, and each
+          segment is scanned by a worker thread which follows LastEvaluatedKey
+          until the segment is complete.
+          \sa parallelScan()
+          \param dynamoClient: A DynamoDB client.
+          \param request: The Scan request for the table. Segment, TotalSegments,
+                          and ExclusiveStartKey are set for each segment.
+          \param options: The parallel scan options.
+          \param sink: The destination for the items.
+          \param segmentStats: A vector to receive the statistics for each segment.
+          \return bool: Function succeeded.
+         */
+        bool parallelScan(const Aws::DynamoDB::DynamoDBClient &dynamoClient,
+                          const Aws::DynamoDB::Model::ScanRequest &request,
+                          const ParallelScanOptions &options,
+                          ScanSink &sink,
+                          Aws::Vector<SegmentStats> &segmentStats);
+    } // DynamoDB
+} // AwsDoc
+
+#endif //DYNAMODB_EXAMPLES_DYNAMODB_PARALLEL_SCAN_H
@@ -0,0 +1,154 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DYNAMODB_EXAMPLES_DYNAMODB_QUERY_CURSOR_H
+#define DYNAMODB_EXAMPLES_DYNAMODB_QUERY_CURSOR_H
+
+#include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/model/QueryRequest.h>
+#include <functional>
+
+namespace AwsDoc {
+    namespace DynamoDB {
+        /**
+         * A cursor over the pages returned by a DynamoDB Query.
+         *
+         * As soon as a page arrives, the request for the following page is
+         * started on the client's executor, so the caller processes one page
+         * while the next one is in flight.
+         *
+         * Items are returned by reference into the current page, so no page is
+         * copied. A reference is valid until the next call to nextPage().
+         *
+         *   AwsDoc::DynamoDB::QueryCursor cursor(dynamoClient, request, 100);
+         *   cursor.forEach([](const QueryCursor::Item &item) { ...; return true; });
+         *   if (cursor.hasError()) { ... }
+         */
+        class QueryCursor {
+        public:
+            typedef Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> Item;
+            typedef std::function<bool(const Item &item)> Visitor;
+
+            //! QueryCursor constructor.
+            /*!
+              \param dynamoClient: A DynamoDB client. It must outlive the cursor.
+              \param request: The Query request.
+              \param pageSize: The maximum number of items for each Query request,
+                               or 0 for the DynamoDB limit of 1 MB of data.
+             */
+            QueryCursor(const Aws::DynamoDB::DynamoDBClient &dynamoClient,
+                        const Aws::DynamoDB::Model::QueryRequest &request,
+                        int pageSize = 0) :
+                    mDynamoClient(dynamoClient), mRequest(request) {
+                if (pageSize > 0) {
+                    mRequest.SetLimit(pageSize);
+                }
+            }
+
+            QueryCursor(const QueryCursor &) = delete;
+
+            QueryCursor &operator=(const QueryCursor &) = delete;
+
+            ~QueryCursor() {
+                // The request is referenced by a running QueryCallable.
+                if (mNextPage.valid()) {
+                    mNextPage.wait();
+                }
+            }
+
+            //! Routine which moves to the next page, and starts the request after it.
+            /*!
+              \return bool: False at the end of the results, or if a request failed.
+             */
+            bool nextPage() {
+                if (!mStarted) {
+                    mStarted = true;
+                    mNextPage = mDynamoClient.QueryCallable(mRequest);
+                }
+
+                if (!mNextPage.valid()) {
+                    return false;
+                }
+
+                mPage = mNextPage.get();
+                if (!mPage.IsSuccess()) {
+                    mHasError = true;
+                    return false;
+                }
+
+                ++mPageCount;
+                mItemCount += mPage.GetResult().GetItems().size();
+
+                // mRequest is not modified while a request is in flight.
+                const Item &lastEvaluatedKey = mPage.GetResult().GetLastEvaluatedKey();
+                if (!lastEvaluatedKey.empty()) {
+                    mRequest.SetExclusiveStartKey(lastEvaluatedKey);
+                    mNextPage = mDynamoClient.QueryCallable(mRequest);
+                }
+
+                return true;
+            }
+
+            //! Routine which returns the items in the current page.
+            /*!
+              \return Aws::Vector<Item>: The items.
+             */
+            const Aws::Vector<Item> &items() const {
+                return mPage.GetResult().GetItems();
+            }
+
+            //! Routine which visits every remaining item.
+            /*!
+              \param visitor: Called with each item. It returns false to stop.
+              \return bool: False if a request failed.
+             */
+            bool forEach(const Visitor &visitor) {
+                while (nextPage()) {
+                    for (const Item &item: items()) {
+                        if (!visitor(item)) {
+                            return true;
+                        }
+                    }
+                }
+
+                return !mHasError;
+            }
+
+            //! Routine which reports whether a Query request failed.
+            /*!
+              \return bool: True if a request failed.
+             */
+            bool hasError() const { return mHasError; }
+
+            //! Routine which returns the error from a failed request.
+            /*!
+              \return DynamoDBError: The error.
+             */
+            const Aws::DynamoDB::DynamoDBError &getError() const { return mPage.GetError(); }
+
+            //! Routine which returns the number of pages retrieved.
+            /*!
+              \return size_t: The number of pages.
+             */
+            size_t pageCount() const { return mPageCount; }
+
+            //! Routine which returns the number of items retrieved.
+            /*!
+              \return size_t: The number of items.
+             */
+            size_t itemCount() const { return mItemCount; }
+
+        private:
+            const Aws::DynamoDB::DynamoDBClient &mDynamoClient;
+            Aws::DynamoDB::Model::QueryRequest mRequest;
+            Aws::DynamoDB::Model::QueryOutcome mPage;
+            Aws::DynamoDB::Model::QueryOutcomeCallable mNextPage;
+            size_t mPageCount = 0;
+            size_t mItemCount = 0;
+            bool mStarted = false;
+            bool mHasError = false;
+        };
+    } // DynamoDB
+} // AwsDoc
+
+#endif //DYNAMODB_EXAMPLES_DYNAMODB_QUERY_CURSOR_H
@@ -5,6 +5,7 @@
 #define DYNAMODB_EXAMPLES_DYNAMODB_SAMPLES_H
 
 #include <aws/core/client/ClientConfiguration.h>
+#include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/AttributeValue.h>
 
 namespace AwsDoc {
@@ -119,6 +120,18 @@ namespace AwsDoc {
                         const Aws::String &partitionValue,
                         const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Delete all the items in a DynamoDB table.
+        /*!
+          \sa deleteAllItems()
+          \param tableName: The table name.
+          \param maxConcurrency: The most BatchWriteItem requests sent at the same time.
+          \param clientConfiguration: AWS client configuration.
+          \return bool: Function succeeded.
+         */
+        bool deleteAllItems(const Aws::String &tableName,
+                            size_t maxConcurrency,
+                            const Aws::Client::ClientConfiguration &clientConfiguration);
+
         //! Describe a DynamoDB table.
         /*!
           \sa describeTable()
@@ -186,7 +199,8 @@ namespace AwsDoc {
           \param partitionKey: The partition key.
           \param partitionValue: The value for the partition key.
           \param projectionExpression: The projections expression, which is ignored if empty.
-          \param clientConfiguration: AWS client configuration.
+          \param clientConfiguration: AWS client configuration. The client is shared with
+                 later calls through AwsDoc::ClientRegistry.
           \return bool: Function succeeded.
           */
         bool queryItems(const Aws::String &tableName,
@@ -195,18 +209,64 @@ namespace AwsDoc {
                         const Aws::String &projectionExpression,
                         const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Perform  a query on a DynamoDB Table and retrieve items with an existing client.
+        /*!
+          \sa queryItems()
+          \param tableName: The table name.
+          \param partitionKey: The partition key.
+          \param partitionValue: The value for the partition key.
+          \param projectionExpression: The projections expression, which is ignored if empty.
+          \param dynamoClient: A DynamoDB client, which can be shared between calls.
+          \return bool: Function succeeded.
+          */
+        bool queryItems(const Aws::String &tableName,
+                        const Aws::String &partitionKey,
+                        const Aws::String &partitionValue,
+                        const Aws::String &projectionExpression,
+                        const Aws::DynamoDB::DynamoDBClient &dynamoClient);
+
         //! Scan a DynamoDB table.
         /*!
           \sa scanTable()
           \param tableName: Name for the DynamoDB table.
           \param projectionExpression: An optional projection expression, ignored if empty.
-          \param clientConfiguration: AWS client configuration.
+          \param clientConfiguration: AWS client configuration. The client is shared with
+                 later calls through AwsDoc::ClientRegistry.
           \return bool: Function succeeded.
          */
         bool scanTable(const Aws::String &tableName,
                        const Aws::String &projectionExpression,
                        const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Scan a DynamoDB table with an existing client.
+        /*!
+          \sa scanTable()
+          \param tableName: Name for the DynamoDB table.
+          \param projectionExpression: An optional projection expression, ignored if empty.
+          \param dynamoClient: A DynamoDB client, which can be shared between calls.
+          \return bool: Function succeeded.
+         */
+        bool scanTable(const Aws::String &tableName,
+                       const Aws::String &projectionExpression,
+                       const Aws::DynamoDB::DynamoDBClient &dynamoClient);
+
+        //! Export a DynamoDB table to a file using a parallel scan.
+        /*!
+          \sa exportTable()
+          \param tableName: Name for the DynamoDB table.
+          \param projectionExpression: An optional projection expression, ignored if empty.
+          \param outputPath: The output file. A file name ending in ".csv" is written
+                             as CSV, and any other file name as NDJSON.
+          \param totalSegments: The number of segments scanned at the same time.
+          \param dynamoClient: A DynamoDB client, which can be shared between calls.
+          \return bool: Function succeeded.
+         */
+        bool exportTable(const Aws::String &tableName,
+                         const Aws::String &projectionExpression,
+                         const Aws::String &outputPath,
+                         int totalSegments,
+                         const Aws::DynamoDB::DynamoDBClient &dynamoClient);
+
         //! Update a DynamoDB table item.
         /*!
           \sa updateItem()
@@ -11,6 +11,7 @@
 
 #include "dynamodb_samples.h"
 #include <thread>
+#include "awsdoc/waiter.h"
 #include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/CreateTableRequest.h>
 #include <aws/dynamodb/model/DeleteTableRequest.h>
@@ -153,32 +154,30 @@ bool AwsDoc::DynamoDB::waitTableActive(const Aws::String &tableName,
                                        const Aws::Client::ClientConfiguration &clientConfiguration) {
     Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration);
     // Repeatedly call DescribeTable until table is ACTIVE.
-    const int MAX_QUERIES = 20;
     Aws::DynamoDB::Model::DescribeTableRequest request;
     request.SetTableName(tableName);
 
-    int count = 0;
-    while (count < MAX_QUERIES) {
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(1);
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         const Aws::DynamoDB::Model::DescribeTableOutcome &result = dynamoClient.DescribeTable(
                 request);
-        if (result.IsSuccess()) {
-            Aws::DynamoDB::Model::TableStatus status = result.GetResult().GetTable().GetTableStatus();
-
-            if (Aws::DynamoDB::Model::TableStatus::ACTIVE != status) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            }
-            else {
-                return true;
-            }
-        }
-        else {
+        if (!result.IsSuccess()) {
             std::cerr << "Error DynamoDB::waitTableActive "
                       << result.GetError().GetMessage() << std::endl;
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
-        count++;
+
+        Aws::DynamoDB::Model::TableStatus status = result.GetResult().GetTable().GetTableStatus();
+        return Aws::DynamoDB::Model::TableStatus::ACTIVE == status ?
+               AwsDoc::WaiterState::SUCCESS : AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
+
+    if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+        std::cerr << "Error DynamoDB::waitTableActive timed out." << std::endl;
     }
-    return false;
+
+    return waiterState == AwsDoc::WaiterState::SUCCESS;
 }
 // snippet-end:[cpp.example_code.dynamodb.scenario.waitTableActive]
 
@@ -18,6 +18,9 @@
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <iostream>
 #include "dynamodb_samples.h"
+#include "dynamodb_parallel_scan.h"
+#include "dynamodb_query_cursor.h"
+#include "awsdoc/client_registry.h"
 
 // snippet-start:[dynamodb.cpp.query_items.code]
 //! Perform a query on an Amazon DynamoDB Table and retrieve items.
@@ -27,7 +30,8 @@
   \param partitionKey: The partition key.
   \param partitionValue: The value for the partition key.
   \param projectionExpression: The projections expression, which is ignored if empty.
-  \param clientConfiguration: AWS client configuration.
+  \param clientConfiguration: AWS client configuration. The client is shared with later
+         calls through AwsDoc::ClientRegistry.
   \return bool: Function succeeded.
   */
 
@@ -43,7 +47,29 @@ bool AwsDoc::DynamoDB::queryItems(const Aws::String &tableName,
                                   const Aws::String &partitionValue,
                                   const Aws::String &projectionExpression,
                                   const Aws::Client::ClientConfiguration &clientConfiguration) {
-    Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration);
+    std::shared_ptr<Aws::DynamoDB::DynamoDBClient> dynamoClient =
+            AwsDoc::ClientRegistry::getClient<Aws::DynamoDB::DynamoDBClient>(
+                    clientConfiguration);
+
+    return queryItems(tableName, partitionKey, partitionValue, projectionExpression,
+                      *dynamoClient);
+}
+
+//! Perform a query on an Amazon DynamoDB Table and retrieve items with an existing client.
+/*!
+  \sa queryItem()
+  \param tableName: The table name.
+  \param partitionKey: The partition key.
+  \param partitionValue: The value for the partition key.
+  \param projectionExpression: The projections expression, which is ignored if empty.
+  \param dynamoClient: A DynamoDB client, which can be shared between calls.
+  \return bool: Function succeeded.
+  */
+bool AwsDoc::DynamoDB::queryItems(const Aws::String &tableName,
+                                  const Aws::String &partitionKey,
+                                  const Aws::String &partitionValue,
+                                  const Aws::String &projectionExpression,
+                                  const Aws::DynamoDB::DynamoDBClient &dynamoClient) {
     Aws::DynamoDB::Model::QueryRequest request;
 
     request.SetTableName(tableName);
@@ -61,47 +87,39 @@ bool AwsDoc::DynamoDB::queryItems(const Aws::String &tableName,
 
     request.SetExpressionAttributeValues(attributeValues);
 
-    bool result = true;
-
-    // "exclusiveStartKey" is used for pagination.
-    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> exclusiveStartKey;
-    do {
-        if (!exclusiveStartKey.empty()) {
-            request.SetExclusiveStartKey(exclusiveStartKey);
-            exclusiveStartKey.clear();
-        }
-        // Perform Query operation.
-        const Aws::DynamoDB::Model::QueryOutcome &outcome = dynamoClient.Query(request);
-        if (outcome.IsSuccess()) {
-            // Reference the retrieved items.
-            const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = outcome.GetResult().GetItems();
-            if (!items.empty()) {
-                std::cout << "Number of items retrieved from Query: " << items.size()
-                          << std::endl;
-                // Iterate each item and print.
-                for (const auto &item: items) {
-                    std::cout
-                            << "******************************************************"
-                            << std::endl;
-                    // Output each retrieved field and its value.
-                    for (const auto &i: item)
-                        std::cout << i.first << ": " << i.second.GetS() << std::endl;
-                }
-            }
-            else {
-                std::cout << "No item found in table: " << tableName << std::endl;
+    // The cursor follows LastEvaluatedKey, and it requests the next page
+    // while the current page is printed.
+    QueryCursor cursor(dynamoClient, request);
+    while (cursor.nextPage()) {
+        // Reference the retrieved items.
+        const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = cursor.items();
+        if (!items.empty()) {
+            std::cout << "Number of items retrieved from Query: " << items.size()
+                      << std::endl;
+            // Iterate each item and print.
+            for (const auto &item: items) {
+                std::cout
+                        << "******************************************************"
+                        << std::endl;
+                // Output each retrieved field and its value, whatever its type.
+                for (const auto &i: item)
+                    std::cout << i.first << ": " << attributeValueToString(i.second)
+                              << std::endl;
             }
-
-            exclusiveStartKey = outcome.GetResult().GetLastEvaluatedKey();
         }
-        else {
-            std::cerr << "Failed to Query items: " << outcome.GetError().GetMessage();
-            result = false;
-            break;
-        }
-    } while (!exclusiveStartKey.empty());
+    }
+
+    if (cursor.hasError()) {
+        std::cerr << "Failed to Query items: " << cursor.getError().GetMessage()
+                  << std::endl;
+        return false;
+    }
+
+    if (cursor.itemCount() == 0) {
+        std::cout << "No item found in table: " << tableName << std::endl;
+    }
 
-    return result;
+    return true;
 }
 // snippet-end:[dynamodb.cpp.query_items.code]
 
@@ -150,6 +168,8 @@ Where:
         AwsDoc::DynamoDB::queryItems(tableName, partitionKey, partitionValue, projection,
                                     clientConfig);
     }
+    // The shared clients must be released before ShutdownAPI.
+    AwsDoc::ClientRegistry::clear();
     Aws::ShutdownAPI(options);
     return 0;
 }
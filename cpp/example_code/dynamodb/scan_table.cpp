@@ -17,8 +17,15 @@
 #include <aws/dynamodb/DynamoDBClient.h>
 #include <aws/dynamodb/model/AttributeDefinition.h>
 #include <aws/dynamodb/model/ScanRequest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include "dynamodb_samples.h"
+#include "dynamodb_parallel_scan.h"
+#include "awsdoc/client_registry.h"
 
 // snippet-start:[dynamodb.cpp.scan_table.code]
 //! Scan an Amazon DynamoDB table.
@@ -26,57 +33,150 @@
   \sa scanTable()
   \param tableName: Name for the DynamoDB table.
   \param projectionExpression: An optional projection expression, ignored if empty.
-  \param clientConfiguration: AWS client configuration.
+  \param clientConfiguration: AWS client configuration. The client is shared with later
+         calls through AwsDoc::ClientRegistry.
   \return bool: Function succeeded.
  */
 
 bool AwsDoc::DynamoDB::scanTable(const Aws::String &tableName,
                                  const Aws::String &projectionExpression,
                                  const Aws::Client::ClientConfiguration &clientConfiguration) {
-    Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfiguration);
+    std::shared_ptr<Aws::DynamoDB::DynamoDBClient> dynamoClient =
+            AwsDoc::ClientRegistry::getClient<Aws::DynamoDB::DynamoDBClient>(
+                    clientConfiguration);
+
+    return scanTable(tableName, projectionExpression, *dynamoClient);
+}
+
+//! Scan an Amazon DynamoDB table with an existing client.
+/*!
+  \sa scanTable()
+  \param tableName: Name for the DynamoDB table.
+  \param projectionExpression: An optional projection expression, ignored if empty.
+  \param dynamoClient: A DynamoDB client, which can be shared between calls.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::DynamoDB::scanTable(const Aws::String &tableName,
+                                 const Aws::String &projectionExpression,
+                                 const Aws::DynamoDB::DynamoDBClient &dynamoClient) {
     Aws::DynamoDB::Model::ScanRequest request;
     request.SetTableName(tableName);
 
     if (!projectionExpression.empty())
         request.SetProjectionExpression(projectionExpression);
 
-    // Perform scan on table.
-    const Aws::DynamoDB::Model::ScanOutcome &outcome = dynamoClient.Scan(request);
-    if (outcome.IsSuccess()) {
+    size_t itemCount = 0;
+    // A Scan returns at most 1 MB of data. Follow LastEvaluatedKey until the
+    // table has been read.
+    while (true) {
+        const Aws::DynamoDB::Model::ScanOutcome &outcome = dynamoClient.Scan(request);
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Failed to Scan items: " << outcome.GetError().GetMessage()
+                      << std::endl;
+            return false;
+        }
+
         // Reference the retrieved items.
         const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = outcome.GetResult().GetItems();
-        if (!items.empty()) {
-            std::cout << "Number of items retrieved from scan: " << items.size()
+        for (const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &itemMap: items) {
+            std::cout << "******************************************************"
                       << std::endl;
-            // Iterate each item and print.
-            for (const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &itemMap: items) {
-                std::cout << "******************************************************"
-                          << std::endl;
-                // Output each retrieved field and its value.
-                for (const auto &itemEntry: itemMap)
-                    std::cout << itemEntry.first << ": " << itemEntry.second.GetS()
-                              << std::endl;
-            }
+            // Output each retrieved field and its value, whatever its type.
+            for (const auto &itemEntry: itemMap)
+                std::cout << itemEntry.first << ": "
+                          << attributeValueToString(itemEntry.second) << std::endl;
         }
+        itemCount += items.size();
 
-        else {
-            std::cout << "No item found in table: " << tableName << std::endl;
+        const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &lastEvaluatedKey = outcome.GetResult().GetLastEvaluatedKey();
+        if (lastEvaluatedKey.empty()) {
+            break;
         }
+        request.SetExclusiveStartKey(lastEvaluatedKey);
     }
-    else {
-        std::cerr << "Failed to Scan items: " << outcome.GetError().GetMessage()
+
+    if (itemCount > 0) {
+        std::cout << "Number of items retrieved from scan: " << itemCount
                   << std::endl;
     }
+    else {
+        std::cout << "No item found in table: " << tableName << std::endl;
+    }
 
-    return outcome.IsSuccess();
+    return true;
 }
 
 // snippet-end:[dynamodb.cpp.scan_table.code]
 
+//! Export an Amazon DynamoDB table to a file using a parallel scan.
+/*!
+  \sa exportTable()
+  \param tableName: Name for the DynamoDB table.
+  \param projectionExpression: An optional projection expression, ignored if empty.
+  \param outputPath: The output file. A file name ending in ".csv" is written
+                     as CSV, and any other file name as NDJSON.
+  \param totalSegments: The number of segments scanned at the same time.
+  \param dynamoClient: A DynamoDB client, which can be shared between calls.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::DynamoDB::exportTable(const Aws::String &tableName,
+                                   const Aws::String &projectionExpression,
+                                   const Aws::String &outputPath,
+                                   int totalSegments,
+                                   const Aws::DynamoDB::DynamoDBClient &dynamoClient) {
+    std::ofstream outputFile(outputPath.c_str(), std::ios::out | std::ios::trunc);
+    if (!outputFile) {
+        std::cerr << "Error: could not open output file '" << outputPath << "'."
+                  << std::endl;
+        return false;
+    }
+
+    const Aws::String CSV_EXTENSION(".csv");
+    bool isCsv = outputPath.size() >= CSV_EXTENSION.size() &&
+                 outputPath.compare(outputPath.size() - CSV_EXTENSION.size(),
+                                    CSV_EXTENSION.size(), CSV_EXTENSION) == 0;
+    FileScanSink sink(outputFile, isCsv ? FileScanSink::CSV : FileScanSink::NDJSON);
+
+    Aws::DynamoDB::Model::ScanRequest request;
+    request.SetTableName(tableName);
+    if (!projectionExpression.empty()) {
+        request.SetProjectionExpression(projectionExpression);
+    }
+
+    ParallelScanOptions options;
+    options.mTotalSegments = totalSegments;
+    Aws::Vector<SegmentStats> segmentStats;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool result = parallelScan(dynamoClient, request, options, sink, segmentStats);
+    double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+    uint64_t totalItems = 0;
+    double totalCapacity = 0.0;
+    for (const SegmentStats &stats: segmentStats) {
+        std::cout << "Segment " << stats.mSegment << ": " << stats.mItems
+                  << " items in " << stats.mPages << " pages, "
+                  << std::fixed << std::setprecision(1) << stats.itemsPerSecond()
+                  << " items/s, " << stats.mConsumedCapacity
+                  << " capacity units." << std::endl;
+        totalItems += stats.mItems;
+        totalCapacity += stats.mConsumedCapacity;
+    }
+
+    std::cout << "Exported " << totalItems << " items to '" << outputPath << "' in "
+              << std::fixed << std::setprecision(2) << seconds << " seconds ("
+              << std::setprecision(1)
+              << (seconds > 0.0 ? static_cast<double>(totalItems) / seconds : 0.0)
+              << " items/s, " << totalCapacity << " capacity units)." << std::endl;
+
+    return result && outputFile.good();
+}
+
 /*
  *  main function
  *
  *  Usage: 'run_scan_table <table> [projection_expression]'
+ *         'run_scan_table --export <table> <output_file> [segments] [projection_expression]'
  *
  *  Prerequisites: Create a pre-populated DynamoDB table.
  *
@@ -92,8 +192,12 @@ int main(int argc, char **argv) {
         std::cout << R"(
 Usage:
     run_scan_table <table> [projection_expression]
+    run_scan_table --export <table> <output_file> [segments] [projection_expression]
 Where:
     table - The table to scan.
+    output_file - The export file, written as CSV if the name ends
+                  in ".csv", and as NDJSON otherwise.
+    segments - The number of segments scanned in parallel (default 8).
 To limit the fields returned from the table, add
 an optional projection expression (a quote-delimited,
 comma-separated list of attributes to retrieve).
@@ -101,19 +205,42 @@ comma-separated list of attributes to retrieve).
         return 1;
     }
 
+    const Aws::String EXPORT_OPTION("--export");
+    if (argv[1] == EXPORT_OPTION && argc < 4) {
+        std::cerr << "Error: --export requires a table and an output file." << std::endl;
+        return 1;
+    }
+
     Aws::SDKOptions options;
 
     Aws::InitAPI(options);
     {
-        const Aws::String tableName = (argv[1]);
-        const Aws::String projectionExpression(argc > 2 ? argv[2] : "");
-
         Aws::Client::ClientConfiguration clientConfig;
         // Optional: Set to the AWS Region (overrides config file).
         // clientConfig.region = "us-east-1";
 
-        AwsDoc::DynamoDB::scanTable(tableName, projectionExpression, clientConfig);
+        if (argv[1] == EXPORT_OPTION) {
+            const Aws::String tableName(argv[2]);
+            const Aws::String outputPath(argv[3]);
+            const int totalSegments = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 8;
+            const Aws::String projectionExpression(argc > 5 ? argv[5] : "");
+
+            // Each segment thread needs its own connection.
+            clientConfig.maxConnections = std::max<unsigned>(clientConfig.maxConnections,
+                                                             totalSegments);
+            Aws::DynamoDB::DynamoDBClient dynamoClient(clientConfig);
+            AwsDoc::DynamoDB::exportTable(tableName, projectionExpression, outputPath,
+                                          totalSegments, dynamoClient);
+        }
+        else {
+            const Aws::String tableName = (argv[1]);
+            const Aws::String projectionExpression(argc > 2 ? argv[2] : "");
+
+            AwsDoc::DynamoDB::scanTable(tableName, projectionExpression, clientConfig);
+        }
     }
+    // The shared clients must be released before ShutdownAPI.
+    AwsDoc::ClientRegistry::clear();
     Aws::ShutdownAPI(options);
     return 0;
 }
@@ -8,8 +8,12 @@
 #include <aws/dynamodb/model/DeleteItemRequest.h>
 #include <aws/dynamodb/model/PutItemRequest.h>
 #include <aws/core/utils/UUID.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <aws/testing/mocks/http/MockHttpClient.h>
 #include <fstream>
+#include <mutex>
 #include "dynamodb_samples.h"
+#include "awsdoc/client_registry.h"
 
 namespace AwsDocTest {
     Aws::SDKOptions DynamoDB_GTests::s_options;
@@ -26,8 +30,88 @@ namespace AwsDocTest {
     bool DynamoDB_GTests::s_SimpleTableCreated = false;
     bool DynamoDB_GTests::s_BatchTablesCreated = false;
     bool DynamoDB_GTests::s_batchTablesPopulated = false;
+    static const char ALLOCATION_TAG[] = "DYNAMODB_GTEST";
 }
 
+/*
+ * Subclass MockHttpClient to generate DynamoDB responses, instead of returning
+ * stored responses, so a test can make any number of requests.
+ */
+class AwsDocTest::DynamoDBServiceMockHTTPClient : public MockHttpClient {
+public:
+    explicit DynamoDBServiceMockHTTPClient(size_t unprocessedRequests) :
+            mUnprocessedRequests(unprocessedRequests) {}
+
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->AddHeader("Content-Type", "application/x-amz-json-1.0");
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+
+        Aws::String target;
+        if (request->HasHeader("x-amz-target")) {
+            target = request->GetHeaderValue("x-amz-target");
+        }
+        Aws::Utils::Json::JsonValue json;
+        std::shared_ptr<Aws::IOStream> content = request->GetContentBody();
+        if (content) {
+            content->clear();
+            content->seekg(0);
+            json = Aws::Utils::Json::JsonValue(*content);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (target.find(".BatchWriteItem") != Aws::String::npos) {
+            const bool returnUnprocessed = mBatchWriteSizes.size() < mUnprocessedRequests;
+            size_t itemCount = 0;
+            Aws::StringStream unprocessed;
+            for (const auto &tableRequests: json.View().GetObject(
+                    "RequestItems").GetAllObjects()) {
+                Aws::Utils::Array<Aws::Utils::Json::JsonView> writeRequests =
+                        tableRequests.second.AsArray();
+                for (size_t i = 0; i < writeRequests.GetLength(); ++i) {
+                    mWrittenIds.push_back(writeRequests[i].GetObject("PutRequest").GetObject(
+                            "Item").GetObject("id").GetString("S"));
+                }
+                itemCount += writeRequests.GetLength();
+                if (returnUnprocessed && unprocessed.str().empty() &&
+                    writeRequests.GetLength() > 0) {
+                    unprocessed << "\"" << tableRequests.first << "\":["
+                                << writeRequests[writeRequests.GetLength() - 1].WriteCompact()
+                                << "]";
+                }
+            }
+            mBatchWriteSizes.push_back(itemCount);
+            response->GetResponseBody() << R"({"UnprocessedItems":{)" << unprocessed.str()
+                                        << "}}";
+        }
+        else {
+            response->SetResponseCode(Aws::Http::HttpResponseCode::BAD_REQUEST);
+        }
+
+        return response;
+    }
+
+    std::vector<size_t> getBatchWriteSizes() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mBatchWriteSizes;
+    }
+
+    std::vector<Aws::String> getWrittenIds() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mWrittenIds;
+    }
+
+private:
+    const size_t mUnprocessedRequests;
+    mutable std::mutex mMutex;
+    mutable std::vector<size_t> mBatchWriteSizes;
+    mutable std::vector<Aws::String> mWrittenIds;
+};
+
 void AwsDocTest::DynamoDB_GTests::SetUpTestSuite() {
     InitAPI(s_options);
 
@@ -53,6 +137,7 @@ void AwsDocTest::DynamoDB_GTests::TearDownTestSuite() {
         s_BatchTablesCreated = false;
     }
 
+    AwsDoc::ClientRegistry::clear();
     ShutdownAPI(s_options);
 }
 
@@ -269,3 +354,23 @@ int AwsDocTest::MyStringBuffer::underflow() {
     return result;
 }
 
+AwsDocTest::MockDynamoDBService::MockDynamoDBService(size_t unprocessedRequests) {
+    mockHttpClient = Aws::MakeShared<DynamoDBServiceMockHTTPClient>(ALLOCATION_TAG,
+                                                                    unprocessedRequests);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockDynamoDBService::~MockDynamoDBService() {
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
+
+std::vector<size_t> AwsDocTest::MockDynamoDBService::getBatchWriteSizes() const {
+    return mockHttpClient->getBatchWriteSizes();
+}
+
+std::vector<Aws::String> AwsDocTest::MockDynamoDBService::getWrittenIds() const {
+    return mockHttpClient->getWrittenIds();
+}
@@ -12,6 +12,8 @@
 #include <gtest/gtest.h>
 #include <dynamodb/model/ScalarAttributeType.h>
 
+class MockHttpClientFactory;
+
 namespace AwsDocTest {
 
     class MyStringBuffer : public std::stringbuf {
@@ -85,6 +87,31 @@ namespace AwsDocTest {
 
         static bool s_BatchTablesCreated;
     };
+
+    class DynamoDBServiceMockHTTPClient;
+
+    /*
+     * A mock DynamoDB service, for tests which make many requests. BatchWriteItem
+     * succeeds, except that the first unprocessedRequests calls return their last
+     * item as unprocessed. The items in each call are recorded.
+     */
+    class MockDynamoDBService {
+    public:
+        explicit MockDynamoDBService(size_t unprocessedRequests);
+
+        virtual ~MockDynamoDBService();
+
+        // The number of items in each BatchWriteItem request.
+        std::vector<size_t> getBatchWriteSizes() const;
+
+        // The "id" key of every item in the BatchWriteItem requests, in order.
+        std::vector<Aws::String> getWrittenIds() const;
+
+    private:
+
+        std::shared_ptr<DynamoDBServiceMockHTTPClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockDynamoDBService
 } // AwsDocTest
 
 #endif //S3_EXAMPLES_S3_GTESTS_H
@@ -12,8 +12,11 @@
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/dynamodb/model/PutRequest.h>
 #include "dynamodb_gtests.h"
 #include "dynamodb_samples.h"
+#include "dynamodb_batch_writer.h"
 
 namespace AwsDocTest {
     // NOLINTNEXTLINE (readability-named-parameter)
@@ -30,4 +33,51 @@ namespace AwsDocTest {
         ASSERT_TRUE(result);
         s_batchTablesPopulated = true;
     }
+
+    // NOLINTNEXTLINE (readability-named-parameter)
+    TEST_F(DynamoDB_GTests, batch_writer_3_) {
+        const size_t ITEM_COUNT = 60;
+        const size_t MAX_BATCH_ITEMS = AwsDoc::DynamoDB::BatchWriter::MAX_BATCH_ITEMS;
+
+        // The first BatchWriteItem call returns its last item as unprocessed.
+        MockDynamoDBService mockDynamoDBService(1);
+        Aws::Auth::AWSCredentials credentials("MOCK_ACCESS_KEY", "MOCK_SECRET_KEY");
+        Aws::DynamoDB::DynamoDBClient dynamoClient(credentials, *s_clientConfig);
+
+        AwsDoc::DynamoDB::BatchWriter::Counters counters;
+        {
+            // One dispatch thread, so the batches are sent in a known order.
+            AwsDoc::DynamoDB::BatchWriter batchWriter(dynamoClient, 1);
+            for (size_t i = 0; i < ITEM_COUNT; ++i) {
+                Aws::DynamoDB::Model::PutRequest putRequest;
+                putRequest.AddItem("id", Aws::DynamoDB::Model::AttributeValue().SetS(
+                        "item-" + std::to_string(i)));
+                batchWriter.push("TestTable",
+                                 Aws::DynamoDB::Model::WriteRequest().WithPutRequest(
+                                         putRequest));
+            }
+
+            ASSERT_TRUE(batchWriter.flush());
+            counters = batchWriter.getCounters();
+        }
+
+        // Full batches of 25 items, the unprocessed item sent again on its own,
+        // and then the remaining items.
+        std::vector<size_t> batchSizes = mockDynamoDBService.getBatchWriteSizes();
+        std::vector<size_t> expectedSizes = {MAX_BATCH_ITEMS, 1, MAX_BATCH_ITEMS,
+                                             ITEM_COUNT - 2 * MAX_BATCH_ITEMS};
+        EXPECT_EQ(batchSizes, expectedSizes);
+
+        // The last item of the first batch is the one sent again.
+        std::vector<Aws::String> writtenIds = mockDynamoDBService.getWrittenIds();
+        ASSERT_EQ(writtenIds.size(), ITEM_COUNT + 1);
+        EXPECT_EQ(writtenIds[MAX_BATCH_ITEMS],
+                  "item-" + std::to_string(MAX_BATCH_ITEMS - 1));
+
+        EXPECT_EQ(counters.mItemsWritten, ITEM_COUNT);
+        EXPECT_EQ(counters.mItemsFailed, 0u);
+        EXPECT_EQ(counters.mBatchesSent, batchSizes.size());
+        EXPECT_EQ(counters.mThrottledBatches, 1u);
+        EXPECT_EQ(counters.mRetriedItems, 1u);
+    }
 } // AwsDocTest
\ No newline at end of file
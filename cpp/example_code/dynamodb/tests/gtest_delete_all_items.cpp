@@ -0,0 +1,37 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <aws/core/utils/StringUtils.h>
+#include "dynamodb_gtests.h"
+#include "dynamodb_samples.h"
+
+namespace AwsDocTest {
+    // NOLINTNEXTLINE (readability-named-parameter)
+    TEST_F(DynamoDB_GTests, delete_all_items_2_) {
+        bool result = createSimpleTable();
+        ASSERT_TRUE(result) << preconditionError();
+
+        for (int i = 0; i < 30; ++i) {
+            const std::vector<Aws::String> keys = {SIMPLE_PRIMARY_KEY, "second_key"};
+            const std::vector<Aws::String> values = {
+                    "delete_all_value_" + Aws::Utils::StringUtils::to_string(i),
+                    "second_value"};
+            result = putItem(SIMPLE_TABLE_NAME, keys, values);
+            ASSERT_TRUE(result) << preconditionError();
+        }
+
+        result = AwsDoc::DynamoDB::deleteAllItems(SIMPLE_TABLE_NAME, 2,
+                                                  *s_clientConfig);
+        ASSERT_TRUE(result);
+    }
+} // AwsDocTest
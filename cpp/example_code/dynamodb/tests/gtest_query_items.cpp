@@ -13,6 +13,7 @@
 #include <fstream>
 #include "dynamodb_gtests.h"
 #include "dynamodb_samples.h"
+#include "dynamodb_query_cursor.h"
 
 namespace AwsDocTest {
     // NOLINTNEXTLINE (readability-named-parameter)
@@ -25,4 +26,29 @@ namespace AwsDocTest {
                                               "", *s_clientConfig);
         ASSERT_TRUE(result);
     }
+
+    // NOLINTNEXTLINE (readability-named-parameter)
+    TEST_F(DynamoDB_GTests, query_cursor_2_) {
+        bool result = createSimpleTable();
+        ASSERT_TRUE(result) << preconditionError();
+
+        Aws::DynamoDB::Model::QueryRequest request;
+        request.SetTableName(SIMPLE_TABLE_NAME);
+        request.SetKeyConditionExpression(SIMPLE_PRIMARY_KEY + "= :valueToMatch");
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> attributeValues;
+        attributeValues.emplace(":valueToMatch", "value1");
+        request.SetExpressionAttributeValues(attributeValues);
+
+        Aws::DynamoDB::DynamoDBClient dynamoClient(*s_clientConfig);
+        // A page size of 1 makes the cursor follow LastEvaluatedKey.
+        AwsDoc::DynamoDB::QueryCursor cursor(dynamoClient, request, 1);
+        size_t visited = 0;
+        result = cursor.forEach(
+                [&visited](const AwsDoc::DynamoDB::QueryCursor::Item &) {
+                    ++visited;
+                    return true;
+                });
+        ASSERT_TRUE(result);
+        ASSERT_EQ(visited, cursor.itemCount());
+    }
 } // AwsDocTest
\ No newline at end of file
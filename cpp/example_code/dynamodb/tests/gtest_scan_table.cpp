@@ -10,6 +10,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstdio>
 #include <fstream>
 #include "dynamodb_gtests.h"
 #include "dynamodb_samples.h"
@@ -24,4 +25,17 @@ namespace AwsDocTest {
                                              *s_clientConfig);
         ASSERT_TRUE(result);
     }
+
+    // NOLINTNEXTLINE (readability-named-parameter)
+    TEST_F(DynamoDB_GTests, export_table_2_) {
+        bool result = createSimpleTable();
+        ASSERT_TRUE(result) << preconditionError();
+
+        const Aws::String outputPath("export_table_test.ndjson");
+        Aws::DynamoDB::DynamoDBClient dynamoClient(*s_clientConfig);
+        result = AwsDoc::DynamoDB::exportTable(SIMPLE_TABLE_NAME, "", outputPath,
+                                               4, dynamoClient);
+        std::remove(outputPath.c_str());
+        ASSERT_TRUE(result);
+    }
 } // AwsDocTest
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef GLACIER_EXAMPLES_GLACIER_SAMPLES_H
+#define GLACIER_EXAMPLES_GLACIER_SAMPLES_H
+
+#include <aws/core/Aws.h>
+#include <aws/core/utils/Array.h>
+#include <vector>
+
+//! Check that a part size is 1 MB times a power of two, up to 4 GB.
+/*!
+  \param part_size: The part size in bytes.
+  \return bool: The part size is valid.
+ */
+bool is_valid_part_size(long long part_size);
+
+//! Calculate the SHA-256 hash of a buffer.
+/*!
+  \param data: The data to hash.
+  \param length: The length of the data.
+  \return Aws::Utils::ByteBuffer: The hash.
+ */
+Aws::Utils::ByteBuffer sha256(const unsigned char* data, size_t length);
+
+//! Combine a range of SHA-256 tree hashes into their parent hash.
+/*!
+  \param first: The first hash.
+  \param last: The end of the range.
+  \return Aws::Utils::ByteBuffer: The tree hash of the range.
+ */
+Aws::Utils::ByteBuffer combine_tree_hashes(
+    std::vector<Aws::Utils::ByteBuffer>::const_iterator first,
+    std::vector<Aws::Utils::ByteBuffer>::const_iterator last);
+
+#endif //GLACIER_EXAMPLES_GLACIER_SAMPLES_H
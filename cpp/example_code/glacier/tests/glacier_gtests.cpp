@@ -0,0 +1,41 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "glacier_gtests.h"
+
+Aws::SDKOptions AwsDocTest::Glacier_GTests::s_options;
+std::unique_ptr<Aws::Client::ClientConfiguration> AwsDocTest::Glacier_GTests::s_clientConfig;
+
+void AwsDocTest::Glacier_GTests::SetUpTestSuite() {
+    InitAPI(s_options);
+
+    // s_clientConfig must be a pointer because the client config must be initialized after InitAPI
+    s_clientConfig = std::make_unique<Aws::Client::ClientConfiguration>();
+}
+
+void AwsDocTest::Glacier_GTests::TearDownTestSuite() {
+    s_clientConfig.reset();
+    ShutdownAPI(s_options);
+}
+
+void AwsDocTest::Glacier_GTests::SetUp() {
+    if (suppressStdOut()) {
+        m_savedBuffer = std::cout.rdbuf();
+        std::cout.rdbuf(&m_coutBuffer);
+    }
+}
+
+void AwsDocTest::Glacier_GTests::TearDown() {
+    if (m_savedBuffer != nullptr) {
+        std::cout.rdbuf(m_savedBuffer);
+        m_savedBuffer = nullptr;
+    }
+}
+
+Aws::String AwsDocTest::Glacier_GTests::preconditionError() {
+    return "Failed to meet precondition.";
+}
+
+bool AwsDocTest::Glacier_GTests::suppressStdOut() {
+    return std::getenv("EXAMPLE_TESTS_LOG_ON") == nullptr;
+}
@@ -0,0 +1,83 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <aws/core/utils/HashingUtils.h>
+#include <algorithm>
+#include "glacier_samples.h"
+#include "glacier_gtests.h"
+
+namespace AwsDocTest {
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Glacier_GTests, upload_archive_multipart_part_size_3_) {
+        const long long MB = 1024 * 1024;
+
+        EXPECT_TRUE(is_valid_part_size(MB));
+        EXPECT_TRUE(is_valid_part_size(4 * MB));
+        EXPECT_TRUE(is_valid_part_size(4096 * MB));
+
+        EXPECT_FALSE(is_valid_part_size(0));
+        EXPECT_FALSE(is_valid_part_size(MB / 2));
+        EXPECT_FALSE(is_valid_part_size(MB + 1));
+        EXPECT_FALSE(is_valid_part_size(3 * MB));
+        EXPECT_FALSE(is_valid_part_size(8192 * MB));
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Glacier_GTests, upload_archive_multipart_tree_hash_3_) {
+        const size_t MB = 1024 * 1024;
+        const size_t PART_SIZE = 2 * MB;
+
+        // Five and a half chunks, so the last part and the last chunk are short.
+        Aws::String data(5 * MB + MB / 2, '\0');
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(i * 31 + i / MB);
+        }
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data.data());
+
+        std::vector<Aws::Utils::ByteBuffer> chunkHashes;
+        for (size_t offset = 0; offset < data.size(); offset += MB) {
+            chunkHashes.push_back(sha256(bytes + offset, std::min(MB, data.size() - offset)));
+        }
+
+        // The archive hash combined from the chunk hashes is the SDK's tree hash.
+        Aws::Utils::ByteBuffer archiveHash = combine_tree_hashes(chunkHashes.begin(),
+                                                                 chunkHashes.end());
+        EXPECT_EQ(Aws::Utils::HashingUtils::HexEncode(archiveHash),
+                  Aws::Utils::HashingUtils::HexEncode(
+                          Aws::Utils::HashingUtils::CalculateSHA256TreeHash(data)));
+
+        // Each part hash is the tree hash of the part, and the part hashes
+        // combine into the archive hash.
+        std::vector<Aws::Utils::ByteBuffer> partHashes;
+        for (size_t offset = 0; offset < data.size(); offset += PART_SIZE) {
+            auto firstChunk = chunkHashes.begin() + offset / MB;
+            auto lastChunk = chunkHashes.begin() +
+                             std::min((offset + PART_SIZE) / MB, chunkHashes.size());
+            partHashes.push_back(combine_tree_hashes(firstChunk, lastChunk));
+
+            Aws::String part = data.substr(offset, PART_SIZE);
+            EXPECT_EQ(Aws::Utils::HashingUtils::HexEncode(partHashes.back()),
+                      Aws::Utils::HashingUtils::HexEncode(
+                              Aws::Utils::HashingUtils::CalculateSHA256TreeHash(part)))
+                                << "Part at offset " << offset;
+        }
+        ASSERT_EQ(partHashes.size(), 3u);
+        EXPECT_EQ(Aws::Utils::HashingUtils::HexEncode(
+                          combine_tree_hashes(partHashes.begin(), partHashes.end())),
+                  Aws::Utils::HashingUtils::HexEncode(archiveHash));
+
+        // A single hash is its own tree hash.
+        EXPECT_EQ(Aws::Utils::HashingUtils::HexEncode(
+                          combine_tree_hashes(chunkHashes.begin(), chunkHashes.begin() + 1)),
+                  Aws::Utils::HashingUtils::HexEncode(chunkHashes.front()));
+    }
+} // namespace AwsDocTest
@@ -17,24 +17,37 @@
 #include <aws/core/Aws.h>
 #include <aws/core/utils/HashingUtils.h>
 #include <aws/core/utils/Outcome.h>
+#include <aws/core/utils/crypto/Sha256.h>
+#include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/glacier/GlacierClient.h>
 #include <aws/glacier/model/AbortMultipartUploadRequest.h>
 #include <aws/glacier/model/InitiateMultipartUploadRequest.h>
 #include <aws/glacier/model/InitiateMultipartUploadResult.h>
+#include <aws/glacier/model/ListPartsRequest.h>
+#include <aws/glacier/model/ListPartsResult.h>
 #include <aws/glacier/model/UploadMultipartPartRequest.h>
 #include <aws/glacier/model/UploadMultipartPartResult.h>
 #include <aws/glacier/model/CompleteMultipartUploadRequest.h>
 #include <aws/glacier/model/CompleteMultipartUploadResult.h>
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include "glacier_samples.h"
 
 
 /**
  * Determine file size
  *
  */
-long get_file_size(const Aws::String& name)
+long long get_file_size(const Aws::String& name)
 {
     struct stat buffer;
     if (stat(name.c_str(), &buffer) != 0)
@@ -45,6 +58,28 @@ long get_file_size(const Aws::String& name)
 }
 
 
+/**
+ * Check a multipart upload part size
+ *
+ * Glacier accepts part sizes of 1 MB times a power of two, up to 4 GB. Parts of
+ * this size hold whole 1 MB chunks, and their tree hashes combine into the tree
+ * hash of the archive.
+ */
+bool is_valid_part_size(long long part_size)
+{
+    const long long chunk_size = 1024 * 1024;
+    const long long max_part_size = 4096 * chunk_size;
+    if (part_size < chunk_size || part_size > max_part_size ||
+        part_size % chunk_size != 0)
+    {
+        return false;
+    }
+
+    const long long chunk_count = part_size / chunk_size;
+    return (chunk_count & (chunk_count - 1)) == 0;
+}
+
+
 /**
  * Initiate a multipart archive upload to Amazon S3 Glacier
  *
@@ -56,6 +91,13 @@ Aws::String initiate_multipart_upload(const Aws::Glacier::GlacierClient& glacier
     const Aws::String& account_id,
     const Aws::String& archive_description)
 {
+    if (!is_valid_part_size(std::stoll(part_size.c_str())))
+    {
+        std::cout << "ERROR: The part size must be 1 MB times a power of two, up to 4 GB."
+            << std::endl;
+        return "";
+    }
+
     // Set up the request
     Aws::Glacier::Model::InitiateMultipartUploadRequest init_request;
     init_request.SetVaultName(vault_name);
@@ -80,9 +122,137 @@ Aws::String initiate_multipart_upload(const Aws::Glacier::GlacierClient& glacier
 }
 
 
+/**
+ * List the parts already uploaded for a multipart upload
+ *
+ * Fills uploaded_parts with the SHA-256 tree hash of each uploaded part, keyed
+ * by the part's first byte, and sets part_size to the upload's part size.
+ * Returns false on error.
+ */
+bool list_uploaded_parts(const Aws::Glacier::GlacierClient& glacier_client,
+    const Aws::String& vault_name,
+    const Aws::String& account_id,
+    const Aws::String& upload_id,
+    Aws::String& part_size,
+    Aws::Map<long long, Aws::String>& uploaded_parts)
+{
+    Aws::Glacier::Model::ListPartsRequest list_request;
+    list_request.SetUploadId(upload_id);
+    list_request.SetVaultName(vault_name);
+    list_request.SetAccountId(account_id);
+
+    // The parts are returned in pages, linked by a marker
+    Aws::String marker;
+    do
+    {
+        if (!marker.empty())
+        {
+            list_request.SetMarker(marker);
+        }
+
+        auto list_outcome = glacier_client.ListParts(list_request);
+        if (!list_outcome.IsSuccess())
+        {
+            std::cout << "ERROR: " << list_outcome.GetError().GetMessage() << std::endl;
+            return false;
+        }
+
+        const auto& result = list_outcome.GetResult();
+        part_size = std::to_string(result.GetPartSizeInBytes()).c_str();
+        for (const auto& part : result.GetParts())
+        {
+            // The range has the form "<first byte>-<last byte>"
+            long long first_byte = std::stoll(part.GetRangeInBytes().c_str());
+            uploaded_parts[first_byte] = part.GetSHA256TreeHash();
+        }
+        marker = result.GetMarker();
+    } while (!marker.empty());
+
+    return true;
+}
+
+
+/**
+ * Calculate the SHA-256 hash of a buffer
+ */
+Aws::Utils::ByteBuffer sha256(const unsigned char* data, size_t length)
+{
+    Aws::Utils::Crypto::Sha256 hash;
+    hash.Update(const_cast<unsigned char*>(data), length);
+    return hash.GetHash().GetResult();
+}
+
+
+/**
+ * Combine a range of SHA-256 tree hashes into their parent hash
+ *
+ * Adjacent hashes are concatenated and hashed until one hash remains. An odd
+ * hash at the end of a level is promoted to the next level unchanged.
+ */
+Aws::Utils::ByteBuffer combine_tree_hashes(
+    std::vector<Aws::Utils::ByteBuffer>::const_iterator first,
+    std::vector<Aws::Utils::ByteBuffer>::const_iterator last)
+{
+    std::vector<Aws::Utils::ByteBuffer> level(first, last);
+    while (level.size() > 1)
+    {
+        std::vector<Aws::Utils::ByteBuffer> parents;
+        for (size_t i = 0; i < level.size(); i += 2)
+        {
+            if (i + 1 == level.size())
+            {
+                parents.push_back(level[i]);
+                continue;
+            }
+
+            unsigned char pair[64];
+            memcpy(pair, level[i].GetUnderlyingData(), 32);
+            memcpy(pair + 32, level[i + 1].GetUnderlyingData(), 32);
+            parents.push_back(sha256(pair, sizeof(pair)));
+        }
+        level.swap(parents);
+    }
+
+    return level.empty() ? sha256(nullptr, 0) : level.front();
+}
+
+
+/**
+ * Read length bytes at offset from a file descriptor
+ *
+ * Uses positional reads, so threads can share the descriptor.
+ */
+bool read_at(int fd, unsigned char* buffer, size_t length, off_t offset)
+{
+    size_t total = 0;
+    while (total < length)
+    {
+        ssize_t count = pread(fd, buffer + total, length - total, offset + total);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+        total += count;
+    }
+    return true;
+}
+
+
 /**
  * Upload the parts of a multipart upload
  *
+ * Parts are read with positional reads and uploaded by thread_count threads.
+ * The SHA-256 hash of each 1 MB chunk is kept, so the part checksums and the
+ * checksum of the complete archive are combined from them, and the file is
+ * read only once.
+ *
+ * Parts listed in uploaded_parts with a matching checksum are not uploaded
+ * again, which resumes an interrupted upload.
+ *
  * Returns the checksum of the complete archive. If error, returns empty string.
  */
 Aws::String upload_parts(const Aws::Glacier::GlacierClient& glacier_client,
@@ -90,98 +260,135 @@ Aws::String upload_parts(const Aws::Glacier::GlacierClient& glacier_client,
     const Aws::String& part_size,
     const Aws::String& account_id,
     const Aws::String& upload_id,
-    const Aws::String& file_name)
+    const Aws::String& file_name,
+    int thread_count,
+    const Aws::Map<long long, Aws::String>& uploaded_parts)
 {
+    // Glacier computes tree hashes over 1 MB chunks, and the part size is
+    // a power of two multiple of 1 MB, so parts always hold whole chunks
+    const long long chunk_size = 1024 * 1024;
+    const long long part_size_int = std::stoll(part_size.c_str());
+    if (!is_valid_part_size(part_size_int))
+    {
+        std::cout << "ERROR: The part size must be 1 MB times a power of two, up to 4 GB."
+            << std::endl;
+        return "";
+    }
 
-    // Convert Aws::String --> std::string --> int
-    std::string part_size_std(part_size.c_str(), part_size.size());
-    int part_size_int = std::stoi(part_size_std);
-
-    // Open the file to upload
-    std::ifstream file (file_name.c_str(), std::ios::in | std::ios::binary);
-    if (!file.is_open())
+    const long long file_size = get_file_size(file_name);
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0 || file_size <= 0)
     {
         std::cout << "ERROR: Could not open " << file_name.c_str() << std::endl;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
         return "";
     }
 
-    // Process file in chucks of size part_size_int
-    Aws::List<Aws::Utils::ByteBuffer> part_checksums;
-    char* buffer = new char[part_size_int];
-    std::streamsize current_filepos = 0;
-    while (!file.eof())
-    {
-        // Read the next part
-        file.read(buffer, part_size_int);
-        std::streamsize chars_read = file.gcount();
-
-        // Copy buffer contents: char* --> std::string --> Aws::String
-        std::string buffer_std(buffer, chars_read);
-        Aws::String buffer_aws(buffer_std.c_str(), buffer_std.size());
-
-        // Calculate SHA-256 tree hash of part, saving each byte_checksum
-        Aws::Utils::ByteBuffer byte_checksum = Aws::Utils::HashingUtils::CalculateSHA256TreeHash(buffer_aws);
-        Aws::String part_checksum = Aws::Utils::HashingUtils::HexEncode(byte_checksum);
-        part_checksums.push_back(byte_checksum);
-
-        // Construct range string ("bytes %s-%s/*") --> Aws::String
-        std::string range = "bytes " + std::to_string(current_filepos) + "-" + 
-            std::to_string(current_filepos + chars_read - 1) + "/*";
-        Aws::String range_aws(range.c_str(), range.size());
-
-        // Set stream input to the loaded part buffer
-        // std::stringstream buffer_ptr(buffer_std);
-        const std::shared_ptr<Aws::IOStream> buffer_ptr = 
-            Aws::MakeShared<std::stringstream>("SampleAllocationTag", buffer_std);
-
-        // Set up request
-        Aws::Glacier::Model::UploadMultipartPartRequest upload_request;
-        upload_request.SetUploadId(upload_id);
-        upload_request.SetVaultName(vault_name);
-        upload_request.SetRange(range_aws);
-        upload_request.SetBody(buffer_ptr);
-        upload_request.SetChecksum(part_checksum);
-        upload_request.SetAccountId(account_id);
-
-        // Upload the part
-        auto upload_outcome = glacier_client.UploadMultipartPart(upload_request);
+    const long long part_count = (file_size + part_size_int - 1) / part_size_int;
+    const long long chunks_per_part = part_size_int / chunk_size;
+    // Each part writes only its own chunk hashes, so no lock is needed
+    std::vector<Aws::Utils::ByteBuffer> chunk_hashes(
+        (file_size + chunk_size - 1) / chunk_size);
 
-        // Process the result
-        if (upload_outcome.IsSuccess())
+    std::atomic<long long> next_part(0);
+    std::atomic<bool> failed(false);
+    std::atomic<long long> skipped_parts(0);
+    std::mutex output_mutex;
+
+    auto upload_worker = [&]()
+    {
+        // One part buffer per thread, reused for each part it uploads
+        std::vector<unsigned char> buffer(part_size_int);
+        for (long long part = next_part++; part < part_count && !failed; part = next_part++)
         {
-            // Update the current file position
-            current_filepos += chars_read;
-        }
-        else {
-            std::cout << "ERROR: " << upload_outcome.GetError().GetMessage() << std::endl;
-            file.close();
-            delete[] buffer;
-            return "";
+            const long long offset = part * part_size_int;
+            const size_t length = std::min(part_size_int, file_size - offset);
+            if (!read_at(fd, buffer.data(), length, offset))
+            {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                std::cout << "ERROR: Could not read " << file_name.c_str() << std::endl;
+                failed = true;
+                break;
+            }
+
+            // Calculate SHA-256 tree hash of part from its 1 MB chunks
+            const long long first_chunk = part * chunks_per_part;
+            long long last_chunk = first_chunk;
+            for (size_t chunk_offset = 0; chunk_offset < length; chunk_offset += chunk_size)
+            {
+                size_t chunk_length = std::min<size_t>(chunk_size, length - chunk_offset);
+                chunk_hashes[last_chunk++] = sha256(buffer.data() + chunk_offset, chunk_length);
+            }
+            Aws::String part_checksum = Aws::Utils::HashingUtils::HexEncode(
+                combine_tree_hashes(chunk_hashes.begin() + first_chunk,
+                                    chunk_hashes.begin() + last_chunk));
+
+            auto uploaded = uploaded_parts.find(offset);
+            if (uploaded != uploaded_parts.end() && uploaded->second == part_checksum)
+            {
+                ++skipped_parts;
+                continue;
+            }
+
+            // Construct range string ("bytes %s-%s/*") --> Aws::String
+            std::string range = "bytes " + std::to_string(offset) + "-" +
+                std::to_string(offset + length - 1) + "/*";
+
+            // Set stream input to the part buffer without copying it
+            Aws::Utils::Stream::PreallocatedStreamBuf stream_buf(buffer.data(), length);
+            const std::shared_ptr<Aws::IOStream> body =
+                Aws::MakeShared<Aws::IOStream>("SampleAllocationTag", &stream_buf);
+
+            // Set up request
+            Aws::Glacier::Model::UploadMultipartPartRequest upload_request;
+            upload_request.SetUploadId(upload_id);
+            upload_request.SetVaultName(vault_name);
+            upload_request.SetRange(range.c_str());
+            upload_request.SetBody(body);
+            upload_request.SetChecksum(part_checksum);
+            upload_request.SetAccountId(account_id);
+
+            // Upload the part
+            auto upload_outcome = glacier_client.UploadMultipartPart(upload_request);
+            if (!upload_outcome.IsSuccess())
+            {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                std::cout << "ERROR: " << upload_outcome.GetError().GetMessage() << std::endl;
+                failed = true;
+            }
         }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < std::max(thread_count, 1); ++i)
+    {
+        threads.emplace_back(upload_worker);
+    }
+    upload_worker();  // The calling thread is also a worker
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    close(fd);
+
+    if (failed)
+    {
+        return "";
+    }
+
+    if (skipped_parts > 0)
+    {
+        std::cout << "Skipped " << skipped_parts << " of " << part_count
+            << " parts which were already uploaded." << std::endl;
     }
 
-    // Clean up resources
-    file.close();
-    delete[] buffer;
-
-    // Calculate checksum for entire file
-#if 0
-    // Ideally, the file checksum is calculated from the checksums of the parts
-    // by calling the TreeHashFinalCompute() method. However, that method is
-    // not currently exposed.
-    Aws::Utils::ByteBuffer file_byte_checksum = 
-        Aws::Utils::HashingUtils::TreeHashFinalCompute(part_checksums);
-#else
-    // Until TreeHashFinalComplete() becomes public, calculate the checksum
-    // by re-reading the entire file.
-    const std::shared_ptr<Aws::IOStream> file_contents =
-        Aws::MakeShared<Aws::FStream>("SampleAllocationTag",
-            file_name.c_str(), std::ios::in | std::ios::binary);
-    Aws::Utils::ByteBuffer file_byte_checksum = 
-        Aws::Utils::HashingUtils::CalculateSHA256TreeHash(*file_contents);
-#endif
-    Aws::String file_checksum = Aws::Utils::HashingUtils::HexEncode(file_byte_checksum);
-    return file_checksum;
+    // Calculate checksum for entire file from the chunk hashes
+    Aws::Utils::ByteBuffer file_byte_checksum =
+        combine_tree_hashes(chunk_hashes.begin(), chunk_hashes.end());
+    return Aws::Utils::HashingUtils::HexEncode(file_byte_checksum);
 }
 
 
@@ -250,37 +457,68 @@ void abort_multipart_upload(const Aws::Glacier::GlacierClient& glacier_client,
 }
 
 
+#ifndef TESTING_BUILD
+
 /**
  * Upload a file in multiple parts to an archive in an Amazon S3 Glacier vault
+ *
+ * Usage: upload_archive_multipart [<vault_name> <file_name> [<upload_id>]]
+ *
+ * If an upload ID is given, the parts already uploaded to it are skipped.
  */
 int main(int argc, char** argv)
 {
     Aws::SDKOptions options;
     Aws::InitAPI(options);
     {
-        // Assign these values before running the program
+        // Assign these values before running the program, or pass them as arguments
         Aws::String vault_name("VAULT_NAME");
         Aws::String file_name("FILE_NAME");
+        Aws::String upload_id;
+        if (argc > 2)
+        {
+            vault_name = argv[1];
+            file_name = argv[2];
+        }
+        if (argc > 3)
+        {
+            upload_id = argv[3];
+        }
 
         // Optional values to modify
         // Aws::String part_size = "1048576";  // 1MB
         Aws::String part_size = "4194304";  // 4MB
         Aws::String account_id("-");        // Hyphen = Use current user's credentials
         Aws::String archive_description("TestArchiveUpload");
+        const int upload_threads = 4;       // Parts uploaded at the same time
 
-        // Initiate multipart upload
-        Aws::Glacier::GlacierClient glacier_client;
-        Aws::String upload_id = initiate_multipart_upload(glacier_client, 
-            vault_name, part_size, account_id, archive_description);
-        if (upload_id.empty()) {
+        Aws::Client::ClientConfiguration client_config;
+        client_config.maxConnections = upload_threads;
+        Aws::Glacier::GlacierClient glacier_client(client_config);
+
+        Aws::Map<long long, Aws::String> uploaded_parts;
+        if (upload_id.empty())
+        {
+            // Initiate multipart upload
+            upload_id = initiate_multipart_upload(glacier_client,
+                vault_name, part_size, account_id, archive_description);
+            if (upload_id.empty()) {
+                exit(1);
+            }
+        }
+        else if (!list_uploaded_parts(glacier_client, vault_name, account_id,
+            upload_id, part_size, uploaded_parts))
+        {
             exit(1);
         }
 
         // Upload all parts
-        Aws::String checksum = upload_parts(glacier_client,
-            vault_name, part_size, account_id, upload_id, file_name);
+        Aws::String checksum = upload_parts(glacier_client, vault_name, part_size,
+            account_id, upload_id, file_name, upload_threads, uploaded_parts);
         if (checksum.empty()) {
-            abort_multipart_upload(glacier_client, vault_name, account_id, upload_id);
+            // The upload is not aborted, so that it can be resumed
+            std::cout << "To resume the upload, run again with upload ID "
+                << upload_id << std::endl;
             exit(2);
         }
 
@@ -307,3 +545,5 @@ int main(int argc, char** argv)
     Aws::ShutdownAPI(options);
     return 0;
 }
+
+#endif // TESTING_BUILD
@@ -62,6 +62,7 @@
 #include <aws/s3/model/PutObjectRequest.h>
 #include <vector>
 #include <fstream>
+#include "awsdoc/waiter.h"
 #include "glue_samples.h"
 
 
@@ -251,39 +252,48 @@ bool AwsDoc::Glue::runGettingStartedWithGlueScenario(const Aws::String &bucketNa
             std::cout << "This may take a while to run." << std::endl;
 
             Aws::Glue::Model::CrawlerState crawlerState = Aws::Glue::Model::CrawlerState::NOT_SET;
-            int iterations = 0;
-            while (Aws::Glue::Model::CrawlerState::READY != crawlerState) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                ++iterations;
-                if ((iterations % 10) == 0) { // Log status every 10 seconds.
-                    std::cout << "Crawler status " <<
-                              Aws::Glue::Model::CrawlerStateMapper::GetNameForCrawlerState(
-                                      crawlerState)
-                              << ". After " << iterations
-                              << " seconds elapsed."
-                              << std::endl;
-                }
+            AwsDoc::WaiterOptions waiterOptions;
+            waiterOptions.mTimeout = std::chrono::minutes(30);
+            // The crawler can report READY just after it is started.
+            waiterOptions.mDelayFirstPoll = true;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
                 Aws::Glue::Model::GetCrawlerRequest getCrawlerRequest;
                 getCrawlerRequest.SetName(CRAWLER_NAME);
 
                 Aws::Glue::Model::GetCrawlerOutcome getCrawlerOutcome = client.GetCrawler(
                         getCrawlerRequest);
 
-                if (getCrawlerOutcome.IsSuccess()) {
-                    crawlerState = getCrawlerOutcome.GetResult().GetCrawler().GetState();
-                }
-                else {
+                if (!getCrawlerOutcome.IsSuccess()) {
                     std::cerr << "Error getting crawler.  "
                               << getCrawlerOutcome.GetError().GetMessage() << std::endl;
-                    break;
+                    return AwsDoc::WaiterState::FAILURE;
                 }
-            }
 
-            if (Aws::Glue::Model::CrawlerState::READY == crawlerState) {
-                std::cout << "Crawler finished running after " << iterations
+                Aws::Glue::Model::CrawlerState state =
+                        getCrawlerOutcome.GetResult().GetCrawler().GetState();
+                if (state != crawlerState) {
+                    crawlerState = state;
+                    std::cout << "Crawler status " <<
+                              Aws::Glue::Model::CrawlerStateMapper::GetNameForCrawlerState(
+                                      crawlerState)
+                              << "." << std::endl;
+                }
+
+                return Aws::Glue::Model::CrawlerState::READY == crawlerState ?
+                       AwsDoc::WaiterState::SUCCESS : AwsDoc::WaiterState::RETRY;
+            }, waiterOptions);
+
+            if (AwsDoc::WaiterState::SUCCESS == waiterState) {
+                std::cout << "Crawler finished running after "
+                          << std::chrono::duration_cast<std::chrono::seconds>(
+                                  std::chrono::steady_clock::now() - start).count()
                           << " seconds."
                           << std::endl;
             }
+            else if (AwsDoc::WaiterState::TIMEOUT == waiterState) {
+                std::cerr << "Wait for the crawler to finish timed out." << std::endl;
+            }
         }
         else {
             std::cerr << "Error starting a crawler.  "
@@ -408,11 +418,11 @@ bool AwsDoc::Glue::runGettingStartedWithGlueScenario(const Aws::String &bucketNa
 
             Aws::String jobRunId = outcome.GetResult().GetJobRunId();
 
-            int iterator = 0;
-            bool done = false;
-            while (!done) {
-                ++iterator;
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+            Aws::Glue::Model::JobRunState lastJobRunState = Aws::Glue::Model::JobRunState::NOT_SET;
+            AwsDoc::WaiterOptions waiterOptions;
+            waiterOptions.mTimeout = std::chrono::minutes(30);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
                 Aws::Glue::Model::GetJobRunRequest jobRunRequest;
                 jobRunRequest.SetJobName(JOB_NAME);
                 jobRunRequest.SetRunId(jobRunId);
@@ -420,44 +430,50 @@ bool AwsDoc::Glue::runGettingStartedWithGlueScenario(const Aws::String &bucketNa
                 Aws::Glue::Model::GetJobRunOutcome jobRunOutcome = client.GetJobRun(
                         jobRunRequest);
 
-                if (jobRunOutcome.IsSuccess()) {
-                    const Aws::Glue::Model::JobRun &jobRun = jobRunOutcome.GetResult().GetJobRun();
-                    Aws::Glue::Model::JobRunState jobRunState = jobRun.GetJobRunState();
-
-                    if ((jobRunState == Aws::Glue::Model::JobRunState::STOPPED) ||
-                        (jobRunState == Aws::Glue::Model::JobRunState::FAILED) ||
-                        (jobRunState == Aws::Glue::Model::JobRunState::TIMEOUT)) {
-                        std::cerr << "Error running job. "
-                                  << jobRun.GetErrorMessage()
-                                  << std::endl;
-                        deleteAssets(CRAWLER_NAME, CRAWLER_DATABASE_NAME, JOB_NAME,
-                                     bucketName,
-                                     clientConfig);
-                        return false;
-                    }
-                    else if (jobRunState ==
-                             Aws::Glue::Model::JobRunState::SUCCEEDED) {
-                        std::cout << "Job run succeeded after  " << iterator <<
-                                  " seconds elapsed." << std::endl;
-                        done = true;
-                    }
-                    else if ((iterator % 10) == 0) { // Log status every 10 seconds.
-                        std::cout << "Job run status " <<
-                                  Aws::Glue::Model::JobRunStateMapper::GetNameForJobRunState(
-                                          jobRunState) <<
-                                  ". " << iterator <<
-                                  " seconds elapsed." << std::endl;
-                    }
-                }
-                else {
+                if (!jobRunOutcome.IsSuccess()) {
                     std::cerr << "Error retrieving job run state. "
                               << jobRunOutcome.GetError().GetMessage()
                               << std::endl;
-                    deleteAssets(CRAWLER_NAME, CRAWLER_DATABASE_NAME, JOB_NAME,
-                                 bucketName, clientConfig);
-                    return false;
+                    return AwsDoc::WaiterState::FAILURE;
+                }
+
+                const Aws::Glue::Model::JobRun &jobRun = jobRunOutcome.GetResult().GetJobRun();
+                Aws::Glue::Model::JobRunState jobRunState = jobRun.GetJobRunState();
+
+                if ((jobRunState == Aws::Glue::Model::JobRunState::STOPPED) ||
+                    (jobRunState == Aws::Glue::Model::JobRunState::FAILED) ||
+                    (jobRunState == Aws::Glue::Model::JobRunState::TIMEOUT)) {
+                    std::cerr << "Error running job. "
+                              << jobRun.GetErrorMessage()
+                              << std::endl;
+                    return AwsDoc::WaiterState::FAILURE;
+                }
+                else if (jobRunState == Aws::Glue::Model::JobRunState::SUCCEEDED) {
+                    return AwsDoc::WaiterState::SUCCESS;
                 }
+                else if (jobRunState != lastJobRunState) {
+                    lastJobRunState = jobRunState;
+                    std::cout << "Job run status " <<
+                              Aws::Glue::Model::JobRunStateMapper::GetNameForJobRunState(
+                                      jobRunState) << "." << std::endl;
+                }
+
+                return AwsDoc::WaiterState::RETRY;
+            }, waiterOptions);
+
+            if (AwsDoc::WaiterState::SUCCESS != waiterState) {
+                if (AwsDoc::WaiterState::TIMEOUT == waiterState) {
+                    std::cerr << "Wait for the job run timed out." << std::endl;
+                }
+                deleteAssets(CRAWLER_NAME, CRAWLER_DATABASE_NAME, JOB_NAME,
+                             bucketName, clientConfig);
+                return false;
             }
+
+            std::cout << "Job run succeeded after  "
+                      << std::chrono::duration_cast<std::chrono::seconds>(
+                              std::chrono::steady_clock::now() - start).count()
+                      << " seconds elapsed." << std::endl;
         }
         else {
             std::cerr << "Error starting a job. " << outcome.GetError().GetMessage()
@@ -48,6 +48,7 @@
 #include <aws/core/utils/StringUtils.h>
 #include <aws/core/utils/Document.h>
 #include <aws/core/auth/AWSCredentials.h>
+#include "awsdoc/waiter.h"
 #include "iam_samples.h"
 
 // snippet-start:[cpp.example_code.iam.Scenario_CreateUserAssumeRole]
@@ -69,6 +70,17 @@ namespace AwsDoc {
     }
 
     static const int LIST_BUCKETS_WAIT_SEC = 20;
+    static const int ROLE_WAIT_SEC = 20;
+
+    //! Routine which returns the whole seconds elapsed since a time.
+    /*!
+      \param start: The start time.
+      \return long long: The elapsed seconds.
+    */
+    static long long elapsedSeconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
 
     static const char ALLOCATION_TAG[] = "example_code";
 }
@@ -239,29 +251,30 @@ bool AwsDoc::IAM::iamCreateUserAssumeRoleScenario(
 
         // Repeatedly call AssumeRole, because there is often a delay
         // before the role is available to be assumed.
-        // Repeat at most 20 times when access is denied.
-        int count = 0;
-        while (true) {
+        // Retry for at most ROLE_WAIT_SEC seconds when access is denied.
+        AwsDoc::WaiterOptions waiterOptions;
+        waiterOptions.mTimeout = std::chrono::seconds(ROLE_WAIT_SEC);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
             assumeRoleOutcome = stsClient.AssumeRole(request);
-            if (!assumeRoleOutcome.IsSuccess()) {
-                if (count > 20 ||
-                    assumeRoleOutcome.GetError().GetErrorType() !=
-                    Aws::STS::STSErrors::ACCESS_DENIED) {
-                    std::cerr << "Error assuming role after 20 tries. " <<
-                              assumeRoleOutcome.GetError().GetMessage() << std::endl;
-
-                    DeleteCreatedEntities(client, role, user, policy);
-                    return false;
-                }
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            }
-            else {
-                std::cout << "Successfully assumed the role after " << count
-                          << " seconds." << std::endl;
-                break;
+            if (assumeRoleOutcome.IsSuccess()) {
+                return AwsDoc::WaiterState::SUCCESS;
             }
-            count++;
+            return assumeRoleOutcome.GetError().GetErrorType() ==
+                   Aws::STS::STSErrors::ACCESS_DENIED ?
+                   AwsDoc::WaiterState::RETRY : AwsDoc::WaiterState::FAILURE;
+        }, waiterOptions);
+
+        if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+            std::cerr << "Error assuming role after "
+                      << elapsedSeconds(start) << " seconds. " <<
+                      assumeRoleOutcome.GetError().GetMessage() << std::endl;
+
+            DeleteCreatedEntities(client, role, user, policy);
+            return false;
         }
+        std::cout << "Successfully assumed the role after " << elapsedSeconds(start)
+                  << " seconds." << std::endl;
 
         credentials = assumeRoleOutcome.GetResult().GetCredentials();
     }
@@ -317,38 +330,41 @@ bool AwsDoc::IAM::iamCreateUserAssumeRoleScenario(
         }
     }
 
-    int count = 0;
     // 7. List objects in the bucket (this should succeed).
     // Repeatedly call ListBuckets, because there is often a delay
     // before the policy with ListBucket permissions has been applied to the role.
-    // Repeat at most LIST_BUCKETS_WAIT_SEC times when access is denied.
-    while (true) {
+    // Retry for at most LIST_BUCKETS_WAIT_SEC seconds when access is denied.
+    {
         Aws::S3::S3Client s3Client(
                 Aws::Auth::AWSCredentials(credentials.GetAccessKeyId(),
                                           credentials.GetSecretAccessKey(),
                                           credentials.GetSessionToken()),
                 Aws::MakeShared<Aws::S3::S3EndpointProvider>(ALLOCATION_TAG),
                 clientConfig);
-        Aws::S3::Model::ListBucketsOutcome listBucketsOutcome = s3Client.ListBuckets();
-        if (!listBucketsOutcome.IsSuccess()) {
-            if ((count > LIST_BUCKETS_WAIT_SEC) ||
-                listBucketsOutcome.GetError().GetErrorType() !=
-                Aws::S3::S3Errors::ACCESS_DENIED) {
-                std::cerr << "Could not lists buckets after " << LIST_BUCKETS_WAIT_SEC << " seconds. " <<
-                          listBucketsOutcome.GetError().GetMessage() << std::endl;
-                DeleteCreatedEntities(client, role, user, policy);
-                return false;
+        Aws::S3::Model::ListBucketsOutcome listBucketsOutcome;
+        AwsDoc::WaiterOptions waiterOptions;
+        waiterOptions.mTimeout = std::chrono::seconds(LIST_BUCKETS_WAIT_SEC);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
+            listBucketsOutcome = s3Client.ListBuckets();
+            if (listBucketsOutcome.IsSuccess()) {
+                return AwsDoc::WaiterState::SUCCESS;
             }
-
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            return listBucketsOutcome.GetError().GetErrorType() ==
+                   Aws::S3::S3Errors::ACCESS_DENIED ?
+                   AwsDoc::WaiterState::RETRY : AwsDoc::WaiterState::FAILURE;
+        }, waiterOptions);
+
+        if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+            std::cerr << "Could not lists buckets after " << elapsedSeconds(start)
+                      << " seconds. " <<
+                      listBucketsOutcome.GetError().GetMessage() << std::endl;
+            DeleteCreatedEntities(client, role, user, policy);
+            return false;
         }
-        else {
 
-            std::cout << "Successfully retrieved bucket lists after " << count
-                      << " seconds." << std::endl;
-            break;
-        }
-        count++;
+        std::cout << "Successfully retrieved bucket lists after "
+                  << elapsedSeconds(start) << " seconds." << std::endl;
     }
 
     // 8. Delete all the created resources.
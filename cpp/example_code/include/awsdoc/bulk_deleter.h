@@ -0,0 +1,420 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef AWSDOC_BULK_DELETER_H
+#define AWSDOC_BULK_DELETER_H
+
+#include <aws/core/Aws.h>
+#include <aws/core/client/AWSError.h>
+#include <aws/core/http/HttpResponse.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "awsdoc/waiter.h"
+
+/**
+ * A deleter which removes many resources with concurrent delete requests, for
+ * example the image sets of an AWS HealthImaging data store, the objects in an
+ * Amazon Simple Storage Service (Amazon S3) bucket, or the items in an Amazon
+ * DynamoDB table.
+ *
+ * A producer, usually a paginated List, Search, or Scan loop, pushes keys while
+ * worker threads delete them, so deletion starts with the first page. push()
+ * waits while the queue is full, so the producer cannot run far ahead of the
+ * deletes. Keys are grouped into batches of up to mBatchSize keys, for services
+ * with batch delete operations, and each batch is passed to a delete function.
+ *
+ * The delete function returns the keys which can be sent again, such as keys
+ * rejected for throttling or unprocessed items, and these are retried with
+ * jittered exponential backoff. When a batch is throttled, the number of batches
+ * sent at the same time is halved, and it grows again by one after each run of
+ * unthrottled batches, so the deleter settles near the rate the service allows.
+ *
+ *   AwsDoc::BulkDeleter<Aws::String> deleter(
+ *           [&](const std::vector<Aws::String> &keys) {
+ *               AwsDoc::BulkDeleteResult<Aws::String> result;
+ *               ...
+ *               return result;
+ *           }, options);
+ *   deleter.push("key");
+ *   bool allDeleted = deleter.finish();
+ *   deleter.printSummary(std::cout);
+ */
+
+namespace AwsDoc {
+    // Options for BulkDeleter.
+    struct BulkDeleterOptions {
+        // The most batches sent at the same time.
+        size_t mMaxConcurrency = 8;
+        // Keys in each delete request. Use 1 for services which delete one
+        // resource for each request.
+        size_t mBatchSize = 1;
+        // The longest time a key waits for its batch to fill.
+        std::chrono::milliseconds mMaxBatchDelay = std::chrono::milliseconds(50);
+        // Keys queued before push() waits.
+        size_t mQueueCapacity = 2000;
+        // Retries for a key which can be sent again.
+        int mMaxRetries = 8;
+        // The backoff between retries. mTimeout is not used.
+        WaiterOptions mRetryBackoff;
+        // The interval between progress lines, or 0 for none.
+        std::chrono::seconds mProgressInterval = std::chrono::seconds(5);
+        // The name of the deleted resources, used in the progress lines.
+        Aws::String mResourceName = "resources";
+
+        BulkDeleterOptions() {
+            mRetryBackoff.mInitialDelay = std::chrono::milliseconds(200);
+            mRetryBackoff.mMaxDelay = std::chrono::seconds(10);
+        }
+    };
+
+    // Metrics for a BulkDeleter.
+    struct BulkDeleterMetrics {
+        uint64_t mQueued = 0;
+        uint64_t mDeleted = 0;
+        uint64_t mFailed = 0;
+        uint64_t mBatchesSent = 0;
+        uint64_t mRetriedKeys = 0;
+        uint64_t mThrottledBatches = 0;
+        // The batches allowed at the same time, after throttling.
+        size_t mConcurrency = 0;
+        double mSeconds = 0.0;
+
+        double deletedPerSecond() const {
+            return mSeconds > 0.0 ? static_cast<double>(mDeleted) / mSeconds : 0.0;
+        }
+    };
+
+    // The result of deleting a batch of keys. Keys which are neither retried nor
+    // counted as failed were deleted.
+    template<typename KEY_TYPE>
+    struct BulkDeleteResult {
+        // Keys which were not deleted and can be sent again.
+        std::vector<KEY_TYPE> mRetryKeys;
+        // Keys which failed and are not sent again.
+        size_t mFailed = 0;
+        // The request, or some of its keys, was throttled.
+        bool mThrottled = false;
+    };
+
+    //! Routine which returns true if an error shows the request was throttled.
+    /*!
+      \sa isThrottlingError()
+      \param error: The error of a failed outcome.
+      \return bool: True for a throttling error.
+     */
+    template<typename ERROR_TYPE>
+    bool isThrottlingError(const Aws::Client::AWSError<ERROR_TYPE> &error) {
+        if (error.GetResponseCode() == Aws::Http::HttpResponseCode::TOO_MANY_REQUESTS) {
+            return true;
+        }
+        const Aws::String &name = error.GetExceptionName();
+        return name.find("Throttl") != Aws::String::npos ||
+               name.find("SlowDown") != Aws::String::npos ||
+               name.find("ProvisionedThroughputExceeded") != Aws::String::npos ||
+               name.find("RequestLimitExceeded") != Aws::String::npos;
+    }
+
+    template<typename KEY_TYPE>
+    class BulkDeleter {
+    public:
+        typedef BulkDeleterOptions Options;
+        typedef BulkDeleterMetrics Metrics;
+        typedef BulkDeleteResult<KEY_TYPE> Result;
+        typedef std::function<Result(const std::vector<KEY_TYPE> &keys)> DeleteBatch;
+
+        //! BulkDeleter constructor.
+        /*!
+          \param deleteBatch: Function which deletes a batch of keys. It is called
+                              from the worker threads, so it must be thread safe.
+                              Its client's maxConnections should cover mMaxConcurrency.
+          \param options: The deleter options.
+         */
+        explicit BulkDeleter(const DeleteBatch &deleteBatch,
+                             const Options &options = Options()) :
+                mDeleteBatch(deleteBatch), mOptions(options),
+                mStart(std::chrono::steady_clock::now()), mLastProgress(mStart),
+                mQueued(0), mDeleted(0), mFailed(0), mBatchesSent(0),
+                mRetriedKeys(0), mThrottledBatches(0) {
+            const size_t threadCount = std::max<size_t>(mOptions.mMaxConcurrency, 1);
+            mConcurrency = threadCount;
+            for (size_t i = 0; i < threadCount; ++i) {
+                mThreads.emplace_back(&BulkDeleter::deleteLoop, this);
+            }
+        }
+
+        BulkDeleter(const BulkDeleter &) = delete;
+
+        BulkDeleter &operator=(const BulkDeleter &) = delete;
+
+        //! BulkDeleter destructor. Waits for queued keys to be deleted.
+        ~BulkDeleter() {
+            finish();
+        }
+
+        //! Routine which queues a key for deletion. This routine is thread safe.
+        /*!
+          \param key: The key.
+          \return void:
+         */
+        void push(const KEY_TYPE &key) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mSpaceAvailable.wait(lock, [this] {
+                return mPending.size() < mOptions.mQueueCapacity || mClosed;
+            });
+            if (mClosed) {
+                std::cerr << "Error with BulkDeleter::push. The deleter has finished."
+                          << std::endl;
+                ++mFailed;
+                return;
+            }
+            mPending.push_back(Pending(key));
+            ++mQueued;
+            mWorkAvailable.notify_one();
+        }
+
+        //! Routine which waits until the queued keys are deleted or have failed,
+        //! and stops the workers. Keys cannot be pushed afterward.
+        /*!
+          \return bool: True if no key has failed.
+         */
+        bool finish() {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mClosed = true;
+            }
+            mWorkAvailable.notify_all();
+            mSpaceAvailable.notify_all();
+            for (std::thread &thread: mThreads) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mThreadsJoined) {
+                    mThreadsJoined = true;
+                    mFinished = std::chrono::steady_clock::now();
+                }
+            }
+
+            return mFailed == 0;
+        }
+
+        //! Routine which returns a snapshot of the deleter metrics.
+        /*!
+          \return Metrics: The metrics.
+         */
+        Metrics getMetrics() const {
+            Metrics metrics;
+            metrics.mQueued = mQueued;
+            metrics.mDeleted = mDeleted;
+            metrics.mFailed = mFailed;
+            metrics.mBatchesSent = mBatchesSent;
+            metrics.mRetriedKeys = mRetriedKeys;
+            metrics.mThrottledBatches = mThrottledBatches;
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            metrics.mConcurrency = mConcurrency;
+            const std::chrono::steady_clock::time_point end =
+                    mThreadsJoined ? mFinished : std::chrono::steady_clock::now();
+            metrics.mSeconds = std::chrono::duration<double>(end - mStart).count();
+            return metrics;
+        }
+
+        //! Routine which writes a summary of the deletion.
+        /*!
+          \param stream: The output stream.
+          \return void:
+         */
+        void printSummary(std::ostream &stream) const {
+            Metrics metrics = getMetrics();
+            stream << "Deleted " << metrics.mDeleted << " of " << metrics.mQueued << " "
+                   << mOptions.mResourceName << " in " << std::fixed
+                   << std::setprecision(1) << metrics.mSeconds << " seconds ("
+                   << metrics.deletedPerSecond() << " per second)." << std::endl;
+            stream << "  " << metrics.mBatchesSent << " delete requests, "
+                   << metrics.mThrottledBatches << " throttled, "
+                   << metrics.mRetriedKeys << " retried keys, "
+                   << metrics.mFailed << " failed." << std::endl;
+            stream << "  Concurrency ended at " << metrics.mConcurrency << " of "
+                   << std::max<size_t>(mOptions.mMaxConcurrency, 1) << "." << std::endl;
+        }
+
+    private:
+        struct Pending {
+            explicit Pending(const KEY_TYPE &key) :
+                    mKey(key), mQueued(std::chrono::steady_clock::now()) {}
+
+            KEY_TYPE mKey;
+            std::chrono::steady_clock::time_point mQueued;
+        };
+
+        void deleteLoop() {
+            const size_t batchSize = std::max<size_t>(mOptions.mBatchSize, 1);
+            std::vector<KEY_TYPE> batch;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    while (true) {
+                        if (mPending.size() >= batchSize ||
+                            (mClosed && !mPending.empty())) {
+                            break;
+                        }
+                        if (mPending.empty()) {
+                            if (mClosed) {
+                                return;
+                            }
+                            mWorkAvailable.wait(lock);
+                            continue;
+                        }
+
+                        // Wait for a full batch until the oldest key is due.
+                        std::chrono::steady_clock::time_point due =
+                                mPending.front().mQueued + mOptions.mMaxBatchDelay;
+                        if (mWorkAvailable.wait_until(lock, due) ==
+                            std::cv_status::timeout && !mPending.empty()) {
+                            break;
+                        }
+                    }
+
+                    while (!mPending.empty() && batch.size() < batchSize) {
+                        batch.push_back(std::move(mPending.front().mKey));
+                        mPending.pop_front();
+                    }
+                }
+                mSpaceAvailable.notify_all();
+
+                deleteWithRetries(batch);
+                batch.clear();
+                printProgress();
+            }
+        }
+
+        void deleteWithRetries(std::vector<KEY_TYPE> &keys) {
+            for (int attempt = 0; !keys.empty(); ++attempt) {
+                acquireSendSlot();
+                Result result = mDeleteBatch(keys);
+                releaseSendSlot(result.mThrottled);
+                ++mBatchesSent;
+
+                const size_t retryCount = std::min(result.mRetryKeys.size(), keys.size());
+                const size_t failedCount = std::min(result.mFailed, keys.size() - retryCount);
+                mDeleted += keys.size() - retryCount - failedCount;
+                mFailed += failedCount;
+                if (result.mThrottled) {
+                    ++mThrottledBatches;
+                }
+                if (retryCount == 0) {
+                    return;
+                }
+
+                if (attempt >= mOptions.mMaxRetries) {
+                    std::cerr << "Error with BulkDeleter. " << retryCount
+                              << " keys were not deleted after " << attempt + 1
+                              << " attempts." << std::endl;
+                    mFailed += retryCount;
+                    return;
+                }
+
+                keys.swap(result.mRetryKeys);
+                keys.resize(retryCount);
+                mRetriedKeys += retryCount;
+                std::this_thread::sleep_for(waiterDelay(mOptions.mRetryBackoff, attempt));
+            }
+        }
+
+        // Waits until fewer batches are being sent than the concurrency allows.
+        void acquireSendSlot() {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mSendSlotAvailable.wait(lock, [this] {
+                return mSending < mConcurrency;
+            });
+            ++mSending;
+        }
+
+        // A throttled batch halves the concurrency. It grows by one after as many
+        // unthrottled batches as the current concurrency.
+        void releaseSendSlot(bool throttled) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                --mSending;
+                const size_t maxConcurrency = std::max<size_t>(mOptions.mMaxConcurrency, 1);
+                if (throttled) {
+                    mConcurrency = std::max<size_t>(mConcurrency / 2, 1);
+                    mUnthrottledBatches = 0;
+                }
+                else if (mConcurrency < maxConcurrency &&
+                         ++mUnthrottledBatches >= mConcurrency) {
+                    ++mConcurrency;
+                    mUnthrottledBatches = 0;
+                }
+            }
+            mSendSlotAvailable.notify_all();
+        }
+
+        void printProgress() {
+            if (mOptions.mProgressInterval.count() <= 0) {
+                return;
+            }
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (now - mLastProgress < mOptions.mProgressInterval) {
+                    return;
+                }
+                mLastProgress = now;
+            }
+
+            Metrics metrics = getMetrics();
+            std::lock_guard<std::mutex> lock(mProgressMutex);
+            std::cout << "Deleted " << metrics.mDeleted << " of " << metrics.mQueued
+                      << " " << mOptions.mResourceName << " queued so far, "
+                      << metrics.mFailed << " failed, " << std::fixed
+                      << std::setprecision(1) << metrics.deletedPerSecond()
+                      << " per second, " << metrics.mConcurrency
+                      << " requests at a time." << std::endl;
+        }
+
+        const DeleteBatch mDeleteBatch;
+        const Options mOptions;
+        const std::chrono::steady_clock::time_point mStart;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mWorkAvailable;
+        std::condition_variable mSpaceAvailable;
+        std::condition_variable mSendSlotAvailable;
+        std::deque<Pending> mPending;
+        size_t mConcurrency = 1;
+        size_t mSending = 0;
+        size_t mUnthrottledBatches = 0;
+        bool mClosed = false;
+        bool mThreadsJoined = false;
+        std::chrono::steady_clock::time_point mFinished;
+        std::chrono::steady_clock::time_point mLastProgress;
+
+        std::mutex mProgressMutex;
+
+        std::atomic<uint64_t> mQueued;
+        std::atomic<uint64_t> mDeleted;
+        std::atomic<uint64_t> mFailed;
+        std::atomic<uint64_t> mBatchesSent;
+        std::atomic<uint64_t> mRetriedKeys;
+        std::atomic<uint64_t> mThrottledBatches;
+
+        std::vector<std::thread> mThreads;
+    };
+} // namespace AwsDoc
+
+#endif //AWSDOC_BULK_DELETER_H
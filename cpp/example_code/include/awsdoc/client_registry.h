@@ -0,0 +1,141 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef AWSDOC_CLIENT_REGISTRY_H
+#define AWSDOC_CLIENT_REGISTRY_H
+
+#include <aws/core/Aws.h>
+#include <aws/core/client/ClientConfiguration.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <utility>
+
+/**
+ * A process-wide registry of shared AWS service clients.
+ *
+ * Constructing a service client resolves the endpoint, builds the credentials
+ * provider chain, and creates a new HTTP connection pool. Code that constructs a
+ * client for every call pays that cost, including new TLS handshakes, each time.
+ *
+ * The registry hands out one client per (client type, client configuration) pair.
+ * Service clients are thread safe, so the returned client can be shared across
+ * threads and calls, and it keeps its connection pool warm between calls.
+ *
+ * The registry must be cleared with ClientRegistry::clear() before calling
+ * Aws::ShutdownAPI, because clients must not outlive the SDK.
+ */
+
+namespace AwsDoc {
+
+    class ClientRegistry {
+    public:
+        //! Routine which returns a shared client for a client configuration.
+        /*!
+          A client is created the first time a client type and configuration
+          pair is requested. Later requests return the same instance.
+          \sa getClient()
+          \param clientConfig: Aws client configuration.
+          \return std::shared_ptr<CLIENT_TYPE>: The shared client.
+         */
+        template<typename CLIENT_TYPE>
+        static std::shared_ptr<CLIENT_TYPE>
+        getClient(const Aws::Client::ClientConfiguration &clientConfig) {
+            Registry &registry = getRegistry();
+            const RegistryKey key(std::type_index(typeid(CLIENT_TYPE)),
+                                  fingerprint(clientConfig));
+
+            std::lock_guard<std::mutex> lock(registry.mMutex);
+            auto iter = registry.mClients.find(key);
+            if (iter != registry.mClients.end()) {
+                return std::static_pointer_cast<CLIENT_TYPE>(iter->second);
+            }
+
+            std::shared_ptr<CLIENT_TYPE> client = Aws::MakeShared<CLIENT_TYPE>(
+                    ALLOCATION_TAG, clientConfig);
+            registry.mClients.emplace(key, client);
+
+            return client;
+        }
+
+        //! Routine which releases all the clients held by the registry.
+        /*!
+          Call this routine before Aws::ShutdownAPI. Clients still referenced by
+          callers stay alive until those references are released.
+          \sa clear()
+          \return void:
+         */
+        static void clear() {
+            Registry &registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mMutex);
+            registry.mClients.clear();
+        }
+
+        //! Routine which returns the number of clients held by the registry.
+        /*!
+          \sa size()
+          \return size_t: The number of clients.
+         */
+        static size_t size() {
+            Registry &registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mMutex);
+            return registry.mClients.size();
+        }
+
+        //! Routine which builds a key from the client configuration settings
+        //! that affect how a client connects.
+        /*!
+          Only value settings are part of the key. Pointer settings, such as the
+          executor and the retry strategy, are not, because a new pointer in every
+          configuration would add a client to the registry for every call. The
+          client for a key uses the executor and retry strategy of the first
+          configuration that requested it.
+          \sa fingerprint()
+          \param clientConfig: Aws client configuration.
+          \return Aws::String: The fingerprint.
+         */
+        static Aws::String
+        fingerprint(const Aws::Client::ClientConfiguration &clientConfig) {
+            Aws::StringStream stream;
+            stream << clientConfig.region << '|'
+                   << clientConfig.profileName << '|'
+                   << static_cast<int>(clientConfig.scheme) << '|'
+                   << clientConfig.endpointOverride << '|'
+                   << static_cast<int>(clientConfig.proxyScheme) << '|'
+                   << clientConfig.proxyHost << '|'
+                   << clientConfig.proxyPort << '|'
+                   << clientConfig.proxyUserName << '|'
+                   << clientConfig.maxConnections << '|'
+                   << clientConfig.requestTimeoutMs << '|'
+                   << clientConfig.connectTimeoutMs << '|'
+                   << clientConfig.verifySSL << '|'
+                   << clientConfig.caPath << '|'
+                   << clientConfig.caFile << '|'
+                   << clientConfig.useDualStack << '|'
+                   << clientConfig.useFIPS << '|'
+                   << clientConfig.enableTcpKeepAlive << '|'
+                   << static_cast<int>(clientConfig.followRedirects);
+
+            return stream.str();
+        }
+
+    private:
+        typedef std::pair<std::type_index, Aws::String> RegistryKey;
+
+        struct Registry {
+            std::mutex mMutex;
+            std::map<RegistryKey, std::shared_ptr<void>> mClients;
+        };
+
+        static Registry &getRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        static constexpr const char *ALLOCATION_TAG = "AwsDocClientRegistry";
+    };
+} // namespace AwsDoc
+
+#endif //AWSDOC_CLIENT_REGISTRY_H
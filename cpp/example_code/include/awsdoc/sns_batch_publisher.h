@@ -0,0 +1,454 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef AWSDOC_SNS_BATCH_PUBLISHER_H
+#define AWSDOC_SNS_BATCH_PUBLISHER_H
+
+#include <aws/core/Aws.h>
+#include <aws/sns/SNSClient.h>
+#include <aws/sns/model/PublishBatchRequest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "awsdoc/waiter.h"
+
+/**
+ * A publisher which sends messages to an Amazon Simple Notification Service
+ * (Amazon SNS) topic with PublishBatch.
+ *
+ * Messages are buffered and packed into batches of up to 10 entries and 256 KB.
+ * Each in-flight slot has its own buffer and thread, so several batches are sent
+ * at the same time. A batch is sent when it is full, or when its oldest message
+ * has waited for the batch delay.
+ *
+ * Messages with a MessageGroupId, which FIFO topics require, always go to the
+ * slot chosen by hashing the group ID. A slot sends its batches one at a time, so
+ * the messages of a group are published in order.
+ *
+ * Entries which fail within a successful batch are sent again in a new batch,
+ * with jittered exponential backoff, before the slot sends new messages. For an
+ * entry with a MessageGroupId, the later entries of its group in the batch are
+ * sent again with it, so the group stays in order.
+ *
+ *   AwsDoc::SNS::BatchPublisher publisher(snsClient, topicARN);
+ *   publisher.publish("Hello");
+ *   bool allPublished = publisher.flush();
+ */
+
+namespace AwsDoc {
+    namespace SNS {
+        // Options for BatchPublisher.
+        struct BatchPublisherOptions {
+            // Batches sent at the same time.
+            size_t mMaxInFlightBatches = 4;
+            // The longest time a message waits for its batch to fill.
+            std::chrono::milliseconds mMaxBatchDelay = std::chrono::milliseconds(10);
+            // Messages each slot buffers before publish() waits.
+            size_t mSlotCapacity = 100;
+            // Retries for a failed batch, or for a failed entry.
+            int mMaxRetries = 3;
+            // The backoff between retries. mTimeout is not used.
+            WaiterOptions mRetryBackoff;
+
+            BatchPublisherOptions() {
+                mRetryBackoff.mInitialDelay = std::chrono::milliseconds(50);
+                mRetryBackoff.mMaxDelay = std::chrono::seconds(2);
+            }
+        };
+
+        // Metrics for a BatchPublisher. The latencies, from publish() until the
+        // message is accepted, cover the most recent published messages.
+        struct BatchPublisherMetrics {
+            uint64_t mPublished = 0;
+            uint64_t mFailed = 0;
+            uint64_t mBatchesSent = 0;
+            uint64_t mRetriedEntries = 0;
+            double mLatencyP50Ms = 0.0;
+            double mLatencyP90Ms = 0.0;
+            double mLatencyP99Ms = 0.0;
+            double mLatencyMaxMs = 0.0;
+        };
+
+        class BatchPublisher {
+        public:
+            // PublishBatch limits.
+            static const size_t MAX_BATCH_ENTRIES = 10;
+            static const size_t MAX_BATCH_BYTES = 256 * 1024;
+            // The number of latency samples kept for the percentiles.
+            static const size_t LATENCY_SAMPLES = 10000;
+
+            typedef BatchPublisherOptions Options;
+            typedef BatchPublisherMetrics Metrics;
+
+            //! BatchPublisher constructor.
+            /*!
+              \param snsClient: An SNS client. It must outlive the publisher, and its
+                                maxConnections should cover the in-flight batches.
+              \param topicARN: The topic ARN.
+              \param options: The publisher options.
+             */
+            BatchPublisher(const Aws::SNS::SNSClient &snsClient,
+                           const Aws::String &topicARN,
+                           const Options &options = Options()) :
+                    mSNSClient(snsClient), mTopicARN(topicARN), mOptions(options),
+                    mPublished(0), mFailed(0), mBatchesSent(0), mRetriedEntries(0) {
+                const size_t slotCount = std::max<size_t>(mOptions.mMaxInFlightBatches, 1);
+                for (size_t i = 0; i < slotCount; ++i) {
+                    mSlots.push_back(std::unique_ptr<Slot>(new Slot()));
+                }
+                for (size_t i = 0; i < slotCount; ++i) {
+                    mSlots[i]->mThread = std::thread(&BatchPublisher::sendLoop, this,
+                                                     std::ref(*mSlots[i]));
+                }
+            }
+
+            BatchPublisher(const BatchPublisher &) = delete;
+
+            BatchPublisher &operator=(const BatchPublisher &) = delete;
+
+            //! BatchPublisher destructor. Waits for buffered messages to be published.
+            ~BatchPublisher() {
+                flush();
+                for (std::unique_ptr<Slot> &slot: mSlots) {
+                    {
+                        std::lock_guard<std::mutex> lock(slot->mMutex);
+                        slot->mStopping = true;
+                    }
+                    slot->mWorkAvailable.notify_all();
+                    slot->mThread.join();
+                }
+            }
+
+            //! Routine which buffers a message. This routine is thread safe.
+            /*!
+              The entry Id is assigned by the publisher.
+              \param entry: The message, with optional subject, attributes, group ID,
+                            and deduplication ID.
+              \return void:
+             */
+            void publish(const Aws::SNS::Model::PublishBatchRequestEntry &entry) {
+                Slot &slot = *mSlots[slotIndex(entry.GetMessageGroupId())];
+                PendingEntry pending;
+                pending.mEntry = entry;
+                pending.mBytes = entrySize(entry);
+                pending.mQueued = std::chrono::steady_clock::now();
+
+                std::unique_lock<std::mutex> lock(slot.mMutex);
+                slot.mSpaceAvailable.wait(lock, [this, &slot] {
+                    return slot.mPending.size() < mOptions.mSlotCapacity;
+                });
+                slot.mPending.push_back(std::move(pending));
+                slot.mWorkAvailable.notify_one();
+            }
+
+            //! Routine which buffers a message. This routine is thread safe.
+            /*!
+              \param message: The message text.
+              \param messageGroupId: The message group ID, required for FIFO topics.
+              \return void:
+             */
+            void publish(const Aws::String &message,
+                         const Aws::String &messageGroupId = "") {
+                Aws::SNS::Model::PublishBatchRequestEntry entry;
+                entry.SetMessage(message);
+                if (!messageGroupId.empty()) {
+                    entry.SetMessageGroupId(messageGroupId);
+                }
+                publish(entry);
+            }
+
+            //! Routine which waits until the buffered messages are published or have failed.
+            /*!
+              \return bool: True if no message has failed.
+             */
+            bool flush() {
+                for (std::unique_ptr<Slot> &slot: mSlots) {
+                    std::unique_lock<std::mutex> lock(slot->mMutex);
+                    // While a flush is waiting, partial batches are sent at once.
+                    ++slot->mFlushRequests;
+                    slot->mWorkAvailable.notify_all();
+                    slot->mIdle.wait(lock, [&slot] {
+                        return slot->mPending.empty() && !slot->mSending;
+                    });
+                    --slot->mFlushRequests;
+                }
+
+                return mFailed == 0;
+            }
+
+            //! Routine which returns a snapshot of the publisher metrics.
+            /*!
+              \return Metrics: The metrics.
+             */
+            Metrics getMetrics() const {
+                Metrics metrics;
+                metrics.mPublished = mPublished;
+                metrics.mFailed = mFailed;
+                metrics.mBatchesSent = mBatchesSent;
+                metrics.mRetriedEntries = mRetriedEntries;
+
+                std::vector<double> latencies;
+                {
+                    std::lock_guard<std::mutex> lock(mLatencyMutex);
+                    latencies = mLatencies;
+                }
+                if (!latencies.empty()) {
+                    std::sort(latencies.begin(), latencies.end());
+                    auto percentile = [&latencies](double fraction) {
+                        size_t index = static_cast<size_t>(fraction * (latencies.size() - 1));
+                        return latencies[index];
+                    };
+                    metrics.mLatencyP50Ms = percentile(0.50);
+                    metrics.mLatencyP90Ms = percentile(0.90);
+                    metrics.mLatencyP99Ms = percentile(0.99);
+                    metrics.mLatencyMaxMs = latencies.back();
+                }
+
+                return metrics;
+            }
+
+        private:
+            struct PendingEntry {
+                Aws::SNS::Model::PublishBatchRequestEntry mEntry;
+                size_t mBytes = 0;
+                // Set when the entry has been accepted, even if it is sent again.
+                bool mAccepted = false;
+                std::chrono::steady_clock::time_point mQueued;
+            };
+
+            struct Slot {
+                std::mutex mMutex;
+                std::condition_variable mWorkAvailable;
+                std::condition_variable mSpaceAvailable;
+                std::condition_variable mIdle;
+                std::deque<PendingEntry> mPending;
+                size_t mFlushRequests = 0;
+                bool mSending = false;
+                bool mStopping = false;
+                std::thread mThread;
+            };
+
+            size_t slotIndex(const Aws::String &messageGroupId) {
+                if (!messageGroupId.empty()) {
+                    return std::hash<std::string>()(messageGroupId.c_str()) % mSlots.size();
+                }
+
+                // Messages without a group are spread across the slots.
+                return mNextSlot++ % mSlots.size();
+            }
+
+            // The payload size counted toward the 256 KB limit.
+            static size_t entrySize(const Aws::SNS::Model::PublishBatchRequestEntry &entry) {
+                size_t bytes = entry.GetMessage().size() + entry.GetSubject().size();
+                for (const auto &attribute: entry.GetMessageAttributes()) {
+                    bytes += attribute.first.size() + attribute.second.GetDataType().size() +
+                             attribute.second.GetStringValue().size() +
+                             attribute.second.GetBinaryValue().GetLength();
+                }
+                return bytes;
+            }
+
+            void sendLoop(Slot &slot) {
+                std::vector<PendingEntry> batch;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(slot.mMutex);
+                        while (true) {
+                            if (slot.mPending.size() >= MAX_BATCH_ENTRIES ||
+                                ((slot.mStopping || slot.mFlushRequests > 0) &&
+                                 !slot.mPending.empty())) {
+                                break;
+                            }
+                            if (slot.mPending.empty()) {
+                                if (slot.mStopping) {
+                                    return;
+                                }
+                                slot.mWorkAvailable.wait(lock);
+                                continue;
+                            }
+
+                            // Wait for a full batch until the oldest message is due.
+                            std::chrono::steady_clock::time_point due =
+                                    slot.mPending.front().mQueued + mOptions.mMaxBatchDelay;
+                            if (slot.mWorkAvailable.wait_until(lock, due) ==
+                                std::cv_status::timeout) {
+                                break;
+                            }
+                        }
+
+                        // Pack entries in order, up to the entry and size limits.
+                        size_t batchBytes = 0;
+                        while (!slot.mPending.empty() && batch.size() < MAX_BATCH_ENTRIES &&
+                               (batch.empty() ||
+                                batchBytes + slot.mPending.front().mBytes <= MAX_BATCH_BYTES)) {
+                            batchBytes += slot.mPending.front().mBytes;
+                            batch.push_back(std::move(slot.mPending.front()));
+                            slot.mPending.pop_front();
+                        }
+                        slot.mSending = true;
+                    }
+                    slot.mSpaceAvailable.notify_all();
+
+                    sendBatch(batch);
+                    batch.clear();
+
+                    {
+                        std::lock_guard<std::mutex> lock(slot.mMutex);
+                        slot.mSending = false;
+                        if (slot.mPending.empty()) {
+                            slot.mIdle.notify_all();
+                        }
+                    }
+                }
+            }
+
+            void sendBatch(std::vector<PendingEntry> &batch) {
+                for (int attempt = 0; !batch.empty(); ++attempt) {
+                    if (attempt > 0) {
+                        std::this_thread::sleep_for(
+                                waiterDelay(mOptions.mRetryBackoff, attempt - 1));
+                    }
+
+                    Aws::SNS::Model::PublishBatchRequest request;
+                    request.SetTopicArn(mTopicARN);
+                    for (size_t i = 0; i < batch.size(); ++i) {
+                        // Ids must be unique within a batch request.
+                        batch[i].mEntry.SetId(std::to_string(i));
+                        request.AddPublishBatchRequestEntries(batch[i].mEntry);
+                    }
+
+                    Aws::SNS::Model::PublishBatchOutcome outcome =
+                            mSNSClient.PublishBatch(request);
+                    ++mBatchesSent;
+                    if (!outcome.IsSuccess()) {
+                        if (!outcome.GetError().ShouldRetry() ||
+                            attempt >= mOptions.mMaxRetries) {
+                            std::cerr << "Error with SNS::PublishBatch. "
+                                      << outcome.GetError().GetMessage() << std::endl;
+                            failEntries(batch);
+                            return;
+                        }
+                        continue;
+                    }
+
+                    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                    for (const auto &successful: outcome.GetResult().GetSuccessful()) {
+                        size_t index = entryIndex(successful.GetId(), batch.size());
+                        if (index < batch.size() && !batch[index].mAccepted) {
+                            batch[index].mAccepted = true;
+                            recordLatency(batch[index], now);
+                        }
+                    }
+
+                    std::vector<bool> retry(batch.size(), false);
+                    for (const auto &failed: outcome.GetResult().GetFailed()) {
+                        size_t index = entryIndex(failed.GetId(), batch.size());
+                        if (index >= batch.size()) {
+                            continue;
+                        }
+                        if (failed.GetSenderFault()) {
+                            std::cerr << "Error with SNS::PublishBatch entry. "
+                                      << failed.GetMessage() << std::endl;
+                            ++mFailed;
+                        }
+                        else {
+                            retry[index] = true;
+                        }
+                    }
+
+                    // The later entries of a group with a failed entry are sent again
+                    // after it, so the group is delivered in order. A FIFO topic
+                    // discards the copies of entries which were already accepted.
+                    std::vector<PendingEntry> retryBatch;
+                    std::set<Aws::String> retryGroups;
+                    for (size_t i = 0; i < batch.size(); ++i) {
+                        const Aws::String &groupId = batch[i].mEntry.GetMessageGroupId();
+                        if (!retry[i] && !groupId.empty() && retryGroups.count(groupId) > 0) {
+                            retry[i] = true;
+                        }
+                        if (retry[i]) {
+                            if (!groupId.empty()) {
+                                retryGroups.insert(groupId);
+                            }
+                            retryBatch.push_back(std::move(batch[i]));
+                        }
+                    }
+
+                    if (!retryBatch.empty() && attempt >= mOptions.mMaxRetries) {
+                        std::cerr << "Error with SNS::PublishBatch. Entries failed after "
+                                  << attempt << " retries." << std::endl;
+                        failEntries(retryBatch);
+                        return;
+                    }
+                    mRetriedEntries += retryBatch.size();
+                    batch.swap(retryBatch);
+                }
+            }
+
+            // Returns batchSize for an Id which is not in the batch.
+            static size_t entryIndex(const Aws::String &id, size_t batchSize) {
+                size_t index = 0;
+                for (char digit: id) {
+                    if (digit < '0' || digit > '9' || index >= batchSize) {
+                        return batchSize;
+                    }
+                    index = index * 10 + (digit - '0');
+                }
+                return id.empty() ? batchSize : std::min(index, batchSize);
+            }
+
+            void failEntries(const std::vector<PendingEntry> &entries) {
+                for (const PendingEntry &entry: entries) {
+                    if (!entry.mAccepted) {
+                        ++mFailed;
+                    }
+                }
+            }
+
+            void recordLatency(const PendingEntry &pending,
+                               std::chrono::steady_clock::time_point now) {
+                ++mPublished;
+                double latencyMs = std::chrono::duration<double, std::milli>(
+                        now - pending.mQueued).count();
+
+                std::lock_guard<std::mutex> lock(mLatencyMutex);
+                if (mLatencies.size() < LATENCY_SAMPLES) {
+                    mLatencies.push_back(latencyMs);
+                }
+                else {
+                    mLatencies[mNextLatency] = latencyMs;
+                }
+                mNextLatency = (mNextLatency + 1) % LATENCY_SAMPLES;
+            }
+
+            const Aws::SNS::SNSClient &mSNSClient;
+            const Aws::String mTopicARN;
+            const Options mOptions;
+
+            std::vector<std::unique_ptr<Slot>> mSlots;
+            std::atomic<size_t> mNextSlot{0};
+
+            std::atomic<uint64_t> mPublished;
+            std::atomic<uint64_t> mFailed;
+            std::atomic<uint64_t> mBatchesSent;
+            std::atomic<uint64_t> mRetriedEntries;
+
+            mutable std::mutex mLatencyMutex;
+            std::vector<double> mLatencies;
+            size_t mNextLatency = 0;
+        };
+    } // namespace SNS
+} // namespace AwsDoc
+
+#endif //AWSDOC_SNS_BATCH_PUBLISHER_H
@@ -0,0 +1,512 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef AWSDOC_SQS_MESSAGE_CONSUMER_H
+#define AWSDOC_SQS_MESSAGE_CONSUMER_H
+
+#include <aws/core/Aws.h>
+#include <aws/sqs/SQSClient.h>
+#include <aws/sqs/model/ChangeMessageVisibilityBatchRequest.h>
+#include <aws/sqs/model/DeleteMessageBatchRequest.h>
+#include <aws/sqs/model/ReceiveMessageRequest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A multithreaded consumer for an Amazon Simple Queue Service (Amazon SQS) queue.
+ *
+ * Receiver threads long poll the queue and hand messages to a pool of worker
+ * threads through a bounded buffer. A receiver only asks for messages when the
+ * buffer has room for them.
+ *
+ * A handler which returns true acknowledges its message. Acknowledged receipt
+ * handles are deleted by a batcher, which sends a DeleteMessageBatch request as
+ * soon as 10 handles are pending or when the oldest handle has waited for the
+ * flush interval. A handler which returns false leaves its message to be
+ * received again after the visibility timeout.
+ *
+ * The consumer records when the visibility timeout of each received message
+ * ends. A heartbeat thread extends the visibility timeout of messages which are
+ * waiting in the buffer or being handled when it is about to end, so slow
+ * messages are not delivered to a second consumer.
+ *
+ *   AwsDoc::SQS::MessageConsumer consumer(sqsClient, queueUrl,
+ *       [](const Aws::SQS::Model::Message &message) { ...; return true; });
+ *   consumer.start();
+ *   ...
+ *   consumer.stop();
+ */
+
+namespace AwsDoc {
+    namespace SQS {
+        // Options for MessageConsumer.
+        struct MessageConsumerOptions {
+            // Threads calling ReceiveMessage.
+            size_t mReceiverThreads = 2;
+            // Threads calling the handler.
+            size_t mWorkerThreads = 8;
+            // Received messages waiting for a worker.
+            size_t mBufferCapacity = 100;
+            // Long polling wait time, up to 20 seconds.
+            int mWaitTimeSeconds = 20;
+            // The visibility timeout requested for received messages, and
+            // used for heartbeat extensions.
+            int mVisibilityTimeoutSeconds = 30;
+            // How often the heartbeat runs. Messages whose visibility timeout ends
+            // within two intervals are extended, so a late heartbeat cannot miss
+            // them. It should be less than half the visibility timeout.
+            std::chrono::seconds mHeartbeatInterval = std::chrono::seconds(10);
+            // The longest time a receipt handle waits before it is deleted.
+            std::chrono::milliseconds mDeleteFlushInterval = std::chrono::milliseconds(5);
+            // When true, each receiver stops after an empty receive, so wait()
+            // returns once the queue has been drained.
+            bool mStopWhenEmpty = false;
+        };
+
+        // Metrics for a MessageConsumer.
+        struct MessageConsumerMetrics {
+            uint64_t mReceived = 0;
+            // Messages whose handler returned true.
+            uint64_t mProcessed = 0;
+            // Messages whose handler returned false.
+            uint64_t mFailed = 0;
+            uint64_t mDeleted = 0;
+            uint64_t mDeleteErrors = 0;
+            uint64_t mVisibilityExtensions = 0;
+            uint64_t mEmptyReceives = 0;
+            // Messages received and not yet acknowledged or failed.
+            uint64_t mInFlight = 0;
+            // Messages processed each second since start().
+            double mThroughput = 0.0;
+        };
+
+        class MessageConsumer {
+        public:
+            // DeleteMessageBatch and ChangeMessageVisibilityBatch entry limit, which
+            // is also the ReceiveMessage limit.
+            static const size_t MAX_BATCH_ENTRIES = 10;
+
+            typedef std::function<bool(const Aws::SQS::Model::Message &message)> Handler;
+
+            typedef MessageConsumerOptions Options;
+            typedef MessageConsumerMetrics Metrics;
+
+            //! MessageConsumer constructor.
+            /*!
+              \param sqsClient: An SQS client. It must outlive the consumer, and its
+                                maxConnections should cover the receiver, heartbeat,
+                                and delete threads.
+              \param queueUrl: The queue URL.
+              \param handler: Called for each message from a worker thread.
+                              It returns true when the message can be deleted.
+              \param options: The consumer options.
+             */
+            MessageConsumer(const Aws::SQS::SQSClient &sqsClient,
+                            const Aws::String &queueUrl,
+                            const Handler &handler,
+                            const Options &options = Options()) :
+                    mSQSClient(sqsClient), mQueueUrl(queueUrl), mHandler(handler),
+                    mOptions(options), mReceived(0), mProcessed(0), mFailed(0),
+                    mDeleted(0), mDeleteErrors(0), mVisibilityExtensions(0),
+                    mEmptyReceives(0) {
+            }
+
+            MessageConsumer(const MessageConsumer &) = delete;
+
+            MessageConsumer &operator=(const MessageConsumer &) = delete;
+
+            ~MessageConsumer() {
+                stop();
+            }
+
+            //! Routine which starts the receiver, worker, heartbeat, and delete threads.
+            void start() {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mStarted) {
+                    return;
+                }
+                mStarted = true;
+                mStartTime = std::chrono::steady_clock::now();
+
+                for (size_t i = 0; i < std::max<size_t>(mOptions.mReceiverThreads, 1); ++i) {
+                    mReceivers.emplace_back(&MessageConsumer::receiveLoop, this);
+                }
+                for (size_t i = 0; i < std::max<size_t>(mOptions.mWorkerThreads, 1); ++i) {
+                    mWorkers.emplace_back(&MessageConsumer::workLoop, this);
+                }
+                mDeleter = std::thread(&MessageConsumer::deleteLoop, this);
+                mHeartbeat = std::thread(&MessageConsumer::heartbeatLoop, this);
+            }
+
+            //! Routine which stops receiving, and then waits for the received
+            //! messages to be handled and deleted.
+            /*!
+              Receivers stop after their current long poll.
+             */
+            void stop() {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mStopping = true;
+                }
+                mBufferNotFull.notify_all();
+                wait();
+            }
+
+            //! Routine which waits until every receiver has stopped and the received
+            //! messages have been handled and deleted.
+            /*!
+              Without Options::mStopWhenEmpty, this only returns after stop().
+             */
+            void wait() {
+                std::lock_guard<std::mutex> joinLock(mJoinMutex);
+                for (std::thread &thread: mReceivers) {
+                    thread.join();
+                }
+                mReceivers.clear();
+
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mReceiversDone = true;
+                }
+                mBufferNotEmpty.notify_all();
+                for (std::thread &thread: mWorkers) {
+                    thread.join();
+                }
+                mWorkers.clear();
+
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mWorkersDone = true;
+                }
+                mDeleteAvailable.notify_all();
+                mHeartbeatWake.notify_all();
+                if (mDeleter.joinable()) {
+                    mDeleter.join();
+                }
+                if (mHeartbeat.joinable()) {
+                    mHeartbeat.join();
+                }
+            }
+
+            //! Routine which returns a snapshot of the consumer metrics.
+            /*!
+              \return Metrics: The metrics.
+             */
+            Metrics getMetrics() const {
+                Metrics metrics;
+                metrics.mReceived = mReceived;
+                metrics.mProcessed = mProcessed;
+                metrics.mFailed = mFailed;
+                metrics.mDeleted = mDeleted;
+                metrics.mDeleteErrors = mDeleteErrors;
+                metrics.mVisibilityExtensions = mVisibilityExtensions;
+                metrics.mEmptyReceives = mEmptyReceives;
+                metrics.mInFlight = metrics.mReceived - metrics.mProcessed - metrics.mFailed;
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mStarted) {
+                    double seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - mStartTime).count();
+                    metrics.mThroughput = seconds > 0.0 ?
+                                          static_cast<double>(metrics.mProcessed) / seconds
+                                                        : 0.0;
+                }
+
+                return metrics;
+            }
+
+        private:
+            void receiveLoop() {
+                Aws::SQS::Model::ReceiveMessageRequest request;
+                request.SetQueueUrl(mQueueUrl);
+                request.SetWaitTimeSeconds(mOptions.mWaitTimeSeconds);
+                request.SetVisibilityTimeout(mOptions.mVisibilityTimeoutSeconds);
+
+                while (true) {
+                    size_t room;
+                    {
+                        // Only receive messages which can be buffered.
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mBufferNotFull.wait(lock, [this] {
+                            return mStopping || mBuffer.size() < mOptions.mBufferCapacity;
+                        });
+                        if (mStopping) {
+                            break;
+                        }
+                        room = mOptions.mBufferCapacity - mBuffer.size();
+                    }
+
+                    request.SetMaxNumberOfMessages(
+                            static_cast<int>(std::min(room, size_t(MAX_BATCH_ENTRIES))));
+                    // The visibility timeout starts when the messages are returned,
+                    // which is after the request is sent.
+                    const std::chrono::steady_clock::time_point deadline =
+                            std::chrono::steady_clock::now() +
+                            std::chrono::seconds(mOptions.mVisibilityTimeoutSeconds);
+                    Aws::SQS::Model::ReceiveMessageOutcome outcome =
+                            mSQSClient.ReceiveMessage(request);
+                    if (!outcome.IsSuccess()) {
+                        std::cerr << "Error with SQS::ReceiveMessage. "
+                                  << outcome.GetError().GetMessage() << std::endl;
+                        if (!outcome.GetError().ShouldRetry()) {
+                            break;
+                        }
+                        std::this_thread::sleep_for(std::chrono::seconds(1));
+                        continue;
+                    }
+
+                    const Aws::Vector<Aws::SQS::Model::Message> &messages =
+                            outcome.GetResult().GetMessages();
+                    if (messages.empty()) {
+                        ++mEmptyReceives;
+                        if (mOptions.mStopWhenEmpty) {
+                            break;
+                        }
+                        continue;
+                    }
+
+                    mReceived += messages.size();
+                    {
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mBuffer.insert(mBuffer.end(), messages.begin(), messages.end());
+                        for (const Aws::SQS::Model::Message &message: messages) {
+                            mVisibilityDeadlines[message.GetReceiptHandle()] = deadline;
+                        }
+                    }
+                    mBufferNotEmpty.notify_all();
+                }
+            }
+
+            void workLoop() {
+                while (true) {
+                    Aws::SQS::Model::Message message;
+                    {
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mBufferNotEmpty.wait(lock, [this] {
+                            return mReceiversDone || !mBuffer.empty();
+                        });
+                        if (mBuffer.empty()) {
+                            return;
+                        }
+                        message = std::move(mBuffer.front());
+                        mBuffer.pop_front();
+                    }
+                    mBufferNotFull.notify_one();
+
+                    bool acknowledged = mHandler(message);
+
+                    {
+                        std::lock_guard<std::mutex> lock(mMutex);
+                        mVisibilityDeadlines.erase(message.GetReceiptHandle());
+                        if (acknowledged) {
+                            mPendingDeletes.push_back(message.GetReceiptHandle());
+                            if (mPendingDeletes.size() == 1) {
+                                mOldestDelete = std::chrono::steady_clock::now();
+                            }
+                        }
+                    }
+
+                    if (acknowledged) {
+                        ++mProcessed;
+                        mDeleteAvailable.notify_one();
+                    }
+                    else {
+                        ++mFailed;
+                    }
+                }
+            }
+
+            void deleteLoop() {
+                std::vector<Aws::String> batch;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        while (true) {
+                            if (mPendingDeletes.size() >= MAX_BATCH_ENTRIES ||
+                                (mWorkersDone && !mPendingDeletes.empty())) {
+                                break;
+                            }
+                            if (mPendingDeletes.empty()) {
+                                if (mWorkersDone) {
+                                    return;
+                                }
+                                mDeleteAvailable.wait(lock);
+                                continue;
+                            }
+
+                            // Wait for a full batch until the oldest handle is due.
+                            std::chrono::steady_clock::time_point due =
+                                    mOldestDelete + mOptions.mDeleteFlushInterval;
+                            if (mDeleteAvailable.wait_until(lock, due) ==
+                                std::cv_status::timeout) {
+                                break;
+                            }
+                        }
+
+                        size_t count = std::min(mPendingDeletes.size(), size_t(MAX_BATCH_ENTRIES));
+                        batch.assign(mPendingDeletes.begin(), mPendingDeletes.begin() + count);
+                        mPendingDeletes.erase(mPendingDeletes.begin(),
+                                              mPendingDeletes.begin() + count);
+                        mOldestDelete = std::chrono::steady_clock::now();
+                    }
+
+                    deleteBatch(batch);
+                    batch.clear();
+                }
+            }
+
+            void deleteBatch(const std::vector<Aws::String> &receiptHandles) {
+                Aws::SQS::Model::DeleteMessageBatchRequest request;
+                request.SetQueueUrl(mQueueUrl);
+                int id = 1; // Ids must be unique within a batch delete request.
+                for (const Aws::String &receiptHandle: receiptHandles) {
+                    Aws::SQS::Model::DeleteMessageBatchRequestEntry entry;
+                    entry.SetId(std::to_string(id));
+                    ++id;
+                    entry.SetReceiptHandle(receiptHandle);
+                    request.AddEntries(entry);
+                }
+
+                Aws::SQS::Model::DeleteMessageBatchOutcome outcome =
+                        mSQSClient.DeleteMessageBatch(request);
+
+                if (!outcome.IsSuccess()) {
+                    std::cerr << "Error with SQS::DeleteMessageBatch. "
+                              << outcome.GetError().GetMessage() << std::endl;
+                    mDeleteErrors += receiptHandles.size();
+                    return;
+                }
+
+                // Messages which were not deleted are received again later.
+                const size_t failed = outcome.GetResult().GetFailed().size();
+                mDeleted += receiptHandles.size() - failed;
+                mDeleteErrors += failed;
+            }
+
+            void heartbeatLoop() {
+                std::vector<Aws::String> receiptHandles;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(mMutex);
+                        mHeartbeatWake.wait_for(lock, mOptions.mHeartbeatInterval, [this] {
+                            return mWorkersDone;
+                        });
+                        if (mWorkersDone) {
+                            return;
+                        }
+
+                        // Extend buffered and running messages whose visibility timeout
+                        // ends before the heartbeat after next.
+                        std::chrono::steady_clock::time_point threshold =
+                                std::chrono::steady_clock::now() + 2 * mOptions.mHeartbeatInterval;
+                        for (const auto &visible: mVisibilityDeadlines) {
+                            if (visible.second <= threshold) {
+                                receiptHandles.push_back(visible.first);
+                            }
+                        }
+                    }
+
+                    for (size_t first = 0; first < receiptHandles.size();
+                         first += MAX_BATCH_ENTRIES) {
+                        size_t last = std::min(first + MAX_BATCH_ENTRIES, receiptHandles.size());
+                        extendVisibility(receiptHandles.begin() + first,
+                                         receiptHandles.begin() + last);
+                    }
+                    receiptHandles.clear();
+                }
+            }
+
+            void extendVisibility(std::vector<Aws::String>::const_iterator first,
+                                  std::vector<Aws::String>::const_iterator last) {
+                Aws::SQS::Model::ChangeMessageVisibilityBatchRequest request;
+                request.SetQueueUrl(mQueueUrl);
+                // Entry ids are the positions of the receipt handles.
+                std::vector<Aws::String> receiptHandles(first, last);
+                for (size_t i = 0; i < receiptHandles.size(); ++i) {
+                    Aws::SQS::Model::ChangeMessageVisibilityBatchRequestEntry entry;
+                    entry.SetId(std::to_string(i));
+                    entry.SetReceiptHandle(receiptHandles[i]);
+                    entry.SetVisibilityTimeout(mOptions.mVisibilityTimeoutSeconds);
+                    request.AddEntries(entry);
+                }
+
+                const std::chrono::steady_clock::time_point deadline =
+                        std::chrono::steady_clock::now() +
+                        std::chrono::seconds(mOptions.mVisibilityTimeoutSeconds);
+                Aws::SQS::Model::ChangeMessageVisibilityBatchOutcome outcome =
+                        mSQSClient.ChangeMessageVisibilityBatch(request);
+                if (!outcome.IsSuccess()) {
+                    std::cerr << "Error with SQS::ChangeMessageVisibilityBatch. "
+                              << outcome.GetError().GetMessage() << std::endl;
+                    return;
+                }
+
+                const Aws::Vector<Aws::SQS::Model::ChangeMessageVisibilityBatchResultEntry> &successful =
+                        outcome.GetResult().GetSuccessful();
+                mVisibilityExtensions += successful.size();
+
+                // Messages which were handled during the request are not tracked again.
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (const Aws::SQS::Model::ChangeMessageVisibilityBatchResultEntry &entry: successful) {
+                    size_t index = std::stoul(entry.GetId().c_str());
+                    if (index >= receiptHandles.size()) {
+                        continue;
+                    }
+                    auto visible = mVisibilityDeadlines.find(receiptHandles[index]);
+                    if (visible != mVisibilityDeadlines.end()) {
+                        visible->second = deadline;
+                    }
+                }
+            }
+
+            const Aws::SQS::SQSClient &mSQSClient;
+            const Aws::String mQueueUrl;
+            const Handler mHandler;
+            const Options mOptions;
+
+            mutable std::mutex mMutex;
+            std::condition_variable mBufferNotEmpty;
+            std::condition_variable mBufferNotFull;
+            std::condition_variable mDeleteAvailable;
+            std::condition_variable mHeartbeatWake;
+            std::deque<Aws::SQS::Model::Message> mBuffer;
+            // The end of the visibility timeout of each buffered or running message,
+            // keyed by receipt handle.
+            std::map<Aws::String, std::chrono::steady_clock::time_point> mVisibilityDeadlines;
+            std::deque<Aws::String> mPendingDeletes;
+            std::chrono::steady_clock::time_point mOldestDelete;
+            std::chrono::steady_clock::time_point mStartTime;
+            bool mStarted = false;
+            bool mStopping = false;
+            bool mReceiversDone = false;
+            bool mWorkersDone = false;
+
+            std::atomic<uint64_t> mReceived;
+            std::atomic<uint64_t> mProcessed;
+            std::atomic<uint64_t> mFailed;
+            std::atomic<uint64_t> mDeleted;
+            std::atomic<uint64_t> mDeleteErrors;
+            std::atomic<uint64_t> mVisibilityExtensions;
+            std::atomic<uint64_t> mEmptyReceives;
+
+            std::mutex mJoinMutex;
+            std::vector<std::thread> mReceivers;
+            std::vector<std::thread> mWorkers;
+            std::thread mDeleter;
+            std::thread mHeartbeat;
+        };
+    } // namespace SQS
+} // namespace AwsDoc
+
+#endif //AWSDOC_SQS_MESSAGE_CONSUMER_H
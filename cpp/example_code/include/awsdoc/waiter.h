@@ -0,0 +1,351 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef AWSDOC_WAITER_H
+#define AWSDOC_WAITER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Waiters which poll a resource until it reaches a state, for example an
+ * Amazon RDS DB instance becoming available.
+ *
+ * The first poll is made immediately, unless mDelayFirstPoll is set. After each
+ * poll which asks to retry, the waiter sleeps for a jittered delay which doubles
+ * up to a maximum, so a short operation is seen soon after it finishes, and a
+ * long one makes few requests.
+ * A wait ends with TIMEOUT if its deadline would pass before the next poll.
+ *
+ * waitUntil() blocks the calling thread. A Waiter can also wait asynchronously on
+ * a WaiterExecutor, whose threads are held only while a poll runs, so many
+ * resources can be waited on at the same time by a few threads.
+ *
+ *   AwsDoc::WaiterOptions options;
+ *   options.mTimeout = std::chrono::minutes(15);
+ *   AwsDoc::WaiterState state = AwsDoc::waitUntil([&]() {
+ *       ...
+ *       return available ? AwsDoc::WaiterState::SUCCESS : AwsDoc::WaiterState::RETRY;
+ *   }, options);
+ */
+
+namespace AwsDoc {
+    // The result of a poll, and of a wait.
+    enum class WaiterState {
+        SUCCESS,
+        FAILURE,
+        RETRY,
+        TIMEOUT
+    };
+
+    // Options for a wait.
+    struct WaiterOptions {
+        // The delay after the first poll.
+        std::chrono::milliseconds mInitialDelay = std::chrono::milliseconds(500);
+        // The longest delay between polls.
+        std::chrono::milliseconds mMaxDelay = std::chrono::seconds(15);
+        // The factor by which the delay grows after each poll.
+        double mMultiplier = 2.0;
+        // The longest time to wait, from the start of the wait.
+        std::chrono::milliseconds mTimeout = std::chrono::minutes(15);
+        // Wait for the initial delay before the first poll. Set this when a
+        // resource can still show its old state just after it was changed.
+        bool mDelayFirstPoll = false;
+    };
+
+    //! Routine which returns the delay after a poll.
+    /*!
+      The delay is chosen at random between half and all of the backoff delay, so
+      concurrent waits do not poll in step.
+      \sa waiterDelay()
+      \param options: The wait options.
+      \param attempt: The number of the poll, from 0.
+      \return std::chrono::milliseconds: The delay.
+     */
+    inline std::chrono::milliseconds
+    waiterDelay(const WaiterOptions &options, int attempt) {
+        double delay = static_cast<double>(options.mInitialDelay.count());
+        const double maxDelay = static_cast<double>(options.mMaxDelay.count());
+        for (int i = 0; i < attempt && delay < maxDelay; ++i) {
+            delay *= options.mMultiplier;
+        }
+        delay = std::min(delay, maxDelay);
+
+        static thread_local std::mt19937 random{std::random_device()()};
+        std::uniform_real_distribution<double> distribution(delay / 2, delay);
+        return std::chrono::milliseconds(static_cast<int64_t>(distribution(random)));
+    }
+
+    //! Routine which polls until the poll function returns a state other than RETRY,
+    //! or the timeout passes.
+    /*!
+      \sa waitUntil()
+      \param poll: Function returning SUCCESS, FAILURE, or RETRY.
+      \param options: The wait options.
+      \return WaiterState: SUCCESS, FAILURE, or TIMEOUT.
+     */
+    template<typename POLL_TYPE>
+    WaiterState waitUntil(POLL_TYPE poll, const WaiterOptions &options = WaiterOptions()) {
+        const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + options.mTimeout;
+        if (options.mDelayFirstPoll) {
+            std::this_thread::sleep_for(options.mInitialDelay);
+        }
+        for (int attempt = 0;; ++attempt) {
+            WaiterState state = poll();
+            if (state != WaiterState::RETRY) {
+                return state;
+            }
+
+            std::chrono::milliseconds delay = waiterDelay(options, attempt);
+            if (std::chrono::steady_clock::now() + delay > deadline) {
+                return WaiterState::TIMEOUT;
+            }
+            std::this_thread::sleep_for(delay);
+        }
+    }
+
+    /**
+     * Threads which run tasks at scheduled times. The threads share one queue
+     * ordered by time, and a thread sleeps until the earliest task is due.
+     *
+     * The destructor waits for the scheduled tasks, including tasks which they
+     * schedule. An exception thrown by a task is logged, and the thread goes on
+     * to the next task.
+     */
+    class WaiterExecutor {
+    public:
+        //! WaiterExecutor constructor.
+        /*!
+          \param threadCount: The threads which run tasks.
+         */
+        explicit WaiterExecutor(size_t threadCount = 4) {
+            for (size_t i = 0; i < std::max<size_t>(threadCount, 1); ++i) {
+                mThreads.emplace_back(&WaiterExecutor::runLoop, this);
+            }
+        }
+
+        WaiterExecutor(const WaiterExecutor &) = delete;
+
+        WaiterExecutor &operator=(const WaiterExecutor &) = delete;
+
+        ~WaiterExecutor() {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mChanged.notify_all();
+            for (std::thread &thread: mThreads) {
+                thread.join();
+            }
+        }
+
+        //! Routine which schedules a task.
+        /*!
+          \sa schedule()
+          \param when: The time at which the task runs.
+          \param task: The task.
+          \return void:
+         */
+        void schedule(std::chrono::steady_clock::time_point when,
+                      std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mTasks.push(Task(when, mNextSequence++, std::move(task)));
+            }
+            mChanged.notify_one();
+        }
+
+    private:
+        struct Task {
+            Task(std::chrono::steady_clock::time_point when, uint64_t sequence,
+                 std::function<void()> function) :
+                    mWhen(when), mSequence(sequence), mFunction(std::move(function)) {}
+
+            // Orders the priority queue with the earliest task on top.
+            bool operator<(const Task &other) const {
+                return mWhen != other.mWhen ? mWhen > other.mWhen
+                                            : mSequence > other.mSequence;
+            }
+
+            std::chrono::steady_clock::time_point mWhen;
+            uint64_t mSequence;
+            std::function<void()> mFunction;
+        };
+
+        void runLoop() {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true) {
+                if (mTasks.empty()) {
+                    if (mStopping && mRunning == 0) {
+                        return;
+                    }
+                    mChanged.wait(lock);
+                    continue;
+                }
+
+                const std::chrono::steady_clock::time_point when = mTasks.top().mWhen;
+                if (std::chrono::steady_clock::now() < when) {
+                    mChanged.wait_until(lock, when);
+                    continue;
+                }
+
+                // top() is const, so the task is copied out of the queue.
+                std::function<void()> function = mTasks.top().mFunction;
+                mTasks.pop();
+                ++mRunning;
+                lock.unlock();
+
+                try {
+                    function();
+                }
+                catch (const std::exception &e) {
+                    std::cerr << "Error with WaiterExecutor task. " << e.what() << std::endl;
+                }
+                catch (...) {
+                    std::cerr << "Error with WaiterExecutor task. Unknown exception."
+                              << std::endl;
+                }
+
+                lock.lock();
+                --mRunning;
+                if (mStopping && mRunning == 0 && mTasks.empty()) {
+                    mChanged.notify_all();
+                }
+            }
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mChanged;
+        std::priority_queue<Task> mTasks;
+        std::vector<std::thread> mThreads;
+        uint64_t mNextSequence = 0;
+        size_t mRunning = 0;
+        bool mStopping = false;
+    };
+
+    /**
+     * A waiter which sends a request and checks its outcome.
+     *
+     * The poll function sends the request, usually with a Describe operation of a
+     * service client, and the check function maps the outcome to SUCCESS,
+     * FAILURE, or RETRY.
+     */
+    template<typename REQUEST_TYPE, typename OUTCOME_TYPE>
+    class Waiter {
+    public:
+        typedef std::function<OUTCOME_TYPE(const REQUEST_TYPE &request)> Poll;
+        typedef std::function<WaiterState(const OUTCOME_TYPE &outcome)> Check;
+
+        //! Waiter constructor.
+        /*!
+          \param poll: Function which sends the request.
+          \param check: Function which checks the outcome.
+          \param options: The wait options.
+         */
+        Waiter(const Poll &poll, const Check &check,
+               const WaiterOptions &options = WaiterOptions()) :
+                mPoll(poll), mCheck(check), mOptions(options) {}
+
+        //! Routine which waits on the calling thread.
+        /*!
+          \sa wait()
+          \param request: The request.
+          \return WaiterState: SUCCESS, FAILURE, or TIMEOUT.
+         */
+        WaiterState wait(const REQUEST_TYPE &request) const {
+            return waitUntil([&]() { return mCheck(mPoll(request)); }, mOptions);
+        }
+
+        //! Routine which waits on the threads of an executor.
+        /*!
+          The waiter is copied into the wait, so it need not outlive the wait.
+          An exception thrown by the poll or check function ends the wait, and is
+          rethrown by the future's get().
+          \sa waitAsync()
+          \param request: The request.
+          \param executor: The executor which runs the polls.
+          \return std::future<WaiterState>: SUCCESS, FAILURE, or TIMEOUT.
+         */
+        std::future<WaiterState>
+        waitAsync(const REQUEST_TYPE &request, WaiterExecutor &executor) const {
+            std::shared_ptr<AsyncWait> asyncWait = std::make_shared<AsyncWait>(
+                    *this, request,
+                    std::chrono::steady_clock::now() + mOptions.mTimeout);
+            std::future<WaiterState> result = asyncWait->mPromise.get_future();
+            std::chrono::steady_clock::time_point first = std::chrono::steady_clock::now();
+            if (mOptions.mDelayFirstPoll) {
+                first += mOptions.mInitialDelay;
+            }
+            executor.schedule(first,
+                              [asyncWait, &executor]() {
+                                  pollAsync(asyncWait, executor);
+                              });
+            return result;
+        }
+
+    private:
+        struct AsyncWait {
+            AsyncWait(const Waiter &waiter, const REQUEST_TYPE &request,
+                      std::chrono::steady_clock::time_point deadline) :
+                    mWaiter(waiter), mRequest(request), mDeadline(deadline) {}
+
+            const Waiter mWaiter;
+            const REQUEST_TYPE mRequest;
+            const std::chrono::steady_clock::time_point mDeadline;
+            int mAttempt = 0;
+            std::promise<WaiterState> mPromise;
+        };
+
+        static void pollAsync(const std::shared_ptr<AsyncWait> &asyncWait,
+                              WaiterExecutor &executor) {
+            const Waiter &waiter = asyncWait->mWaiter;
+            WaiterState state;
+            try {
+                state = waiter.mCheck(waiter.mPoll(asyncWait->mRequest));
+            }
+            catch (...) {
+                // The exception is rethrown by the future's get().
+                asyncWait->mPromise.set_exception(std::current_exception());
+                return;
+            }
+            if (state != WaiterState::RETRY) {
+                asyncWait->mPromise.set_value(state);
+                return;
+            }
+
+            const std::chrono::steady_clock::time_point next =
+                    std::chrono::steady_clock::now() +
+                    waiterDelay(waiter.mOptions, asyncWait->mAttempt++);
+            if (next > asyncWait->mDeadline) {
+                asyncWait->mPromise.set_value(WaiterState::TIMEOUT);
+                return;
+            }
+
+            std::shared_ptr<AsyncWait> nextWait = asyncWait;
+            executor.schedule(next, [nextWait, &executor]() {
+                pollAsync(nextWait, executor);
+            });
+        }
+
+        Poll mPoll;
+        Check mCheck;
+        WaiterOptions mOptions;
+    };
+} // AwsDoc
+
+#endif //AWSDOC_WAITER_H
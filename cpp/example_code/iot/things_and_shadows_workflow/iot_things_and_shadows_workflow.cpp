@@ -31,6 +31,7 @@
 #include <aws/cloudformation/model/DeleteStackRequest.h>
 #include <aws/cloudformation/model/DescribeStacksRequest.h>
 #include <aws/core/utils/UUID.h>
+#include "awsdoc/waiter.h"
 #include "../iot_samples.h"
 
 namespace AwsDoc {
@@ -518,34 +519,44 @@ bool AwsDoc::IoT::waitStackCreated(
     describeStacksRequest.SetStackName(stackName);
     Aws::CloudFormation::Model::StackStatus stackStatus = Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS;
 
-    int count = 0;
-    while (stackStatus ==
-           Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    // Stack creation takes minutes, so the waiter backs off to a poll every 15 seconds.
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(30);
+    AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
+        Aws::CloudFormation::Model::StackStatus previousStatus = stackStatus;
         stackStatus = Aws::CloudFormation::Model::StackStatus::NOT_SET;
         auto outcome = cloudFormationClient.DescribeStacks(describeStacksRequest);
-        if (outcome.IsSuccess()) {
-            const auto &stacks = outcome.GetResult().GetStacks();
-            if (!stacks.empty()) {
-                const auto &stack = stacks[0];
-                stackStatus = stack.GetStackStatus();
-                if (stackStatus ==
-                    Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
-                    outputs = stack.GetOutputs();
-                }
-                else if (stackStatus !=
-                         Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
-                    std::cerr << "Failed to create stack because "
-                              << stack.GetStackStatusReason() << std::endl;
-                }
-                if (count % 5 == 0)
-                {
-                    std::cout << "Stack status: " << Aws::CloudFormation::Model::StackStatusMapper::GetNameForStackStatus(stackStatus) << std::endl;
-                }
-                count++;
-            }
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Failed to describe stack. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        const auto &stacks = outcome.GetResult().GetStacks();
+        if (stacks.empty()) {
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        const auto &stack = stacks[0];
+        stackStatus = stack.GetStackStatus();
+        if (stackStatus != previousStatus) {
+            std::cout << "Stack status: " << Aws::CloudFormation::Model::StackStatusMapper::GetNameForStackStatus(stackStatus) << std::endl;
+        }
+
+        if (stackStatus ==
+            Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
+            outputs = stack.GetOutputs();
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+        else if (stackStatus !=
+                 Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
+            std::cerr << "Failed to create stack because "
+                      << stack.GetStackStatusReason() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
         }
-    }
+
+        return AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
 
     if (stackStatus == Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
         std::cout << "Stack creation completed." << std::endl;
@@ -567,50 +578,54 @@ bool AwsDoc::IoT::waitStackDeleted(
     describeStacksRequest.SetStackName(stackName);
     Aws::CloudFormation::Model::StackStatus stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS;
 
-    int count = 0;
-    while (stackStatus ==
-           Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(30);
+    AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
+        Aws::CloudFormation::Model::StackStatus previousStatus = stackStatus;
         stackStatus = Aws::CloudFormation::Model::StackStatus::NOT_SET;
         auto outcome = cloudFormationClient.DescribeStacks(describeStacksRequest);
-        if (outcome.IsSuccess()) {
-            const auto &stacks = outcome.GetResult().GetStacks();
-            if (!stacks.empty()) {
-                const auto &stack = stacks[0];
-                stackStatus = stack.GetStackStatus();
-                if (stackStatus !=
-                    Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS &&
-                    stackStatus !=
-                    Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
-                    std::cerr << "Failed to delete stack because "
-                              << stack.GetStackStatusReason() << std::endl;
-                }
-
-                if (count % 5 == 0) {
-                    std::cout << "Stack status: "
-                              << Aws::CloudFormation::Model::StackStatusMapper::GetNameForStackStatus(
-                                      stackStatus) << std::endl;
-                }
-                count++;
-            }
-            else {
-                stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
-            }
-        }
-        else {
+        if (!outcome.IsSuccess()) {
             auto &error = outcome.GetError();
             if (error.GetResponseCode() ==
                 Aws::Http::HttpResponseCode::BAD_REQUEST &&
                 (outcome.GetError().GetMessage().find("does not exist") !=
                  std::string::npos)) {
                 stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
+                return AwsDoc::WaiterState::SUCCESS;
             }
-            else {
-                std::cerr << "Failed to describe stack. "
-                          << outcome.GetError().GetMessage() << std::endl;
-            }
+
+            std::cerr << "Failed to describe stack. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
         }
-    }
+
+        const auto &stacks = outcome.GetResult().GetStacks();
+        if (stacks.empty()) {
+            stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+
+        const auto &stack = stacks[0];
+        stackStatus = stack.GetStackStatus();
+        if (stackStatus != previousStatus) {
+            std::cout << "Stack status: "
+                      << Aws::CloudFormation::Model::StackStatusMapper::GetNameForStackStatus(
+                              stackStatus) << std::endl;
+        }
+
+        if (stackStatus ==
+            Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+        else if (stackStatus !=
+                 Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS) {
+            std::cerr << "Failed to delete stack because "
+                      << stack.GetStackStatusReason() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        return AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
 
     if (stackStatus == Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
         std::cout << "Stack deletion completed." << std::endl;
@@ -0,0 +1,677 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kinesis_consumer.h"
+#include "kinesis_producer.h"
+#include <aws/core/utils/crypto/MD5.h>
+#include <aws/kinesis/KinesisErrors.h>
+#include <aws/kinesis/model/GetRecordsRequest.h>
+#include <aws/kinesis/model/GetShardIteratorRequest.h>
+#include <aws/kinesis/model/ListShardsRequest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // An aggregated record is the magic bytes, a protobuf AggregatedRecord
+    // message, and the MD5 hash of the message.
+    const size_t AGGREGATED_RECORD_MAGIC_LENGTH = 4;
+    const size_t MD5_LENGTH = 16;
+
+    // Protobuf wire types.
+    const uint64_t WIRE_VARINT = 0;
+    const uint64_t WIRE_FIXED64 = 1;
+    const uint64_t WIRE_LENGTH_DELIMITED = 2;
+    const uint64_t WIRE_FIXED32 = 5;
+
+    // AggregatedRecord fields.
+    const uint64_t PARTITION_KEY_TABLE_FIELD = 1;
+    const uint64_t RECORDS_FIELD = 3;
+    // Record fields.
+    const uint64_t PARTITION_KEY_INDEX_FIELD = 1;
+    const uint64_t DATA_FIELD = 3;
+
+    bool readVarint(const unsigned char *&position, const unsigned char *end,
+                    uint64_t &value) {
+        value = 0;
+        for (unsigned shift = 0; position < end && shift < 64; shift += 7) {
+            unsigned char byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reads the next field. A length-delimited value is returned in bytes and
+    // length, and other values are skipped.
+    bool readField(const unsigned char *&position, const unsigned char *end,
+                   uint64_t &field, uint64_t &wireType, uint64_t &varint,
+                   const unsigned char *&bytes, size_t &length) {
+        uint64_t key = 0;
+        if (!readVarint(position, end, key)) {
+            return false;
+        }
+        field = key >> 3;
+        wireType = key & 0x7;
+        switch (wireType) {
+            case WIRE_VARINT:
+                return readVarint(position, end, varint);
+            case WIRE_FIXED64:
+                if (end - position < 8) {
+                    return false;
+                }
+                position += 8;
+                return true;
+            case WIRE_LENGTH_DELIMITED:
+                if (!readVarint(position, end, varint) ||
+                    varint > static_cast<uint64_t>(end - position)) {
+                    return false;
+                }
+                bytes = position;
+                length = static_cast<size_t>(varint);
+                position += length;
+                return true;
+            case WIRE_FIXED32:
+                if (end - position < 4) {
+                    return false;
+                }
+                position += 4;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // A user record in an aggregated record.
+    struct UserRecord {
+        uint64_t mPartitionKeyIndex = 0;
+        const unsigned char *mData = nullptr;
+        size_t mLength = 0;
+    };
+} // namespace
+
+const char *const AwsDoc::Kinesis::CheckpointStore::SHARD_END = "SHARD_END";
+
+AwsDoc::Kinesis::FileCheckpointStore::FileCheckpointStore(const Aws::String &path) :
+        mPath(path) {
+    std::ifstream inStream(mPath.c_str());
+    Aws::String shardId;
+    Aws::String sequenceNumber;
+    while (inStream >> shardId >> sequenceNumber) {
+        mCheckpoints[shardId] = sequenceNumber;
+    }
+}
+
+bool AwsDoc::Kinesis::FileCheckpointStore::load(const Aws::String &shardId,
+                                                Aws::String &sequenceNumber) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto checkpoint = mCheckpoints.find(shardId);
+    if (checkpoint == mCheckpoints.end()) {
+        return false;
+    }
+
+    sequenceNumber = checkpoint->second;
+    return true;
+}
+
+bool AwsDoc::Kinesis::FileCheckpointStore::save(const Aws::String &shardId,
+                                                const Aws::String &sequenceNumber) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCheckpoints[shardId] = sequenceNumber;
+
+    const Aws::String tempPath = mPath + ".tmp";
+    {
+        std::ofstream outStream(tempPath.c_str(), std::ios::trunc);
+        for (const auto &checkpoint: mCheckpoints) {
+            outStream << checkpoint.first << ' ' << checkpoint.second << '\n';
+        }
+        outStream.close();
+        if (!outStream) {
+            std::cerr << "Error with FileCheckpointStore::save. Could not write '"
+                      << tempPath << "'." << std::endl;
+            return false;
+        }
+    }
+
+    // On Windows, rename does not replace an existing file.
+    if (std::rename(tempPath.c_str(), mPath.c_str()) != 0) {
+        std::remove(mPath.c_str());
+        if (std::rename(tempPath.c_str(), mPath.c_str()) != 0) {
+            std::cerr << "Error with FileCheckpointStore::save. Could not replace '"
+                      << mPath << "'." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+AwsDoc::Kinesis::Consumer::Consumer(const Aws::Kinesis::KinesisClient &kinesisClient,
+                                    const Aws::String &streamName,
+                                    const Handler &handler,
+                                    const Options &options,
+                                    const std::shared_ptr<CheckpointStore> &checkpointStore) :
+        mKinesisClient(kinesisClient), mStreamName(streamName), mHandler(handler),
+        mOptions(options), mCheckpointStore(checkpointStore),
+        mUserRecords(0), mUserBytes(0), mKinesisRecords(0), mGetRecordsCalls(0),
+        mThrottles(0) {
+    if (!mCheckpointStore) {
+        Aws::String path = mOptions.mCheckpointFile.empty() ? mStreamName + ".checkpoints"
+                                                             : mOptions.mCheckpointFile;
+        mCheckpointStore = std::make_shared<FileCheckpointStore>(path);
+    }
+}
+
+AwsDoc::Kinesis::Consumer::~Consumer() {
+    stop();
+}
+
+bool AwsDoc::Kinesis::Consumer::start() {
+    if (mStarted) {
+        return true;
+    }
+
+    Aws::Vector<Aws::Kinesis::Model::Shard> shards;
+    if (!listShards(shards)) {
+        return false;
+    }
+
+    mExecutor.reset(new Aws::Utils::Threading::PooledThreadExecutor(
+            std::max<size_t>(mOptions.mMaxThreads, 1)));
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShards.clear();
+        mShardIndexes.clear();
+        addShards(shards);
+        mNextShardList = std::chrono::steady_clock::now() + mOptions.mShardListInterval;
+        mListingShards = false;
+        mStarted = true;
+        mStopping = false;
+        mFinished = false;
+        mFailed = false;
+        startReadyShards();
+    }
+    mScheduler = std::thread(&Consumer::scheduleLoop, this);
+
+    return true;
+}
+
+// Lists every shard of the stream.
+bool AwsDoc::Kinesis::Consumer::listShards(
+        Aws::Vector<Aws::Kinesis::Model::Shard> &shards) const {
+    Aws::Kinesis::Model::ListShardsRequest request;
+    request.SetStreamName(mStreamName);
+    Aws::String nextToken;
+    do {
+        Aws::Kinesis::Model::ListShardsOutcome outcome = mKinesisClient.ListShards(request);
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Error with Kinesis::ListShards. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return false;
+        }
+
+        const Aws::Vector<Aws::Kinesis::Model::Shard> &page = outcome.GetResult().GetShards();
+        shards.insert(shards.end(), page.begin(), page.end());
+
+        // A request with a NextToken must not have a StreamName.
+        nextToken = outcome.GetResult().GetNextToken();
+        request = Aws::Kinesis::Model::ListShardsRequest();
+        request.SetNextToken(nextToken);
+    } while (!nextToken.empty());
+
+    return true;
+}
+
+// Adds the shards which are not known yet, with their checkpoints. mMutex must
+// be locked.
+void AwsDoc::Kinesis::Consumer::addShards(
+        const Aws::Vector<Aws::Kinesis::Model::Shard> &shards) {
+    for (const Aws::Kinesis::Model::Shard &shard: shards) {
+        if (mShardIndexes.find(shard.GetShardId()) != mShardIndexes.end()) {
+            continue;
+        }
+
+        ShardState state;
+        state.mShardId = shard.GetShardId();
+        if (!shard.GetParentShardId().empty()) {
+            state.mParentShardIds.push_back(shard.GetParentShardId());
+        }
+        if (!shard.GetAdjacentParentShardId().empty()) {
+            state.mParentShardIds.push_back(shard.GetAdjacentParentShardId());
+        }
+
+        Aws::String sequenceNumber;
+        if (mCheckpointStore->load(state.mShardId, sequenceNumber)) {
+            if (sequenceNumber == CheckpointStore::SHARD_END) {
+                state.mFinished = true;
+            }
+            else {
+                state.mSequenceNumber = sequenceNumber;
+            }
+        }
+
+        mShardIndexes[state.mShardId] = mShards.size();
+        mShards.push_back(std::move(state));
+    }
+}
+
+// Schedules the shards whose parents are finished. mMutex must be locked.
+void AwsDoc::Kinesis::Consumer::startReadyShards() {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < mShards.size(); ++i) {
+        ShardState &shard = mShards[i];
+        if (shard.mStarted || shard.mFinished) {
+            continue;
+        }
+
+        // A parent which has expired from the stream is not listed.
+        bool parentsFinished = true;
+        for (const Aws::String &parentShardId: shard.mParentShardIds) {
+            auto parent = mShardIndexes.find(parentShardId);
+            if (parent != mShardIndexes.end() && !mShards[parent->second].mFinished) {
+                parentsFinished = false;
+            }
+        }
+
+        if (parentsFinished) {
+            shard.mStarted = true;
+            mPolls.push(Poll(now, i));
+        }
+    }
+    mWake.notify_one();
+}
+
+bool AwsDoc::Kinesis::Consumer::getShardIterator(ShardState &shard) {
+    Aws::Kinesis::Model::GetShardIteratorRequest request;
+    request.SetStreamName(mStreamName);
+    request.SetShardId(shard.mShardId);
+    if (!shard.mSequenceNumber.empty()) {
+        request.SetShardIteratorType(
+                Aws::Kinesis::Model::ShardIteratorType::AFTER_SEQUENCE_NUMBER);
+        request.SetStartingSequenceNumber(shard.mSequenceNumber);
+    }
+    else if (!shard.mParentShardIds.empty()) {
+        // A child shard continues where its parents finished.
+        request.SetShardIteratorType(Aws::Kinesis::Model::ShardIteratorType::TRIM_HORIZON);
+    }
+    else {
+        request.SetShardIteratorType(mOptions.mInitialPosition);
+    }
+
+    Aws::Kinesis::Model::GetShardIteratorOutcome outcome =
+            mKinesisClient.GetShardIterator(request);
+    if (!outcome.IsSuccess()) {
+        if (outcome.GetError().GetErrorType() ==
+            Aws::Kinesis::KinesisErrors::PROVISIONED_THROUGHPUT_EXCEEDED) {
+            ++mThrottles;
+        }
+        std::cerr << "Error with Kinesis::GetShardIterator. "
+                  << outcome.GetError().GetMessage() << std::endl;
+        return false;
+    }
+
+    shard.mIterator = outcome.GetResult().GetShardIterator();
+    return true;
+}
+
+// Submits each shard to the executor when its next poll is due.
+void AwsDoc::Kinesis::Consumer::scheduleLoop() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        if (mPolls.empty()) {
+            if (mRunning == 0) {
+                // Every shard is finished, or has stopped after an error.
+                break;
+            }
+            mWake.wait(lock);
+            continue;
+        }
+
+        if (mOptions.mStopWhenCaughtUp && mRunning == 0 && isCaughtUp()) {
+            break;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const bool listShardsPeriodically =
+                mOptions.mShardListInterval.count() > 0 && !mListingShards;
+        if (listShardsPeriodically && mNextShardList <= now) {
+            // Look for shards added by a reshard.
+            mListingShards = true;
+            ++mRunning;
+            lock.unlock();
+            mExecutor->Submit([this]() { refreshShards(); });
+            lock.lock();
+            continue;
+        }
+
+        const Poll next = mPolls.top();
+        if (next.first > now) {
+            mWake.wait_until(lock, listShardsPeriodically ? std::min(next.first, mNextShardList)
+                                                          : next.first);
+            continue;
+        }
+
+        mPolls.pop();
+        ++mRunning;
+        const size_t index = next.second;
+        lock.unlock();
+        mExecutor->Submit([this, index]() { pollShard(index); });
+        lock.lock();
+    }
+
+    mFinished = true;
+    mDone.notify_all();
+}
+
+// Reads one response from a shard, then schedules the next poll.
+void AwsDoc::Kinesis::Consumer::pollShard(size_t index) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mStopping) {
+        --mRunning;
+        mDone.notify_all();
+        return;
+    }
+
+    // Only one poll of a shard runs at a time, so its state is not locked. Shards
+    // can be added while the poll runs, so the reference is taken under the lock.
+    ShardState &shard = mShards[index];
+    lock.unlock();
+    if (shard.mIterator.empty() && !getShardIterator(shard)) {
+        if (++shard.mErrors > mOptions.mMaxRetries) {
+            finishShard(index, true);
+        }
+        else {
+            reschedule(index, backoffDelay(shard.mErrors), shard.mMillisBehindLatest);
+        }
+        return;
+    }
+
+    Aws::Kinesis::Model::GetRecordsRequest request;
+    request.SetShardIterator(shard.mIterator);
+    request.SetLimit(mOptions.mRecordsPerRequest);
+    Aws::Kinesis::Model::GetRecordsOutcome outcome = mKinesisClient.GetRecords(request);
+    ++mGetRecordsCalls;
+
+    if (!outcome.IsSuccess()) {
+        const Aws::Kinesis::KinesisError &error = outcome.GetError();
+        if (error.GetErrorType() == Aws::Kinesis::KinesisErrors::EXPIRED_ITERATOR) {
+            // Get a new iterator after the last processed record.
+            shard.mIterator.clear();
+            reschedule(index, std::chrono::milliseconds(0), shard.mMillisBehindLatest);
+            return;
+        }
+        if (error.GetErrorType() ==
+            Aws::Kinesis::KinesisErrors::PROVISIONED_THROUGHPUT_EXCEEDED) {
+            ++mThrottles;
+        }
+        if (!error.ShouldRetry() || ++shard.mErrors > mOptions.mMaxRetries) {
+            std::cerr << "Error with Kinesis::GetRecords for shard " << shard.mShardId
+                      << ". " << error.GetMessage() << std::endl;
+            finishShard(index, true);
+            return;
+        }
+        reschedule(index, backoffDelay(shard.mErrors), shard.mMillisBehindLatest);
+        return;
+    }
+
+    shard.mErrors = 0;
+    const Aws::Kinesis::Model::GetRecordsResult &result = outcome.GetResult();
+    const Aws::Vector<Aws::Kinesis::Model::Record> &records = result.GetRecords();
+    uint64_t userRecords = 0;
+    uint64_t userBytes = 0;
+    for (const Aws::Kinesis::Model::Record &record: records) {
+        userRecords += deliver(shard, record, userBytes);
+    }
+    mKinesisRecords += records.size();
+    mUserRecords += userRecords;
+    mUserBytes += userBytes;
+
+    if (!records.empty()) {
+        shard.mSequenceNumber = records.back().GetSequenceNumber();
+        mCheckpointStore->save(shard.mShardId, shard.mSequenceNumber);
+    }
+
+    shard.mIterator = result.GetNextShardIterator();
+    if (shard.mIterator.empty()) {
+        // The shard was closed by a reshard, and all of its records are read. Its
+        // children may have been created after the shards were listed.
+        mCheckpointStore->save(shard.mShardId, CheckpointStore::SHARD_END);
+        Aws::Vector<Aws::Kinesis::Model::Shard> shards;
+        if (listShards(shards)) {
+            lock.lock();
+            addShards(shards);
+            lock.unlock();
+        }
+        finishShard(index, false);
+        return;
+    }
+
+    const int64_t millisBehindLatest = result.GetMillisBehindLatest();
+    reschedule(index, millisBehindLatest > 0 ? mOptions.mMinPollInterval
+                                             : mOptions.mIdlePollInterval,
+               millisBehindLatest);
+}
+
+void AwsDoc::Kinesis::Consumer::finishShard(size_t index, bool failed) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    --mRunning;
+    mShards[index].mFinished = true;
+    if (failed) {
+        mFailed = true;
+    }
+    else if (!mStopping) {
+        startReadyShards();
+    }
+    mWake.notify_one();
+    mDone.notify_all();
+}
+
+void AwsDoc::Kinesis::Consumer::reschedule(size_t index, std::chrono::milliseconds delay,
+                                           int64_t millisBehindLatest) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    --mRunning;
+    mShards[index].mMillisBehindLatest = millisBehindLatest;
+    if (!mStopping) {
+        mPolls.push(Poll(std::chrono::steady_clock::now() + delay, index));
+    }
+    mWake.notify_one();
+    mDone.notify_all();
+}
+
+// Lists the shards again, and starts the shards added by a reshard.
+void AwsDoc::Kinesis::Consumer::refreshShards() {
+    Aws::Vector<Aws::Kinesis::Model::Shard> shards;
+    const bool listed = listShards(shards);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    --mRunning;
+    mListingShards = false;
+    mNextShardList = std::chrono::steady_clock::now() + mOptions.mShardListInterval;
+    if (listed && !mStopping) {
+        addShards(shards);
+        startReadyShards();
+    }
+    mWake.notify_one();
+    mDone.notify_all();
+}
+
+// True if every shard being read is at the tip of the stream. mMutex must be locked.
+bool AwsDoc::Kinesis::Consumer::isCaughtUp() const {
+    for (const ShardState &shard: mShards) {
+        if (shard.mStarted && !shard.mFinished && shard.mMillisBehindLatest != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AwsDoc::Kinesis::Consumer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mStarted) {
+            return;
+        }
+        mStopping = true;
+    }
+    mWake.notify_all();
+    mScheduler.join();
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this] { return mRunning == 0; });
+    }
+    mExecutor.reset();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStarted = false;
+    mDone.notify_all();
+}
+
+bool AwsDoc::Kinesis::Consumer::wait() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return !mStarted || (mFinished && mRunning == 0); });
+    return !mFailed;
+}
+
+AwsDoc::Kinesis::Consumer::Metrics AwsDoc::Kinesis::Consumer::getMetrics() const {
+    Metrics metrics;
+    metrics.mUserRecords = mUserRecords;
+    metrics.mUserBytes = mUserBytes;
+    metrics.mKinesisRecords = mKinesisRecords;
+    metrics.mGetRecordsCalls = mGetRecordsCalls;
+    metrics.mThrottles = mThrottles;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const ShardState &shard: mShards) {
+        if (shard.mFinished) {
+            ++metrics.mCompletedShards;
+        }
+        else if (shard.mStarted) {
+            ++metrics.mActiveShards;
+            metrics.mMillisBehindLatest = std::max(metrics.mMillisBehindLatest,
+                                                   static_cast<int64_t>(
+                                                           shard.mMillisBehindLatest));
+        }
+    }
+    return metrics;
+}
+
+// Passes the user records in a Kinesis record to the handler, and returns their number.
+uint64_t AwsDoc::Kinesis::Consumer::deliver(const ShardState &shard,
+                                            const Aws::Kinesis::Model::Record &record,
+                                            uint64_t &userBytes) const {
+    if (isAggregatedRecord(record.GetData())) {
+        uint64_t userRecords = deliverAggregated(shard, record, userBytes);
+        if (userRecords > 0) {
+            return userRecords;
+        }
+    }
+
+    ConsumerRecord userRecord;
+    userRecord.mShardId = &shard.mShardId;
+    userRecord.mSequenceNumber = &record.GetSequenceNumber();
+    userRecord.mPartitionKey = record.GetPartitionKey().c_str();
+    userRecord.mPartitionKeyLength = record.GetPartitionKey().size();
+    userRecord.mData = record.GetData().GetUnderlyingData();
+    userRecord.mLength = record.GetData().GetLength();
+    mHandler(userRecord);
+
+    userBytes += userRecord.mLength;
+    return 1;
+}
+
+// Returns 0 if the record is not a valid aggregated record.
+uint64_t AwsDoc::Kinesis::Consumer::deliverAggregated(const ShardState &shard,
+                                                      const Aws::Kinesis::Model::Record &record,
+                                                      uint64_t &userBytes) const {
+    const Aws::Utils::ByteBuffer &data = record.GetData();
+    const unsigned char *begin = data.GetUnderlyingData() + AGGREGATED_RECORD_MAGIC_LENGTH;
+    const unsigned char *end = data.GetUnderlyingData() + data.GetLength() - MD5_LENGTH;
+
+    Aws::Utils::Crypto::MD5 md5;
+    md5.Update(const_cast<unsigned char *>(begin), static_cast<size_t>(end - begin));
+    Aws::Utils::ByteBuffer hash = md5.GetHash().GetResult();
+    if (hash.GetLength() != MD5_LENGTH ||
+        std::memcmp(hash.GetUnderlyingData(), end, MD5_LENGTH) != 0) {
+        return 0;
+    }
+
+    // Parse the whole message before any user record is delivered.
+    std::vector<std::pair<const char *, size_t>> partitionKeys;
+    std::vector<UserRecord> userRecords;
+    const unsigned char *position = begin;
+    while (position < end) {
+        uint64_t field = 0;
+        uint64_t wireType = 0;
+        uint64_t varint = 0;
+        const unsigned char *bytes = nullptr;
+        size_t length = 0;
+        if (!readField(position, end, field, wireType, varint, bytes, length)) {
+            return 0;
+        }
+        if (wireType != WIRE_LENGTH_DELIMITED) {
+            continue;
+        }
+
+        if (field == PARTITION_KEY_TABLE_FIELD) {
+            partitionKeys.push_back(
+                    std::make_pair(reinterpret_cast<const char *>(bytes), length));
+        }
+        else if (field == RECORDS_FIELD) {
+            UserRecord userRecord;
+            const unsigned char *recordPosition = bytes;
+            const unsigned char *recordEnd = bytes + length;
+            while (recordPosition < recordEnd) {
+                const unsigned char *recordBytes = nullptr;
+                size_t recordLength = 0;
+                if (!readField(recordPosition, recordEnd, field, wireType, varint,
+                               recordBytes, recordLength)) {
+                    return 0;
+                }
+                if (field == PARTITION_KEY_INDEX_FIELD && wireType == WIRE_VARINT) {
+                    userRecord.mPartitionKeyIndex = varint;
+                }
+                else if (field == DATA_FIELD && wireType == WIRE_LENGTH_DELIMITED) {
+                    userRecord.mData = recordBytes;
+                    userRecord.mLength = recordLength;
+                }
+            }
+            userRecords.push_back(userRecord);
+        }
+    }
+
+    for (const UserRecord &userRecord: userRecords) {
+        if (userRecord.mPartitionKeyIndex >= partitionKeys.size()) {
+            return 0;
+        }
+    }
+
+    ConsumerRecord consumerRecord;
+    consumerRecord.mShardId = &shard.mShardId;
+    consumerRecord.mSequenceNumber = &record.GetSequenceNumber();
+    for (size_t i = 0; i < userRecords.size(); ++i) {
+        const std::pair<const char *, size_t> &partitionKey =
+                partitionKeys[userRecords[i].mPartitionKeyIndex];
+        consumerRecord.mSubSequenceNumber = i;
+        consumerRecord.mPartitionKey = partitionKey.first;
+        consumerRecord.mPartitionKeyLength = partitionKey.second;
+        consumerRecord.mData = userRecords[i].mData;
+        consumerRecord.mLength = userRecords[i].mLength;
+        mHandler(consumerRecord);
+        userBytes += consumerRecord.mLength;
+    }
+
+    return userRecords.size();
+}
+
+std::chrono::milliseconds AwsDoc::Kinesis::Consumer::backoffDelay(int attempt) {
+    const int BASE_DELAY_MS = 200;
+    const int MAX_DELAY_MS = 10000;
+    return std::chrono::milliseconds(
+            std::min(MAX_DELAY_MS, BASE_DELAY_MS << std::min(attempt, 10)));
+}
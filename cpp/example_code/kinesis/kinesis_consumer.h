@@ -0,0 +1,298 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef KINESIS_EXAMPLES_KINESIS_CONSUMER_H
+#define KINESIS_EXAMPLES_KINESIS_CONSUMER_H
+
+#include <aws/core/Aws.h>
+#include <aws/core/utils/threading/Executor.h>
+#include <aws/kinesis/KinesisClient.h>
+#include <aws/kinesis/model/Record.h>
+#include <aws/kinesis/model/Shard.h>
+#include <aws/kinesis/model/ShardIteratorType.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace AwsDoc {
+    namespace Kinesis {
+        /**
+         * Stores the position reached in each shard, so a restarted consumer
+         * resumes after the last processed record.
+         *
+         * save() is called from the consumer's worker threads, so implementations
+         * must be thread safe.
+         */
+        class CheckpointStore {
+        public:
+            // The checkpoint of a shard whose records have all been processed.
+            static const char *const SHARD_END;
+
+            virtual ~CheckpointStore() = default;
+
+            //! Retrieve the checkpoint of a shard.
+            /*!
+              \param shardId: The shard ID.
+              \param sequenceNumber: String to receive the sequence number of the last
+                                     processed record, or SHARD_END.
+              \return bool: True if the shard has a checkpoint.
+             */
+            virtual bool load(const Aws::String &shardId, Aws::String &sequenceNumber) = 0;
+
+            //! Store the checkpoint of a shard.
+            /*!
+              \param shardId: The shard ID.
+              \param sequenceNumber: The sequence number of the last processed record,
+                                     or SHARD_END.
+              \return bool: Function succeeded.
+             */
+            virtual bool save(const Aws::String &shardId, const Aws::String &sequenceNumber) = 0;
+        };
+
+        /**
+         * A checkpoint store which keeps one line for each shard in a local file.
+         *
+         * The file is read when the store is created. Each save writes a
+         * temporary file and renames it over the checkpoint file, so a crash
+         * leaves either the old checkpoints or the new ones.
+         */
+        class FileCheckpointStore : public CheckpointStore {
+        public:
+            //! FileCheckpointStore constructor.
+            /*!
+              \param path: The checkpoint file. It is created by the first save.
+             */
+            explicit FileCheckpointStore(const Aws::String &path);
+
+            bool load(const Aws::String &shardId, Aws::String &sequenceNumber) override;
+
+            bool save(const Aws::String &shardId, const Aws::String &sequenceNumber) override;
+
+        private:
+            const Aws::String mPath;
+            std::mutex mMutex;
+            Aws::Map<Aws::String, Aws::String> mCheckpoints;
+        };
+
+        // A user record passed to the consumer's handler. The pointers refer to
+        // the GetRecords response, and they are valid only during the call.
+        struct ConsumerRecord {
+            const Aws::String *mShardId = nullptr;
+            const Aws::String *mSequenceNumber = nullptr;
+            // The index of the user record in an aggregated Kinesis record, or 0.
+            uint64_t mSubSequenceNumber = 0;
+            const char *mPartitionKey = nullptr;
+            size_t mPartitionKeyLength = 0;
+            const unsigned char *mData = nullptr;
+            size_t mLength = 0;
+        };
+
+        // Options for Consumer.
+        struct ConsumerOptions {
+            // The executor threads shared by the shard workers.
+            size_t mMaxThreads = 4;
+            // The maximum number of Kinesis records for each GetRecords request.
+            int mRecordsPerRequest = 1000;
+            // The time between GetRecords requests while a shard is behind the
+            // tip of the stream. Kinesis allows 5 requests per second per shard.
+            std::chrono::milliseconds mMinPollInterval = std::chrono::milliseconds(200);
+            // The time between GetRecords requests once a shard has caught up.
+            std::chrono::milliseconds mIdlePollInterval = std::chrono::milliseconds(1000);
+            // Where to start in a shard without a checkpoint.
+            Aws::Kinesis::Model::ShardIteratorType mInitialPosition =
+                    Aws::Kinesis::Model::ShardIteratorType::TRIM_HORIZON;
+            // Retries for a failed request before a shard stops.
+            int mMaxRetries = 5;
+            // The time between ListShards requests which look for shards added
+            // by a reshard. Zero lists the shards only when a shard is closed.
+            std::chrono::milliseconds mShardListInterval = std::chrono::milliseconds(60000);
+            // Stop once every shard has reached the tip of the stream.
+            bool mStopWhenCaughtUp = false;
+            // The checkpoint file used when no checkpoint store is given. If empty,
+            // the file is named after the stream.
+            Aws::String mCheckpointFile;
+        };
+
+        // Metrics for a Consumer.
+        struct ConsumerMetrics {
+            uint64_t mUserRecords = 0;
+            uint64_t mUserBytes = 0;
+            uint64_t mKinesisRecords = 0;
+            uint64_t mGetRecordsCalls = 0;
+            uint64_t mThrottles = 0;
+            // The greatest MillisBehindLatest of the shards being read.
+            int64_t mMillisBehindLatest = 0;
+            size_t mActiveShards = 0;
+            size_t mCompletedShards = 0;
+        };
+
+        /**
+         * A consumer which reads every shard of an Amazon Kinesis data stream.
+         *
+         * The shards are listed with ListShards. Each shard has a worker which
+         * polls GetRecords, and the workers share a pool of executor threads, so
+         * a worker holds a thread only while it processes a response. The delay
+         * before the next poll of a shard depends on its MillisBehindLatest: a shard
+         * which is behind is polled as often as Kinesis allows, and a shard which
+         * has caught up is polled at the idle interval.
+         *
+         * Aggregated records written by the Kinesis Producer Library (KPL) are
+         * de-aggregated, and each user record is passed to the handler as pointers
+         * into the response, without copying. After each response, the sequence
+         * number of its last record is saved to the checkpoint store. A child shard
+         * from a reshard is read once its parents are finished. The shards are
+         * listed again when a shard is closed, and every options.mShardListInterval,
+         * so shards added after start() are read too.
+         *
+         *   AwsDoc::Kinesis::Consumer consumer(kinesisClient, streamName,
+         *       [](const AwsDoc::Kinesis::ConsumerRecord &record) { ... });
+         *   if (consumer.start()) {
+         *       consumer.wait();
+         *   }
+         */
+        class Consumer {
+        public:
+            // The handler is called for each user record, concurrently for different
+            // shards, and in order within a shard.
+            typedef std::function<void(const ConsumerRecord &record)> Handler;
+            typedef ConsumerOptions Options;
+            typedef ConsumerMetrics Metrics;
+
+            //! Consumer constructor.
+            /*!
+              \param kinesisClient: A Kinesis client. It must outlive the consumer.
+              \param streamName: The stream name.
+              \param handler: Called for each user record.
+              \param options: The consumer options.
+              \param checkpointStore: The checkpoint store, or nullptr for a
+                                      FileCheckpointStore.
+             */
+            Consumer(const Aws::Kinesis::KinesisClient &kinesisClient,
+                     const Aws::String &streamName,
+                     const Handler &handler,
+                     const Options &options = Options(),
+                     const std::shared_ptr<CheckpointStore> &checkpointStore = nullptr);
+
+            Consumer(const Consumer &) = delete;
+
+            Consumer &operator=(const Consumer &) = delete;
+
+            //! Consumer destructor. Stops the consumer.
+            ~Consumer();
+
+            //! Routine which lists the shards of the stream and starts the shard workers.
+            /*!
+              \return bool: Function succeeded.
+             */
+            bool start();
+
+            //! Routine which stops polling and waits for the running workers.
+            /*!
+              \return void:
+             */
+            void stop();
+
+            //! Routine which waits until every shard is finished, or the consumer has
+            //! caught up with options.mStopWhenCaughtUp, or stop() is called.
+            /*!
+              \return bool: False if a shard stopped after an error.
+             */
+            bool wait();
+
+            //! Routine which returns a snapshot of the consumer metrics.
+            /*!
+              \return Metrics: The metrics.
+             */
+            Metrics getMetrics() const;
+
+        private:
+            struct ShardState {
+                Aws::String mShardId;
+                Aws::Vector<Aws::String> mParentShardIds;
+                Aws::String mIterator;
+                // The sequence number of the last processed record.
+                Aws::String mSequenceNumber;
+                int64_t mMillisBehindLatest = -1;
+                int mErrors = 0;
+                bool mStarted = false;
+                bool mFinished = false;
+            };
+
+            // A shard index and the time of its next poll, ordered by time.
+            typedef std::pair<std::chrono::steady_clock::time_point, size_t> Poll;
+
+            bool listShards(Aws::Vector<Aws::Kinesis::Model::Shard> &shards) const;
+
+            void addShards(const Aws::Vector<Aws::Kinesis::Model::Shard> &shards);
+
+            void startReadyShards();
+
+            void refreshShards();
+
+            bool getShardIterator(ShardState &shard);
+
+            void scheduleLoop();
+
+            void pollShard(size_t index);
+
+            void finishShard(size_t index, bool failed);
+
+            void reschedule(size_t index, std::chrono::milliseconds delay,
+                            int64_t millisBehindLatest);
+
+            bool isCaughtUp() const;
+
+            uint64_t deliver(const ShardState &shard, const Aws::Kinesis::Model::Record &record,
+                             uint64_t &userBytes) const;
+
+            uint64_t deliverAggregated(const ShardState &shard,
+                                       const Aws::Kinesis::Model::Record &record,
+                                       uint64_t &userBytes) const;
+
+            static std::chrono::milliseconds backoffDelay(int attempt);
+
+            const Aws::Kinesis::KinesisClient &mKinesisClient;
+            const Aws::String mStreamName;
+            const Handler mHandler;
+            const Options mOptions;
+            std::shared_ptr<CheckpointStore> mCheckpointStore;
+
+            std::unique_ptr<Aws::Utils::Threading::PooledThreadExecutor> mExecutor;
+            std::thread mScheduler;
+
+            mutable std::mutex mMutex;
+            std::condition_variable mWake;
+            std::condition_variable mDone;
+            // A deque, so a running poll's reference to its shard stays valid
+            // while shards are added.
+            std::deque<ShardState> mShards;
+            Aws::Map<Aws::String, size_t> mShardIndexes;
+            std::priority_queue<Poll, std::vector<Poll>, std::greater<Poll>> mPolls;
+            size_t mRunning = 0;
+            std::chrono::steady_clock::time_point mNextShardList;
+            bool mListingShards = false;
+            bool mStarted = false;
+            bool mStopping = false;
+            bool mFinished = false;
+            bool mFailed = false;
+
+            std::atomic<uint64_t> mUserRecords;
+            std::atomic<uint64_t> mUserBytes;
+            std::atomic<uint64_t> mKinesisRecords;
+            std::atomic<uint64_t> mGetRecordsCalls;
+            std::atomic<uint64_t> mThrottles;
+        };
+    } // Kinesis
+} // AwsDoc
+
+#endif //KINESIS_EXAMPLES_KINESIS_CONSUMER_H
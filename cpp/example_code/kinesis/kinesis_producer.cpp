@@ -0,0 +1,541 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "kinesis_producer.h"
+#include <aws/core/utils/HashingUtils.h>
+#include <aws/core/utils/crypto/MD5.h>
+#include <aws/kinesis/model/ListShardsRequest.h>
+#include <aws/kinesis/model/PutRecordsRequest.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    // The first bytes of a KPL aggregated record, followed by a protobuf
+    // AggregatedRecord message and the MD5 hash of the message.
+    const unsigned char AGGREGATED_RECORD_MAGIC[] = {0xF3, 0x89, 0x9A, 0xC2};
+    const size_t MD5_LENGTH = 16;
+
+    // Protobuf field keys: partition_key_table (1) and records (3) in
+    // AggregatedRecord, and partition_key_index (1) and data (3) in Record.
+    const char PARTITION_KEY_TABLE_KEY = 0x0A;
+    const char RECORDS_KEY = 0x1A;
+    const char PARTITION_KEY_INDEX_KEY = 0x08;
+    const char DATA_KEY = 0x1A;
+
+    size_t varintSize(uint64_t value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    void appendVarint(Aws::String &buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    // The size of an encoded Record message.
+    size_t recordMessageSize(uint64_t partitionKeyIndex, size_t length) {
+        return 1 + varintSize(partitionKeyIndex) + 1 + varintSize(length) + length;
+    }
+} // namespace
+
+bool AwsDoc::Kinesis::isAggregatedRecord(const Aws::Utils::ByteBuffer &data) {
+    return data.GetLength() >= sizeof(AGGREGATED_RECORD_MAGIC) + MD5_LENGTH &&
+           std::memcmp(data.GetUnderlyingData(), AGGREGATED_RECORD_MAGIC,
+                       sizeof(AGGREGATED_RECORD_MAGIC)) == 0;
+}
+
+AwsDoc::Kinesis::Producer::Producer(const Aws::Kinesis::KinesisClient &kinesisClient,
+                                    const Aws::String &streamName,
+                                    const Options &options) :
+        mKinesisClient(kinesisClient), mStreamName(streamName), mOptions(options),
+        mUserRecords(0), mUserBytes(0), mKinesisRecords(0), mRequests(0),
+        mRetriedRecords(0), mFailedUserRecords(0) {
+}
+
+AwsDoc::Kinesis::Producer::~Producer() {
+    stop();
+}
+
+bool AwsDoc::Kinesis::Producer::start() {
+    if (mStarted) {
+        return true;
+    }
+
+    if (!listShards()) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStarted = true;
+        mStopping = false;
+    }
+
+    const size_t senderCount = std::max<size_t>(mOptions.mMaxInFlightRequests, 1);
+    for (size_t i = 0; i < senderCount; ++i) {
+        mSenders.push_back(std::thread(&Producer::sendLoop, this));
+    }
+
+    return true;
+}
+
+bool AwsDoc::Kinesis::Producer::listShards() {
+    mShards.clear();
+
+    Aws::Kinesis::Model::ListShardsRequest request;
+    request.SetStreamName(mStreamName);
+    Aws::String nextToken;
+    do {
+        Aws::Kinesis::Model::ListShardsOutcome outcome = mKinesisClient.ListShards(request);
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Error with Kinesis::ListShards. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return false;
+        }
+
+        for (const Aws::Kinesis::Model::Shard &shard: outcome.GetResult().GetShards()) {
+            // A closed shard, after a reshard, has an ending sequence number.
+            if (!shard.GetSequenceNumberRange().GetEndingSequenceNumber().empty()) {
+                continue;
+            }
+            Shard openShard;
+            openShard.mStartingHashKeyString = shard.GetHashKeyRange().GetStartingHashKey();
+            openShard.mStartingHashKey = parseHashKey(openShard.mStartingHashKeyString);
+            mShards.push_back(std::move(openShard));
+        }
+
+        // A request with a NextToken must not have a StreamName.
+        nextToken = outcome.GetResult().GetNextToken();
+        request = Aws::Kinesis::Model::ListShardsRequest();
+        request.SetNextToken(nextToken);
+    } while (!nextToken.empty());
+
+    if (mShards.empty()) {
+        std::cerr << "Error with Kinesis::ListShards. The stream '" << mStreamName
+                  << "' has no open shards." << std::endl;
+        return false;
+    }
+
+    std::sort(mShards.begin(), mShards.end(), [](const Shard &a, const Shard &b) {
+        return a.mStartingHashKey < b.mStartingHashKey;
+    });
+
+    return true;
+}
+
+bool AwsDoc::Kinesis::Producer::put(const Aws::String &partitionKey,
+                                    const unsigned char *data, size_t length) {
+    if (partitionKey.empty() || partitionKey.size() > MAX_PARTITION_KEY_LENGTH) {
+        std::cerr << "Error with Producer::put. The partition key must have 1 to "
+                  << MAX_PARTITION_KEY_LENGTH << " characters." << std::endl;
+        return false;
+    }
+    if (partitionKey.size() + length > MAX_RECORD_BYTES) {
+        std::cerr << "Error with Producer::put. The record exceeds "
+                  << MAX_RECORD_BYTES << " bytes." << std::endl;
+        return false;
+    }
+
+    const HashKey hashKey = hashPartitionKey(partitionKey);
+    const size_t maxAggregatedBytes = std::min(mOptions.mMaxAggregatedBytes,
+                                               size_t(MAX_RECORD_BYTES) -
+                                               MAX_PARTITION_KEY_LENGTH);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSpaceAvailable.wait(lock, [this] {
+        return mBufferedBytes < mOptions.mMaxBufferedBytes || mStopping;
+    });
+    if (!mStarted || mStopping) {
+        std::cerr << "Error with Producer::put. The producer is not running." << std::endl;
+        return false;
+    }
+
+    Shard &shard = mShards[shardIndex(hashKey)];
+    if (shard.mOpen.mUserRecords > 0 &&
+        shard.mOpen.recordBytes() + appendedBytes(shard.mOpen, partitionKey, length) >
+        maxAggregatedBytes) {
+        seal(shard);
+    }
+
+    Aggregate &aggregate = shard.mOpen;
+    if (aggregate.mUserRecords == 0) {
+        aggregate.mCreated = std::chrono::steady_clock::now();
+        aggregate.mExplicitHashKey = shard.mStartingHashKeyString;
+    }
+    append(aggregate, partitionKey, data, length);
+    mBufferedBytes += length;
+
+    if (!mOptions.mAggregate || aggregate.mUserRecords >= mOptions.mMaxAggregatedRecords) {
+        seal(shard);
+    }
+
+    return true;
+}
+
+bool AwsDoc::Kinesis::Producer::put(const Aws::String &partitionKey,
+                                    const Aws::String &data) {
+    return put(partitionKey, reinterpret_cast<const unsigned char *>(data.data()),
+               data.size());
+}
+
+bool AwsDoc::Kinesis::Producer::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mStarted) {
+            // While a flush is waiting, open aggregates are sent at once.
+            ++mFlushRequests;
+            mWorkAvailable.notify_all();
+            mIdle.wait(lock, [this] {
+                return mReady.empty() && mSending == 0 && !hasOpenRecords();
+            });
+            --mFlushRequests;
+        }
+    }
+
+    return mFailedUserRecords == 0;
+}
+
+void AwsDoc::Kinesis::Producer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mStarted) {
+            return;
+        }
+        // The senders send the buffered records before they return.
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+    mSpaceAvailable.notify_all();
+
+    for (std::thread &sender: mSenders) {
+        sender.join();
+    }
+    mSenders.clear();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStarted = false;
+    mIdle.notify_all();
+}
+
+AwsDoc::Kinesis::Producer::Metrics AwsDoc::Kinesis::Producer::getMetrics() const {
+    Metrics metrics;
+    metrics.mUserRecords = mUserRecords;
+    metrics.mUserBytes = mUserBytes;
+    metrics.mKinesisRecords = mKinesisRecords;
+    metrics.mRequests = mRequests;
+    metrics.mRetriedRecords = mRetriedRecords;
+    metrics.mFailedUserRecords = mFailedUserRecords;
+    return metrics;
+}
+
+size_t AwsDoc::Kinesis::Producer::Aggregate::recordBytes() const {
+    if (mUserRecords == 1) {
+        return mPartitionKey.size() + mFirstDataLength;
+    }
+
+    return mPartitionKey.size() + sizeof(AGGREGATED_RECORD_MAGIC) +
+           mPartitionKeyTable.size() + mRecords.size() + MD5_LENGTH;
+}
+
+size_t AwsDoc::Kinesis::Producer::shardIndex(const HashKey &hashKey) const {
+    // The shard with the greatest starting hash key not above the hash key.
+    auto shard = std::upper_bound(mShards.begin(), mShards.end(), hashKey,
+                                  [](const HashKey &key, const Shard &shard) {
+                                      return key < shard.mStartingHashKey;
+                                  });
+    return shard == mShards.begin() ? 0 : static_cast<size_t>(shard - mShards.begin()) - 1;
+}
+
+size_t AwsDoc::Kinesis::Producer::appendedBytes(const Aggregate &aggregate,
+                                                const Aws::String &partitionKey,
+                                                size_t length) {
+    auto index = aggregate.mPartitionKeyIndexes.find(partitionKey);
+    uint64_t keyIndex = aggregate.mPartitionKeyIndexes.size();
+    size_t bytes = 0;
+    if (index != aggregate.mPartitionKeyIndexes.end()) {
+        keyIndex = index->second;
+    }
+    else {
+        bytes += 1 + varintSize(partitionKey.size()) + partitionKey.size();
+    }
+
+    const size_t messageSize = recordMessageSize(keyIndex, length);
+    return bytes + 1 + varintSize(messageSize) + messageSize;
+}
+
+void AwsDoc::Kinesis::Producer::append(Aggregate &aggregate,
+                                       const Aws::String &partitionKey,
+                                       const unsigned char *data, size_t length) {
+    uint64_t keyIndex = aggregate.mPartitionKeyIndexes.size();
+    auto inserted = aggregate.mPartitionKeyIndexes.insert(
+            std::make_pair(partitionKey, keyIndex));
+    if (inserted.second) {
+        aggregate.mPartitionKeyTable.push_back(PARTITION_KEY_TABLE_KEY);
+        appendVarint(aggregate.mPartitionKeyTable, partitionKey.size());
+        aggregate.mPartitionKeyTable.append(partitionKey);
+    }
+    else {
+        keyIndex = inserted.first->second;
+    }
+
+    Aws::String &records = aggregate.mRecords;
+    records.push_back(RECORDS_KEY);
+    appendVarint(records, recordMessageSize(keyIndex, length));
+    records.push_back(PARTITION_KEY_INDEX_KEY);
+    appendVarint(records, keyIndex);
+    records.push_back(DATA_KEY);
+    appendVarint(records, length);
+
+    if (aggregate.mUserRecords == 0) {
+        aggregate.mPartitionKey = partitionKey;
+        aggregate.mFirstDataOffset = records.size();
+        aggregate.mFirstDataLength = length;
+    }
+    records.append(reinterpret_cast<const char *>(data), length);
+
+    ++aggregate.mUserRecords;
+    aggregate.mUserBytes += length;
+}
+
+// Moves the open aggregate of a shard to the ready queue. mMutex must be locked.
+void AwsDoc::Kinesis::Producer::seal(Shard &shard) {
+    mReady.push_back(std::move(shard.mOpen));
+    shard.mOpen = Aggregate();
+    mWorkAvailable.notify_one();
+}
+
+// Seals the open aggregates which are due, or all of them. mMutex must be locked.
+void AwsDoc::Kinesis::Producer::sealDue(std::chrono::steady_clock::time_point now,
+                                        bool all) {
+    for (Shard &shard: mShards) {
+        if (shard.mOpen.mUserRecords > 0 &&
+            (all || shard.mOpen.mCreated + mOptions.mMaxBufferTime <= now)) {
+            seal(shard);
+        }
+    }
+}
+
+bool AwsDoc::Kinesis::Producer::hasOpenRecords() const {
+    for (const Shard &shard: mShards) {
+        if (shard.mOpen.mUserRecords > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::chrono::steady_clock::time_point AwsDoc::Kinesis::Producer::nextDue() const {
+    std::chrono::steady_clock::time_point due = std::chrono::steady_clock::time_point::max();
+    for (const Shard &shard: mShards) {
+        if (shard.mOpen.mUserRecords > 0) {
+            due = std::min(due, shard.mOpen.mCreated + mOptions.mMaxBufferTime);
+        }
+    }
+    return due;
+}
+
+void AwsDoc::Kinesis::Producer::sendLoop() {
+    std::vector<Aggregate> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (true) {
+                sealDue(std::chrono::steady_clock::now(), mStopping || mFlushRequests > 0);
+                if (!mReady.empty()) {
+                    break;
+                }
+                if (mStopping) {
+                    return;
+                }
+
+                std::chrono::steady_clock::time_point due = nextDue();
+                if (due == std::chrono::steady_clock::time_point::max()) {
+                    mWorkAvailable.wait(lock);
+                }
+                else {
+                    mWorkAvailable.wait_until(lock, due);
+                }
+            }
+
+            // Take records in order, up to the PutRecords limits.
+            size_t requestBytes = 0;
+            while (!mReady.empty() && batch.size() < MAX_REQUEST_RECORDS &&
+                   (batch.empty() ||
+                    requestBytes + mReady.front().recordBytes() <= MAX_REQUEST_BYTES)) {
+                requestBytes += mReady.front().recordBytes();
+                mBufferedBytes -= mReady.front().mUserBytes;
+                batch.push_back(std::move(mReady.front()));
+                mReady.pop_front();
+            }
+            ++mSending;
+            if (!mReady.empty()) {
+                mWorkAvailable.notify_one();
+            }
+        }
+        mSpaceAvailable.notify_all();
+
+        sendRecords(batch);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mSending;
+            if (mReady.empty() && mSending == 0 && !hasOpenRecords()) {
+                mIdle.notify_all();
+            }
+        }
+    }
+}
+
+void AwsDoc::Kinesis::Producer::sendRecords(std::vector<Aggregate> &batch) {
+    Aws::Kinesis::Model::PutRecordsRequest request;
+    request.SetStreamName(mStreamName);
+    // The index in the batch of each record in the request.
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        request.AddRecords(buildEntry(batch[i]));
+        pending.push_back(i);
+    }
+
+    for (int attempt = 0;; ++attempt) {
+        Aws::Kinesis::Model::PutRecordsOutcome outcome = mKinesisClient.PutRecords(request);
+        ++mRequests;
+        if (!outcome.IsSuccess()) {
+            if (!outcome.GetError().ShouldRetry() || attempt >= mOptions.mMaxRetries) {
+                std::cerr << "Error with Kinesis::PutRecords. "
+                          << outcome.GetError().GetMessage() << std::endl;
+                for (size_t index: pending) {
+                    mFailedUserRecords += batch[index].mUserRecords;
+                }
+                return;
+            }
+            mRetriedRecords += pending.size();
+            std::this_thread::sleep_for(backoffDelay(attempt));
+            continue;
+        }
+
+        // The results are in the order of the request records. Only the records
+        // with an error code are sent again.
+        const Aws::Vector<Aws::Kinesis::Model::PutRecordsResultEntry> &results =
+                outcome.GetResult().GetRecords();
+        Aws::Kinesis::Model::PutRecordsRequest retryRequest;
+        retryRequest.SetStreamName(mStreamName);
+        std::vector<size_t> retryPending;
+        Aws::String errorMessage;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const Aggregate &aggregate = batch[pending[i]];
+            if (i < results.size() && results[i].GetErrorCode().empty()) {
+                ++mKinesisRecords;
+                mUserRecords += aggregate.mUserRecords;
+                mUserBytes += aggregate.mUserBytes;
+            }
+            else {
+                if (i < results.size()) {
+                    errorMessage = results[i].GetErrorCode() + ": " +
+                                   results[i].GetErrorMessage();
+                }
+                retryRequest.AddRecords(request.GetRecords()[i]);
+                retryPending.push_back(pending[i]);
+            }
+        }
+
+        if (retryPending.empty()) {
+            return;
+        }
+        if (attempt >= mOptions.mMaxRetries) {
+            std::cerr << "Error with Kinesis::PutRecords record. " << errorMessage
+                      << std::endl;
+            for (size_t index: retryPending) {
+                mFailedUserRecords += batch[index].mUserRecords;
+            }
+            return;
+        }
+
+        mRetriedRecords += retryPending.size();
+        std::this_thread::sleep_for(backoffDelay(attempt));
+        request = std::move(retryRequest);
+        pending.swap(retryPending);
+    }
+}
+
+Aws::Kinesis::Model::PutRecordsRequestEntry
+AwsDoc::Kinesis::Producer::buildEntry(const Aggregate &aggregate) {
+    Aws::Kinesis::Model::PutRecordsRequestEntry entry;
+    entry.SetPartitionKey(aggregate.mPartitionKey);
+
+    const unsigned char *records =
+            reinterpret_cast<const unsigned char *>(aggregate.mRecords.data());
+    if (aggregate.mUserRecords == 1) {
+        // A single user record gains nothing from aggregation.
+        entry.SetData(Aws::Utils::ByteBuffer(records + aggregate.mFirstDataOffset,
+                                             aggregate.mFirstDataLength));
+        return entry;
+    }
+
+    // Every user record hashed to this shard, so the record is routed to the
+    // shard by its starting hash key.
+    entry.SetExplicitHashKey(aggregate.mExplicitHashKey);
+
+    const size_t messageSize = aggregate.mPartitionKeyTable.size() + aggregate.mRecords.size();
+    Aws::Utils::ByteBuffer data(sizeof(AGGREGATED_RECORD_MAGIC) + messageSize + MD5_LENGTH);
+    unsigned char *out = data.GetUnderlyingData();
+    std::memcpy(out, AGGREGATED_RECORD_MAGIC, sizeof(AGGREGATED_RECORD_MAGIC));
+    unsigned char *message = out + sizeof(AGGREGATED_RECORD_MAGIC);
+    std::memcpy(message, aggregate.mPartitionKeyTable.data(),
+                aggregate.mPartitionKeyTable.size());
+    std::memcpy(message + aggregate.mPartitionKeyTable.size(), records,
+                aggregate.mRecords.size());
+
+    Aws::Utils::Crypto::MD5 md5;
+    md5.Update(message, messageSize);
+    Aws::Utils::ByteBuffer hash = md5.GetHash().GetResult();
+    std::memcpy(message + messageSize, hash.GetUnderlyingData(), MD5_LENGTH);
+
+    entry.SetData(std::move(data));
+    return entry;
+}
+
+// The MD5 hash of a partition key, as a 128-bit big-endian integer.
+AwsDoc::Kinesis::Producer::HashKey
+AwsDoc::Kinesis::Producer::hashPartitionKey(const Aws::String &partitionKey) {
+    Aws::Utils::ByteBuffer hash = Aws::Utils::HashingUtils::CalculateMD5(partitionKey);
+    HashKey hashKey(0, 0);
+    for (size_t i = 0; i < 8; ++i) {
+        hashKey.first = (hashKey.first << 8) | hash[i];
+        hashKey.second = (hashKey.second << 8) | hash[i + 8];
+    }
+    return hashKey;
+}
+
+// Parses a decimal hash key, from 0 to 2^128 - 1.
+AwsDoc::Kinesis::Producer::HashKey
+AwsDoc::Kinesis::Producer::parseHashKey(const Aws::String &decimal) {
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (char digit: decimal) {
+        if (digit < '0' || digit > '9') {
+            break;
+        }
+        // Multiply by 10 and add the digit, 32 bits at a time.
+        uint64_t lowPart = (low & 0xFFFFFFFF) * 10 + static_cast<uint64_t>(digit - '0');
+        uint64_t highPart = (low >> 32) * 10 + (lowPart >> 32);
+        low = (highPart << 32) | (lowPart & 0xFFFFFFFF);
+        high = high * 10 + (highPart >> 32);
+    }
+    return HashKey(high, low);
+}
+
+std::chrono::milliseconds AwsDoc::Kinesis::Producer::backoffDelay(int attempt) {
+    const int BASE_DELAY_MS = 100;
+    const int MAX_DELAY_MS = 5000;
+    return std::chrono::milliseconds(
+            std::min(MAX_DELAY_MS, BASE_DELAY_MS << std::min(attempt, 10)));
+}
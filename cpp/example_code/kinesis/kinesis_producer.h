@@ -0,0 +1,257 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef KINESIS_EXAMPLES_KINESIS_PRODUCER_H
+#define KINESIS_EXAMPLES_KINESIS_PRODUCER_H
+
+#include <aws/core/Aws.h>
+#include <aws/kinesis/KinesisClient.h>
+#include <aws/kinesis/model/PutRecordsRequestEntry.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace AwsDoc {
+    namespace Kinesis {
+        //! Routine which checks whether Kinesis record data is a KPL aggregated record.
+        /*!
+          \sa isAggregatedRecord()
+          \param data: The record data.
+          \return bool: True if the data starts with the aggregated record magic bytes.
+         */
+        bool isAggregatedRecord(const Aws::Utils::ByteBuffer &data);
+
+        // Options for Producer.
+        struct ProducerOptions {
+            // Combine user records into aggregated Kinesis records.
+            bool mAggregate = true;
+            // The maximum size of an aggregated Kinesis record.
+            size_t mMaxAggregatedBytes = 50 * 1024;
+            // The maximum number of user records in an aggregated Kinesis record.
+            size_t mMaxAggregatedRecords = 1000;
+            // The longest time a user record is buffered before it is sent.
+            std::chrono::milliseconds mMaxBufferTime = std::chrono::milliseconds(100);
+            // PutRecords requests sent at the same time.
+            size_t mMaxInFlightRequests = 4;
+            // User record bytes buffered before put() waits.
+            size_t mMaxBufferedBytes = 16 * 1024 * 1024;
+            // Retries for a failed request, or for the failed records in a request.
+            int mMaxRetries = 5;
+        };
+
+        // Metrics for a Producer.
+        struct ProducerMetrics {
+            // User records, and their data bytes, accepted by Kinesis.
+            uint64_t mUserRecords = 0;
+            uint64_t mUserBytes = 0;
+            // Kinesis records accepted by Kinesis.
+            uint64_t mKinesisRecords = 0;
+            uint64_t mRequests = 0;
+            // Kinesis records sent again after a failure.
+            uint64_t mRetriedRecords = 0;
+            // User records which could not be put.
+            uint64_t mFailedUserRecords = 0;
+        };
+
+        /**
+         * A producer which writes small user records to an Amazon Kinesis data stream.
+         *
+         * The stream's shards are listed when the producer starts. Each user record
+         * is routed to a shard by the MD5 hash of its partition key, and each shard
+         * has a queue in which its user records are combined into aggregated Kinesis
+         * records, in the format used by the Kinesis Producer Library (KPL). The
+         * Kinesis Client Library (KCL) de-aggregates them, and a Kinesis record holds
+         * many user records toward the per-shard limit of 1,000 records per second.
+         *
+         * An aggregated record is sent when it is full, or when its first user
+         * record has waited for the buffer time. Several PutRecords requests are in
+         * flight at the same time. Only the records which fail within a request are
+         * sent again, after an exponential backoff.
+         *
+         *   AwsDoc::Kinesis::Producer producer(kinesisClient, streamName);
+         *   if (producer.start()) {
+         *       producer.put("partition-key", "data");
+         *       bool allPut = producer.flush();
+         *   }
+         */
+        class Producer {
+        public:
+            // PutRecords limits.
+            static const size_t MAX_REQUEST_RECORDS = 500;
+            static const size_t MAX_REQUEST_BYTES = 5 * 1024 * 1024;
+            // The limit for the data and partition key of a Kinesis record.
+            static const size_t MAX_RECORD_BYTES = 1024 * 1024;
+            static const size_t MAX_PARTITION_KEY_LENGTH = 256;
+
+            typedef ProducerOptions Options;
+            typedef ProducerMetrics Metrics;
+
+            //! Producer constructor.
+            /*!
+              \param kinesisClient: A Kinesis client. It must outlive the producer, and
+                                    its maxConnections should cover the in-flight requests.
+              \param streamName: The stream name.
+              \param options: The producer options.
+             */
+            Producer(const Aws::Kinesis::KinesisClient &kinesisClient,
+                     const Aws::String &streamName,
+                     const Options &options = Options());
+
+            Producer(const Producer &) = delete;
+
+            Producer &operator=(const Producer &) = delete;
+
+            //! Producer destructor. Waits for buffered records to be put.
+            ~Producer();
+
+            //! Routine which lists the shards of the stream and starts the sender threads.
+            /*!
+              \return bool: Function succeeded.
+             */
+            bool start();
+
+            //! Routine which buffers a user record. This routine is thread safe.
+            /*!
+              put() waits while the buffered records exceed options.mMaxBufferedBytes.
+              \param partitionKey: The partition key, of 1 to 256 characters.
+              \param data: The record data.
+              \param length: The length of the data.
+              \return bool: False if the producer is not started, or if the record
+                            is too large.
+             */
+            bool put(const Aws::String &partitionKey, const unsigned char *data,
+                     size_t length);
+
+            //! Routine which buffers a user record. This routine is thread safe.
+            /*!
+              \param partitionKey: The partition key, of 1 to 256 characters.
+              \param data: The record data.
+              \return bool: False if the producer is not started, or if the record
+                            is too large.
+             */
+            bool put(const Aws::String &partitionKey, const Aws::String &data);
+
+            //! Routine which waits until the buffered records are put or have failed.
+            /*!
+              \return bool: True if no user record has failed.
+             */
+            bool flush();
+
+            //! Routine which flushes the buffered records and stops the sender threads.
+            /*!
+              \return void:
+             */
+            void stop();
+
+            //! Routine which returns a snapshot of the producer metrics.
+            /*!
+              \return Metrics: The metrics.
+             */
+            Metrics getMetrics() const;
+
+            //! Routine which returns the number of open shards in the stream.
+            /*!
+              \return size_t: The number of shards.
+             */
+            size_t shardCount() const { return mShards.size(); }
+
+        private:
+            // A 128-bit hash key, as high and low 64 bits.
+            typedef std::pair<uint64_t, uint64_t> HashKey;
+
+            // The user records combined into one Kinesis record.
+            struct Aggregate {
+                // The partition key of the first user record.
+                Aws::String mPartitionKey;
+                Aws::String mExplicitHashKey;
+                // The encoded partition key table, and the index of each key in it.
+                Aws::String mPartitionKeyTable;
+                Aws::Map<Aws::String, uint64_t> mPartitionKeyIndexes;
+                // The encoded user records.
+                Aws::String mRecords;
+                // The data of the first user record, which is sent unaggregated
+                // when it is the only user record.
+                size_t mFirstDataOffset = 0;
+                size_t mFirstDataLength = 0;
+                size_t mUserRecords = 0;
+                size_t mUserBytes = 0;
+                std::chrono::steady_clock::time_point mCreated;
+
+                // The size of the Kinesis record data and partition key.
+                size_t recordBytes() const;
+            };
+
+            struct Shard {
+                HashKey mStartingHashKey;
+                Aws::String mStartingHashKeyString;
+                Aggregate mOpen;
+            };
+
+            bool listShards();
+
+            size_t shardIndex(const HashKey &hashKey) const;
+
+            static size_t appendedBytes(const Aggregate &aggregate,
+                                        const Aws::String &partitionKey, size_t length);
+
+            static void append(Aggregate &aggregate, const Aws::String &partitionKey,
+                               const unsigned char *data, size_t length);
+
+            void seal(Shard &shard);
+
+            void sealDue(std::chrono::steady_clock::time_point now, bool all);
+
+            bool hasOpenRecords() const;
+
+            std::chrono::steady_clock::time_point nextDue() const;
+
+            void sendLoop();
+
+            void sendRecords(std::vector<Aggregate> &batch);
+
+            static Aws::Kinesis::Model::PutRecordsRequestEntry
+            buildEntry(const Aggregate &aggregate);
+
+            static HashKey hashPartitionKey(const Aws::String &partitionKey);
+
+            static HashKey parseHashKey(const Aws::String &decimal);
+
+            static std::chrono::milliseconds backoffDelay(int attempt);
+
+            const Aws::Kinesis::KinesisClient &mKinesisClient;
+            const Aws::String mStreamName;
+            const Options mOptions;
+
+            // Sorted by starting hash key.
+            std::vector<Shard> mShards;
+            std::vector<std::thread> mSenders;
+
+            mutable std::mutex mMutex;
+            std::condition_variable mWorkAvailable;
+            std::condition_variable mSpaceAvailable;
+            std::condition_variable mIdle;
+            std::deque<Aggregate> mReady;
+            size_t mBufferedBytes = 0;
+            size_t mSending = 0;
+            size_t mFlushRequests = 0;
+            bool mStarted = false;
+            bool mStopping = false;
+
+            std::atomic<uint64_t> mUserRecords;
+            std::atomic<uint64_t> mUserBytes;
+            std::atomic<uint64_t> mKinesisRecords;
+            std::atomic<uint64_t> mRequests;
+            std::atomic<uint64_t> mRetriedRecords;
+            std::atomic<uint64_t> mFailedUserRecords;
+        };
+    } // Kinesis
+} // AwsDoc
+
+#endif //KINESIS_EXAMPLES_KINESIS_PRODUCER_H
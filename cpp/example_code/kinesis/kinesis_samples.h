@@ -0,0 +1,39 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef KINESIS_EXAMPLES_KINESIS_SAMPLES_H
+#define KINESIS_EXAMPLES_KINESIS_SAMPLES_H
+
+#include <aws/core/client/ClientConfiguration.h>
+
+namespace AwsDoc {
+    namespace Kinesis {
+        //! Put records into an Amazon Kinesis data stream.
+        /*!
+          The records are combined into aggregated Kinesis records for each shard,
+          and only the records which fail in a PutRecords request are sent again.
+          \param streamName: The stream name.
+          \param recordCount: The number of records to put.
+          \param clientConfig: AWS client configuration.
+          \return bool: Function succeeded.
+         */
+        bool putRecords(const Aws::String &streamName, int recordCount,
+                        const Aws::Client::ClientConfiguration &clientConfig);
+
+        //! Retrieve the records from every shard of an Amazon Kinesis data stream.
+        /*!
+          Each shard is read until it reaches the tip of the stream. The position
+          reached in each shard is saved, so the next call starts after it.
+          \param streamName: The stream name.
+          \param checkpointFile: The file which records the position reached in each shard.
+          \param clientConfig: AWS client configuration.
+          \return bool: Function succeeded.
+         */
+        bool getRecords(const Aws::String &streamName,
+                        const Aws::String &checkpointFile,
+                        const Aws::Client::ClientConfiguration &clientConfig);
+    } // Kinesis
+} // AwsDoc
+
+#endif //KINESIS_EXAMPLES_KINESIS_SAMPLES_H
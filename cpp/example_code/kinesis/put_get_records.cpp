@@ -1,43 +1,152 @@
 // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // SPDX-License-Identifier: Apache-2.0
- // Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
-// SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <random>
 #include <aws/core/Aws.h>
 #include <aws/core/utils/Outcome.h>
 #include <aws/kinesis/KinesisClient.h>
-#include <aws/kinesis/model/DescribeStreamRequest.h>
-#include <aws/kinesis/model/DescribeStreamResult.h>
-#include <aws/kinesis/model/GetRecordsRequest.h>
-#include <aws/kinesis/model/GetRecordsResult.h>
-#include <aws/kinesis/model/GetShardIteratorRequest.h>
-#include <aws/kinesis/model/GetShardIteratorResult.h>
-#include <aws/kinesis/model/Shard.h>
-#include <aws/kinesis/model/PutRecordsResult.h>
-#include <aws/kinesis/model/PutRecordsRequest.h>
-#include <aws/kinesis/model/PutRecordsRequestEntry.h>
+#include <mutex>
+#include "kinesis_consumer.h"
+#include "kinesis_producer.h"
+#include "kinesis_samples.h"
 
 /**
-* Puts multiple records into a stream. Retrieves some records
-* using a shard iterator.
+* Puts multiple records into a stream. Retrieves the records
+* from every shard.
 *
 * Takes name of a data stream to populate.
 *
 * This code expects that you have AWS credentials set up per:
 * http://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/credentials.html
 */
+
+//! Put records into a stream with an aggregating producer.
+/*!
+  \sa putRecords()
+  \param streamName: The stream name.
+  \param recordCount: The number of records to put.
+  \param clientConfig: AWS client configuration.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::Kinesis::putRecords(const Aws::String &streamName, int recordCount,
+                                 const Aws::Client::ClientConfiguration &clientConfig)
+{
+    std::random_device rd;
+    std::mt19937 mt_rand(rd());
+
+    Aws::Kinesis::KinesisClient kinesisClient(clientConfig);
+
+    // The records are combined into aggregated records for each shard, and only
+    // the records which fail in a PutRecords request are sent again.
+    AwsDoc::Kinesis::Producer producer(kinesisClient, streamName);
+    if (!producer.start())
+    {
+        return false;
+    }
+
+    Aws::Vector<Aws::String> animals{"dog", "cat", "mouse", "horse", "stoat", "snake"};
+
+    std::cout << "Adding records to stream \"" << streamName << "\"" << std::endl;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < recordCount; i++)
+    {
+        Aws::StringStream pk;
+        pk << "pk-" << (i % 100);
+        Aws::StringStream data;
+        data << i << ", " << animals[mt_rand() % animals.size()] << ", " << mt_rand() << ", " << mt_rand() * (float).001;
+        producer.put(pk.str(), data.str());
+    }
+
+    bool result = producer.flush();
+    double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    AwsDoc::Kinesis::Producer::Metrics metrics = producer.getMetrics();
+    std::cout << "Put " << metrics.mUserRecords << " records in " << metrics.mKinesisRecords
+              << " Kinesis records to " << producer.shardCount() << " shards with "
+              << metrics.mRequests << " requests." << std::endl;
+    std::cout << metrics.mUserRecords / std::max(seconds, 1e-9) << " records/s, "
+              << metrics.mUserBytes / std::max(seconds, 1e-9) << " bytes/s." << std::endl;
+    if (metrics.mRetriedRecords > 0)
+    {
+        std::cout << metrics.mRetriedRecords << " Kinesis records were retried." << std::endl;
+    }
+    if (!result)
+    {
+        std::cerr << metrics.mFailedUserRecords << " records could not be put." << std::endl;
+    }
+
+    return result;
+}
+
+//! Retrieve the records from every shard of a stream.
+/*!
+  \sa getRecords()
+  \param streamName: The stream name.
+  \param checkpointFile: The file which records the position reached in each shard.
+  \param clientConfig: AWS client configuration.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::Kinesis::getRecords(const Aws::String &streamName,
+                                 const Aws::String &checkpointFile,
+                                 const Aws::Client::ClientConfiguration &clientConfig)
+{
+    Aws::Kinesis::KinesisClient kinesisClient(clientConfig);
+
+    const uint64_t MAX_PRINTED_RECORDS = 100;
+    std::mutex printMutex;
+    uint64_t recordCount = 0;
+    auto handler = [&](const AwsDoc::Kinesis::ConsumerRecord &record)
+    {
+        // The data is not null terminated.
+        std::lock_guard<std::mutex> lock(printMutex);
+        if (++recordCount <= MAX_PRINTED_RECORDS)
+        {
+            std::cout << *record.mShardId << ": ";
+            std::cout.write(reinterpret_cast<const char*>(record.mData), record.mLength);
+            std::cout << std::endl;
+        }
+    };
+
+    // Every shard is read until it reaches the tip of the stream. The checkpoints
+    // let the next run start after the records read by this one.
+    AwsDoc::Kinesis::Consumer::Options options;
+    options.mStopWhenCaughtUp = true;
+    options.mCheckpointFile = checkpointFile;
+    AwsDoc::Kinesis::Consumer consumer(kinesisClient, streamName, handler, options);
+    if (!consumer.start())
+    {
+        return false;
+    }
+
+    bool result = consumer.wait();
+    AwsDoc::Kinesis::Consumer::Metrics metrics = consumer.getMetrics();
+    std::cout << "Retrieved " << metrics.mUserRecords << " records in "
+              << metrics.mKinesisRecords << " Kinesis records from "
+              << metrics.mActiveShards + metrics.mCompletedShards << " shards with "
+              << metrics.mGetRecordsCalls << " requests." << std::endl;
+
+    return result;
+}
+
+#ifndef TESTING_BUILD
+
 int main(int argc, char** argv)
 {
     const std::string USAGE = "\n" \
         "Usage:\n"
-        "    put_get_records <streamname>\n\n"
+        "    put_get_records <streamname> [recordcount]\n\n"
         "Where:\n"
-        "    streamname - the table to delete the item from.\n\n"
+        "    streamname - the stream to put records into and get records from.\n"
+        "    recordcount - the number of records to put, 500 by default.\n\n"
+        "The position reached in each shard is saved in <streamname>.checkpoints,\n"
+        "so the next run retrieves only the records put after this one.\n\n"
         "Example:\n"
         "    put_get_records sample-stream\n\n";
 
-    if (argc != 2)
+    if (argc < 2 || argc > 3)
     {
         std::cout << USAGE;
         return 1;
@@ -47,108 +156,15 @@ int main(int argc, char** argv)
     Aws::InitAPI(options);
     {
         const Aws::String streamName(argv[1]);
-
-        std::random_device rd;
-        std::mt19937 mt_rand(rd());
+        const int recordCount = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 500;
 
         Aws::Client::ClientConfiguration clientConfig;
         // set your region
         clientConfig.region = Aws::Region::US_WEST_2;
-        Aws::Kinesis::KinesisClient kinesisClient(clientConfig);
-
-        Aws::Vector<Aws::String> animals{"dog", "cat", "mouse", "horse", "stoat", "snake"};
-        Aws::Kinesis::Model::PutRecordsRequest putRecordsRequest;
-        putRecordsRequest.SetStreamName(streamName);
-        Aws::Vector<Aws::Kinesis::Model::PutRecordsRequestEntry> putRecordsRequestEntryList;
-
-        // create 500 records
-        std::cout << "Adding records to stream \"" << streamName << "\"" << std::endl;
-        for (int i = 0; i < 500; i++)
-        {
-            Aws::Kinesis::Model::PutRecordsRequestEntry putRecordsRequestEntry;
-            Aws::StringStream pk;
-            pk << "pk-" << (i % 100);
-            putRecordsRequestEntry.SetPartitionKey(pk.str()); 
-            Aws::StringStream data;
-            data << i << ", " << animals[mt_rand() % animals.size()] << ", " << mt_rand() << ", " << mt_rand() * (float).001;
-            Aws::Utils::ByteBuffer bytes((unsigned char*)data.str().c_str(), data.str().length());
-            putRecordsRequestEntry.SetData(bytes);
-            putRecordsRequestEntryList.emplace_back(putRecordsRequestEntry);
-        }
-        putRecordsRequest.SetRecords(putRecordsRequestEntryList);
-        Aws::Kinesis::Model::PutRecordsOutcome putRecordsResult = kinesisClient.PutRecords(putRecordsRequest);
 
-        // if one or more records were not put, retry them
-        while (putRecordsResult.GetResult().GetFailedRecordCount() > 0)
+        if (AwsDoc::Kinesis::putRecords(streamName, recordCount, clientConfig))
         {
-            std::cout << "Some records failed, retrying" << std::endl;
-            Aws::Vector<Aws::Kinesis::Model::PutRecordsRequestEntry> failedRecordsList;
-            Aws::Vector<Aws::Kinesis::Model::PutRecordsResultEntry> putRecordsResultEntryList = putRecordsResult.GetResult().GetRecords();
-            for (unsigned int i = 0; i < putRecordsResultEntryList.size(); i++)
-            {
-                Aws::Kinesis::Model::PutRecordsRequestEntry putRecordRequestEntry = putRecordsRequestEntryList[i];
-                Aws::Kinesis::Model::PutRecordsResultEntry putRecordsResultEntry = putRecordsResultEntryList[i];
-                if (putRecordsResultEntry.GetErrorCode().length() > 0)
-                    failedRecordsList.emplace_back(putRecordRequestEntry);
-            }
-            putRecordsRequestEntryList = failedRecordsList;
-            putRecordsRequest.SetRecords(putRecordsRequestEntryList);
-            putRecordsResult = kinesisClient.PutRecords(putRecordsRequest);
-        }
-
-        // Describe shards
-        Aws::Kinesis::Model::DescribeStreamRequest describeStreamRequest;
-        describeStreamRequest.SetStreamName(streamName);
-        Aws::Vector<Aws::Kinesis::Model::Shard> shards;
-        Aws::String exclusiveStartShardId = "";
-        do
-        {
-            Aws::Kinesis::Model::DescribeStreamOutcome describeStreamResult = kinesisClient.DescribeStream(describeStreamRequest);
-            Aws::Vector<Aws::Kinesis::Model::Shard> shardsTemp = describeStreamResult.GetResult().GetStreamDescription().GetShards();
-            shards.insert(shards.end(), shardsTemp.begin(), shardsTemp.end());
-            std::cout << describeStreamResult.GetError().GetMessage();
-            if (describeStreamResult.GetResult().GetStreamDescription().GetHasMoreShards() && shards.size() > 0)
-            {
-                exclusiveStartShardId = shards[shards.size() - 1].GetShardId();
-                describeStreamRequest.SetExclusiveStartShardId(exclusiveStartShardId);
-            }
-            else
-                exclusiveStartShardId = "";
-        } while (exclusiveStartShardId.length() != 0);
-
-        if (shards.size() > 0)
-        {
-            std::cout << "Shards found:" << std::endl;
-            for (auto shard : shards)
-            {
-                std::cout << shard.GetShardId() << std::endl;
-            }
-
-            Aws::Kinesis::Model::GetShardIteratorRequest getShardIteratorRequest;
-            getShardIteratorRequest.SetStreamName(streamName);
-            // use the first shard found
-            getShardIteratorRequest.SetShardId(shards[0].GetShardId());
-            getShardIteratorRequest.SetShardIteratorType(Aws::Kinesis::Model::ShardIteratorType::TRIM_HORIZON);
-
-            Aws::Kinesis::Model::GetShardIteratorOutcome getShardIteratorResult = kinesisClient.GetShardIterator(getShardIteratorRequest);
-            Aws::String shardIterator = getShardIteratorResult.GetResult().GetShardIterator();
-
-            Aws::Kinesis::Model::GetRecordsRequest getRecordsRequest;
-            getRecordsRequest.SetShardIterator(shardIterator);
-            getRecordsRequest.SetLimit(25);
-
-            // pull down 100 records
-            std::cout << "Retrieving 100 records" << std::endl;
-            for (int i = 0; i < 4; i++)
-            {
-                Aws::Kinesis::Model::GetRecordsOutcome getRecordsResult = kinesisClient.GetRecords(getRecordsRequest);
-                for (auto r : getRecordsResult.GetResult().GetRecords())
-                {
-                    Aws::String s((char*)r.GetData().GetUnderlyingData());
-                    std::cout << s.substr(0, r.GetData().GetLength()) << std::endl;
-                }
-                shardIterator = getRecordsResult.GetResult().GetNextShardIterator();
-            }
+            AwsDoc::Kinesis::getRecords(streamName, streamName + ".checkpoints", clientConfig);
         }
     }
     Aws::ShutdownAPI(options);
@@ -156,4 +172,4 @@ int main(int argc, char** argv)
     return 0;
 }
 
-
+#endif // TESTING_BUILD
@@ -0,0 +1,151 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/kinesis/KinesisClient.h>
+#include "kinesis_consumer.h"
+#include "kinesis_producer.h"
+#include "kinesis_samples.h"
+#include "kinesis_gtests.h"
+
+namespace AwsDocTest {
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Kinesis_GTests, put_records_3_) {
+        MockHTTP mockHttp;
+        bool result = mockHttp.addResponseWithBody("mock_input/list_shards.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        // The record is throttled, and only that record is sent again.
+        result = mockHttp.addResponseWithBody("mock_input/put_records_failed_entry.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/put_records.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+
+        result = AwsDoc::Kinesis::putRecords("MockStream", 1, *s_clientConfig);
+        ASSERT_TRUE(result);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Kinesis_GTests, producer_aggregate_and_retry_3_) {
+        const size_t RECORD_COUNT = 2000;
+        const size_t RECORD_BYTES = 100;
+
+        // One Kinesis record in 10 is throttled.
+        MockKinesisService mockKinesisService(10);
+        Aws::Auth::AWSCredentials credentials("MOCK_ACCESS_KEY", "MOCK_SECRET_KEY");
+        Aws::Kinesis::KinesisClient kinesisClient(credentials, *s_clientConfig);
+
+        // Small aggregated records, so there are enough Kinesis records to throttle.
+        AwsDoc::Kinesis::Producer::Options options;
+        options.mMaxAggregatedRecords = 10;
+        AwsDoc::Kinesis::Producer producer(kinesisClient, "MockStream", options);
+        ASSERT_TRUE(producer.start()) << preconditionError() << std::endl;
+        ASSERT_EQ(producer.shardCount(), 4u) << preconditionError() << std::endl;
+
+        const Aws::String data(RECORD_BYTES, 'x');
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            ASSERT_TRUE(producer.put("pk-" + Aws::Utils::StringUtils::to_string(i % 100),
+                                     data));
+        }
+        ASSERT_TRUE(producer.flush());
+
+        // The user records are aggregated, and the throttled Kinesis records are
+        // sent again until every user record is put.
+        AwsDoc::Kinesis::Producer::Metrics metrics = producer.getMetrics();
+        ASSERT_EQ(metrics.mUserRecords, RECORD_COUNT);
+        ASSERT_EQ(metrics.mUserBytes, RECORD_COUNT * RECORD_BYTES);
+        ASSERT_LT(metrics.mKinesisRecords, RECORD_COUNT);
+        ASSERT_GT(metrics.mRetriedRecords, 0u);
+        ASSERT_GT(metrics.mRequests, 1u);
+        ASSERT_EQ(metrics.mFailedUserRecords, 0u);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Kinesis_GTests, get_records_3_) {
+        MockHTTP mockHttp;
+        bool result = mockHttp.addResponseWithBody("mock_input/list_shards.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/get_shard_iterator.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        // A record, and an aggregated record with two user records.
+        result = mockHttp.addResponseWithBody("mock_input/get_records.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+
+        const Aws::String checkpointFile = "gtest_get_records.checkpoints";
+        std::remove(checkpointFile.c_str());
+        result = AwsDoc::Kinesis::getRecords("MockStream", checkpointFile, *s_clientConfig);
+        ASSERT_TRUE(result);
+
+        // The shard is checkpointed at the last record.
+        AwsDoc::Kinesis::FileCheckpointStore checkpointStore(checkpointFile);
+        Aws::String sequenceNumber;
+        ASSERT_TRUE(checkpointStore.load("shardId-000000000000", sequenceNumber));
+        ASSERT_EQ(sequenceNumber, "49590338271490256608559692538361571095921575989136588899");
+        std::remove(checkpointFile.c_str());
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Kinesis_GTests, get_records_reshard_3_) {
+        MockHTTP mockHttp;
+        bool result = mockHttp.addResponseWithBody("mock_input/list_shards.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/get_shard_iterator.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        // The shard is closed by a reshard after its last record.
+        result = mockHttp.addResponseWithBody("mock_input/get_records_shard_end.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        // The child shard was created after the shards were first listed.
+        result = mockHttp.addResponseWithBody("mock_input/list_shards_resharded.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/get_shard_iterator.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/get_records.json");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+
+        const Aws::String checkpointFile = "gtest_get_records_reshard.checkpoints";
+        std::remove(checkpointFile.c_str());
+        result = AwsDoc::Kinesis::getRecords("MockStream", checkpointFile, *s_clientConfig);
+        ASSERT_TRUE(result);
+
+        // The closed shard is finished, and the child shard is read.
+        AwsDoc::Kinesis::FileCheckpointStore checkpointStore(checkpointFile);
+        Aws::String sequenceNumber;
+        ASSERT_TRUE(checkpointStore.load("shardId-000000000000", sequenceNumber));
+        ASSERT_EQ(sequenceNumber, AwsDoc::Kinesis::CheckpointStore::SHARD_END);
+        ASSERT_TRUE(checkpointStore.load("shardId-000000000001", sequenceNumber));
+        ASSERT_EQ(sequenceNumber, "49590338271490256608559692538361571095921575989136588899");
+        std::remove(checkpointFile.c_str());
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(Kinesis_GTests, file_checkpoint_store_3_) {
+        const Aws::String checkpointFile = "gtest_file_checkpoint_store.checkpoints";
+        std::remove(checkpointFile.c_str());
+        {
+            AwsDoc::Kinesis::FileCheckpointStore checkpointStore(checkpointFile);
+            ASSERT_TRUE(checkpointStore.save("shardId-000000000000", "12345"));
+            ASSERT_TRUE(checkpointStore.save("shardId-000000000001",
+                                             AwsDoc::Kinesis::CheckpointStore::SHARD_END));
+            ASSERT_TRUE(checkpointStore.save("shardId-000000000000", "67890"));
+        }
+
+        AwsDoc::Kinesis::FileCheckpointStore checkpointStore(checkpointFile);
+        Aws::String sequenceNumber;
+        ASSERT_TRUE(checkpointStore.load("shardId-000000000000", sequenceNumber));
+        ASSERT_EQ(sequenceNumber, "67890");
+        ASSERT_TRUE(checkpointStore.load("shardId-000000000001", sequenceNumber));
+        ASSERT_EQ(sequenceNumber, AwsDoc::Kinesis::CheckpointStore::SHARD_END);
+        ASSERT_FALSE(checkpointStore.load("shardId-000000000002", sequenceNumber));
+        std::remove(checkpointFile.c_str());
+    }
+} // namespace AwsDocTest
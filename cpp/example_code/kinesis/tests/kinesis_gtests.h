@@ -0,0 +1,65 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef KINESIS_EXAMPLES_KINESIS_GTESTS_H
+#define KINESIS_EXAMPLES_KINESIS_GTESTS_H
+
+#include <aws/core/Aws.h>
+#include <memory>
+#include <gtest/gtest.h>
+#include <aws/core/http/standard/StandardHttpRequest.h>
+#include "mock_kinesis_service.h"
+
+class MockHttpClient;
+
+class MockHttpClientFactory;
+
+namespace AwsDocTest {
+
+    class Kinesis_GTests : public testing::Test {
+    protected:
+
+        void SetUp() override;
+
+        void TearDown() override;
+
+        static void SetUpTestSuite();
+
+        static void TearDownTestSuite();
+
+        static Aws::String preconditionError();
+
+        // s_clientConfig must be a pointer because the client config must be initialized
+        // after InitAPI.
+        static std::unique_ptr<Aws::Client::ClientConfiguration> s_clientConfig;
+
+    private:
+
+        bool suppressStdOut();
+
+        static Aws::SDKOptions s_options;
+
+        std::stringbuf m_coutBuffer;  // Used to silence cout.
+        std::streambuf *m_savedBuffer = nullptr;
+    }; // Kinesis_GTests
+
+
+    class MockHTTP {
+    public:
+        MockHTTP();
+
+        virtual ~MockHTTP();
+
+        bool addResponseWithBody(const std::string &fileName,
+                                 Aws::Http::HttpResponseCode httpResponseCode = Aws::Http::HttpResponseCode::OK);
+
+    private:
+
+        std::shared_ptr<MockHttpClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+        std::shared_ptr<Aws::Http::HttpRequest> requestTmp;
+    }; // MockHTTP
+} // AwsDocTest
+
+#endif //KINESIS_EXAMPLES_KINESIS_GTESTS_H
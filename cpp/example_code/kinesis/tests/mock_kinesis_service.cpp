@@ -0,0 +1,116 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mock_kinesis_service.h"
+#include <atomic>
+#include <aws/core/Aws.h>
+#include <aws/core/http/HttpClientFactory.h>
+#include <aws/core/http/standard/StandardHttpResponse.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <aws/testing/mocks/http/MockHttpClient.h>
+
+namespace AwsDocTest {
+    static const char ALLOCATION_TAG[] = "KINESIS_MOCK_SERVICE";
+
+/*
+ * Subclass MockHttpClient to generate Kinesis responses, instead of returning
+ * stored responses, so a test or a benchmark can make any number of requests.
+ */
+    class KinesisServiceMockHTTPClient : public MockHttpClient {
+    public:
+        explicit KinesisServiceMockHTTPClient(int failureInterval) :
+                mFailureInterval(failureInterval), mRecordCount(0) {}
+
+        std::shared_ptr<Aws::Http::HttpResponse>
+        MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                    Aws::Utils::RateLimits::RateLimiterInterface *,
+                    Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+            std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                    ALLOCATION_TAG, request);
+            response->AddHeader("Content-Type", "application/x-amz-json-1.1");
+            response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+
+            Aws::String target;
+            if (request->HasHeader("x-amz-target")) {
+                target = request->GetHeaderValue("x-amz-target");
+            }
+
+            if (target.find(".ListShards") != Aws::String::npos) {
+                // Four shards, each with a quarter of the hash key space.
+                static const char *const STARTING_HASH_KEYS[] = {
+                        "0",
+                        "85070591730234615865843651857942052864",
+                        "170141183460469231731687303715884105728",
+                        "255211775190703847597530955573826158592"
+                };
+                static const char *const ENDING_HASH_KEYS[] = {
+                        "85070591730234615865843651857942052863",
+                        "170141183460469231731687303715884105727",
+                        "255211775190703847597530955573826158591",
+                        "340282366920938463463374607431768211455"
+                };
+                Aws::StringStream body;
+                body << R"({"Shards":[)";
+                for (int i = 0; i < 4; ++i) {
+                    body << (i > 0 ? "," : "")
+                         << R"({"ShardId":"shardId-00000000000)" << i
+                         << R"(","HashKeyRange":{"StartingHashKey":")" << STARTING_HASH_KEYS[i]
+                         << R"(","EndingHashKey":")" << ENDING_HASH_KEYS[i]
+                         << R"("},"SequenceNumberRange":{"StartingSequenceNumber":"1"}})";
+                }
+                body << "]}";
+                response->GetResponseBody() << body.str();
+            }
+            else if (target.find(".PutRecords") != Aws::String::npos) {
+                size_t requestRecords = 0;
+                std::shared_ptr<Aws::IOStream> content = request->GetContentBody();
+                if (content) {
+                    content->clear();
+                    content->seekg(0);
+                    Aws::Utils::Json::JsonValue json(*content);
+                    requestRecords = json.View().GetArray("Records").GetLength();
+                }
+
+                Aws::StringStream records;
+                size_t failedCount = 0;
+                for (size_t i = 0; i < requestRecords; ++i) {
+                    int recordNumber = ++mRecordCount;
+                    records << (i > 0 ? "," : "");
+                    if (mFailureInterval > 0 && recordNumber % mFailureInterval == 0) {
+                        ++failedCount;
+                        records << R"({"ErrorCode":"ProvisionedThroughputExceededException",)"
+                                << R"("ErrorMessage":"Rate exceeded for shard."})";
+                    }
+                    else {
+                        records << R"({"SequenceNumber":")" << recordNumber
+                                << R"(","ShardId":"shardId-000000000000"})";
+                    }
+                }
+                response->GetResponseBody() << R"({"FailedRecordCount":)" << failedCount
+                                            << R"(,"Records":[)" << records.str() << "]}";
+            }
+            else {
+                response->SetResponseCode(Aws::Http::HttpResponseCode::BAD_REQUEST);
+            }
+
+            return response;
+        }
+
+    private:
+        const int mFailureInterval;
+        mutable std::atomic<int> mRecordCount;
+    };
+}
+
+AwsDocTest::MockKinesisService::MockKinesisService(int failureInterval) {
+    mockHttpClient = Aws::MakeShared<KinesisServiceMockHTTPClient>(
+            ALLOCATION_TAG, failureInterval);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockKinesisService::~MockKinesisService() {
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
@@ -0,0 +1,34 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef KINESIS_EXAMPLES_MOCK_KINESIS_SERVICE_H
+#define KINESIS_EXAMPLES_MOCK_KINESIS_SERVICE_H
+
+#include <memory>
+
+class MockHttpClient;
+
+class MockHttpClientFactory;
+
+namespace AwsDocTest {
+
+    /*
+     * A mock Kinesis service, for tests and benchmarks which make many requests. ListShards
+     * returns four shards, and PutRecords accepts every record except every
+     * failureInterval-th one, which is throttled.
+     */
+    class MockKinesisService {
+    public:
+        explicit MockKinesisService(int failureInterval = 0);
+
+        virtual ~MockKinesisService();
+
+    private:
+
+        std::shared_ptr<MockHttpClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockKinesisService
+} // AwsDocTest
+
+#endif //KINESIS_EXAMPLES_MOCK_KINESIS_SERVICE_H
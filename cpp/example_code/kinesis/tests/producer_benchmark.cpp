@@ -0,0 +1,85 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ *  producer_benchmark.cpp
+ *
+ *  The code in this file puts small records through the Kinesis producer
+ *  against a mock Kinesis service, and reports the user records and bytes
+ *  per second. One Kinesis record in 100 is throttled, so the retries are
+ *  measured too. No AWS resources are used.
+ *
+ * To run the example, refer to the instructions in the README.
+ *
+ */
+
+#include "kinesis_producer.h"
+#include "mock_kinesis_service.h"
+#include <aws/core/Aws.h>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/kinesis/KinesisClient.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+/*
+ *
+ *  main function
+ *
+ *  Usage: 'run_producer_benchmark [record_count] [record_bytes]'
+ *
+ */
+
+int main(int argc, char **argv) {
+    size_t recordCount = 200000;
+    size_t recordBytes = 100;
+    if (argc > 1) {
+        recordCount = std::strtoul(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        recordBytes = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    Aws::SDKOptions options;
+    InitAPI(options);
+    int exitCode = 0;
+    {
+        AwsDocTest::MockKinesisService mockKinesisService(100);
+        Aws::Client::ClientConfiguration clientConfig;
+        Aws::Auth::AWSCredentials credentials("MOCK_ACCESS_KEY", "MOCK_SECRET_KEY");
+        Aws::Kinesis::KinesisClient kinesisClient(credentials, clientConfig);
+
+        AwsDoc::Kinesis::Producer producer(kinesisClient, "MockStream");
+        if (!producer.start()) {
+            std::cerr << "Failed to start the producer." << std::endl;
+            exitCode = 1;
+        }
+        else {
+            const Aws::String data(recordBytes, 'x');
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < recordCount; ++i) {
+                producer.put("pk-" + Aws::Utils::StringUtils::to_string(i % 1000), data);
+            }
+            bool result = producer.flush();
+            double seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            AwsDoc::Kinesis::Producer::Metrics metrics = producer.getMetrics();
+            std::cout << "Put " << metrics.mUserRecords << " records of " << recordBytes
+                      << " bytes in " << metrics.mKinesisRecords << " Kinesis records with "
+                      << metrics.mRequests << " requests, " << metrics.mRetriedRecords
+                      << " Kinesis records retried." << std::endl;
+            std::cout << metrics.mUserRecords / std::max(seconds, 1e-9) << " records/s, "
+                      << metrics.mUserBytes / std::max(seconds, 1e-9) << " bytes/s."
+                      << std::endl;
+            if (!result) {
+                std::cerr << metrics.mFailedUserRecords << " records failed." << std::endl;
+                exitCode = 1;
+            }
+        }
+    }
+    ShutdownAPI(options);
+
+    return exitCode;
+}
@@ -48,6 +48,7 @@
 #include <aws/lambda/model/UpdateFunctionConfigurationRequest.h>
 #include <aws/core/utils/HashingUtils.h>
 #include <fstream>
+#include "awsdoc/waiter.h"
 #include "lambda_samples.h"
 
 #define USE_CPP_LAMBDA_FUNCTION 0  // For building instructions, see cpp_lambda/README.md.
@@ -79,6 +80,16 @@ namespace AwsDoc {
         Aws::String INCREMENT_RESUlT_PREFIX("The result of the increment is ");
         Aws::String ARITHMETIC_RESUlT_PREFIX("The result of the operation ");
 
+        //! Routine which returns the whole seconds elapsed since a time.
+        /*!
+         \param start: The start time.
+         \return long long: The elapsed seconds.
+         */
+        static long long elapsedSeconds(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+
         //! Routine which invokes a Lambda function and returns the result.
         /*!
          \param jsonPayload: Payload for invoke function.
@@ -167,8 +178,31 @@ bool AwsDoc::Lambda::getStartedWithFunctionsScenario(
     }
 
     // 2. Create a Lambda function.
-    int seconds = 0;
-    do {
+    // The zip file is read once, before CreateFunction is first called.
+    Aws::StringStream zipFile;
+    {
+        std::ifstream ifstream(INCREMENT_LAMBDA_CODE.c_str(),
+                               std::ios_base::in | std::ios_base::binary);
+        if (!ifstream.is_open()) {
+            std::cerr << "Error opening file " << INCREMENT_LAMBDA_CODE << "." << std::endl;
+
+#if USE_CPP_LAMBDA_FUNCTION
+            std::cerr
+                    << "The cpp Lambda function must be built following the instructions in the cpp_lambda/README.md file. "
+                    << std::endl;
+#endif
+            deleteIamRole(clientConfig);
+            return false;
+        }
+
+        zipFile << ifstream.rdbuf();
+    }
+
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::seconds(60);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // CreateFunction is retried until the new IAM role can be used.
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         // snippet-start:[cpp.example_code.lambda.CreateFunction]
         Aws::Lambda::Model::CreateFunctionRequest request;
         request.SetFunctionName(LAMBDA_NAME);
@@ -193,61 +227,51 @@ bool AwsDoc::Lambda::getStartedWithFunctionsScenario(
         request.SetRole(roleArn);
         request.SetHandler(LAMBDA_HANDLER_NAME);
         request.SetPublish(true);
+        // zipFile holds the contents of the function's .zip file.
         Aws::Lambda::Model::FunctionCode code;
-        std::ifstream ifstream(INCREMENT_LAMBDA_CODE.c_str(),
-                               std::ios_base::in | std::ios_base::binary);
-        if (!ifstream.is_open()) {
-            std::cerr << "Error opening file " << INCREMENT_LAMBDA_CODE << "." << std::endl;
-
-#if USE_CPP_LAMBDA_FUNCTION
-            std::cerr
-                    << "The cpp Lambda function must be built following the instructions in the cpp_lambda/README.md file. "
-                    << std::endl;
-#endif
-            deleteIamRole(clientConfig);
-            return false;
-        }
-
-        Aws::StringStream buffer;
-        buffer << ifstream.rdbuf();
-
-        code.SetZipFile(Aws::Utils::ByteBuffer((unsigned char *) buffer.str().c_str(),
-                                               buffer.str().length()));
+        code.SetZipFile(Aws::Utils::ByteBuffer((unsigned char *) zipFile.str().c_str(),
+                                               zipFile.str().length()));
         request.SetCode(code);
 
         Aws::Lambda::Model::CreateFunctionOutcome outcome = client.CreateFunction(
                 request);
+        // snippet-end:[cpp.example_code.lambda.CreateFunction]
 
         if (outcome.IsSuccess()) {
-            std::cout << "The lambda function was successfully created. " << seconds
-                      << " seconds elapsed." << std::endl;
-            break;
+            std::cout << "The lambda function was successfully created. "
+                      << elapsedSeconds(start) << " seconds elapsed." << std::endl;
+            return AwsDoc::WaiterState::SUCCESS;
         }
-            // snippet-end:[cpp.example_code.lambda.CreateFunction]
         else if (outcome.GetError().GetErrorType() ==
                  Aws::Lambda::LambdaErrors::INVALID_PARAMETER_VALUE &&
-                 outcome.GetError().GetMessage().find("role") >= 0) {
-            if ((seconds % 5) == 0) { // Log status every 10 seconds.
-                std::cout
-                        << "Waiting for the IAM role to become available as a CreateFunction parameter. "
-                        << seconds
-                        << " seconds elapsed." << std::endl;
-
-                std::cout << outcome.GetError().GetMessage() << std::endl;
-            }
+                 outcome.GetError().GetMessage().find("role") != Aws::String::npos) {
+            std::cout
+                    << "Waiting for the IAM role to become available as a CreateFunction parameter. "
+                    << elapsedSeconds(start)
+                    << " seconds elapsed." << std::endl;
+
+            std::cout << outcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::RETRY;
         }
             // snippet-start:[cpp.example_code.lambda.create_function2]
         else {
             std::cerr << "Error with CreateFunction. "
                       << outcome.GetError().GetMessage()
                       << std::endl;
-            deleteIamRole(clientConfig);
-            return false;
         }
         // snippet-end:[cpp.example_code.lambda.create_function2]
-        ++seconds;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    } while (60 > seconds);
+
+        return AwsDoc::WaiterState::FAILURE;
+    }, waiterOptions);
+
+    if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+        if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+            std::cerr << "The IAM role did not become available to CreateFunction."
+                      << std::endl;
+        }
+        deleteIamRole(clientConfig);
+        return false;
+    }
 
     std::cout << "The current Lambda function increments 1 by an input." << std::endl;
 
@@ -333,12 +357,12 @@ bool AwsDoc::Lambda::getStartedWithFunctionsScenario(
     std::cout
             << "UpdateFunctionConfiguration will be used to set the LOG_LEVEL to DEBUG."
             << std::endl;
-    seconds = 0;
-
     // 5.  Update the Lambda function configuration.
-    do {
-        ++seconds;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    // RESOURCE_CONFLICT or RESOURCE_IN_USE: function code update not completed.
+    start = std::chrono::steady_clock::now();
+    waiterOptions.mTimeout = std::chrono::minutes(5);
+    waiterOptions.mDelayFirstPoll = true;
+    waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         // snippet-start:[cpp.example_code.lambda.UpdateFunctionConfiguration]
         Aws::Lambda::Model::UpdateFunctionConfigurationRequest request;
         request.SetFunctionName(LAMBDA_NAME);
@@ -348,21 +372,21 @@ bool AwsDoc::Lambda::getStartedWithFunctionsScenario(
 
         Aws::Lambda::Model::UpdateFunctionConfigurationOutcome outcome = client.UpdateFunctionConfiguration(
                 request);
+        // snippet-end:[cpp.example_code.lambda.UpdateFunctionConfiguration]
 
         if (outcome.IsSuccess()) {
             std::cout << "The lambda configuration was successfully updated."
                       << std::endl;
-            break;
+            return AwsDoc::WaiterState::SUCCESS;
         }
-            // snippet-end:[cpp.example_code.lambda.UpdateFunctionConfiguration]
-
-            // RESOURCE_IN_USE: function code update not completed.
-        else if (outcome.GetError().GetErrorType() !=
-                 Aws::Lambda::LambdaErrors::RESOURCE_IN_USE) {
-            if ((seconds % 10) == 0) { // Log status every 10 seconds.
-                std::cout << "Lambda function update in progress . After " << seconds
-                          << " seconds elapsed." << std::endl;
-            }
+        else if ((outcome.GetError().GetErrorType() ==
+                  Aws::Lambda::LambdaErrors::RESOURCE_CONFLICT) ||
+                 (outcome.GetError().GetErrorType() ==
+                  Aws::Lambda::LambdaErrors::RESOURCE_IN_USE)) {
+            std::cout << "Lambda function update in progress . After "
+                      << elapsedSeconds(start)
+                      << " seconds elapsed." << std::endl;
+            return AwsDoc::WaiterState::RETRY;
         }
             // snippet-start:[cpp.example_code.lambda.update_function_configuration2]
         else {
@@ -372,14 +396,15 @@ bool AwsDoc::Lambda::getStartedWithFunctionsScenario(
         }
         // snippet-end:[cpp.example_code.lambda.update_function_configuration2]
 
-    } while (0 < seconds);
+        return AwsDoc::WaiterState::FAILURE;
+    }, waiterOptions);
 
-    if (0 > seconds) {
+    if (waiterState != AwsDoc::WaiterState::SUCCESS) {
         std::cerr << "Function failed to become active." << std::endl;
     }
     else {
-        std::cout << "Updated function active after " << seconds << " seconds."
-                  << std::endl;
+        std::cout << "Updated function active after " << elapsedSeconds(start)
+                  << " seconds." << std::endl;
     }
 
     std::cout
@@ -527,14 +552,16 @@ AwsDoc::Lambda::invokeLambdaFunction(const Aws::Utils::Json::JsonValue &jsonPayl
                                      Aws::Lambda::Model::LogType logType,
                                      Aws::Lambda::Model::InvokeResult &invokeResult,
                                      const Aws::Lambda::LambdaClient &client) {
-    int seconds = 0;
     bool result = false;
     /*
      * In this example, the Invoke function can be called before recently created resources are
      * available.  The Invoke function is called repeatedly until the resources are
      * available.
      */
-    do {
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::seconds(60);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         // snippet-start:[cpp.example_code.lambda.Invoke]
         Aws::Lambda::Model::InvokeRequest request;
         request.SetFunctionName(LAMBDA_NAME);
@@ -545,39 +572,41 @@ AwsDoc::Lambda::invokeLambdaFunction(const Aws::Utils::Json::JsonValue &jsonPayl
         request.SetBody(payload);
         request.SetContentType("application/json");
         Aws::Lambda::Model::InvokeOutcome outcome = client.Invoke(request);
+        // snippet-end:[cpp.example_code.lambda.Invoke]
 
         if (outcome.IsSuccess()) {
             invokeResult = std::move(outcome.GetResult());
             result = true;
-            break;
+            return AwsDoc::WaiterState::SUCCESS;
         }
-            // snippet-end:[cpp.example_code.lambda.Invoke]
-
             // ACCESS_DENIED: because the role is not available yet.
             // RESOURCE_CONFLICT: because the Lambda function is being created or updated.
         else if ((outcome.GetError().GetErrorType() ==
                   Aws::Lambda::LambdaErrors::ACCESS_DENIED) ||
                  (outcome.GetError().GetErrorType() ==
                   Aws::Lambda::LambdaErrors::RESOURCE_CONFLICT)) {
-            if ((seconds % 5) == 0) { // Log status every 10 seconds.
-                std::cout << "Waiting for the invoke api to be available, status " <<
-                          ((outcome.GetError().GetErrorType() ==
-                            Aws::Lambda::LambdaErrors::ACCESS_DENIED ?
-                            "ACCESS_DENIED" : "RESOURCE_CONFLICT")) << ". " << seconds
-                          << " seconds elapsed." << std::endl;
-            }
+            std::cout << "Waiting for the invoke api to be available, status " <<
+                      ((outcome.GetError().GetErrorType() ==
+                        Aws::Lambda::LambdaErrors::ACCESS_DENIED ?
+                        "ACCESS_DENIED" : "RESOURCE_CONFLICT")) << ". "
+                      << elapsedSeconds(start)
+                      << " seconds elapsed." << std::endl;
+            return AwsDoc::WaiterState::RETRY;
         }
             // snippet-start:[cpp.example_code.lambda.invoke_function2]
         else {
             std::cerr << "Error with Lambda::InvokeRequest. "
                       << outcome.GetError().GetMessage()
                       << std::endl;
-            break;
         }
         // snippet-end:[cpp.example_code.lambda.invoke_function2]
-        ++seconds;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    } while (seconds < 60);
+
+        return AwsDoc::WaiterState::FAILURE;
+    }, waiterOptions);
+
+    if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+        std::cerr << "The invoke api did not become available." << std::endl;
+    }
 
     return result;
 }
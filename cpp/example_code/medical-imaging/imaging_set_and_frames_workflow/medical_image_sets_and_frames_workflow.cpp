@@ -18,7 +18,10 @@
 #include <aws/cloudformation/model/DeleteStackRequest.h>
 #include <aws/cloudformation/model/DescribeStacksRequest.h>
 #include <aws/medical-imaging/MedicalImagingClient.h>
+#include <aws/medical-imaging/model/DeleteImageSetRequest.h>
 #include <aws/medical-imaging/model/GetImageFrameRequest.h>
+#include <aws/medical-imaging/model/GetImageSetMetadataRequest.h>
+#include <aws/medical-imaging/model/SearchImageSetsRequest.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/CopyObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
@@ -30,12 +33,29 @@
 #include <aws/core/utils/threading/Semaphore.h>
 #include <fstream>
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_cursor.hpp>
 #include <jsoncons_ext/jmespath/jmespath.hpp>
+#include <gzip/compress.hpp>
 #include <gzip/decompress.hpp>
 #include <openjpeg.h>
 #include <boost/crc.hpp>  // for boost::crc_32_type
+#include <zlib.h>  // for crc32
 #include <utility>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "awsdoc/bulk_deleter.h"
+#include "awsdoc/waiter.h"
 #include "medical-imaging_samples.h"
 
 namespace AwsDoc::Medical_Imaging {
@@ -88,6 +108,93 @@ namespace AwsDoc::Medical_Imaging {
         uint32_t mFullResolutionChecksum = 0;
     };
 
+    // Worker counts and queue sizes for the download, decode, and verify stages of
+    // downloadDecodeAndCheckImageFrames.
+    struct FramePipelineOptions {
+        // Number of image sets whose metadata is retrieved and parsed at the same
+        // time by downloadDecodeAndCheckImageSets.
+        size_t mMetadataThreads = 4;
+        // Number of concurrent GetImageFrame requests.
+        size_t mDownloadThreads = 8;
+        // Number of images decoded at the same time. Each decode also uses
+        // several OpenJPEG threads.
+        size_t mDecodeThreads = 4;
+        // Number of threads interleaving decoded images and computing checksums.
+        size_t mVerifyThreads = 2;
+        // Maximum number of frames waiting between two stages. A full queue blocks
+        // the stage feeding it, which limits the memory used by large studies.
+        size_t mQueueCapacity = 32;
+        // Also save each downloaded frame as a .jph file. Frames are always
+        // decoded from memory.
+        bool mPersistFrames = false;
+    };
+
+    // A blocking, fixed-capacity queue connecting two pipeline stages.
+    template<typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) : mCapacity(std::max<size_t>(capacity, 1)) {}
+
+        //! Routine which adds an item, waiting while the queue is full.
+        /*!
+           \param item: The item to add.
+           \return bool: False if the queue was closed.
+        */
+        bool push(T item) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mNotFull.wait(lock, [this] { return mClosed || mItems.size() < mCapacity; });
+            if (mClosed) {
+                return false;
+            }
+
+            mItems.push_back(std::move(item));
+            mNotEmpty.notify_one();
+            return true;
+        }
+
+        //! Routine which removes an item, waiting while the queue is empty.
+        /*!
+           \param item: Receives the item.
+           \return bool: False if the queue is closed and empty.
+        */
+        bool pop(T &item) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mNotEmpty.wait(lock, [this] { return mClosed || !mItems.empty(); });
+            if (mItems.empty()) {
+                return false;
+            }
+
+            item = std::move(mItems.front());
+            mItems.pop_front();
+            mNotFull.notify_one();
+            return true;
+        }
+
+        //! Routine which closes the queue. Items already queued can still be removed.
+        /*!
+           \return void:
+        */
+        void close() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+            mNotEmpty.notify_all();
+            mNotFull.notify_all();
+        }
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mNotEmpty;
+        std::condition_variable mNotFull;
+        std::deque<T> mItems;
+        const size_t mCapacity;
+        bool mClosed = false;
+    };
+
+    // Function which adds image frames to the download queue of runImageFramePipeline,
+    // using the pipeline's client. It returns false on an error.
+    typedef std::function<bool(const Aws::MedicalImaging::MedicalImagingClient &client,
+                               BoundedQueue<ImageFrameInfo> &downloadQueue)> FrameProducer;
+
     //! Routine which runs the HealthImaging workflow.
     /*!
        \param clientConfig: Aws client configuration.
@@ -166,10 +273,12 @@ namespace AwsDoc::Medical_Imaging {
     /*!
      * @param datastoreID: The HealthImaging data store ID.
      * @param clientConfiguration: Aws client configuration.
+     * @param options: The concurrency and retry options. The batch size is ignored.
      * @return bool: Function succeeded.
      */
     bool emptyDatastore(const Aws::String &datastoreID,
-                        const Aws::Client::ClientConfiguration &clientConfiguration);
+                        const Aws::Client::ClientConfiguration &clientConfiguration,
+                        const AwsDoc::BulkDeleterOptions &options = AwsDoc::BulkDeleterOptions());
 
     //! Routine which starts a DICOM import.
     /*!
@@ -219,44 +328,107 @@ namespace AwsDoc::Medical_Imaging {
     //! associated with an image set.
     /*!
      * @param dataStoreID: The HealthImaging data store ID.
-     * @param importJobId: The import job ID.
-     * @param imageSets: An image set ID.
-     * @param imageSets: Array to receive structs of image frame in information.
+     * @param imageSetID: An image set ID.
+     * @param imageFrames: Array to receive structs of image frame information.
      * @param clientConfiguration : Aws client configuration.
      * @return  bool: Function succeeded.
      */
     bool getImageFramesForImageSet(const Aws::String &dataStoreID,
                                    const Aws::String &imageSetID,
-                                   const Aws::String &outDirectory,
                                    Aws::Vector<ImageFrameInfo> &imageFrames,
                                    const Aws::Client::ClientConfiguration &clientConfiguration);
 
-    //! Routine which saves image frames, decodes them and uses the checksum to
-    //! validate the decoded images.
+    //! Routine which retrieves image frame information for the image frames
+    //! associated with an image set, using an existing client.
+    /*!
+     * @param dataStoreID: The HealthImaging data store ID.
+     * @param imageSetID: An image set ID.
+     * @param imageFrames: Array to receive structs of image frame information.
+     * @param client: A HealthImaging client.
+     * @return  bool: Function succeeded.
+     */
+    bool getImageFramesForImageSet(const Aws::String &dataStoreID,
+                                   const Aws::String &imageSetID,
+                                   Aws::Vector<ImageFrameInfo> &imageFrames,
+                                   const Aws::MedicalImaging::MedicalImagingClient &client);
+
+    //! Routine which extracts image frame information from gzip-compressed image set
+    //! metadata in one pass.
+    /*!
+     * @param metadataGZip: A stream of gzip-compressed image set metadata.
+     * @param imageSetID: The image set ID.
+     * @param imageFrames: Array to receive structs of image frame information.
+     * @return  bool: Function succeeded.
+     */
+    bool extractImageFramesFromMetadata(std::istream &metadataGZip,
+                                        const Aws::String &imageSetID,
+                                        Aws::Vector<ImageFrameInfo> &imageFrames);
+
+    //! Routine which checks a downloaded image frame and optionally saves it to a file.
     /*!
      * @param outcome: The outcome of a GetImageFrame request.
      * @param outDirectory: A directory for saved files.
      * @param imageFrameInfo: Info for this image frame.
+     * @param persistFrame: Save the frame to a .jph file in outDirectory.
       * @return  bool: Function succeeded.
      */
     bool handleGetImageFrameResult(
             const Aws::MedicalImaging::Model::GetImageFrameOutcome &outcome,
             const Aws::String &outDirectory,
-            const ImageFrameInfo &imageFrameInfo);
+            const ImageFrameInfo &imageFrameInfo,
+            bool persistFrame);
 
     //! Routine which downloads image frames, decodes them and uses the checksum to
     //! validate the decoded images.
     /*!
      * @param dataStoreID: The HealthImaging data store ID.
-     * @param importJobId: A list of structs containing image frame information.
-     * @param imageSets: A directory for the downloaded images.
+     * @param imageFrames: A list of structs containing image frame information.
+     * @param outDirectory: A directory for the downloaded images.
      * @param clientConfiguration : Aws client configuration.
+     * @param options: Worker counts and queue sizes for the pipeline stages.
      * @return  bool: Function succeeded.
      */
     bool downloadDecodeAndCheckImageFrames(const Aws::String &dataStoreID,
                                            const Aws::Vector<ImageFrameInfo> &imageFrames,
                                            const Aws::String &outDirectory,
-                                           const Aws::Client::ClientConfiguration &clientConfiguration);
+                                           const Aws::Client::ClientConfiguration &clientConfiguration,
+                                           const FramePipelineOptions &options = FramePipelineOptions());
+
+    //! Routine which retrieves the metadata of image sets, and downloads, decodes and
+    //! validates their image frames.
+    /*!
+     * @param dataStoreID: The HealthImaging data store ID.
+     * @param imageSetIDs: The image set IDs.
+     * @param outDirectory: A directory for the downloaded images.
+     * @param imageFrameCount: The number of image frames in the image sets.
+     * @param clientConfiguration : Aws client configuration.
+     * @param options: Worker counts and queue sizes for the pipeline stages.
+     * @return  bool: Function succeeded.
+     */
+    bool downloadDecodeAndCheckImageSets(const Aws::String &dataStoreID,
+                                         const Aws::Vector<Aws::String> &imageSetIDs,
+                                         const Aws::String &outDirectory,
+                                         size_t &imageFrameCount,
+                                         const Aws::Client::ClientConfiguration &clientConfiguration,
+                                         const FramePipelineOptions &options = FramePipelineOptions());
+
+    //! Routine which runs the download, decode, and verify stages on the image frames
+    //! added to a queue by producer threads.
+    /*!
+     * @param dataStoreID: The HealthImaging data store ID.
+     * @param producerThreads: The number of threads running produceFrames.
+     * @param produceFrames: Function which adds image frames to the queue.
+     * @param outDirectory: A directory for the downloaded images.
+     * @param clientConfiguration : Aws client configuration.
+     * @param options: Worker counts and queue sizes for the pipeline stages.
+     * @return  bool: Function succeeded.
+     */
+    bool runImageFramePipeline(const Aws::String &dataStoreID,
+                               size_t producerThreads,
+                               const FrameProducer &produceFrames,
+                               const Aws::String &outDirectory,
+                               const Aws::Client::ClientConfiguration &clientConfiguration,
+                               const FramePipelineOptions &options);
 
     //! Routine which deletes workflow resources after asking the user.
     /*!
@@ -285,21 +457,63 @@ namespace AwsDoc::Medical_Imaging {
             Aws::String &outputBucketName,
             Aws::String &roleArn);
 
-    //! Routine which decodes an HTJ2K-encoded image and validates with a checksum.
+    //! Routine which decodes an HTJ2K-encoded image using the OpenJPEG library.
     /*!
      * @param jphFile: The path to the image file.
-     * @param crc32Checksum: The CRC32 checksum.
-     * @return  bool: Function succeeded.
+     * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
+     */
+    opj_image_t *jphImageToOpjBitmap(const Aws::String &jphFile);
+
+    //! Routine which decodes an HTJ2K-encoded image held in memory.
+    /*!
+     * @param jphBuffer: The encoded image.
+     * @param length: The length of the encoded image.
+     * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
      */
-    bool decodeJPHFileAndValidateWithChecksum(const Aws::String &jphFile,
-                                              uint32_t crc32Checksum);
+    opj_image_t *jphImageToOpjBitmap(const unsigned char *jphBuffer, size_t length);
 
-    //! Routine which decodes an HTJ2K-encoded image using the OpenJPEG library.
+    //! Routine which decodes an HTJ2K-encoded image read from a stream, such as the
+    //! image frame blob of a GetImageFrame response.
     /*!
-     * @param jphFile: The path to the image file.
+     * @param jphStream: A seekable stream positioned at the start of the encoded image.
      * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
      */
-    opj_image_t *jphImageToOpjBitmap(const Aws::String &jphFile);
+    opj_image_t *jphImageToOpjBitmap(Aws::IOStream &jphStream);
+
+    //! Routine which decodes an HTJ2K-encoded image from an OpenJPEG stream.
+    /*!
+     * @param inStream: An OpenJPEG input stream.
+     * @param description: Describes the stream in error messages.
+     * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
+     */
+    static opj_image_t *decodeOpjStream(opj_stream_t *inStream,
+                                        const Aws::String &description);
+
+    //! Routine which compares decoding .jph files from disk with decoding them
+    //! from memory.
+    /*!
+     * @param directory: A directory containing .jph files.
+     * @param iterations: The number of times each file is decoded by each method.
+     * @return  bool: Function succeeded.
+     */
+    bool benchmarkImageFrameDecoding(const Aws::String &directory, int iterations);
+
+    //! Routine which compares the tiled image checksum with converting the whole
+    //! image before computing the checksum, for each supported pixel type.
+    /*!
+     * @param iterations: The number of times each checksum is computed.
+     * @return  bool: The checksums match for every pixel type.
+     */
+    bool benchmarkImageChecksums(int iterations);
+
+    //! Routine which compares extracting image frame information with the streaming
+    //! parser and with a JSON document and JMESPath, for synthetic image set metadata.
+    /*!
+     * @param instanceCount: The number of DICOM instances in the metadata.
+     * @param iterations: The number of times the metadata is parsed by each method.
+     * @return  bool: Both methods extract the same image frames.
+     */
+    bool benchmarkImageSetMetadataParsing(int instanceCount, int iterations);
 
     //! Routine which verifies the checksum of an OpenJPEG image struct.
     /*!
@@ -559,29 +773,16 @@ bool AwsDoc::Medical_Imaging::workingWithHealthImagingImageSetsAndImageFrames(
     std::cout
             << "The image set metadata will be downloaded and parsed for the image frame IDs."
             << std::endl;
+    std::cout
+            << "The metadata of several image sets is parsed at the same time, and the image\n"
+            << "frames of each image set are downloaded as soon as its metadata is parsed."
+            << std::endl;
     askQuestion("Enter return to continue.", alwaysTrueTest);
 
     Aws::String outDirectory = "output/import_job_" + importJobId;
 
     std::filesystem::create_directories(outDirectory);
 
-    Aws::Vector<ImageFrameInfo> allImageFrameIDs;
-    for (auto &imageSet: imageSets) {
-        Aws::Vector<ImageFrameInfo> imageFrames;
-        if (!getImageFramesForImageSet(dataStoreId, imageSet, outDirectory,
-                                       imageFrames, clientConfiguration)) {
-            std::cerr << "This workflow will exit because of an error." << std::endl;
-            cleanup(stackName, dataStoreId, clientConfiguration);
-            return false;
-        }
-
-        for (auto &imageFrame: imageFrames) {
-            allImageFrameIDs.emplace_back(imageFrame);
-        }
-    }
-
-    std::cout << allImageFrameIDs.size()
-              << " image frames were created by this import job.\n" << std::endl;
     printAsterisksLine();
     std::cout
             << "The image frames are encoded in the HTJ2K format. This example will convert\n"
@@ -597,10 +798,17 @@ bool AwsDoc::Medical_Imaging::workingWithHealthImagingImageSetsAndImageFrames(
             << std::endl;
     askQuestion("Enter return to download and convert the images.", alwaysTrueTest);
 
-    bool result = downloadDecodeAndCheckImageFrames(dataStoreId,
-                                                    allImageFrameIDs,
-                                                    outDirectory, clientConfiguration);
+    FramePipelineOptions pipelineOptions;
+    pipelineOptions.mPersistFrames = true;  // Keep the .jph files for the user.
+    size_t imageFrameCount = 0;
+    bool result = downloadDecodeAndCheckImageSets(dataStoreId,
+                                                  imageSets,
+                                                  outDirectory, imageFrameCount,
+                                                  clientConfiguration,
+                                                  pipelineOptions);
 
+    std::cout << imageFrameCount << " image frames were created by this import job.\n"
+              << std::endl;
     if (result) {
         std::cout << "The image files were successfully decoded and validated."
                   << std::endl;
@@ -628,26 +836,37 @@ bool AwsDoc::Medical_Imaging::waitImportJobCompleted(const Aws::String &datastor
                                                      const Aws::String &importJobId,
                                                      const Aws::Client::ClientConfiguration &clientConfiguration) {
 
-    Aws::MedicalImaging::Model::JobStatus jobStatus = Aws::MedicalImaging::Model::JobStatus::IN_PROGRESS;
-    while (jobStatus == Aws::MedicalImaging::Model::JobStatus::IN_PROGRESS) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-
+    Aws::MedicalImaging::Model::JobStatus jobStatus = Aws::MedicalImaging::Model::JobStatus::NOT_SET;
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mDelayFirstPoll = true;
+    waiterOptions.mTimeout = std::chrono::minutes(30);
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         Aws::MedicalImaging::Model::GetDICOMImportJobOutcome getDicomImportJobOutcome = getDICOMImportJob(
                 datastoreID, importJobId,
                 clientConfiguration);
 
-        if (getDicomImportJobOutcome.IsSuccess()) {
-            jobStatus = getDicomImportJobOutcome.GetResult().GetJobProperties().GetJobStatus();
+        if (!getDicomImportJobOutcome.IsSuccess()) {
+            std::cerr << "Failed to get import job status because "
+                      << getDicomImportJobOutcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
+        }
 
+        Aws::MedicalImaging::Model::JobStatus previousStatus = jobStatus;
+        jobStatus = getDicomImportJobOutcome.GetResult().GetJobProperties().GetJobStatus();
+        if (jobStatus != previousStatus) {
             std::cout << "DICOM import job status: " <<
                       Aws::MedicalImaging::Model::JobStatusMapper::GetNameForJobStatus(
                               jobStatus) << std::endl;
         }
-        else {
-            std::cerr << "Failed to get import job status because "
-                      << getDicomImportJobOutcome.GetError().GetMessage() << std::endl;
-            return false;
-        }
+
+        return jobStatus == Aws::MedicalImaging::Model::JobStatus::IN_PROGRESS ||
+               jobStatus == Aws::MedicalImaging::Model::JobStatus::SUBMITTED ?
+               AwsDoc::WaiterState::RETRY : AwsDoc::WaiterState::SUCCESS;
+    }, waiterOptions);
+
+    if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+        std::cerr << "Wait for DICOM import job timed out." << std::endl;
+        return false;
     }
 
     return jobStatus == Aws::MedicalImaging::Model::JobStatus::COMPLETED;
@@ -723,88 +942,345 @@ AwsDoc::Medical_Imaging::getImageSetsForDicomImportJob(const Aws::String &datast
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.get_image_sets]
 
+namespace {
+    // A read-only stream buffer which inflates gzip-compressed data as it is read
+    // from another stream. Only one chunk of compressed data and one chunk of
+    // inflated data are held in memory.
+    class GzipInflateStreamBuf : public std::streambuf {
+    public:
+        explicit GzipInflateStreamBuf(std::istream &source,
+                                      size_t bufferSize = 64 * 1024) :
+                mSource(source), mInput(bufferSize), mOutput(bufferSize) {
+            std::memset(&mZStream, 0, sizeof(mZStream));
+            // 32 + MAX_WBITS detects a gzip or a zlib header, as gzip::decompress does.
+            if (inflateInit2(&mZStream, 32 + MAX_WBITS) == Z_OK) {
+                mInitialized = true;
+            }
+            else {
+                mError = "Failed to initialize zlib.";
+            }
+        }
+
+        GzipInflateStreamBuf(const GzipInflateStreamBuf &) = delete;
+
+        GzipInflateStreamBuf &operator=(const GzipInflateStreamBuf &) = delete;
+
+        ~GzipInflateStreamBuf() override {
+            if (mInitialized) {
+                inflateEnd(&mZStream);
+            }
+        }
+
+        // An error message if the compressed data could not be inflated.
+        const std::string &error() const { return mError; }
+
+        // The number of inflated bytes read so far.
+        uint64_t inflatedBytes() const { return mInflatedBytes; }
+
+    protected:
+        int_type underflow() override {
+            if (gptr() < egptr()) {
+                return traits_type::to_int_type(*gptr());
+            }
+
+            while (mError.empty() && !mFinished) {
+                if (mZStream.avail_in == 0) {
+                    mSource.read(mInput.data(), static_cast<std::streamsize>(mInput.size()));
+                    mZStream.next_in = reinterpret_cast<Bytef *>(mInput.data());
+                    mZStream.avail_in = static_cast<uInt>(mSource.gcount());
+                    if (mZStream.avail_in == 0) {
+                        mError = "The gzip data is truncated.";
+                        break;
+                    }
+                }
+
+                mZStream.next_out = reinterpret_cast<Bytef *>(mOutput.data());
+                mZStream.avail_out = static_cast<uInt>(mOutput.size());
+                int status = inflate(&mZStream, Z_NO_FLUSH);
+                if (status == Z_STREAM_END) {
+                    mFinished = true;
+                }
+                else if (status != Z_OK && status != Z_BUF_ERROR) {
+                    mError = std::string("Failed to inflate the gzip data. ") +
+                             (mZStream.msg != nullptr ? mZStream.msg : "");
+                    break;
+                }
+
+                size_t produced = mOutput.size() - mZStream.avail_out;
+                if (produced > 0) {
+                    mInflatedBytes += produced;
+                    setg(mOutput.data(), mOutput.data(), mOutput.data() + produced);
+                    return traits_type::to_int_type(*gptr());
+                }
+            }
+
+            return traits_type::eof();
+        }
+
+    private:
+        std::istream &mSource;
+        std::vector<char> mInput;
+        std::vector<char> mOutput;
+        z_stream mZStream;
+        bool mInitialized = false;
+        bool mFinished = false;
+        std::string mError;
+        uint64_t mInflatedBytes = 0;
+    };
+} // namespace
+
+//! Routine which extracts image frame information from gzip-compressed image set
+//! metadata in one pass.
+/*!
+ * The metadata is inflated while it is parsed, and the parser reports JSON events
+ * without building a document. Only the image frames of the current DICOM instance
+ * are held until the instance ends, because the instance's "DICOM" object with
+ * the rescale values can follow its "ImageFrames" array.
+ * @param metadataGZip: A stream of gzip-compressed image set metadata.
+ * @param imageSetID: The image set ID.
+ * @param imageFrames: Array to receive structs of image frame information.
+ * @return  bool: Function succeeded.
+ */
+bool AwsDoc::Medical_Imaging::extractImageFramesFromMetadata(std::istream &metadataGZip,
+                                                             const Aws::String &imageSetID,
+                                                             Aws::Vector<ImageFrameInfo> &imageFrames) {
+    // The containers on the path to the values which are extracted, which follows
+    // "Study.Series.*.Instances.*", and then "DICOM" or
+    // "ImageFrames[].PixelDataChecksumFromBaseToFullResolution[]".
+    enum class Container {
+        Root,
+        Study,
+        Series,
+        SeriesItem,
+        Instances,
+        Instance,
+        InstanceDICOM,
+        ImageFrames,
+        ImageFrame,
+        Checksums,
+        Checksum,
+        Other
+    };
+
+    GzipInflateStreamBuf inflateStreamBuf(metadataGZip);
+    std::istream jsonStream(&inflateStreamBuf);
+    bool result = false;
+    try {
+        std::vector<Container> path;
+        std::string key; // The last key read in the innermost object.
+
+        std::string rescaleSlope;
+        std::string rescaleIntercept;
+        Aws::Vector<ImageFrameInfo> instanceFrames;
+        ImageFrameInfo imageFrame;
+        bool hasChecksum = false;
+        uint64_t checksumWidth = 0;
+        uint64_t entryWidth = 0;
+        uint64_t entryChecksum = 0;
+        bool entryHasChecksum = false;
+
+        // Returns the container which begins at the current event.
+        auto childContainer = [&](bool isObject) -> Container {
+            if (path.empty()) {
+                return isObject ? Container::Root : Container::Other;
+            }
+            switch (path.back()) {
+                case Container::Root:
+                    return isObject && key == "Study" ? Container::Study : Container::Other;
+                case Container::Study:
+                    return isObject && key == "Series" ? Container::Series : Container::Other;
+                case Container::Series:
+                    return isObject ? Container::SeriesItem : Container::Other;
+                case Container::SeriesItem:
+                    return isObject && key == "Instances" ? Container::Instances
+                                                          : Container::Other;
+                case Container::Instances:
+                    return isObject ? Container::Instance : Container::Other;
+                case Container::Instance:
+                    if (isObject && key == "DICOM") {
+                        return Container::InstanceDICOM;
+                    }
+                    return !isObject && key == "ImageFrames" ? Container::ImageFrames
+                                                             : Container::Other;
+                case Container::ImageFrames:
+                    // Nested arrays are flattened, as with "ImageFrames[][]".
+                    return isObject ? Container::ImageFrame : Container::ImageFrames;
+                case Container::ImageFrame:
+                    return !isObject && key == "PixelDataChecksumFromBaseToFullResolution" ?
+                           Container::Checksums : Container::Other;
+                case Container::Checksums:
+                    return isObject ? Container::Checksum : Container::Other;
+                default:
+                    return Container::Other;
+            }
+        };
+
+        jsoncons::json_stream_cursor cursor(jsonStream);
+        for (; !cursor.done(); cursor.next()) {
+            const jsoncons::staj_event &event = cursor.current();
+            switch (event.event_type()) {
+                case jsoncons::staj_event_type::begin_object:
+                case jsoncons::staj_event_type::begin_array: {
+                    Container container = childContainer(
+                            event.event_type() == jsoncons::staj_event_type::begin_object);
+                    if (container == Container::Instance) {
+                        rescaleSlope = "null";
+                        rescaleIntercept = "null";
+                        instanceFrames.clear();
+                    }
+                    else if (container == Container::ImageFrame) {
+                        imageFrame = ImageFrameInfo();
+                        imageFrame.mImageSetId = imageSetID;
+                        hasChecksum = false;
+                        checksumWidth = 0;
+                    }
+                    else if (container == Container::Checksum) {
+                        entryWidth = 0;
+                        entryChecksum = 0;
+                        entryHasChecksum = false;
+                    }
+                    path.push_back(container);
+                    break;
+                }
+                case jsoncons::staj_event_type::end_object:
+                case jsoncons::staj_event_type::end_array: {
+                    Container container = path.back();
+                    path.pop_back();
+                    if (container == Container::Checksum) {
+                        // The full resolution checksum is the one with the greatest width,
+                        // as with "max_by(PixelDataChecksumFromBaseToFullResolution, &Width)".
+                        if (entryHasChecksum && (!hasChecksum || entryWidth > checksumWidth)) {
+                            imageFrame.mFullResolutionChecksum = static_cast<uint32_t>(entryChecksum);
+                            checksumWidth = entryWidth;
+                            hasChecksum = true;
+                        }
+                    }
+                    else if (container == Container::ImageFrame) {
+                        if (imageFrame.mImageFrameId.empty() || !hasChecksum) {
+                            throw std::runtime_error(
+                                    "An image frame has no ID or no full resolution checksum.");
+                        }
+                        instanceFrames.push_back(std::move(imageFrame));
+                    }
+                    else if (container == Container::Instance) {
+                        for (ImageFrameInfo &frame: instanceFrames) {
+                            frame.mRescaleSlope = rescaleSlope;
+                            frame.mRescaleIntercept = rescaleIntercept;
+                            imageFrames.push_back(std::move(frame));
+                        }
+                        instanceFrames.clear();
+                    }
+                    break;
+                }
+                case jsoncons::staj_event_type::key: {
+                    jsoncons::string_view view = event.get<jsoncons::string_view>();
+                    key.assign(view.data(), view.size());
+                    break;
+                }
+                default: // A scalar value.
+                    if (path.empty()) {
+                        break;
+                    }
+                    switch (path.back()) {
+                        case Container::InstanceDICOM:
+                            if (key == "RescaleSlope") {
+                                rescaleSlope = event.get<std::string>();
+                            }
+                            else if (key == "RescaleIntercept") {
+                                rescaleIntercept = event.get<std::string>();
+                            }
+                            break;
+                        case Container::ImageFrame:
+                            if (key == "ID") {
+                                imageFrame.mImageFrameId = event.get<std::string>();
+                            }
+                            else if (key == "MinPixelValue") {
+                                imageFrame.MinPixelValue = event.get<std::string>();
+                            }
+                            else if (key == "MaxPixelValue") {
+                                imageFrame.MaxPixelValue = event.get<std::string>();
+                            }
+                            break;
+                        case Container::Checksum:
+                            if (key == "Width") {
+                                entryWidth = event.get<uint64_t>();
+                            }
+                            else if (key == "Checksum") {
+                                entryChecksum = event.get<uint64_t>();
+                                entryHasChecksum = true;
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+            }
+        }
+
+        result = inflateStreamBuf.error().empty();
+        if (!result) {
+            std::cerr << "extractImageFramesFromMetadata failed because "
+                      << inflateStreamBuf.error() << std::endl;
+        }
+    }
+    catch (const std::exception &e) {
+        // A gzip error ends the JSON early, so it is the better explanation.
+        std::cerr << "extractImageFramesFromMetadata failed because "
+                  << (inflateStreamBuf.error().empty() ? std::string(e.what())
+                                                       : inflateStreamBuf.error())
+                  << std::endl;
+    }
+
+    return result;
+}
+
 //! Routine which retrieves image frame information for the image frames
 //! associated with an image set.
 /*!
  * @param dataStoreID: The HealthImaging data store ID.
- * @param importJobId: The import job ID.
- * @param imageSets: An image set ID.
- * @param imageSets: Array to receive structs of image frame in information.
+ * @param imageSetID: An image set ID.
+ * @param imageFrames: Array to receive structs of image frame information.
  * @param clientConfiguration : Aws client configuration.
  * @return  bool: Function succeeded.
  */
 // snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.get_image_frames]
 bool AwsDoc::Medical_Imaging::getImageFramesForImageSet(const Aws::String &dataStoreID,
                                                         const Aws::String &imageSetID,
-                                                        const Aws::String &outDirectory,
                                                         Aws::Vector<ImageFrameInfo> &imageFrames,
                                                         const Aws::Client::ClientConfiguration &clientConfiguration) {
-    Aws::String fileName = outDirectory + "/" + imageSetID + "_metadata.json.gzip";
-    bool result = false;
-    if (getImageSetMetadata(dataStoreID, imageSetID, "", // Empty string for version ID.
-                            fileName, clientConfiguration)) {
-        try {
-            std::string metadataGZip;
-            {
-                std::ifstream inFileStream(fileName.c_str(), std::ios::binary);
-                if (!inFileStream) {
-                    throw std::runtime_error("Failed to open file " + fileName);
-                }
-
-                std::stringstream stringStream;
-                stringStream << inFileStream.rdbuf();
-                metadataGZip = stringStream.str();
-            }
-            std::string metadataJson = gzip::decompress(metadataGZip.data(),
-                                                        metadataGZip.size());
-            // Use JMESPath to extract the image set IDs.
-            // https://jmespath.org/specification.html
-            jsoncons::json doc = jsoncons::json::parse(metadataJson);
-            std::string jmesPathExpression = "Study.Series.*.Instances[].*[]";
-            jsoncons::json instances = jsoncons::jmespath::search(doc,
-                                                                  jmesPathExpression);
-            for (auto &instance: instances.array_range()) {
-                jmesPathExpression = "DICOM.RescaleSlope";
-                std::string rescaleSlope = jsoncons::jmespath::search(instance,
-                                                                      jmesPathExpression).to_string();
-                jmesPathExpression = "DICOM.RescaleIntercept";
-                std::string rescaleIntercept = jsoncons::jmespath::search(instance,
-                                                                          jmesPathExpression).to_string();
-
-                jmesPathExpression = "ImageFrames[][]";
-                jsoncons::json imageFramesJson = jsoncons::jmespath::search(instance,
-                                                                            jmesPathExpression);
-
-                for (auto &imageFrame: imageFramesJson.array_range()) {
-                    ImageFrameInfo imageFrameIDs;
-                    imageFrameIDs.mImageSetId = imageSetID;
-                    imageFrameIDs.mImageFrameId = imageFrame.find(
-                            "ID")->value().as_string();
-                    imageFrameIDs.mRescaleIntercept = rescaleIntercept;
-                    imageFrameIDs.mRescaleSlope = rescaleSlope;
-                    imageFrameIDs.MinPixelValue = imageFrame.find(
-                            "MinPixelValue")->value().as_string();
-                    imageFrameIDs.MaxPixelValue = imageFrame.find(
-                            "MaxPixelValue")->value().as_string();
-
-                    jmesPathExpression = "max_by(PixelDataChecksumFromBaseToFullResolution, &Width).Checksum";
-                    jsoncons::json checksumJson = jsoncons::jmespath::search(imageFrame,
-                                                                             jmesPathExpression);
-                    imageFrameIDs.mFullResolutionChecksum = checksumJson.as_integer<uint32_t>();
-
-                    imageFrames.emplace_back(imageFrameIDs);
-                }
-            }
+    Aws::MedicalImaging::MedicalImagingClient client(clientConfiguration);
+    return getImageFramesForImageSet(dataStoreID, imageSetID, imageFrames, client);
+}
 
-            result = true;
-        }
-        catch (const std::exception &e) {
-            std::cerr << "getImageFramesForImageSet failed because " << e.what()
-                      << std::endl;
-        }
+//! Routine which retrieves image frame information for the image frames
+//! associated with an image set, using an existing client.
+/*!
+ * @param dataStoreID: The HealthImaging data store ID.
+ * @param imageSetID: An image set ID.
+ * @param imageFrames: Array to receive structs of image frame information.
+ * @param client: A HealthImaging client.
+ * @return  bool: Function succeeded.
+ */
+bool AwsDoc::Medical_Imaging::getImageFramesForImageSet(const Aws::String &dataStoreID,
+                                                        const Aws::String &imageSetID,
+                                                        Aws::Vector<ImageFrameInfo> &imageFrames,
+                                                        const Aws::MedicalImaging::MedicalImagingClient &client) {
+    Aws::MedicalImaging::Model::GetImageSetMetadataRequest request;
+    request.SetDatastoreId(dataStoreID);
+    request.SetImageSetId(imageSetID);
+
+    Aws::MedicalImaging::Model::GetImageSetMetadataOutcome outcome = client.GetImageSetMetadata(
+            request);
+    if (!outcome.IsSuccess()) {
+        std::cerr << "Failed to get image set metadata: "
+                  << outcome.GetError().GetMessage() << std::endl;
+        return false;
     }
 
-    return result;
+    // The metadata is parsed directly from the response body, instead of being
+    // saved to a file and decompressed into a string.
+    return extractImageFramesFromMetadata(outcome.GetResult().GetImageSetMetadataBlob(),
+                                          imageSetID, imageFrames);
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.get_image_frames]
 
@@ -846,38 +1322,48 @@ bool AwsDoc::Medical_Imaging::startDicomImport(const Aws::String &dataStoreID,
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.dicom-import]
 
-//! Routine which saves image frames, decodes them and uses the checksum to
-//! validate the decoded images.
+//! Routine which checks a downloaded image frame and optionally saves it to a file.
 /*!
  * @param outcome: The outcome of a GetImageFrame request.
  * @param outDirectory: A directory for saved files.
  * @param imageFrameInfo: Info for this image frame.
+ * @param persistFrame: Save the frame to a .jph file in outDirectory.
   * @return  bool: Function succeeded.
  */
 // snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.handle_get_frame]
 bool AwsDoc::Medical_Imaging::handleGetImageFrameResult(
         const Aws::MedicalImaging::Model::GetImageFrameOutcome &outcome,
         const Aws::String &outDirectory,
-        const ImageFrameInfo &imageFrameInfo) {
+        const ImageFrameInfo &imageFrameInfo,
+        bool persistFrame) {
     bool result = false;
     if (outcome.IsSuccess()) {
-        Aws::String fileNameBase =
-                outDirectory + "/imageSet_" + imageFrameInfo.mImageSetId +
-                "_frame_" +
-                imageFrameInfo.mImageFrameId;
-        Aws::String jphFileName = fileNameBase + ".jph";
-        auto &buffer = outcome.GetResult().GetImageFrameBlob();
-        {
-            std::ofstream outfile(jphFileName, std::ios::binary);
-            outfile << buffer.rdbuf();
-        }
+        result = true;
+        if (persistFrame) {
+            Aws::String fileNameBase =
+                    outDirectory + "/imageSet_" + imageFrameInfo.mImageSetId +
+                    "_frame_" +
+                    imageFrameInfo.mImageFrameId;
+            Aws::String jphFileName = fileNameBase + ".jph";
+            auto &buffer = outcome.GetResult().GetImageFrameBlob();
+            {
+                std::ofstream outfile(jphFileName, std::ios::binary);
+                outfile << buffer.rdbuf();
+                result = static_cast<bool>(outfile);
+            }
 
-        result = decodeJPHFileAndValidateWithChecksum(jphFileName,
-                                                      imageFrameInfo.mFullResolutionChecksum);
+            // Rewind the blob so that it can be decoded from memory.
+            buffer.clear();
+            buffer.seekg(0, std::ios::beg);
 
+            if (!result) {
+                std::cerr << "Failed to save image frame to file " << jphFileName
+                          << std::endl;
+            }
+        }
 
         if (DEBUGGING) {
-            std::cout << "Downloaded and converted image frame: "
+            std::cout << "Downloaded image frame: "
                       << imageFrameInfo.mImageFrameId << " from image set: "
                       << imageFrameInfo.mImageSetId << std::endl;
         }
@@ -894,100 +1380,369 @@ bool AwsDoc::Medical_Imaging::handleGetImageFrameResult(
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.handle_get_frame]
 
-//! Routine which downloads image frames, decodes them and uses the checksum to
-//! validate the decoded images.
+//! Routine which runs the download, decode, and verify stages on the image frames
+//! added to a queue by producer threads.
 /*!
+ * The work is split into three stages, each with its own threads: download,
+ * decode, and verify. Bounded queues between the stages let the network
+ * transfers and the OpenJPEG decoding run at the same time, while a slow stage
+ * holds back the stage feeding it instead of letting frames pile up in memory.
+ * The producers feed the download stage through another bounded queue, so
+ * frames are downloaded while the producers are still finding frames.
+ *
  * @param dataStoreID: The HealthImaging data store ID.
- * @param importJobId: A list of structs containing image frame information.
- * @param imageSets: A directory for the downloaded images.
+ * @param producerThreads: The number of threads running produceFrames.
+ * @param produceFrames: Function which adds image frames to the queue, using the
+ *                       client shared by the stages. It returns false on an error.
+ * @param outDirectory: A directory for the downloaded images.
  * @param clientConfiguration : Aws client configuration.
+ * @param options: Worker counts and queue sizes for the pipeline stages.
  * @return  bool: Function succeeded.
  */
 // snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.download_frames]
-bool AwsDoc::Medical_Imaging::downloadDecodeAndCheckImageFrames(
+bool AwsDoc::Medical_Imaging::runImageFramePipeline(
         const Aws::String &dataStoreID,
-        const Aws::Vector<ImageFrameInfo> &imageFrames,
+        size_t producerThreads,
+        const FrameProducer &produceFrames,
         const Aws::String &outDirectory,
-        const Aws::Client::ClientConfiguration &clientConfiguration) {
+        const Aws::Client::ClientConfiguration &clientConfiguration,
+        const FramePipelineOptions &options) {
+
+    const size_t downloadThreads = std::max<size_t>(options.mDownloadThreads, 1);
+    const size_t decodeThreads = std::max<size_t>(options.mDecodeThreads, 1);
+    const size_t verifyThreads = std::max<size_t>(options.mVerifyThreads, 1);
+    producerThreads = std::max<size_t>(producerThreads, 1);
 
     Aws::Client::ClientConfiguration clientConfiguration1(clientConfiguration);
-    clientConfiguration1.executor = Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(
-            "executor", 25);
+    // Allow one connection for each producer and download thread.
+    clientConfiguration1.maxConnections = std::max<unsigned>(
+            clientConfiguration1.maxConnections,
+            static_cast<unsigned>(producerThreads + downloadThreads));
     Aws::MedicalImaging::MedicalImagingClient medicalImagingClient(
             clientConfiguration1);
 
-    Aws::Utils::Threading::Semaphore semaphore(0, 1);
-    std::atomic<size_t> count(imageFrames.size());
+    // The response is kept so that the frame can be decoded directly from
+    // the response body.
+    struct DownloadedFrame {
+        ImageFrameInfo mImageFrame;
+        std::shared_ptr<Aws::MedicalImaging::Model::GetImageFrameResult> mResult;
+    };
 
-    bool result = true;
-    for (auto &imageFrame: imageFrames) {
-        Aws::MedicalImaging::Model::GetImageFrameRequest getImageFrameRequest;
-        getImageFrameRequest.SetDatastoreId(dataStoreID);
-        getImageFrameRequest.SetImageSetId(imageFrame.mImageSetId);
-
-        Aws::MedicalImaging::Model::ImageFrameInformation imageFrameInformation;
-        imageFrameInformation.SetImageFrameId(imageFrame.mImageFrameId);
-        getImageFrameRequest.SetImageFrameInformation(imageFrameInformation);
-
-        auto getImageFrameAsyncLambda = [&semaphore, &result, &count, imageFrame, outDirectory](
-                const Aws::MedicalImaging::MedicalImagingClient *client,
-                const Aws::MedicalImaging::Model::GetImageFrameRequest &request,
-                Aws::MedicalImaging::Model::GetImageFrameOutcome outcome,
-                const std::shared_ptr<const Aws::Client::AsyncCallerContext> &context) {
-
-                if (!handleGetImageFrameResult(outcome, outDirectory, imageFrame)) {
-                    std::cerr << "Failed to download and convert image frame: "
-                              << imageFrame.mImageFrameId << " from image set: "
-                              << imageFrame.mImageSetId << std::endl;
-                    result = false;
-                }
+    struct DecodedFrame {
+        ImageFrameInfo mImageFrame;
+        opj_image_t *mImage = nullptr;
+    };
 
-                count--;
-                if (count <= 0) {
+    BoundedQueue<ImageFrameInfo> downloadQueue(options.mQueueCapacity);
+    BoundedQueue<DownloadedFrame> decodeQueue(options.mQueueCapacity);
+    BoundedQueue<DecodedFrame> verifyQueue(options.mQueueCapacity);
+    std::atomic<size_t> frameCount(0);
+    std::atomic<size_t> downloaded(0);
+    std::atomic<size_t> verified(0);
+    std::atomic<bool> producersSucceeded(true);
+    std::atomic<bool> firstFrameDownloaded(false);
+    const auto start = std::chrono::steady_clock::now();
+
+    auto producerWorker = [&]() {
+        if (!produceFrames(medicalImagingClient, downloadQueue)) {
+            producersSucceeded = false;
+        }
+    };
 
-                    semaphore.ReleaseAll();
+    auto downloadWorker = [&]() {
+        ImageFrameInfo imageFrame;
+        while (downloadQueue.pop(imageFrame)) {
+            ++frameCount;
+            Aws::MedicalImaging::Model::GetImageFrameRequest getImageFrameRequest;
+            getImageFrameRequest.SetDatastoreId(dataStoreID);
+            getImageFrameRequest.SetImageSetId(imageFrame.mImageSetId);
+
+            Aws::MedicalImaging::Model::ImageFrameInformation imageFrameInformation;
+            imageFrameInformation.SetImageFrameId(imageFrame.mImageFrameId);
+            getImageFrameRequest.SetImageFrameInformation(imageFrameInformation);
+
+            Aws::MedicalImaging::Model::GetImageFrameOutcome outcome =
+                    medicalImagingClient.GetImageFrame(getImageFrameRequest);
+            if (handleGetImageFrameResult(outcome, outDirectory, imageFrame,
+                                          options.mPersistFrames)) {
+                ++downloaded;
+                if (!firstFrameDownloaded.exchange(true)) {
+                    std::chrono::duration<double> elapsed =
+                            std::chrono::steady_clock::now() - start;
+                    std::cout << "The first image frame was downloaded after "
+                              << elapsed.count() << " seconds." << std::endl;
                 }
-        }; // End of 'getImageFrameAsyncLambda' lambda.
+                DownloadedFrame downloadedFrame;
+                downloadedFrame.mImageFrame = std::move(imageFrame);
+                downloadedFrame.mResult = Aws::MakeShared<Aws::MedicalImaging::Model::GetImageFrameResult>(
+                        "runImageFramePipeline",
+                        outcome.GetResultWithOwnership());
+                decodeQueue.push(std::move(downloadedFrame));
+            }
+            else {
+                std::cerr << "Failed to download image frame: " << imageFrame.mImageFrameId
+                          << " from image set: " << imageFrame.mImageSetId << std::endl;
+            }
+        }
+    };
+
+    auto decodeWorker = [&]() {
+        DownloadedFrame downloadedFrame;
+        while (decodeQueue.pop(downloadedFrame)) {
+            DecodedFrame decodedFrame;
+            decodedFrame.mImage = jphImageToOpjBitmap(
+                    downloadedFrame.mResult->GetImageFrameBlob());
+            decodedFrame.mImageFrame = std::move(downloadedFrame.mImageFrame);
+            // Release the encoded frame before waiting on the verify queue.
+            downloadedFrame.mResult.reset();
+            if (decodedFrame.mImage != nullptr) {
+                verifyQueue.push(std::move(decodedFrame));
+            }
+            else {
+                std::cerr << "Failed to decode image frame: "
+                          << decodedFrame.mImageFrame.mImageFrameId
+                          << " from image set: " << decodedFrame.mImageFrame.mImageSetId
+                          << std::endl;
+            }
+        }
+    };
 
-        medicalImagingClient.GetImageFrameAsync(getImageFrameRequest,
-                                                getImageFrameAsyncLambda);
+    auto verifyWorker = [&]() {
+        DecodedFrame decodedFrame;
+        while (verifyQueue.pop(decodedFrame)) {
+            const ImageFrameInfo &imageFrame = decodedFrame.mImageFrame;
+            if (verifyChecksumForImage(decodedFrame.mImage,
+                                       imageFrame.mFullResolutionChecksum)) {
+                ++verified;
+            }
+            else {
+                std::cerr << "Failed to verify image frame: " << imageFrame.mImageFrameId
+                          << " from image set: " << imageFrame.mImageSetId << std::endl;
+            }
+            opj_image_destroy(decodedFrame.mImage);
+        }
+    };
+
+    std::vector<std::thread> producers;
+    std::vector<std::thread> downloaders;
+    std::vector<std::thread> decoders;
+    std::vector<std::thread> verifiers;
+    for (size_t i = 0; i < producerThreads; ++i) {
+        producers.emplace_back(producerWorker);
+    }
+    for (size_t i = 0; i < downloadThreads; ++i) {
+        downloaders.emplace_back(downloadWorker);
+    }
+    for (size_t i = 0; i < decodeThreads; ++i) {
+        decoders.emplace_back(decodeWorker);
+    }
+    for (size_t i = 0; i < verifyThreads; ++i) {
+        verifiers.emplace_back(verifyWorker);
     }
 
-    if (count > 0) {
-        semaphore.WaitOne();
+    // Close each queue after the stage feeding it finishes, so the next stage
+    // drains the queue and exits.
+    for (std::thread &thread: producers) {
+        thread.join();
+    }
+    downloadQueue.close();
+    for (std::thread &thread: downloaders) {
+        thread.join();
+    }
+    decodeQueue.close();
+    for (std::thread &thread: decoders) {
+        thread.join();
+    }
+    verifyQueue.close();
+    for (std::thread &thread: verifiers) {
+        thread.join();
     }
 
+    const size_t frameTotal = frameCount.load();
+    bool result = producersSucceeded.load() && verified.load() == frameTotal;
     if (result) {
-        std::cout << imageFrames.size() << " image files were downloaded."
+        std::cout << frameTotal << " image files were downloaded."
                   << std::endl;
     }
+    else {
+        std::cerr << downloaded.load() << " of " << frameTotal
+                  << " image frames were downloaded, and " << verified.load()
+                  << " were decoded and validated." << std::endl;
+    }
 
     return result;
 }
+
+//! Routine which downloads image frames, decodes them and uses the checksum to
+//! validate the decoded images.
+/*!
+ * @param dataStoreID: The HealthImaging data store ID.
+ * @param imageFrames: A list of structs containing image frame information.
+ * @param outDirectory: A directory for the downloaded images.
+ * @param clientConfiguration : Aws client configuration.
+ * @param options: Worker counts and queue sizes for the pipeline stages.
+ * @return  bool: Function succeeded.
+ */
+bool AwsDoc::Medical_Imaging::downloadDecodeAndCheckImageFrames(
+        const Aws::String &dataStoreID,
+        const Aws::Vector<ImageFrameInfo> &imageFrames,
+        const Aws::String &outDirectory,
+        const Aws::Client::ClientConfiguration &clientConfiguration,
+        const FramePipelineOptions &options) {
+    return runImageFramePipeline(
+            dataStoreID, 1,
+            [&imageFrames](const Aws::MedicalImaging::MedicalImagingClient &,
+                           BoundedQueue<ImageFrameInfo> &downloadQueue) {
+                for (const ImageFrameInfo &imageFrame: imageFrames) {
+                    downloadQueue.push(imageFrame);
+                }
+                return true;
+            },
+            outDirectory, clientConfiguration, options);
+}
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.download_frames]
 
+//! Routine which retrieves the metadata of image sets, and downloads, decodes and
+//! validates their image frames.
+/*!
+ * The metadata of several image sets is retrieved and parsed at the same time,
+ * and the frames of each image set are passed to the download stage as soon as
+ * its metadata is parsed. Downloads start after the first image set is parsed,
+ * rather than after all of them.
+ *
+ * @param dataStoreID: The HealthImaging data store ID.
+ * @param imageSetIDs: The image set IDs.
+ * @param outDirectory: A directory for the downloaded images.
+ * @param imageFrameCount: The number of image frames in the image sets.
+ * @param clientConfiguration : Aws client configuration.
+ * @param options: Worker counts and queue sizes for the pipeline stages.
+ * @return  bool: Function succeeded.
+ */
+bool AwsDoc::Medical_Imaging::downloadDecodeAndCheckImageSets(
+        const Aws::String &dataStoreID,
+        const Aws::Vector<Aws::String> &imageSetIDs,
+        const Aws::String &outDirectory,
+        size_t &imageFrameCount,
+        const Aws::Client::ClientConfiguration &clientConfiguration,
+        const FramePipelineOptions &options) {
+    std::atomic<size_t> nextImageSet(0);
+    std::atomic<size_t> frameCount(0);
+    std::atomic<bool> failed(false);
+    const size_t metadataThreads = std::min<size_t>(
+            std::max<size_t>(options.mMetadataThreads, 1),
+            std::max<size_t>(imageSetIDs.size(), 1));
+
+    bool result = runImageFramePipeline(
+            dataStoreID, metadataThreads,
+            [&](const Aws::MedicalImaging::MedicalImagingClient &client,
+                BoundedQueue<ImageFrameInfo> &downloadQueue) {
+                // An error stops all the producers from starting another image set,
+                // as the workflow stops on an error.
+                for (size_t index = nextImageSet++;
+                     index < imageSetIDs.size() && !failed; index = nextImageSet++) {
+                    Aws::Vector<ImageFrameInfo> imageFrames;
+                    if (!getImageFramesForImageSet(dataStoreID, imageSetIDs[index],
+                                                   imageFrames, client)) {
+                        failed = true;
+                        return false;
+                    }
+
+                    frameCount += imageFrames.size();
+                    for (ImageFrameInfo &imageFrame: imageFrames) {
+                        downloadQueue.push(std::move(imageFrame));
+                    }
+                }
+                return true;
+            },
+            outDirectory, clientConfiguration, options);
+    imageFrameCount = frameCount.load();
+
+    return result;
+}
+
 //! Routine which deletes the image sets in a data store.
 /*!
+ * Image sets are deleted by concurrent DeleteImageSet calls while the search
+ * results are still being paged, using one client for every request.
  * @param datastoreID: The HealthImaging data store ID.
  * @param clientConfiguration: Aws client configuration.
+ * @param options: The concurrency and retry options. The batch size is ignored.
  * @return bool: Function succeeded.
  */
 // snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.empty_data_store]
 bool AwsDoc::Medical_Imaging::emptyDatastore(const Aws::String &datastoreID,
-                                             const Aws::Client::ClientConfiguration &clientConfiguration) {
-
-    Aws::MedicalImaging::Model::SearchCriteria emptyCriteria;
-    Aws::Vector<Aws::String> imageSetIDs;
-    bool result = false;
-    if (searchImageSets(datastoreID, emptyCriteria, imageSetIDs,
-                        clientConfiguration)) {
-        result = true;
-        for (auto &imageSetID: imageSetIDs) {
-            result &= deleteImageSet(datastoreID, imageSetID, clientConfiguration);
-        }
-    }
+                                             const Aws::Client::ClientConfiguration &clientConfiguration,
+                                             const AwsDoc::BulkDeleterOptions &options) {
+    AwsDoc::BulkDeleterOptions deleterOptions(options);
+    // DeleteImageSet deletes one image set for each request.
+    deleterOptions.mBatchSize = 1;
+    deleterOptions.mResourceName = "image sets";
 
-    return result;
+    Aws::Client::ClientConfiguration clientConfiguration1(clientConfiguration);
+    // Allow one connection for each delete and one for the search.
+    clientConfiguration1.maxConnections = std::max<unsigned>(
+            clientConfiguration1.maxConnections,
+            static_cast<unsigned>(deleterOptions.mMaxConcurrency + 1));
+    Aws::MedicalImaging::MedicalImagingClient client(clientConfiguration1);
+
+    AwsDoc::BulkDeleter<Aws::String> deleter(
+            [&client, &datastoreID](const std::vector<Aws::String> &imageSetIDs) {
+                AwsDoc::BulkDeleteResult<Aws::String> result;
+                for (const Aws::String &imageSetID: imageSetIDs) {
+                    Aws::MedicalImaging::Model::DeleteImageSetRequest request;
+                    request.SetDatastoreId(datastoreID);
+                    request.SetImageSetId(imageSetID);
+                    Aws::MedicalImaging::Model::DeleteImageSetOutcome outcome =
+                            client.DeleteImageSet(request);
+                    if (outcome.IsSuccess()) {
+                        continue;
+                    }
+
+                    const auto &error = outcome.GetError();
+                    if (error.ShouldRetry()) {
+                        result.mRetryKeys.push_back(imageSetID);
+                        result.mThrottled |= AwsDoc::isThrottlingError(error);
+                    }
+                    else {
+                        std::cerr << "Error deleting image set " << imageSetID
+                                  << " from data store " << datastoreID << ": "
+                                  << error.GetMessage() << std::endl;
+                        ++result.mFailed;
+                    }
+                }
+                return result;
+            }, deleterOptions);
+
+    Aws::MedicalImaging::Model::SearchImageSetsRequest request;
+    request.SetDatastoreId(datastoreID);
+    request.SetSearchCriteria(Aws::MedicalImaging::Model::SearchCriteria());
+
+    bool result = true;
+    Aws::String nextToken; // Used for paginated results.
+    do {
+        if (!nextToken.empty()) {
+            request.SetNextToken(nextToken);
+        }
+
+        Aws::MedicalImaging::Model::SearchImageSetsOutcome outcome = client.SearchImageSets(
+                request);
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Error with MedicalImaging::SearchImageSets. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            result = false;
+            break;
+        }
+
+        for (auto &imageSetMetadataSummary: outcome.GetResult().GetImageSetsMetadataSummaries()) {
+            deleter.push(imageSetMetadataSummary.GetImageSetId());
+        }
+        nextToken = outcome.GetResult().GetNextToken();
+    } while (!nextToken.empty());
+
+    result &= deleter.finish();
+    deleter.printSummary(std::cout);
+
+    return result;
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.empty_data_store]
 
@@ -1024,17 +1779,33 @@ bool AwsDoc::Medical_Imaging::cleanup(const Aws::String &stackName,
  *
 */
 int main(int argc, char **argv) {
-    (void) argc;
-    (void) argv;
     Aws::SDKOptions options;
     Aws::InitAPI(options);
     {
-        Aws::Client::ClientConfiguration clientConfig;
-        // Optional: Set to the AWS Region in which the bucket was created (overrides config file).
-        // clientConfig.region = "us-east-1";
+        if (argc > 2 && std::string(argv[1]) == "--benchmark-decode") {
+            // Usage: 'run_medical_image_sets_and_frames_workflow --benchmark-decode <jph_directory> [iterations]'
+            int iterations = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 5;
+            AwsDoc::Medical_Imaging::benchmarkImageFrameDecoding(argv[2], iterations);
+        }
+        else if (argc > 1 && std::string(argv[1]) == "--benchmark-checksum") {
+            // Usage: 'run_medical_image_sets_and_frames_workflow --benchmark-checksum [iterations]'
+            int iterations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 20;
+            AwsDoc::Medical_Imaging::benchmarkImageChecksums(iterations);
+        }
+        else if (argc > 1 && std::string(argv[1]) == "--benchmark-metadata") {
+            // Usage: 'run_medical_image_sets_and_frames_workflow --benchmark-metadata [instances] [iterations]'
+            int instances = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 20000;
+            int iterations = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 3;
+            AwsDoc::Medical_Imaging::benchmarkImageSetMetadataParsing(instances, iterations);
+        }
+        else {
+            Aws::Client::ClientConfiguration clientConfig;
+            // Optional: Set to the AWS Region in which the bucket was created (overrides config file).
+            // clientConfig.region = "us-east-1";
 
-        AwsDoc::Medical_Imaging::workingWithHealthImagingImageSetsAndImageFrames(
-                clientConfig);
+            AwsDoc::Medical_Imaging::workingWithHealthImagingImageSetsAndImageFrames(
+                    clientConfig);
+        }
     }
     Aws::ShutdownAPI(options);
 
@@ -1157,44 +1928,37 @@ bool AwsDoc::Medical_Imaging::setupCodecLogging(opj_codec_t *codec, int *levelPt
     return result;
 }
 
-//! Routine which decodes an HTJ2K-encoded image and validates with a checksum.
+//! Routine which decodes an HTJ2K-encoded image using the OpenJPEG library.
 /*!
  * @param jphFile: The path to the image file.
- * @param crc32Checksum: The CRC32 checksum.
- * @return  bool: Function succeeded.
+ * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
  */
-// snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.decode_and_check]
-bool AwsDoc::Medical_Imaging::decodeJPHFileAndValidateWithChecksum(
-        const Aws::String &jphFile,
-        uint32_t crc32Checksum) {
-    opj_image_t *outputImage = jphImageToOpjBitmap(jphFile);
-    if (!outputImage) {
-        return false;
-    }
-
-    bool result = true;
-    if (!verifyChecksumForImage(outputImage, crc32Checksum)) {
-        std::cerr << "The checksum for the image does not match the expected value."
-                  << std::endl;
-        std::cerr << "File :" << jphFile << std::endl;
-        result = false;
+// snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.decode_jph]
+opj_image *
+AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
+    opj_stream_t *inFileStream = opj_stream_create_default_file_stream(
+            jphFile.c_str(), true);
+    if (!inFileStream) {
+        std::cerr << "Unable to create input file stream for file '" << jphFile
+                  << "'." << std::endl;
+        return nullptr;
     }
 
-    opj_image_destroy(outputImage);
+    opj_image_t *outputImage = decodeOpjStream(inFileStream, jphFile);
+    opj_stream_destroy(inFileStream);
 
-    return result;
+    return outputImage;
 }
-// snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.decode_and_check]
 
-//! Routine which decodes an HTJ2K-encoded image using the OpenJPEG library.
+//! Routine which decodes an HTJ2K-encoded image from an OpenJPEG stream.
 /*!
- * @param jphFile: The path to the image file.
+ * @param inStream: An OpenJPEG input stream.
+ * @param description: Describes the stream in error messages.
  * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
  */
-// snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.decode_jph]
-opj_image *
-AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
-    opj_stream_t *inFileStream = nullptr;
+opj_image_t *
+AwsDoc::Medical_Imaging::decodeOpjStream(opj_stream_t *inStream,
+                                         const Aws::String &description) {
     opj_codec_t *decompressorCodec = nullptr;
     opj_image_t *outputImage = nullptr;
     try {
@@ -1206,16 +1970,6 @@ AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
         decodeParameters->decod_format = 1; // JP2 image format.
         decodeParameters->cod_format = 2; // BMP image format.
 
-        std::strncpy(decodeParameters->infile, jphFile.c_str(),
-                     OPJ_PATH_LEN);
-
-        inFileStream = opj_stream_create_default_file_stream(
-                decodeParameters->infile, true);
-        if (!inFileStream) {
-            throw std::runtime_error(
-                    "Unable to create input file stream for file '" + jphFile + "'.");
-        }
-
         decompressorCodec = opj_create_decompress(OPJ_CODEC_JP2);
         if (!decompressorCodec) {
             throw std::runtime_error("Failed to create decompression codec.");
@@ -1233,11 +1987,11 @@ AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
             throw std::runtime_error("Failed to set decompression codec threads.");
         }
 
-        if (!opj_read_header(inFileStream, decompressorCodec, &outputImage)) {
+        if (!opj_read_header(inStream, decompressorCodec, &outputImage)) {
             throw std::runtime_error("Failed to read header.");
         }
 
-        if (!opj_decode(decompressorCodec, inFileStream,
+        if (!opj_decode(decompressorCodec, inStream,
                         outputImage)) {
             throw std::runtime_error("Failed to decode.");
         }
@@ -1253,15 +2007,12 @@ AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
         }
 
     } catch (const std::exception &e) {
-        std::cerr << e.what() << std::endl;
+        std::cerr << e.what() << " '" << description << "'" << std::endl;
         if (outputImage) {
             opj_image_destroy(outputImage);
             outputImage = nullptr;
         }
     }
-    if (inFileStream) {
-        opj_stream_destroy(inFileStream);
-    }
     if (decompressorCodec) {
         opj_destroy_codec(decompressorCodec);
     }
@@ -1270,49 +2021,308 @@ AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const Aws::String &jphFile) {
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.decode_jph]
 
+namespace {
+    // OpenJPEG stream callbacks for an encoded image in a contiguous buffer.
+    struct OpjBufferSource {
+        const unsigned char *mData = nullptr;
+        size_t mLength = 0;
+        size_t mOffset = 0;
+    };
+
+    OPJ_SIZE_T opjBufferRead(void *buffer, OPJ_SIZE_T bytes, void *userData) {
+        auto *source = static_cast<OpjBufferSource *>(userData);
+        size_t available = source->mLength - source->mOffset;
+        if (available == 0) {
+            return static_cast<OPJ_SIZE_T>(-1);  // End of stream.
+        }
+
+        size_t count = std::min<size_t>(bytes, available);
+        std::memcpy(buffer, source->mData + source->mOffset, count);
+        source->mOffset += count;
+        return count;
+    }
+
+    OPJ_OFF_T opjBufferSkip(OPJ_OFF_T bytes, void *userData) {
+        auto *source = static_cast<OpjBufferSource *>(userData);
+        OPJ_OFF_T offset = static_cast<OPJ_OFF_T>(source->mOffset) + bytes;
+        if (offset < 0 || offset > static_cast<OPJ_OFF_T>(source->mLength)) {
+            return -1;
+        }
+
+        source->mOffset = static_cast<size_t>(offset);
+        return bytes;
+    }
+
+    OPJ_BOOL opjBufferSeek(OPJ_OFF_T position, void *userData) {
+        auto *source = static_cast<OpjBufferSource *>(userData);
+        if (position < 0 || position > static_cast<OPJ_OFF_T>(source->mLength)) {
+            return OPJ_FALSE;
+        }
+
+        source->mOffset = static_cast<size_t>(position);
+        return OPJ_TRUE;
+    }
+
+    // OpenJPEG stream callbacks for an encoded image in a seekable std::istream.
+    struct OpjIStreamSource {
+        Aws::IOStream *mStream = nullptr;
+        std::streamoff mStart = 0;
+    };
+
+    OPJ_SIZE_T opjIStreamRead(void *buffer, OPJ_SIZE_T bytes, void *userData) {
+        auto *source = static_cast<OpjIStreamSource *>(userData);
+        source->mStream->read(static_cast<char *>(buffer),
+                              static_cast<std::streamsize>(bytes));
+        std::streamsize count = source->mStream->gcount();
+        // A short read sets eofbit and failbit, which would block later seeks.
+        source->mStream->clear();
+        if (count <= 0) {
+            return static_cast<OPJ_SIZE_T>(-1);  // End of stream.
+        }
+
+        return static_cast<OPJ_SIZE_T>(count);
+    }
+
+    OPJ_OFF_T opjIStreamSkip(OPJ_OFF_T bytes, void *userData) {
+        auto *source = static_cast<OpjIStreamSource *>(userData);
+        if (!source->mStream->seekg(bytes, std::ios::cur)) {
+            source->mStream->clear();
+            return -1;
+        }
+
+        return bytes;
+    }
+
+    OPJ_BOOL opjIStreamSeek(OPJ_OFF_T position, void *userData) {
+        auto *source = static_cast<OpjIStreamSource *>(userData);
+        if (!source->mStream->seekg(source->mStart + position, std::ios::beg)) {
+            source->mStream->clear();
+            return OPJ_FALSE;
+        }
+
+        return OPJ_TRUE;
+    }
+} // namespace
+
+//! Routine which decodes an HTJ2K-encoded image held in memory.
+/*!
+ * @param jphBuffer: The encoded image.
+ * @param length: The length of the encoded image.
+ * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
+ */
+opj_image_t *
+AwsDoc::Medical_Imaging::jphImageToOpjBitmap(const unsigned char *jphBuffer,
+                                             size_t length) {
+    OpjBufferSource source;
+    source.mData = jphBuffer;
+    source.mLength = length;
+
+    opj_stream_t *inStream = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, true);
+    if (!inStream) {
+        std::cerr << "Unable to create input memory stream." << std::endl;
+        return nullptr;
+    }
+
+    opj_stream_set_user_data(inStream, &source, nullptr);
+    opj_stream_set_user_data_length(inStream, length);
+    opj_stream_set_read_function(inStream, opjBufferRead);
+    opj_stream_set_skip_function(inStream, opjBufferSkip);
+    opj_stream_set_seek_function(inStream, opjBufferSeek);
+
+    opj_image_t *outputImage = decodeOpjStream(inStream, "memory buffer");
+    opj_stream_destroy(inStream);
+
+    return outputImage;
+}
+
+//! Routine which decodes an HTJ2K-encoded image read from a stream, such as the
+//! image frame blob of a GetImageFrame response.
+/*!
+ * @param jphStream: A seekable stream positioned at the start of the encoded image.
+ * @return  opj_image_t: An OpenJPEG image struct or a null ptr.
+ */
+opj_image_t *
+AwsDoc::Medical_Imaging::jphImageToOpjBitmap(Aws::IOStream &jphStream) {
+    OpjIStreamSource source;
+    source.mStream = &jphStream;
+    source.mStart = jphStream.tellg();
+    jphStream.seekg(0, std::ios::end);
+    std::streamoff length = jphStream.tellg() - source.mStart;
+    jphStream.seekg(source.mStart, std::ios::beg);
+    if (!jphStream || length <= 0) {
+        std::cerr << "Unable to read the length of the image frame stream." << std::endl;
+        return nullptr;
+    }
+
+    opj_stream_t *inStream = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, true);
+    if (!inStream) {
+        std::cerr << "Unable to create input memory stream." << std::endl;
+        return nullptr;
+    }
+
+    opj_stream_set_user_data(inStream, &source, nullptr);
+    opj_stream_set_user_data_length(inStream, static_cast<OPJ_UINT64>(length));
+    opj_stream_set_read_function(inStream, opjIStreamRead);
+    opj_stream_set_skip_function(inStream, opjIStreamSkip);
+    opj_stream_set_seek_function(inStream, opjIStreamSeek);
+
+    opj_image_t *outputImage = decodeOpjStream(inStream, "image frame stream");
+    opj_stream_destroy(inStream);
+
+    return outputImage;
+}
+
+//! Routine which compares decoding .jph files from disk with decoding them
+//! from memory.
+/*!
+ * @param directory: A directory containing .jph files.
+ * @param iterations: The number of times each file is decoded by each method.
+ * @return  bool: Function succeeded.
+ */
+bool AwsDoc::Medical_Imaging::benchmarkImageFrameDecoding(const Aws::String &directory,
+                                                          int iterations) {
+    Aws::Vector<Aws::String> jphFiles;
+    Aws::Vector<Aws::Vector<unsigned char>> jphBuffers;
+    std::error_code errorCode;
+    for (const auto &entry: std::filesystem::directory_iterator(directory.c_str(),
+                                                                errorCode)) {
+        if (entry.path().extension() != ".jph") {
+            continue;
+        }
+
+        std::ifstream inFile(entry.path(), std::ios::binary);
+        jphFiles.push_back(entry.path().string().c_str());
+        jphBuffers.emplace_back(std::istreambuf_iterator<char>(inFile),
+                                std::istreambuf_iterator<char>());
+    }
+
+    if (errorCode || jphFiles.empty()) {
+        std::cerr << "No .jph files were found in '" << directory << "'." << std::endl;
+        return false;
+    }
+
+    bool result = true;
+    auto timeDecodes = [&](const std::function<opj_image_t *(size_t)> &decode) {
+        auto start = std::chrono::steady_clock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            for (size_t i = 0; i < jphFiles.size(); ++i) {
+                opj_image_t *image = decode(i);
+                if (image == nullptr) {
+                    result = false;
+                    continue;
+                }
+                opj_image_destroy(image);
+            }
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(jphFiles.size() * iterations) / seconds.count();
+    };
+
+    double fileFramesPerSecond = timeDecodes([&jphFiles](size_t i) {
+        return jphImageToOpjBitmap(jphFiles[i]);
+    });
+    double memoryFramesPerSecond = timeDecodes([&jphBuffers](size_t i) {
+        return jphImageToOpjBitmap(jphBuffers[i].data(), jphBuffers[i].size());
+    });
+
+    std::cout << "Decoded " << jphFiles.size() << " frames " << iterations
+              << " times with each method." << std::endl;
+    std::cout << "File path:   " << fileFramesPerSecond << " frames/sec" << std::endl;
+    std::cout << "Memory path: " << memoryFramesPerSecond << " frames/sec" << std::endl;
+
+    return result;
+}
+
 // snippet-start:[cpp.example_code.medical-imaging.image-sets-workflow.verify_check_sum]
-//! Template function which converts a planar image bitmap to an interleaved image bitmap and
-//! then verifies the checksum of the bitmap.
+// Number of bytes of the interleaved bitmap converted before each checksum
+// update. A tile stays in the L1 cache between conversion and checksum.
+static const size_t CHECKSUM_TILE_BYTES = 16 * 1024;
+
+//! Template function which computes the CRC32 checksum of the interleaved bitmap
+//! of a planar image.
 /*!
+ * The interleaved bitmap is never fully materialized. Samples are converted one
+ * tile at a time, and each tile is added to the checksum with zlib's crc32,
+ * which processes a tile at a time instead of one byte per call.
  * @param image: The OpenJPEG image struct.
- * @param crc32Checksum: The CRC32 checksum.
- * @return  bool: Function succeeded.
+ * @return  uint32_t: The CRC32 checksum.
  */
 template<class myType>
-bool verifyChecksumForImageForType(opj_image_t *image, uint32_t crc32Checksum) {
-    uint32_t width = image->x1 - image->x0;
-    uint32_t height = image->y1 - image->y0;
-    uint32_t numOfChannels = image->numcomps;
-
-    // Buffer for interleaved bitmap.
-    std::vector<myType> buffer(width * height * numOfChannels);
+uint32_t interleavedChecksumForType(const opj_image_t *image) {
+    const uint32_t width = image->x1 - image->x0;
+    const uint32_t height = image->y1 - image->y0;
+    const uint32_t numOfChannels = image->numcomps;
+    constexpr size_t TILE_SAMPLES = CHECKSUM_TILE_BYTES / sizeof(myType);
+
+    myType tile[TILE_SAMPLES];
+    uLong crc = crc32(0L, Z_NULL, 0);
+    auto addTile = [&crc, &tile](size_t samples) {
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(tile),
+                    static_cast<uInt>(samples * sizeof(myType)));
+    };
 
-    // Convert planar bitmap to interleaved bitmap.
+    bool fullResolution = true;
     for (uint32_t channel = 0; channel < numOfChannels; channel++) {
-        for (uint32_t row = 0; row < height; row++) {
-            uint32_t fromRowStart = row / image->comps[channel].dy * width /
-                                    image->comps[channel].dx;
-            uint32_t toIndex = (row * width) * numOfChannels + channel;
+        fullResolution &= image->comps[channel].dx == 1 && image->comps[channel].dy == 1;
+    }
 
-            for (uint32_t col = 0; col < width; col++) {
-                uint32_t fromIndex = fromRowStart + col / image->comps[channel].dx;
+    if (fullResolution && numOfChannels == 1) {
+        // Fast path for grayscale images such as CT and MR frames. The plane is
+        // already in interleaved order, so it is converted with a flat loop.
+        const OPJ_INT32 *data = image->comps[0].data;
+        const size_t samples = static_cast<size_t>(width) * height;
+        for (size_t offset = 0; offset < samples; offset += TILE_SAMPLES) {
+            const size_t count = std::min(TILE_SAMPLES, samples - offset);
+            for (size_t i = 0; i < count; ++i) {
+                tile[i] = static_cast<myType>(data[offset + i]);
+            }
+            addTile(count);
+        }
 
-                buffer[toIndex] = static_cast<myType>(image->comps[channel].data[fromIndex]);
+        return static_cast<uint32_t>(crc);
+    }
 
-                toIndex += numOfChannels;
+    // Convert planar bitmap to interleaved bitmap, in the output order.
+    Aws::Vector<const OPJ_INT32 *> rowStarts(numOfChannels);
+    size_t used = 0;
+    for (uint32_t row = 0; row < height; row++) {
+        for (uint32_t channel = 0; channel < numOfChannels; channel++) {
+            const opj_image_comp_t &component = image->comps[channel];
+            rowStarts[channel] = component.data +
+                                 row / component.dy * width / component.dx;
+        }
+
+        for (uint32_t col = 0; col < width; col++) {
+            for (uint32_t channel = 0; channel < numOfChannels; channel++) {
+                const uint32_t fromCol = fullResolution ? col : col / image->comps[channel].dx;
+                tile[used++] = static_cast<myType>(rowStarts[channel][fromCol]);
+                if (used == TILE_SAMPLES) {
+                    addTile(used);
+                    used = 0;
+                }
             }
         }
     }
+    addTile(used);
 
-    // Verify checksum.
-    boost::crc_32_type crc32;
-    crc32.process_bytes(reinterpret_cast<char *>(buffer.data()),
-                        buffer.size() * sizeof(myType));
+    return static_cast<uint32_t>(crc);
+}
+
+//! Template function which verifies the checksum of the interleaved bitmap of a
+//! planar image.
+/*!
+ * @param image: The OpenJPEG image struct.
+ * @param crc32Checksum: The CRC32 checksum.
+ * @return  bool: Function succeeded.
+ */
+template<class myType>
+bool verifyChecksumForImageForType(opj_image_t *image, uint32_t crc32Checksum) {
+    uint32_t checksum = interleavedChecksumForType<myType>(image);
 
-    bool result = crc32.checksum() == crc32Checksum;
+    bool result = checksum == crc32Checksum;
     if (!result) {
         std::cerr << "verifyChecksumForImage, checksum mismatch, expected - "
-                  << crc32Checksum << ", actual - " << crc32.checksum()
+                  << crc32Checksum << ", actual - " << checksum
                   << std::endl;
     }
 
@@ -1392,6 +2402,356 @@ bool AwsDoc::Medical_Imaging::verifyChecksumForImage(opj_image_t *image,
 }
 // snippet-end:[cpp.example_code.medical-imaging.image-sets-workflow.verify_check_sum]
 
+//! Template function which converts a planar image bitmap to an interleaved image bitmap and
+//! then computes the checksum of the bitmap.
+/*!
+ * This is the straightforward version of interleavedChecksumForType. It is used
+ * by the benchmark as a reference.
+ * @param image: The OpenJPEG image struct.
+ * @return  uint32_t: The CRC32 checksum.
+ */
+template<class myType>
+uint32_t materializedChecksumForType(const opj_image_t *image) {
+    uint32_t width = image->x1 - image->x0;
+    uint32_t height = image->y1 - image->y0;
+    uint32_t numOfChannels = image->numcomps;
+
+    // Buffer for interleaved bitmap.
+    std::vector<myType> buffer(width * height * numOfChannels);
+
+    // Convert planar bitmap to interleaved bitmap.
+    for (uint32_t channel = 0; channel < numOfChannels; channel++) {
+        for (uint32_t row = 0; row < height; row++) {
+            uint32_t fromRowStart = row / image->comps[channel].dy * width /
+                                    image->comps[channel].dx;
+            uint32_t toIndex = (row * width) * numOfChannels + channel;
+
+            for (uint32_t col = 0; col < width; col++) {
+                uint32_t fromIndex = fromRowStart + col / image->comps[channel].dx;
+
+                buffer[toIndex] = static_cast<myType>(image->comps[channel].data[fromIndex]);
+
+                toIndex += numOfChannels;
+            }
+        }
+    }
+
+    boost::crc_32_type crc32;
+    crc32.process_bytes(reinterpret_cast<char *>(buffer.data()),
+                        buffer.size() * sizeof(myType));
+
+    return crc32.checksum();
+}
+
+//! Template function which times the tiled checksum and the reference checksum
+//! for one pixel type.
+/*!
+ * @param description: The pixel type and layout.
+ * @param image: An OpenJPEG image struct with the pixel type.
+ * @param iterations: The number of times each checksum is computed.
+ * @return  bool: The checksums match.
+ */
+template<class myType>
+static bool benchmarkChecksumForType(const char *description,
+                                     const opj_image_t *image, int iterations) {
+    uint32_t tiledChecksum = 0;
+    uint32_t referenceChecksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        tiledChecksum = interleavedChecksumForType<myType>(image);
+    }
+    std::chrono::duration<double> tiledSeconds = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        referenceChecksum = materializedChecksumForType<myType>(image);
+    }
+    std::chrono::duration<double> referenceSeconds =
+            std::chrono::steady_clock::now() - start;
+
+    double megabytes = static_cast<double>(image->x1 - image->x0) *
+                       (image->y1 - image->y0) * image->numcomps * sizeof(myType) *
+                       iterations / (1024.0 * 1024.0);
+    std::cout << std::setw(24) << std::left << description
+              << " tiled: " << std::setw(10) << megabytes / tiledSeconds.count()
+              << " MB/s, materialized: " << std::setw(10)
+              << megabytes / referenceSeconds.count() << " MB/s" << std::endl;
+
+    bool result = tiledChecksum == referenceChecksum;
+    if (!result) {
+        std::cerr << description << " checksums do not match, tiled - "
+                  << tiledChecksum << ", materialized - " << referenceChecksum
+                  << std::endl;
+    }
+
+    return result;
+}
+
+//! Routine which compares the tiled image checksum with converting the whole
+//! image before computing the checksum, for each supported pixel type.
+/*!
+ * @param iterations: The number of times each checksum is computed.
+ * @return  bool: The checksums match for every pixel type.
+ */
+bool AwsDoc::Medical_Imaging::benchmarkImageChecksums(int iterations) {
+    const uint32_t WIDTH = 512;
+    const uint32_t HEIGHT = 512;
+
+    // Creates an image with random samples. Chroma channels are subsampled by 2
+    // when subsampled is true.
+    auto createImage = [WIDTH, HEIGHT](uint32_t channels, uint32_t precision,
+                                       bool sgnd, bool subsampled) {
+        Aws::Vector<opj_image_cmptparm_t> parameters(channels);
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            opj_image_cmptparm_t &parameter = parameters[channel];
+            memset(&parameter, 0, sizeof(parameter));
+            parameter.dx = parameter.dy = (subsampled && channel > 0) ? 2 : 1;
+            parameter.w = WIDTH / parameter.dx;
+            parameter.h = HEIGHT / parameter.dy;
+            parameter.prec = precision;
+            parameter.sgnd = sgnd;
+        }
+
+        opj_image_t *image = opj_image_create(channels, parameters.data(),
+                                              channels == 1 ? OPJ_CLRSPC_GRAY
+                                                            : OPJ_CLRSPC_SRGB);
+        if (image != nullptr) {
+            image->x1 = WIDTH;
+            image->y1 = HEIGHT;
+            std::mt19937 generator(precision);
+            for (uint32_t channel = 0; channel < channels; channel++) {
+                opj_image_comp_t &component = image->comps[channel];
+                for (size_t i = 0; i < static_cast<size_t>(component.w) * component.h; ++i) {
+                    component.data[i] = static_cast<OPJ_INT32>(generator() >> (32 - precision + (sgnd ? 1 : 0)));
+                }
+            }
+        }
+
+        return image;
+    };
+
+    struct Case {
+        const char *mDescription;
+        uint32_t mChannels;
+        uint32_t mPrecision;
+        bool mSigned;
+        bool mSubsampled;
+    };
+
+    const Case cases[] = {
+            {"uint8 gray",          1, 8,  false, false},
+            {"int8 gray",           1, 8,  true,  false},
+            {"uint16 gray",         1, 16, false, false},
+            {"int16 gray",          1, 16, true,  false},
+            {"uint32 gray",         1, 32, false, false},
+            {"int32 gray",          1, 32, true,  false},
+            {"uint8 RGB",           3, 8,  false, false},
+            {"uint8 RGB subsampled", 3, 8,  false, true},
+            {"uint16 RGB",          3, 16, false, false}
+    };
+
+    bool result = true;
+    for (const Case &benchmarkCase: cases) {
+        opj_image_t *image = createImage(benchmarkCase.mChannels, benchmarkCase.mPrecision,
+                                         benchmarkCase.mSigned, benchmarkCase.mSubsampled);
+        if (image == nullptr) {
+            std::cerr << "Failed to create image for " << benchmarkCase.mDescription
+                      << std::endl;
+            result = false;
+            continue;
+        }
+
+        const bool sgnd = benchmarkCase.mSigned;
+        switch (benchmarkCase.mPrecision) {
+            case 8:
+                result &= sgnd ?
+                          benchmarkChecksumForType<int8_t>(benchmarkCase.mDescription, image, iterations) :
+                          benchmarkChecksumForType<uint8_t>(benchmarkCase.mDescription, image, iterations);
+                break;
+            case 16:
+                result &= sgnd ?
+                          benchmarkChecksumForType<int16_t>(benchmarkCase.mDescription, image, iterations) :
+                          benchmarkChecksumForType<uint16_t>(benchmarkCase.mDescription, image, iterations);
+                break;
+            default:
+                result &= sgnd ?
+                          benchmarkChecksumForType<int32_t>(benchmarkCase.mDescription, image, iterations) :
+                          benchmarkChecksumForType<uint32_t>(benchmarkCase.mDescription, image, iterations);
+                break;
+        }
+
+        opj_image_destroy(image);
+    }
+
+    return result;
+}
+
+//! Routine which extracts image frame information by decompressing the whole
+//! metadata, parsing it into a JSON document, and searching it with JMESPath.
+/*!
+ * This was the method used by getImageFramesForImageSet before the streaming
+ * parser. It is used by the benchmark as a reference.
+ * @param metadataGZip: The gzip-compressed image set metadata.
+ * @param imageSetID: The image set ID.
+ * @param imageFrames: Array to receive structs of image frame information.
+ * @return  void:
+ */
+static void extractImageFramesWithJMESPath(const std::string &metadataGZip,
+                                           const Aws::String &imageSetID,
+                                           Aws::Vector<AwsDoc::Medical_Imaging::ImageFrameInfo> &imageFrames) {
+    std::string metadataJson = gzip::decompress(metadataGZip.data(),
+                                                metadataGZip.size());
+    // https://jmespath.org/specification.html
+    jsoncons::json doc = jsoncons::json::parse(metadataJson);
+    jsoncons::json instances = jsoncons::jmespath::search(doc,
+                                                          "Study.Series.*.Instances[].*[]");
+    for (auto &instance: instances.array_range()) {
+        std::string rescaleSlope = jsoncons::jmespath::search(instance,
+                                                              "DICOM.RescaleSlope").as_string();
+        std::string rescaleIntercept = jsoncons::jmespath::search(instance,
+                                                                  "DICOM.RescaleIntercept").as_string();
+        jsoncons::json imageFramesJson = jsoncons::jmespath::search(instance,
+                                                                    "ImageFrames[][]");
+        for (auto &imageFrame: imageFramesJson.array_range()) {
+            AwsDoc::Medical_Imaging::ImageFrameInfo imageFrameInfo;
+            imageFrameInfo.mImageSetId = imageSetID;
+            imageFrameInfo.mImageFrameId = imageFrame.at("ID").as_string();
+            imageFrameInfo.mRescaleIntercept = rescaleIntercept;
+            imageFrameInfo.mRescaleSlope = rescaleSlope;
+            imageFrameInfo.MinPixelValue = imageFrame.at("MinPixelValue").as_string();
+            imageFrameInfo.MaxPixelValue = imageFrame.at("MaxPixelValue").as_string();
+            imageFrameInfo.mFullResolutionChecksum = jsoncons::jmespath::search(
+                    imageFrame,
+                    "max_by(PixelDataChecksumFromBaseToFullResolution, &Width).Checksum").as_integer<uint32_t>();
+            imageFrames.push_back(std::move(imageFrameInfo));
+        }
+    }
+}
+
+//! Routine which compares extracting image frame information with the streaming
+//! parser and with a JSON document and JMESPath, for synthetic image set metadata.
+/*!
+ * @param instanceCount: The number of DICOM instances in the metadata.
+ * @param iterations: The number of times the metadata is parsed by each method.
+ * @return  bool: Both methods extract the same image frames.
+ */
+bool AwsDoc::Medical_Imaging::benchmarkImageSetMetadataParsing(int instanceCount,
+                                                               int iterations) {
+    const int INSTANCES_PER_SERIES = 500;
+    // Real instances have dozens of DICOM attributes, which the parsers must skip.
+    const int DICOM_ATTRIBUTES = 60;
+    const Aws::String imageSetID = "0123456789abcdef0123456789abcdef";
+
+    std::string metadataJson;
+    {
+        std::ostringstream json;
+        std::mt19937 generator(instanceCount);
+        json << R"({"SchemaVersion":"1.1","DatastoreID":"datastore","ImageSetID":")"
+             << imageSetID
+             << R"(","Patient":{"DICOM":{"PatientID":"patient"}},"Study":{"DICOM":{"StudyID":"1"},"Series":{)";
+        for (int instance = 0; instance < instanceCount; ++instance) {
+            if (instance % INSTANCES_PER_SERIES == 0) {
+                if (instance > 0) {
+                    json << "}},";
+                }
+                json << R"("1.2.840.)" << instance / INSTANCES_PER_SERIES
+                     << R"(":{"DICOM":{"Modality":"CT"},"Instances":{)";
+            }
+            else {
+                json << ",";
+            }
+
+            std::ostringstream dicom;
+            dicom << R"("DICOM":{)";
+            for (int attribute = 0; attribute < DICOM_ATTRIBUTES; ++attribute) {
+                dicom << R"("Attribute)" << attribute << R"(":")" << generator() << R"(",)";
+            }
+            dicom << R"("RescaleSlope":"1","RescaleIntercept":")" << -1024 - instance % 7
+                  << R"("})";
+
+            std::ostringstream frames;
+            frames << R"("ImageFrames":[{"ID":")" << std::hex << generator() << generator()
+                   << std::dec << R"(","PixelDataChecksumFromBaseToFullResolution":[)";
+            for (int width = 64; width <= 512; width *= 2) {
+                frames << (width > 64 ? "," : "") << R"({"Width":)" << width
+                       << R"(,"Height":)" << width << R"(,"Checksum":)" << generator() << "}";
+            }
+            frames << R"(],"MinPixelValue":0,"MaxPixelValue":)" << 4095 - instance % 100
+                   << R"(,"FrameSizeInBytes":)" << generator() % 100000 << "}]";
+
+            // The order of "DICOM" and "ImageFrames" varies between instances.
+            json << R"("1.2.840.)" << instanceCount << "." << instance << R"(":{)"
+                 << (instance % 2 == 0 ? dicom.str() : frames.str()) << ","
+                 << (instance % 2 == 0 ? frames.str() : dicom.str()) << "}";
+        }
+        json << (instanceCount > 0 ? "}}" : "") << "}}}";
+        metadataJson = json.str();
+    }
+    const std::string metadataGZip = gzip::compress(metadataJson.data(),
+                                                    metadataJson.size());
+    const double megabytes = metadataJson.size() / (1024.0 * 1024.0);
+    std::cout << "Metadata with " << instanceCount << " instances, "
+              << megabytes << " MB of JSON, "
+              << metadataGZip.size() / (1024.0 * 1024.0) << " MB compressed."
+              << std::endl;
+    metadataJson = std::string();
+
+    Aws::Vector<ImageFrameInfo> streamingFrames;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        streamingFrames.clear();
+        std::istringstream metadataStream(metadataGZip);
+        if (!extractImageFramesFromMetadata(metadataStream, imageSetID, streamingFrames)) {
+            return false;
+        }
+    }
+    std::chrono::duration<double> streamingSeconds = std::chrono::steady_clock::now() - start;
+
+    Aws::Vector<ImageFrameInfo> referenceFrames;
+    start = std::chrono::steady_clock::now();
+    try {
+        for (int i = 0; i < iterations; ++i) {
+            referenceFrames.clear();
+            extractImageFramesWithJMESPath(metadataGZip, imageSetID, referenceFrames);
+        }
+    }
+    catch (const std::exception &e) {
+        std::cerr << "extractImageFramesWithJMESPath failed because " << e.what()
+                  << std::endl;
+        return false;
+    }
+    std::chrono::duration<double> referenceSeconds =
+            std::chrono::steady_clock::now() - start;
+
+    std::cout << "Streaming: " << streamingSeconds.count() / iterations
+              << " s per parse, " << megabytes * iterations / streamingSeconds.count()
+              << " MB/s.\n"
+              << "Document and JMESPath: " << referenceSeconds.count() / iterations
+              << " s per parse, " << megabytes * iterations / referenceSeconds.count()
+              << " MB/s, holding the " << megabytes
+              << " MB of JSON and its document in memory." << std::endl;
+
+    bool result = streamingFrames.size() == referenceFrames.size() &&
+                  streamingFrames.size() == static_cast<size_t>(instanceCount);
+    for (size_t i = 0; result && i < streamingFrames.size(); ++i) {
+        const ImageFrameInfo &streaming = streamingFrames[i];
+        const ImageFrameInfo &reference = referenceFrames[i];
+        result = streaming.mImageSetId == reference.mImageSetId &&
+                 streaming.mImageFrameId == reference.mImageFrameId &&
+                 streaming.mRescaleIntercept == reference.mRescaleIntercept &&
+                 streaming.mRescaleSlope == reference.mRescaleSlope &&
+                 streaming.MinPixelValue == reference.MinPixelValue &&
+                 streaming.MaxPixelValue == reference.MaxPixelValue &&
+                 streaming.mFullResolutionChecksum == reference.mFullResolutionChecksum;
+    }
+    if (!result) {
+        std::cerr << "The streaming parser and the reference extracted different image frames."
+                  << std::endl;
+    }
+
+    return result;
+}
+
 //! Routine which gets the user's account ID.
 /*!
    \param clientConfig: Aws client configuration.
@@ -1426,32 +2786,43 @@ bool AwsDoc::Medical_Imaging::waitStackCreated(
         Aws::CloudFormation::CloudFormationClient &cloudFormationClient,
         const std::string &stackName,
         Aws::Vector<Aws::CloudFormation::Model::Output> &outputs) {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
     Aws::CloudFormation::Model::DescribeStacksRequest describeStacksRequest;
     describeStacksRequest.SetStackName(stackName);
     Aws::CloudFormation::Model::StackStatus stackStatus = Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS;
 
-    while (stackStatus ==
-           Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mDelayFirstPoll = true;
+    waiterOptions.mTimeout = std::chrono::minutes(30);
+    AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         stackStatus = Aws::CloudFormation::Model::StackStatus::NOT_SET;
         auto outcome = cloudFormationClient.DescribeStacks(describeStacksRequest);
-        if (outcome.IsSuccess()) {
-            const auto &stacks = outcome.GetResult().GetStacks();
-            if (!stacks.empty()) {
-                const auto &stack = stacks[0];
-                stackStatus = stack.GetStackStatus();
-                if (stackStatus ==
-                    Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
-                    outputs = stack.GetOutputs();
-                }
-                else if (stackStatus !=
-                         Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
-                    std::cerr << "Failed to create stack because "
-                              << stack.GetStackStatusReason() << std::endl;
-                }
-            }
+        if (!outcome.IsSuccess()) {
+            std::cerr << "Failed to describe stack. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        const auto &stacks = outcome.GetResult().GetStacks();
+        if (stacks.empty()) {
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        const auto &stack = stacks[0];
+        stackStatus = stack.GetStackStatus();
+        if (stackStatus ==
+            Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
+            outputs = stack.GetOutputs();
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+        else if (stackStatus !=
+                 Aws::CloudFormation::Model::StackStatus::CREATE_IN_PROGRESS) {
+            std::cerr << "Failed to create stack because "
+                      << stack.GetStackStatusReason() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
         }
-    }
+
+        return AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
 
     if (stackStatus == Aws::CloudFormation::Model::StackStatus::CREATE_COMPLETE) {
         std::cout << "Stack creation completed." << std::endl;
@@ -1469,46 +2840,52 @@ bool AwsDoc::Medical_Imaging::waitStackCreated(
 bool AwsDoc::Medical_Imaging::waitStackDeleted(
         Aws::CloudFormation::CloudFormationClient &cloudFormationClient,
         const std::string &stackName) {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
     Aws::CloudFormation::Model::DescribeStacksRequest describeStacksRequest;
     describeStacksRequest.SetStackName(stackName);
     Aws::CloudFormation::Model::StackStatus stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS;
 
-    while (stackStatus ==
-           Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS) {
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mDelayFirstPoll = true;
+    waiterOptions.mTimeout = std::chrono::minutes(30);
+    AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         stackStatus = Aws::CloudFormation::Model::StackStatus::NOT_SET;
         auto outcome = cloudFormationClient.DescribeStacks(describeStacksRequest);
-        if (outcome.IsSuccess()) {
-            const auto &stacks = outcome.GetResult().GetStacks();
-            if (!stacks.empty()) {
-                const auto &stack = stacks[0];
-                stackStatus = stack.GetStackStatus();
-                if (stackStatus !=
-                    Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS &&
-                    stackStatus !=
-                    Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
-                    std::cerr << "Failed to delete stack because "
-                              << stack.GetStackStatusReason() << std::endl;
-                }
-            }
-            else {
-                stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
-            }
-        }
-        else {
+        if (!outcome.IsSuccess()) {
             auto &error = outcome.GetError();
             if (error.GetResponseCode() ==
                 Aws::Http::HttpResponseCode::BAD_REQUEST &&
                 (outcome.GetError().GetMessage().find("does not exist") !=
                  std::string::npos)) {
                 stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
+                return AwsDoc::WaiterState::SUCCESS;
             }
-            else {
-                std::cerr << "Failed to describe stack. "
-                          << outcome.GetError().GetMessage() << std::endl;
-            }
+
+            std::cerr << "Failed to describe stack. "
+                      << outcome.GetError().GetMessage() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
         }
-    }
+
+        const auto &stacks = outcome.GetResult().GetStacks();
+        if (stacks.empty()) {
+            stackStatus = Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE;
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+
+        const auto &stack = stacks[0];
+        stackStatus = stack.GetStackStatus();
+        if (stackStatus ==
+            Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
+            return AwsDoc::WaiterState::SUCCESS;
+        }
+        else if (stackStatus !=
+                 Aws::CloudFormation::Model::StackStatus::DELETE_IN_PROGRESS) {
+            std::cerr << "Failed to delete stack because "
+                      << stack.GetStackStatusReason() << std::endl;
+            return AwsDoc::WaiterState::FAILURE;
+        }
+
+        return AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
 
     if (stackStatus == Aws::CloudFormation::Model::StackStatus::DELETE_COMPLETE) {
         std::cout << "Stack deletion completed." << std::endl;
@@ -54,6 +54,7 @@
 #include <aws/rds/model/DescribeDBSnapshotsRequest.h>
 #include <aws/rds/model/ModifyDBParameterGroupRequest.h>
 #include <aws/core/utils/UUID.h>
+#include "awsdoc/waiter.h"
 #include "rds_samples.h"
 
 
@@ -510,36 +511,36 @@ bool AwsDoc::RDS::gettingStartedWithDBInstances(
 
     std::cout << "Waiting for the DB instance to become available." << std::endl;
 
-    int counter = 0;
+    AwsDoc::WaiterOptions waiterOptions;
+    waiterOptions.mTimeout = std::chrono::minutes(15);
+    Aws::String status;
     // 11. Wait for the DB instance to become available.
-    do {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        ++counter;
-        if (counter > 900) {
-            std::cerr << "Wait for instance to become available timed out ofter "
-                      << counter
-                      << " seconds." << std::endl;
-            cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
-            return false;
-        }
-
+    AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
         dbInstance = Aws::RDS::Model::DBInstance();
         if (!describeDBInstance(DB_INSTANCE_IDENTIFIER, dbInstance, client)) {
-            cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
-            return false;
+            return AwsDoc::WaiterState::FAILURE;
         }
 
-        if ((counter % 20) == 0) {
-            std::cout << "Current DB instance status is '"
-                      << dbInstance.GetDBInstanceStatus()
-                      << "' after " << counter << " seconds." << std::endl;
+        if (dbInstance.GetDBInstanceStatus() != status) {
+            status = dbInstance.GetDBInstanceStatus();
+            std::cout << "Current DB instance status is '" << status << "'." << std::endl;
         }
-    } while (dbInstance.GetDBInstanceStatus() != "available");
 
-    if (dbInstance.GetDBInstanceStatus() == "available") {
-        std::cout << "The DB instance has been created." << std::endl;
+        return status == "available" ? AwsDoc::WaiterState::SUCCESS
+                                     : AwsDoc::WaiterState::RETRY;
+    }, waiterOptions);
+
+    if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+        if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+            std::cerr << "Wait for instance to become available timed out."
+                      << std::endl;
+        }
+        cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
+        return false;
     }
 
+    std::cout << "The DB instance has been created." << std::endl;
+
     printAsterisksLine();
 
     // 12. Display the connection string that can be used to connect a 'mysql' shell to the database.
@@ -581,18 +582,9 @@ bool AwsDoc::RDS::gettingStartedWithDBInstances(
         std::cout << "Waiting for snapshot to become available." << std::endl;
 
         Aws::RDS::Model::DBSnapshot snapshot;
-        counter = 0;
-        do {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            ++counter;
-            if (counter > 600) {
-                std::cerr << "Wait for snapshot to be available timed out ofter "
-                          << counter
-                          << " seconds." << std::endl;
-                cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
-                return false;
-            }
-
+        waiterOptions.mTimeout = std::chrono::minutes(10);
+        status.clear();
+        waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
             // 14. Wait for the snapshot to become available.
             // snippet-start:[cpp.example_code.rds.DescribeDBSnapshots]
             Aws::RDS::Model::DescribeDBSnapshotsRequest request;
@@ -608,21 +600,29 @@ bool AwsDoc::RDS::gettingStartedWithDBInstances(
                 std::cerr << "Error with RDS::DescribeDBSnapshots. "
                           << outcome.GetError().GetMessage()
                           << std::endl;
-                cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
-                return false;
+                return AwsDoc::WaiterState::FAILURE;
             }
             // snippet-end:[cpp.example_code.rds.DescribeDBSnapshots]
 
-            if ((counter % 20) == 0) {
-                std::cout << "Current snapshot status is '"
-                          << snapshot.GetStatus()
-                          << "' after " << counter << " seconds." << std::endl;
+            if (snapshot.GetStatus() != status) {
+                status = snapshot.GetStatus();
+                std::cout << "Current snapshot status is '" << status << "'." << std::endl;
             }
-        } while (snapshot.GetStatus() != "available");
 
-        if (snapshot.GetStatus() != "available") {
-            std::cout << "A snapshot has been created." << std::endl;
+            return status == "available" ? AwsDoc::WaiterState::SUCCESS
+                                         : AwsDoc::WaiterState::RETRY;
+        }, waiterOptions);
+
+        if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+            if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+                std::cerr << "Wait for snapshot to be available timed out."
+                          << std::endl;
+            }
+            cleanUpResources(PARAMETER_GROUP_NAME, DB_INSTANCE_IDENTIFIER, client);
+            return false;
         }
+
+        std::cout << "A snapshot has been created." << std::endl;
     }
 
     printAsterisksLine();
@@ -881,29 +881,34 @@ bool AwsDoc::RDS::cleanUpResources(const Aws::String &parameterGroupName,
                 << std::endl;
         std::cout << "This may take a while." << std::endl;
 
-        int counter = 0;
-        Aws::RDS::Model::DBInstance dbInstance;
-        do {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            ++counter;
-            if (counter > 800) {
-                std::cerr << "Wait for instance to delete timed out ofter " << counter
-                          << " seconds." << std::endl;
-                return false;
-            }
-
-            dbInstance = Aws::RDS::Model::DBInstance();
+        AwsDoc::WaiterOptions waiterOptions;
+        waiterOptions.mTimeout = std::chrono::minutes(15);
+        Aws::String status;
+        AwsDoc::WaiterState waiterState = AwsDoc::waitUntil([&]() -> AwsDoc::WaiterState {
+            Aws::RDS::Model::DBInstance dbInstance;
             // 16. Wait for the DB instance to be deleted.
             if (!describeDBInstance(dbInstanceIdentifier, dbInstance, client)) {
-                return false;
+                return AwsDoc::WaiterState::FAILURE;
+            }
+
+            if (!dbInstance.DBInstanceIdentifierHasBeenSet()) {
+                return AwsDoc::WaiterState::SUCCESS;
+            }
+
+            if (dbInstance.GetDBInstanceStatus() != status) {
+                status = dbInstance.GetDBInstanceStatus();
+                std::cout << "Current DB instance status is '" << status << "'."
+                          << std::endl;
             }
+            return AwsDoc::WaiterState::RETRY;
+        }, waiterOptions);
 
-            if (dbInstance.DBInstanceIdentifierHasBeenSet() && (counter % 20) == 0) {
-                std::cout << "Current DB instance status is '"
-                          << dbInstance.GetDBInstanceStatus()
-                          << "' after " << counter << " seconds." << std::endl;
+        if (waiterState != AwsDoc::WaiterState::SUCCESS) {
+            if (waiterState == AwsDoc::WaiterState::TIMEOUT) {
+                std::cerr << "Wait for instance to delete timed out." << std::endl;
             }
-        } while (dbInstance.DBInstanceIdentifierHasBeenSet());
+            return false;
+        }
     }
 
     if (!parameterGroupName.empty()) {
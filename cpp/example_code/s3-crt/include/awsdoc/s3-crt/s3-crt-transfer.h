@@ -0,0 +1,505 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// High-throughput transfers with the S3CrtClient: parallel ranged GETs into a
+// caller-provided buffer or a memory-mapped file, and uploads from a
+// memory-mapped file.
+
+#pragma once
+
+#include <aws/core/Aws.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/s3-crt/S3CrtClient.h>
+#include <aws/s3-crt/model/GetObjectRequest.h>
+#include <aws/s3-crt/model/HeadObjectRequest.h>
+#include <aws/s3-crt/model/PutObjectRequest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace AwsDoc {
+    namespace S3Crt {
+        static const char TRANSFER_ALLOCATION_TAG[] = "s3-crt-transfer";
+
+        // Options for the transfers.
+        struct TransferOptions {
+            // The throughputTargetGbps of the client. It sets the default number
+            // of parts in flight.
+            double mThroughputTargetGbps = 5.0;
+            // The size of each ranged GET, or 0 to choose it from the object size.
+            uint64_t mPartSize = 0;
+            // The most ranged GETs in flight, or 0 to choose it from the throughput target.
+            size_t mMaxParallelParts = 0;
+            // Retries for a part which fails with a retryable error.
+            int mMaxRetries = 3;
+        };
+
+        // Metrics for a transfer.
+        struct TransferMetrics {
+            uint64_t mBytes = 0;
+            uint64_t mParts = 0;
+            uint64_t mPartSize = 0;
+            uint64_t mRetriedParts = 0;
+            size_t mParallelParts = 0;
+            double mSeconds = 0.0;
+
+            double gbps() const {
+                return mSeconds > 0.0 ? static_cast<double>(mBytes) * 8.0 / mSeconds / 1.0e9
+                                      : 0.0;
+            }
+        };
+
+        // The size and entity tag of an object.
+        struct ObjectInfo {
+            uint64_t mSize = 0;
+            Aws::String mETag;
+        };
+
+        //! Routine which returns the number of ranged GETs to keep in flight for a throughput target.
+        /*!
+          The CRT plans about ten connections for each 4 Gbps of target throughput,
+          and this keeps a part in flight for each of them.
+          \param throughputTargetGbps: The client's throughput target.
+          \return size_t: The number of parts in flight.
+         */
+        inline size_t partsForThroughput(double throughputTargetGbps) {
+            const double GBPS_PER_PART = 0.4;
+            return std::max<size_t>(
+                    static_cast<size_t>(std::ceil(throughputTargetGbps / GBPS_PER_PART)), 1);
+        }
+
+        //! Routine which chooses the size of each ranged GET for an object.
+        /*!
+          Parts are large enough to amortize the cost of each request, and small
+          enough that every connection gets at least two parts, so one slow part
+          does not hold up the end of the transfer.
+          \param objectSize: The object size in bytes.
+          \param parallelParts: The number of parts in flight.
+          \return uint64_t: The part size in bytes.
+         */
+        inline uint64_t autoPartSize(uint64_t objectSize, size_t parallelParts) {
+            const uint64_t MEGABYTE = 1024 * 1024;
+            const uint64_t MIN_PART_SIZE = 8 * MEGABYTE;
+            const uint64_t MAX_PART_SIZE = 128 * MEGABYTE;
+            const uint64_t PARTS_PER_CONNECTION = 2;
+
+            if (objectSize <= MIN_PART_SIZE) {
+                return std::max<uint64_t>(objectSize, 1);
+            }
+            const uint64_t targetParts =
+                    std::max<uint64_t>(parallelParts, 1) * PARTS_PER_CONNECTION;
+            uint64_t partSize = (objectSize + targetParts - 1) / targetParts;
+            partSize = std::min(std::max(partSize, MIN_PART_SIZE), MAX_PART_SIZE);
+
+            // Round up to a whole number of megabytes.
+            return (partSize + MEGABYTE - 1) / MEGABYTE * MEGABYTE;
+        }
+
+        /**
+         * An iostream which reads and writes a fixed region of memory, so a
+         * response body is written in place and a request body is read in place.
+         */
+        class MemoryRegionStream : public Aws::IOStream {
+        public:
+            //! MemoryRegionStream constructor.
+            /*!
+              \param region: The memory. It must outlive the stream.
+              \param length: The length of the memory in bytes.
+             */
+            MemoryRegionStream(unsigned char *region, uint64_t length) :
+                    Aws::IOStream(nullptr), mStreamBuf(region, length) {
+                rdbuf(&mStreamBuf);
+            }
+
+        private:
+            Aws::Utils::Stream::PreallocatedStreamBuf mStreamBuf;
+        };
+
+        /**
+         * A file mapped into memory. On Windows the file is read into, or
+         * written from, a heap buffer instead.
+         */
+        class MappedFile {
+        public:
+            MappedFile() = default;
+
+            MappedFile(const MappedFile &) = delete;
+
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            ~MappedFile() {
+                close();
+            }
+
+            //! Routine which maps an existing file for reading.
+            /*!
+              \param path: The file path.
+              \return bool: Function succeeded.
+             */
+            bool openForRead(const Aws::String &path) {
+                close();
+#ifdef _WIN32
+                std::ifstream file(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+                if (!file) {
+                    return fail("open", path);
+                }
+                mBuffer.resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                if (!mBuffer.empty() &&
+                    !file.read(reinterpret_cast<char *>(mBuffer.data()), mBuffer.size())) {
+                    return fail("read", path);
+                }
+                mData = mBuffer.data();
+                mSize = mBuffer.size();
+#else
+                mFileDescriptor = ::open(path.c_str(), O_RDONLY);
+                if (mFileDescriptor < 0) {
+                    return fail("open", path);
+                }
+                struct stat fileStat;
+                if (::fstat(mFileDescriptor, &fileStat) != 0) {
+                    return fail("stat", path);
+                }
+                mSize = static_cast<uint64_t>(fileStat.st_size);
+                if (mSize > 0) {
+                    void *data = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED,
+                                        mFileDescriptor, 0);
+                    if (data == MAP_FAILED) {
+                        return fail("mmap", path);
+                    }
+                    mData = static_cast<unsigned char *>(data);
+                    // The file is read once from start to end.
+                    ::madvise(data, mSize, MADV_SEQUENTIAL);
+                }
+#endif // _WIN32
+                return true;
+            }
+
+            //! Routine which creates or truncates a file of a given size and maps it for writing.
+            /*!
+              \param path: The file path.
+              \param size: The file size in bytes.
+              \return bool: Function succeeded.
+             */
+            bool createForWrite(const Aws::String &path, uint64_t size) {
+                close();
+                mPath = path;
+                mWritable = true;
+                mSize = size;
+#ifdef _WIN32
+                mBuffer.resize(static_cast<size_t>(size));
+                mData = mBuffer.data();
+#else
+                mFileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (mFileDescriptor < 0) {
+                    return fail("open", path);
+                }
+                if (::ftruncate(mFileDescriptor, static_cast<off_t>(size)) != 0) {
+                    return fail("ftruncate", path);
+                }
+                if (size > 0) {
+                    void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                        mFileDescriptor, 0);
+                    if (data == MAP_FAILED) {
+                        return fail("mmap", path);
+                    }
+                    mData = static_cast<unsigned char *>(data);
+                }
+#endif // _WIN32
+                return true;
+            }
+
+            //! Routine which writes a mapping for writing back to its file, and unmaps the file.
+            /*!
+              \return bool: Function succeeded.
+             */
+            bool close() {
+                bool result = true;
+#ifdef _WIN32
+                if (mWritable && !mPath.empty()) {
+                    std::ofstream file(mPath.c_str(), std::ios::out | std::ios::binary |
+                                                      std::ios::trunc);
+                    file.write(reinterpret_cast<const char *>(mBuffer.data()), mBuffer.size());
+                    result = file.good();
+                }
+                mBuffer.clear();
+#else
+                if (mData != nullptr) {
+                    if (mWritable && ::msync(mData, mSize, MS_SYNC) != 0) {
+                        result = fail("msync", mPath);
+                    }
+                    ::munmap(mData, mSize);
+                }
+                if (mFileDescriptor >= 0) {
+                    ::close(mFileDescriptor);
+                    mFileDescriptor = -1;
+                }
+#endif // _WIN32
+                mData = nullptr;
+                mSize = 0;
+                mWritable = false;
+                mPath.clear();
+                return result;
+            }
+
+            unsigned char *data() const { return mData; }
+
+            uint64_t size() const { return mSize; }
+
+        private:
+            bool fail(const char *operation, const Aws::String &path) {
+                std::cerr << "Error: " << operation << " failed for file '" << path
+                          << "'." << std::endl;
+                return false;
+            }
+
+            unsigned char *mData = nullptr;
+            uint64_t mSize = 0;
+            bool mWritable = false;
+            Aws::String mPath;
+#ifdef _WIN32
+            std::vector<unsigned char> mBuffer;
+#else
+            int mFileDescriptor = -1;
+#endif // _WIN32
+        };
+
+        //! Routine which gets the size and entity tag of an object.
+        /*!
+          \param s3CrtClient: An S3CrtClient.
+          \param bucketName: The bucket name.
+          \param objectKey: The object key.
+          \param objectInfo: A struct to receive the size and entity tag.
+          \return bool: Function succeeded.
+         */
+        inline bool GetObjectInfo(const Aws::S3Crt::S3CrtClient &s3CrtClient,
+                                  const Aws::String &bucketName,
+                                  const Aws::String &objectKey,
+                                  ObjectInfo &objectInfo) {
+            Aws::S3Crt::Model::HeadObjectRequest request;
+            request.SetBucket(bucketName);
+            request.SetKey(objectKey);
+
+            Aws::S3Crt::Model::HeadObjectOutcome outcome = s3CrtClient.HeadObject(request);
+            if (!outcome.IsSuccess()) {
+                std::cerr << "HeadObject error:\n" << outcome.GetError() << std::endl;
+                return false;
+            }
+
+            objectInfo.mSize = static_cast<uint64_t>(outcome.GetResult().GetContentLength());
+            objectInfo.mETag = outcome.GetResult().GetETag();
+            return true;
+        }
+
+        //! Routine which downloads an object into a caller-provided buffer with parallel ranged GETs.
+        /*!
+          Each part is written by the CRT directly into its range of the buffer.
+          Every part must match the entity tag, so an object which is replaced
+          during the download fails instead of mixing versions.
+          \param s3CrtClient: An S3CrtClient.
+          \param bucketName: The bucket name.
+          \param objectKey: The object key.
+          \param objectInfo: The object size and entity tag, from GetObjectInfo().
+          \param buffer: The buffer, which must hold objectInfo.mSize bytes.
+          \param options: The transfer options.
+          \param metrics: A struct to receive the transfer metrics.
+          \return bool: Function succeeded.
+         */
+        inline bool GetObjectIntoBuffer(const Aws::S3Crt::S3CrtClient &s3CrtClient,
+                                        const Aws::String &bucketName,
+                                        const Aws::String &objectKey,
+                                        const ObjectInfo &objectInfo,
+                                        unsigned char *buffer,
+                                        const TransferOptions &options,
+                                        TransferMetrics &metrics) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const uint64_t objectSize = objectInfo.mSize;
+            metrics = TransferMetrics();
+            metrics.mParallelParts = options.mMaxParallelParts > 0 ?
+                                     options.mMaxParallelParts :
+                                     partsForThroughput(options.mThroughputTargetGbps);
+            metrics.mPartSize = options.mPartSize > 0 ? options.mPartSize :
+                                autoPartSize(objectSize, metrics.mParallelParts);
+            metrics.mParts = (objectSize + metrics.mPartSize - 1) / metrics.mPartSize;
+
+            std::mutex mutex;
+            std::condition_variable partDone;
+            std::deque<uint64_t> pendingParts;
+            std::vector<int> attempts(static_cast<size_t>(metrics.mParts), 0);
+            size_t partsInFlight = 0;
+            bool failed = false;
+            for (uint64_t part = 0; part < metrics.mParts; ++part) {
+                pendingParts.push_back(part);
+            }
+
+            // The asynchronous GETs use their requests until they complete, so the
+            // requests are kept until every part in flight has finished. Adding to a
+            // deque does not move the requests already in it.
+            std::deque<Aws::S3Crt::Model::GetObjectRequest> requests;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!failed && (!pendingParts.empty() || partsInFlight > 0)) {
+                if (pendingParts.empty() || partsInFlight >= metrics.mParallelParts) {
+                    partDone.wait(lock);
+                    continue;
+                }
+
+                const uint64_t part = pendingParts.front();
+                pendingParts.pop_front();
+                const uint64_t first = part * metrics.mPartSize;
+                const uint64_t length = std::min(metrics.mPartSize, objectSize - first);
+                ++partsInFlight;
+                lock.unlock();
+
+                requests.emplace_back();
+                Aws::S3Crt::Model::GetObjectRequest &request = requests.back();
+                request.SetBucket(bucketName);
+                request.SetKey(objectKey);
+                request.SetRange("bytes=" + Aws::Utils::StringUtils::to_string(first) + "-" +
+                                 Aws::Utils::StringUtils::to_string(first + length - 1));
+                if (!objectInfo.mETag.empty()) {
+                    request.SetIfMatch(objectInfo.mETag);
+                }
+                unsigned char *region = buffer + first;
+                request.SetResponseStreamFactory([region, length]() {
+                    return Aws::New<MemoryRegionStream>(TRANSFER_ALLOCATION_TAG, region, length);
+                });
+
+                s3CrtClient.GetObjectAsync(
+                        request,
+                        [&, part, length](const Aws::S3Crt::S3CrtClient *,
+                                          const Aws::S3Crt::Model::GetObjectRequest &,
+                                          const Aws::S3Crt::Model::GetObjectOutcome &outcome,
+                                          const std::shared_ptr<const Aws::Client::AsyncCallerContext> &) {
+                            std::lock_guard<std::mutex> callbackLock(mutex);
+                            --partsInFlight;
+                            if (outcome.IsSuccess() &&
+                                static_cast<uint64_t>(outcome.GetResult().GetContentLength()) ==
+                                length) {
+                                metrics.mBytes += length;
+                            }
+                            else if (!outcome.IsSuccess() && outcome.GetError().ShouldRetry() &&
+                                     attempts[static_cast<size_t>(part)]++ < options.mMaxRetries) {
+                                ++metrics.mRetriedParts;
+                                pendingParts.push_back(part);
+                            }
+                            else {
+                                if (outcome.IsSuccess()) {
+                                    std::cerr << "GetObject error: part " << part
+                                              << " returned the wrong length." << std::endl;
+                                }
+                                else {
+                                    std::cerr << "GetObject error:\n" << outcome.GetError()
+                                              << std::endl;
+                                }
+                                failed = true;
+                            }
+                            partDone.notify_all();
+                        });
+
+                lock.lock();
+            }
+
+            // Wait for the parts in flight, which write into the buffer.
+            partDone.wait(lock, [&partsInFlight] { return partsInFlight == 0; });
+            metrics.mSeconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            return !failed;
+        }
+
+        //! Routine which downloads an object into a memory-mapped file with parallel ranged GETs.
+        /*!
+          \param s3CrtClient: An S3CrtClient.
+          \param bucketName: The bucket name.
+          \param objectKey: The object key.
+          \param fileName: The file to create or replace.
+          \param options: The transfer options.
+          \param metrics: A struct to receive the transfer metrics.
+          \return bool: Function succeeded.
+         */
+        inline bool GetObjectIntoFile(const Aws::S3Crt::S3CrtClient &s3CrtClient,
+                                      const Aws::String &bucketName,
+                                      const Aws::String &objectKey,
+                                      const Aws::String &fileName,
+                                      const TransferOptions &options,
+                                      TransferMetrics &metrics) {
+            ObjectInfo objectInfo;
+            if (!GetObjectInfo(s3CrtClient, bucketName, objectKey, objectInfo)) {
+                return false;
+            }
+
+            MappedFile file;
+            if (!file.createForWrite(fileName, objectInfo.mSize)) {
+                return false;
+            }
+
+            bool result = GetObjectIntoBuffer(s3CrtClient, bucketName, objectKey, objectInfo,
+                                              file.data(), options, metrics);
+            result &= file.close();
+            return result;
+        }
+
+        //! Routine which uploads a file, reading the request body from a memory-mapped file.
+        /*!
+          The CRT reads the body directly from the mapped pages, without a file
+          stream buffer, and splits it into a multipart upload using the part
+          size of the client.
+          \param s3CrtClient: An S3CrtClient.
+          \param bucketName: The bucket name.
+          \param objectKey: The object key.
+          \param fileName: The file to upload.
+          \param metrics: A struct to receive the transfer metrics.
+          \return bool: Function succeeded.
+         */
+        inline bool PutObjectFromFile(const Aws::S3Crt::S3CrtClient &s3CrtClient,
+                                      const Aws::String &bucketName,
+                                      const Aws::String &objectKey,
+                                      const Aws::String &fileName,
+                                      TransferMetrics &metrics) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            metrics = TransferMetrics();
+
+            MappedFile file;
+            if (!file.openForRead(fileName)) {
+                return false;
+            }
+
+            Aws::S3Crt::Model::PutObjectRequest request;
+            request.SetBucket(bucketName);
+            request.SetKey(objectKey);
+            request.SetContentLength(static_cast<long long>(file.size()));
+            request.SetBody(Aws::MakeShared<MemoryRegionStream>(TRANSFER_ALLOCATION_TAG,
+                                                                file.data(), file.size()));
+
+            Aws::S3Crt::Model::PutObjectOutcome outcome = s3CrtClient.PutObject(request);
+            if (!outcome.IsSuccess()) {
+                std::cerr << "PutObject error:\n" << outcome.GetError() << std::endl;
+                return false;
+            }
+
+            metrics.mBytes = file.size();
+            metrics.mParts = 1;
+            metrics.mPartSize = file.size();
+            metrics.mSeconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start).count();
+            return true;
+        }
+    } // namespace S3Crt
+} // namespace AwsDoc
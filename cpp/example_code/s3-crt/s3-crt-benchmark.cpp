@@ -0,0 +1,228 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures the throughput of uploads and downloads with the S3CrtClient, and
+// reports the achieved Gbps against the client's throughput target.
+//
+// The benchmark can run against Amazon S3, or against a local S3-compatible
+// server such as MinIO, so that the client side can be measured without
+// network limits or charges.
+
+#include <awsdoc/s3-crt/s3-crt-transfer.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <aws/core/Aws.h>
+#include <aws/core/utils/FileSystemUtils.h>
+#include <aws/core/utils/UUID.h>
+#include <aws/s3-crt/S3CrtClient.h>
+#include <aws/s3-crt/model/CreateBucketRequest.h>
+#include <aws/s3-crt/model/DeleteObjectRequest.h>
+#include <aws/s3-crt/model/GetObjectRequest.h>
+
+// The results of one transfer method over several iterations.
+struct BenchmarkResult {
+    Aws::String mMethod;
+    double mBestGbps = 0.0;
+    double mTotalGbps = 0.0;
+    int mIterations = 0;
+    bool mSuccess = true;
+
+    void add(const AwsDoc::S3Crt::TransferMetrics& metrics) {
+        mBestGbps = std::max(mBestGbps, metrics.gbps());
+        mTotalGbps += metrics.gbps();
+        ++mIterations;
+    }
+};
+
+// Write a file of random bytes.
+static bool WriteRandomFile(const Aws::String& fileName, uint64_t size) {
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> block(1024 * 1024 / sizeof(uint64_t));
+    for (uint64_t written = 0; written < size && file; ) {
+        for (uint64_t& value : block) {
+            value = random();
+        }
+        uint64_t count = std::min<uint64_t>(size - written, block.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(count));
+        written += count;
+    }
+    return file.good();
+}
+
+// Download with a plain GetObject into the SDK's default response stream.
+// This is the baseline for the ranged downloads.
+static bool GetObjectToDefaultStream(const Aws::S3Crt::S3CrtClient& s3CrtClient,
+    const Aws::String& bucketName, const Aws::String& objectKey, uint64_t objectSize,
+    AwsDoc::S3Crt::TransferMetrics& metrics) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    metrics = AwsDoc::S3Crt::TransferMetrics();
+
+    Aws::S3Crt::Model::GetObjectRequest request;
+    request.SetBucket(bucketName);
+    request.SetKey(objectKey);
+    Aws::S3Crt::Model::GetObjectOutcome outcome = s3CrtClient.GetObject(request);
+    if (!outcome.IsSuccess()) {
+        std::cout << "GetObject error:\n" << outcome.GetError() << std::endl;
+        return false;
+    }
+
+    metrics.mBytes = objectSize;
+    metrics.mParts = 1;
+    metrics.mSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+static void PrintResult(const BenchmarkResult& result, double throughputTargetGbps) {
+    double meanGbps = result.mIterations > 0 ? result.mTotalGbps / result.mIterations : 0.0;
+    std::cout << "  " << std::left << std::setw(28) << result.mMethod << std::right << std::fixed
+        << std::setprecision(2) << std::setw(8) << meanGbps << " Gbps mean, " << std::setw(8)
+        << result.mBestGbps << " Gbps best, " << std::setprecision(0) << std::setw(4)
+        << 100.0 * meanGbps / throughputTargetGbps << "% of target"
+        << (result.mSuccess ? "" : " (FAILED)") << std::endl;
+}
+
+/*
+ *  main function
+ *
+ *  Usage: 'run_s3-crt-benchmark <endpoint_url> <bucket_name> [object_size_mb] [iterations] [throughput_target_gbps]'
+ *
+ *  Prerequisites: Credentials for the endpoint. For a local MinIO server, set
+ *  AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY to its root user and password.
+ *  The bucket is created if it does not exist.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 6) {
+        std::cout << R"(
+Usage:
+    run_s3-crt-benchmark <endpoint_url> <bucket_name> [object_size_mb] [iterations] [throughput_target_gbps]
+Where:
+    endpoint_url - The S3 endpoint, for example http://127.0.0.1:9000 for a local
+                   MinIO server, or "aws" for Amazon S3 in the configured Region.
+    bucket_name - The bucket for the test object. It is created if needed.
+    object_size_mb - The size of the test object in MB (default 1024).
+    iterations - The number of times each download is repeated (default 3).
+    throughput_target_gbps - The client's throughput target (default 5).
+)" << std::endl;
+        return 1;
+    }
+
+    const Aws::String endpoint = argv[1];
+    const Aws::String bucket_name = argv[2];
+    const uint64_t object_size = (argc > 3 ? std::stoull(argv[3]) : 1024) * 1024 * 1024;
+    const int iterations = argc > 4 ? std::max(std::stoi(argv[4]), 1) : 3;
+    const double throughput_target_gbps = argc > 5 ? std::stod(argv[5]) : 5.0;
+
+    bool success = true;
+    Aws::SDKOptions options;
+    Aws::InitAPI(options);
+    {
+        AwsDoc::S3Crt::TransferOptions transfer_options;
+        transfer_options.mThroughputTargetGbps = throughput_target_gbps;
+        const uint64_t part_size = AwsDoc::S3Crt::autoPartSize(object_size,
+            AwsDoc::S3Crt::partsForThroughput(throughput_target_gbps));
+
+        Aws::S3Crt::ClientConfiguration config;
+        config.throughputTargetGbps = throughput_target_gbps;
+        // Uploads are split into parts of this size.
+        config.partSize = part_size;
+        if (endpoint != "aws") {
+            config.endpointOverride = endpoint;
+            config.scheme = endpoint.find("http://") == 0 ? Aws::Http::Scheme::HTTP : Aws::Http::Scheme::HTTPS;
+            // Local servers do not resolve bucket subdomains.
+            config.useVirtualAddressing = false;
+        }
+        Aws::S3Crt::S3CrtClient s3_crt_client(config);
+
+        Aws::S3Crt::Model::CreateBucketRequest create_request;
+        create_request.SetBucket(bucket_name);
+        Aws::S3Crt::Model::CreateBucketOutcome create_outcome = s3_crt_client.CreateBucket(create_request);
+        if (!create_outcome.IsSuccess() &&
+            create_outcome.GetError().GetExceptionName() != "BucketAlreadyOwnedByYou") {
+            std::cout << "CreateBucket error:\n" << create_outcome.GetError() << std::endl;
+        }
+
+        Aws::String uuid = Aws::Utils::StringUtils::ToLower(static_cast<Aws::String>(Aws::Utils::UUID::RandomUUID()).c_str());
+        Aws::String object_key = "s3-crt-benchmark-" + uuid;
+        Aws::String upload_file_name = "s3-crt-benchmark-upload-" + uuid + ".bin";
+        Aws::String download_file_name = "s3-crt-benchmark-download-" + uuid + ".bin";
+
+        std::cout << "Object size " << object_size / (1024 * 1024) << " MB, part size "
+            << part_size / (1024 * 1024) << " MB, "
+            << AwsDoc::S3Crt::partsForThroughput(throughput_target_gbps)
+            << " ranged GETs in flight, target " << throughput_target_gbps << " Gbps." << std::endl;
+
+        if (!WriteRandomFile(upload_file_name, object_size)) {
+            std::cout << "Failed to write file: \"" << upload_file_name << "\"." << std::endl;
+            success = false;
+        }
+
+        BenchmarkResult upload_result;
+        upload_result.mMethod = "PutObject from mapped file";
+        AwsDoc::S3Crt::TransferMetrics metrics;
+        if (success) {
+            upload_result.mSuccess = AwsDoc::S3Crt::PutObjectFromFile(s3_crt_client, bucket_name,
+                object_key, upload_file_name, metrics);
+            upload_result.add(metrics);
+            success = upload_result.mSuccess;
+        }
+
+        AwsDoc::S3Crt::ObjectInfo object_info;
+        if (success) {
+            success = AwsDoc::S3Crt::GetObjectInfo(s3_crt_client, bucket_name, object_key, object_info);
+        }
+
+        BenchmarkResult default_result;
+        default_result.mMethod = "GetObject to default stream";
+        BenchmarkResult buffer_result;
+        buffer_result.mMethod = "Ranged GETs into buffer";
+        BenchmarkResult file_result;
+        file_result.mMethod = "Ranged GETs into mapped file";
+
+        if (success) {
+            std::vector<unsigned char> buffer(static_cast<size_t>(object_info.mSize));
+            AwsDoc::S3Crt::MappedFile upload_file;
+            upload_file.openForRead(upload_file_name);
+
+            for (int i = 0; i < iterations; ++i) {
+                default_result.mSuccess &= GetObjectToDefaultStream(s3_crt_client, bucket_name,
+                    object_key, object_info.mSize, metrics);
+                default_result.add(metrics);
+
+                bool result = AwsDoc::S3Crt::GetObjectIntoBuffer(s3_crt_client, bucket_name,
+                    object_key, object_info, buffer.data(), transfer_options, metrics);
+                // Check that every part landed in the right place.
+                result = result && upload_file.size() == buffer.size() &&
+                    (buffer.empty() || std::memcmp(upload_file.data(), buffer.data(), buffer.size()) == 0);
+                buffer_result.mSuccess &= result;
+                buffer_result.add(metrics);
+
+                file_result.mSuccess &= AwsDoc::S3Crt::GetObjectIntoFile(s3_crt_client, bucket_name,
+                    object_key, download_file_name, transfer_options, metrics);
+                file_result.add(metrics);
+            }
+            success = default_result.mSuccess && buffer_result.mSuccess && file_result.mSuccess;
+        }
+
+        std::cout << "Results:" << std::endl;
+        PrintResult(upload_result, throughput_target_gbps);
+        PrintResult(default_result, throughput_target_gbps);
+        PrintResult(buffer_result, throughput_target_gbps);
+        PrintResult(file_result, throughput_target_gbps);
+
+        Aws::S3Crt::Model::DeleteObjectRequest delete_request;
+        delete_request.SetBucket(bucket_name);
+        delete_request.SetKey(object_key);
+        s3_crt_client.DeleteObject(delete_request);
+
+        Aws::FileSystem::RemoveFileIfExists(upload_file_name.c_str());
+        Aws::FileSystem::RemoveFileIfExists(download_file_name.c_str());
+    }
+    Aws::ShutdownAPI(options);
+
+    return success ? 0 : 1;
+}
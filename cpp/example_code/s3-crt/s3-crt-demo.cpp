@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <awsdoc/s3-crt/s3-crt-demo.h>
+#include <awsdoc/s3-crt/s3-crt-transfer.h>
 // snippet-start:[s3-crt.cpp.bucket_operations.list_create_delete]
 #include <iostream>
 #include <fstream>
@@ -16,6 +17,8 @@
 #include <aws/s3-crt/model/GetObjectRequest.h>
 #include <aws/s3-crt/model/DeleteObjectRequest.h>
 #include <aws/core/utils/UUID.h>
+#include <iomanip>
+#include <vector>
 
 static const char ALLOCATION_TAG[] = "s3-crt-demo";
 
@@ -101,27 +104,18 @@ bool PutObject(const Aws::S3Crt::S3CrtClient& s3CrtClient, const Aws::String& bu
 
     std::cout << "Putting object: \"" << objectKey << "\" to bucket: \"" << bucketName << "\" ..." << std::endl;
 
-    Aws::S3Crt::Model::PutObjectRequest request;
-    request.SetBucket(bucketName);
-    request.SetKey(objectKey);
-    std::shared_ptr<Aws::IOStream> bodyStream = Aws::MakeShared<Aws::FStream>(ALLOCATION_TAG, fileName.c_str(), std::ios_base::in | std::ios_base::binary);
-    if (!bodyStream->good()) {
-        std::cout << "Failed to open file: \"" << fileName << "\"." << std::endl << std::endl;
-        return false;
-    }
-    request.SetBody(bodyStream);
-
     //A PUT operation turns into a multipart upload using the s3-crt client.
     //https://github.com/aws/aws-sdk-cpp/wiki/Improving-S3-Throughput-with-AWS-SDK-for-CPP-v1.9
-    Aws::S3Crt::Model::PutObjectOutcome outcome = s3CrtClient.PutObject(request);
-
-    if (outcome.IsSuccess()) {
-        std::cout << "Object added." << std::endl << std::endl;
+    //The body is read from the memory-mapped file, without a file stream in between.
+    AwsDoc::S3Crt::TransferMetrics metrics;
+    if (AwsDoc::S3Crt::PutObjectFromFile(s3CrtClient, bucketName, objectKey, fileName, metrics)) {
+        std::cout << "Object added. " << metrics.mBytes << " bytes at " << std::fixed
+                  << std::setprecision(2) << metrics.gbps() << " Gbps." << std::endl << std::endl;
 
         return true;
     }
     else {
-        std::cout << "PutObject error:\n" << outcome.GetError() << std::endl << std::endl;
+        std::cout << "Failed to put file: \"" << fileName << "\"." << std::endl << std::endl;
 
         return false;
     }
@@ -132,21 +126,30 @@ bool GetObject(const Aws::S3Crt::S3CrtClient& s3CrtClient, const Aws::String& bu
 
     std::cout << "Getting object: \"" << objectKey << "\" from bucket: \"" << bucketName << "\" ..." << std::endl;
 
-    Aws::S3Crt::Model::GetObjectRequest request;
-    request.SetBucket(bucketName);
-    request.SetKey(objectKey);
-
-    Aws::S3Crt::Model::GetObjectOutcome outcome = s3CrtClient.GetObject(request);
+    AwsDoc::S3Crt::ObjectInfo objectInfo;
+    if (!AwsDoc::S3Crt::GetObjectInfo(s3CrtClient, bucketName, objectKey, objectInfo)) {
+        return false;
+    }
 
-    if (outcome.IsSuccess()) {
-       //Uncomment this line if you wish to have the contents of the file displayed. Not recommended for large files
-       // because it takes a while.
-       // std::cout << "Object content: " << outcome.GetResult().GetBody().rdbuf() << std::endl << std::endl;
+    //The object is downloaded with parallel ranged GETs, each written directly into its part of the buffer.
+    //Use AwsDoc::S3Crt::GetObjectIntoFile to download into a memory-mapped file instead.
+    std::vector<unsigned char> buffer(static_cast<size_t>(objectInfo.mSize));
+    AwsDoc::S3Crt::TransferOptions transferOptions;
+    AwsDoc::S3Crt::TransferMetrics metrics;
+    if (AwsDoc::S3Crt::GetObjectIntoBuffer(s3CrtClient, bucketName, objectKey, objectInfo,
+                                           buffer.data(), transferOptions, metrics)) {
+        std::cout << "Object downloaded. " << metrics.mBytes << " bytes in " << metrics.mParts
+                  << " parts of " << metrics.mPartSize << " bytes at " << std::fixed
+                  << std::setprecision(2) << metrics.gbps() << " Gbps." << std::endl << std::endl;
+
+        //Uncomment this line if you wish to have the contents of the file displayed. Not recommended for large files
+        // because it takes a while.
+        // std::cout << "Object content: " << Aws::String(buffer.begin(), buffer.end()) << std::endl << std::endl;
 
         return true;
     }
     else {
-        std::cout << "GetObject error:\n" << outcome.GetError() << std::endl << std::endl;
+        std::cout << "Failed to get object: \"" << objectKey << "\"." << std::endl << std::endl;
 
         return false;
     }
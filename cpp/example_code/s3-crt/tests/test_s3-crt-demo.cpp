@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include <aws/core/Aws.h>
 #include <aws/core/utils/UUID.h>
 #include <aws/core/utils/FileSystemUtils.h>
@@ -11,6 +12,7 @@
 #include <aws/s3-crt/model/DeleteObjectRequest.h>
 #include <aws/s3-crt/model/DeleteBucketRequest.h>
 #include <awsdoc/s3-crt/s3-crt-demo.h>
+#include <awsdoc/s3-crt/s3-crt-transfer.h>
 
 static const char ALLOCATION_TAG[] = "test_s3-crt-demo";
 
@@ -118,6 +120,27 @@ int main()
             success = false;
         }
 
+        // Download into a buffer with a small part size, so the object is split into several ranged GETs.
+        if (success) {
+            AwsDoc::S3Crt::ObjectInfo object_info;
+            AwsDoc::S3Crt::TransferOptions transfer_options;
+            transfer_options.mPartSize = 4;
+            AwsDoc::S3Crt::TransferMetrics metrics;
+            std::vector<unsigned char> buffer;
+            if (AwsDoc::S3Crt::GetObjectInfo(s3_crt_client, bucket_name, object_key, object_info)) {
+                buffer.resize(static_cast<size_t>(object_info.mSize));
+            }
+            if (buffer.empty() ||
+                !AwsDoc::S3Crt::GetObjectIntoBuffer(s3_crt_client, bucket_name, object_key, object_info,
+                    buffer.data(), transfer_options, metrics) ||
+                Aws::String(buffer.begin(), buffer.end()) != "s3-crt-demo" ||
+                metrics.mParts != 3) {
+                std::cout << "GetObjectIntoBuffer returned the wrong content." << std::endl;
+                Cleanup(s3_crt_client, bucket_name);
+                success = false;
+            }
+        }
+
         if (success && !DeleteObject(s3_crt_client, bucket_name, object_key)) {
             Cleanup(s3_crt_client, bucket_name);
             success = false;
@@ -0,0 +1,171 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Before running this C++ code example, set up your development environment, including your credentials.
+ *
+ * For more information, see the following documentation topic:
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started.html
+ *
+ * For information on the structure of the code examples and how to build and run the examples, see
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started-code-examples.html.
+ *
+ * Purpose
+ *
+ * Demonstrates using the AWS SDK for C++ to delete all the objects with a key prefix in an
+ * Amazon Simple Storage Service (Amazon S3) bucket, with concurrent DeleteObjects requests
+ * of up to 1000 keys.
+ *
+ */
+
+#include <iostream>
+#include <aws/core/Aws.h>
+#include <aws/s3/S3Client.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
+#include "awsdoc/bulk_deleter.h"
+#include "awsdoc/s3/list_objects_pager.h"
+#include "awsdoc/s3/s3_examples.h"
+
+//! Routine which demonstrates deleting all the objects with a key prefix in an Amazon S3 bucket.
+/*!
+  Objects are deleted while the bucket is still being listed. In a versioned bucket,
+  a delete marker is added for each object.
+  \sa DeleteAllObjects()
+  \param bucketName: Name of the bucket.
+  \param prefix: Only delete keys beginning with this prefix, ignored if empty.
+  \param maxConcurrency: The most DeleteObjects requests sent at the same time.
+  \param clientConfig: AWS client configuration.
+  \return bool: Function succeeded.
+*/
+
+// snippet-start:[cpp.example_code.s3.delete_all_objects]
+bool AwsDoc::S3::DeleteAllObjects(const Aws::String &bucketName,
+                                  const Aws::String &prefix,
+                                  size_t maxConcurrency,
+                                  const Aws::Client::ClientConfiguration &clientConfig) {
+    // DeleteObjects accepts up to 1000 keys.
+    const size_t MAX_DELETE_KEYS = 1000;
+
+    AwsDoc::BulkDeleterOptions options;
+    options.mMaxConcurrency = maxConcurrency;
+    options.mBatchSize = MAX_DELETE_KEYS;
+    options.mQueueCapacity = 4 * MAX_DELETE_KEYS;
+    options.mResourceName = "objects";
+
+    Aws::Client::ClientConfiguration clientConfig1(clientConfig);
+    // Allow one connection for each delete and one for the listing.
+    clientConfig1.maxConnections = std::max<unsigned>(
+            clientConfig1.maxConnections, static_cast<unsigned>(maxConcurrency + 1));
+    Aws::S3::S3Client client(clientConfig1);
+
+    AwsDoc::BulkDeleter<Aws::String> deleter(
+            [&client, &bucketName](const std::vector<Aws::String> &objectKeys) {
+                AwsDoc::BulkDeleteResult<Aws::String> result;
+
+                Aws::S3::Model::Delete deleteObject;
+                for (const Aws::String &objectKey: objectKeys) {
+                    deleteObject.AddObjects(
+                            Aws::S3::Model::ObjectIdentifier().WithKey(objectKey));
+                }
+                // Only the keys which could not be deleted are returned.
+                deleteObject.SetQuiet(true);
+
+                Aws::S3::Model::DeleteObjectsRequest request;
+                request.SetBucket(bucketName);
+                request.SetDelete(deleteObject);
+
+                Aws::S3::Model::DeleteObjectsOutcome outcome = client.DeleteObjects(request);
+                if (!outcome.IsSuccess()) {
+                    const Aws::S3::S3Error &error = outcome.GetError();
+                    if (error.ShouldRetry()) {
+                        result.mRetryKeys = objectKeys;
+                        result.mThrottled = AwsDoc::isThrottlingError(error);
+                    }
+                    else {
+                        std::cerr << "Error deleting objects. " << error.GetExceptionName()
+                                  << ": " << error.GetMessage() << std::endl;
+                        result.mFailed = objectKeys.size();
+                    }
+                    return result;
+                }
+
+                // A successful request can still fail for some keys.
+                for (const Aws::S3::Model::Error &error: outcome.GetResult().GetErrors()) {
+                    const Aws::String &code = error.GetCode();
+                    if (code == "SlowDown" || code == "InternalError" ||
+                        code == "ServiceUnavailable") {
+                        result.mRetryKeys.push_back(error.GetKey());
+                        result.mThrottled |= code == "SlowDown";
+                    }
+                    else {
+                        std::cerr << "Error deleting object " << error.GetKey() << ". "
+                                  << code << ": " << error.GetMessage() << std::endl;
+                        ++result.mFailed;
+                    }
+                }
+                return result;
+            }, options);
+
+    AwsDoc::S3::ObjectPager pager(client, bucketName, prefix);
+    for (const Aws::S3::Model::Object &object: pager) {
+        deleter.push(object.GetKey());
+    }
+
+    bool result = !pager.hasError();
+    if (pager.hasError()) {
+        std::cerr << "Error: ListObjectsV2: " <<
+                  pager.getError().GetMessage() << std::endl;
+    }
+
+    result &= deleter.finish();
+    deleter.printSummary(std::cout);
+
+    return result;
+}
+// snippet-end:[cpp.example_code.s3.delete_all_objects]
+
+/*
+ *
+ * main function
+ *
+ * Prerequisites: The bucket containing the objects to delete.
+ *
+ * Usage: 'run_delete_all_objects <bucket_name> [prefix] [max_concurrency]'
+ *
+ */
+
+#ifndef TESTING_BUILD
+
+int main(int argc, char **argv) {
+
+    if (argc < 2 || argc > 4)
+    {
+        std::cout << R"(
+Usage:
+   run_delete_all_objects <bucket_name> [prefix] [max_concurrency]
+Where:
+   bucket_name - Name of S3 bucket.
+   prefix - Only delete objects with keys beginning with this prefix.
+   max_concurrency - The most DeleteObjects requests sent at the same time (default 8).
+)" << std::endl;
+
+        return 1;
+    }
+    Aws::SDKOptions options;
+    Aws::InitAPI(options);
+    {
+        Aws::String bucketName(argv[1]);
+        Aws::String prefix = argc > 2 ? argv[2] : "";
+        size_t maxConcurrency = argc > 3 ? std::stoul(argv[3]) : 8;
+
+        Aws::Client::ClientConfiguration clientConfig;
+        // Optional: Set to the AWS Region in which the bucket was created (overrides config file).
+        // clientConfig.region = "us-east-1";
+        AwsDoc::S3::DeleteAllObjects(bucketName, prefix, maxConcurrency, clientConfig);
+    }
+
+    ShutdownAPI(options);
+
+    return 0;
+}
+
+#endif // TESTING_BUILD
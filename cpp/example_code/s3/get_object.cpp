@@ -8,6 +8,7 @@
 #include <aws/s3/model/GetObjectRequest.h>
 #include <fstream>
 #include "awsdoc/s3/s3_examples.h"
+#include "awsdoc/client_registry.h"
 
 /**
  * Before running this C++ code example, set up your development environment, including your credentials.
@@ -27,15 +28,30 @@
   \sa GetObject()
   \param objectKey Name of an object in a bucket.
   \param toBucket: Name of a bucket.
-  \param clientConfig: Aws client configuration.
+  \param clientConfig: Aws client configuration. The client is shared with later calls
+         through AwsDoc::ClientRegistry.
 */
 
 // snippet-start:[s3.cpp.get_object.code]
 bool AwsDoc::S3::GetObject(const Aws::String &objectKey,
                            const Aws::String &fromBucket,
                            const Aws::Client::ClientConfiguration &clientConfig) {
-    Aws::S3::S3Client client(clientConfig);
+    std::shared_ptr<Aws::S3::S3Client> client =
+            AwsDoc::ClientRegistry::getClient<Aws::S3::S3Client>(clientConfig);
 
+    return GetObject(objectKey, fromBucket, *client);
+}
+
+//! Routine which demonstrates getting an object in an S3 bucket with an existing client.
+/*!
+  \sa GetObject()
+  \param objectKey Name of an object in a bucket.
+  \param toBucket: Name of a bucket.
+  \param client: An S3 client, which can be shared between calls.
+*/
+bool AwsDoc::S3::GetObject(const Aws::String &objectKey,
+                           const Aws::String &fromBucket,
+                           const Aws::S3::S3Client &client) {
     Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(fromBucket);
     request.SetKey(objectKey);
@@ -88,6 +104,8 @@ int main() {
 
         AwsDoc::S3::GetObject(objectName, bucketName, clientConfig);
     }
+    // The shared clients must be released before ShutdownAPI.
+    AwsDoc::ClientRegistry::clear();
     Aws::ShutdownAPI(options);
 
     return 0;
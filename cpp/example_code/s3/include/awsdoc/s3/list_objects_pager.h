@@ -0,0 +1,319 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <aws/core/Aws.h>
+#include <aws/s3/S3Client.h>
+#include <aws/s3/model/ListObjectsV2Request.h>
+#include <aws/s3/model/Object.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A lazy, range-for compatible sequence of the objects in an S3 bucket.
+ *
+ * ObjectPager lists objects with ListObjectsV2 and follows continuation tokens
+ * until the listing is complete. While the caller consumes one page, the request
+ * for the next page is already running on the client's executor.
+ *
+ * Objects are returned by reference into the current page, so no page is copied.
+ * A reference is valid until the iterator is advanced past the end of its page.
+ *
+ *   AwsDoc::S3::ObjectPager pager(s3Client, bucketName);
+ *   for (const Aws::S3::Model::Object &object: pager) {
+ *       std::cout << object.GetKey() << std::endl;
+ *   }
+ *   if (pager.hasError()) { ... }
+ */
+
+namespace AwsDoc {
+    namespace S3 {
+
+        class ObjectPager {
+        public:
+            class iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef Aws::S3::Model::Object value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const Aws::S3::Model::Object *pointer;
+                typedef const Aws::S3::Model::Object &reference;
+
+                explicit iterator(ObjectPager *pager = nullptr) : mPager(pager) {
+                    if (mPager != nullptr && !mPager->fetchIfNeeded()) {
+                        mPager = nullptr;
+                    }
+                }
+
+                reference operator*() const { return mPager->current(); }
+
+                pointer operator->() const { return &mPager->current(); }
+
+                iterator &operator++() {
+                    if (!mPager->advance()) {
+                        mPager = nullptr;
+                    }
+                    return *this;
+                }
+
+                bool operator==(const iterator &other) const {
+                    return mPager == other.mPager;
+                }
+
+                bool operator!=(const iterator &other) const {
+                    return mPager != other.mPager;
+                }
+
+            private:
+                ObjectPager *mPager;
+            };
+
+            //! ObjectPager constructor.
+            /*!
+              \param s3Client: An S3 client. It must outlive the pager.
+              \param bucketName: The name of the bucket to list.
+              \param prefix: Only list keys beginning with this prefix, ignored if empty.
+              \param maxKeys: The maximum number of keys for each page, up to 1000.
+             */
+            ObjectPager(const Aws::S3::S3Client &s3Client,
+                        const Aws::String &bucketName,
+                        const Aws::String &prefix = "",
+                        int maxKeys = 1000) : mS3Client(s3Client) {
+                mRequest.SetBucket(bucketName);
+                if (!prefix.empty()) {
+                    mRequest.SetPrefix(prefix);
+                }
+                mRequest.SetMaxKeys(maxKeys);
+            }
+
+            ObjectPager(const ObjectPager &) = delete;
+
+            ObjectPager &operator=(const ObjectPager &) = delete;
+
+            ~ObjectPager() {
+                // Do not leave a request running against a destroyed pager's client.
+                if (mNextPage.valid()) {
+                    mNextPage.wait();
+                }
+            }
+
+            //! Routine which returns an iterator to the first object.
+            /*!
+              The listing can only be traversed once.
+              \return iterator: The first object, or end() if there are none.
+             */
+            iterator begin() { return iterator(this); }
+
+            iterator end() { return iterator(); }
+
+            //! Routine which reports whether a ListObjectsV2 request failed.
+            /*!
+              \return bool: True if a request failed.
+             */
+            bool hasError() const { return mHasError; }
+
+            //! Routine which returns the error from a failed request.
+            /*!
+              \return S3Error: The error.
+             */
+            const Aws::S3::S3Error &getError() const { return mPage.GetError(); }
+
+            //! Routine which returns the number of pages retrieved.
+            /*!
+              \return size_t: The number of pages.
+             */
+            size_t pageCount() const { return mPageCount; }
+
+        private:
+            const Aws::S3::Model::Object &current() const {
+                return mPage.GetResult().GetContents()[mIndex];
+            }
+
+            //! Start the first request if it has not been started.
+            //! Returns false if there are no objects.
+            bool fetchIfNeeded() {
+                if (!mStarted) {
+                    mStarted = true;
+                    mNextPage = mS3Client.ListObjectsV2Callable(mRequest);
+                    return loadNextPage();
+                }
+
+                return !mDone;
+            }
+
+            //! Move to the next object. Returns false at the end of the listing.
+            bool advance() {
+                ++mIndex;
+                if (mIndex < mPage.GetResult().GetContents().size()) {
+                    return true;
+                }
+
+                return loadNextPage();
+            }
+
+            //! Wait for the prefetched page, and then prefetch the page after it.
+            //! Pages with no contents are skipped.
+            bool loadNextPage() {
+                while (mNextPage.valid()) {
+                    mPage = mNextPage.get();
+                    mIndex = 0;
+                    if (!mPage.IsSuccess()) {
+                        mHasError = true;
+                        break;
+                    }
+
+                    ++mPageCount;
+                    const Aws::S3::Model::ListObjectsV2Result &result = mPage.GetResult();
+                    if (result.GetIsTruncated() &&
+                        !result.GetNextContinuationToken().empty()) {
+                        mRequest.SetContinuationToken(result.GetNextContinuationToken());
+                        mNextPage = mS3Client.ListObjectsV2Callable(mRequest);
+                    }
+
+                    if (!result.GetContents().empty()) {
+                        return true;
+                    }
+                }
+
+                mDone = true;
+                return false;
+            }
+
+            const Aws::S3::S3Client &mS3Client;
+            Aws::S3::Model::ListObjectsV2Request mRequest;
+            Aws::S3::Model::ListObjectsV2Outcome mPage;
+            Aws::S3::Model::ListObjectsV2OutcomeCallable mNextPage;
+            size_t mIndex = 0;
+            size_t mPageCount = 0;
+            bool mStarted = false;
+            bool mDone = false;
+            bool mHasError = false;
+        };
+
+        //! Routine which lists all the objects under a prefix in parallel.
+        /*!
+          Each prefix is listed with the delimiter, so its keys are split into the
+          objects directly under it and common prefixes. The common prefixes are
+          queued and listed in the same way, at every level of the key hierarchy,
+          by up to maxThreads threads. A prefix whose keys contain no delimiter is
+          listed by one thread.
+
+          The callback is called from several threads, and it must be thread safe.
+          \sa ListObjectsParallel()
+          \param s3Client: An S3 client.
+          \param bucketName: The name of the bucket to list.
+          \param prefix: The prefix to split, ignored if empty.
+          \param delimiter: The delimiter used to split the keys into prefixes.
+          \param maxThreads: The maximum number of prefixes listed at the same time.
+          \param callback: Called with each object.
+          \return bool: Function succeeded.
+         */
+        inline bool ListObjectsParallel(const Aws::S3::S3Client &s3Client,
+                                        const Aws::String &bucketName,
+                                        const Aws::String &prefix,
+                                        const Aws::String &delimiter,
+                                        size_t maxThreads,
+                                        const std::function<void(
+                                                const Aws::S3::Model::Object &)> &callback) {
+            std::mutex mutex;
+            std::condition_variable prefixAvailable;
+            std::deque<Aws::String> prefixes(1, prefix);
+            size_t busyThreads = 0;
+            bool result = true;
+
+            // Lists one prefix, and queues its common prefixes.
+            auto listPrefix = [&](const Aws::String &listedPrefix) {
+                Aws::S3::Model::ListObjectsV2Request request;
+                request.SetBucket(bucketName);
+                request.SetDelimiter(delimiter);
+                if (!listedPrefix.empty()) {
+                    request.SetPrefix(listedPrefix);
+                }
+
+                Aws::String continuationToken;
+                do {
+                    if (!continuationToken.empty()) {
+                        request.SetContinuationToken(continuationToken);
+                    }
+
+                    Aws::S3::Model::ListObjectsV2Outcome outcome = s3Client.ListObjectsV2(
+                            request);
+                    if (!outcome.IsSuccess()) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        std::cerr << "Error: ListObjectsV2: prefix '" << listedPrefix
+                                  << "', " << outcome.GetError().GetMessage() << std::endl;
+                        return false;
+                    }
+
+                    const Aws::S3::Model::ListObjectsV2Result &listResult = outcome.GetResult();
+                    for (const Aws::S3::Model::Object &object: listResult.GetContents()) {
+                        callback(object);
+                    }
+
+                    if (!listResult.GetCommonPrefixes().empty()) {
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            for (const Aws::S3::Model::CommonPrefix &commonPrefix: listResult.GetCommonPrefixes()) {
+                                prefixes.push_back(commonPrefix.GetPrefix());
+                            }
+                        }
+                        prefixAvailable.notify_all();
+                    }
+
+                    continuationToken = listResult.GetIsTruncated() ?
+                                        listResult.GetNextContinuationToken() : "";
+                } while (!continuationToken.empty());
+
+                return true;
+            };
+
+            // Threads wait for a prefix until the queue is empty and no thread is
+            // listing a prefix, which could queue more.
+            auto listPrefixes = [&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    prefixAvailable.wait(lock, [&] {
+                        return !prefixes.empty() || busyThreads == 0;
+                    });
+                    if (prefixes.empty()) {
+                        break;
+                    }
+
+                    Aws::String nextPrefix = std::move(prefixes.front());
+                    prefixes.pop_front();
+                    ++busyThreads;
+                    lock.unlock();
+                    bool listed = listPrefix(nextPrefix);
+                    lock.lock();
+                    --busyThreads;
+                    if (!listed) {
+                        result = false;
+                    }
+                }
+                prefixAvailable.notify_all();
+            };
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < std::max<size_t>(maxThreads, 1); ++i) {
+                threads.emplace_back(listPrefixes);
+            }
+
+            listPrefixes();  // The calling thread is also a worker.
+
+            for (std::thread &thread: threads) {
+                thread.join();
+            }
+
+            return result;
+        }
+    } // namespace S3
+} // namespace AwsDoc
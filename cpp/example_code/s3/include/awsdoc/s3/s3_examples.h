@@ -4,12 +4,27 @@
 #pragma once
 
 #include <aws/core/Aws.h>
+#include <aws/core/http/HttpTypes.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/BucketLocationConstraint.h>
 #include <cstdint>
+#include <vector>
 
 namespace AwsDoc {
     namespace S3 {
+        //! The object and operation for one pre-signed URL.
+        struct PresignedUrlRequest {
+            PresignedUrlRequest(const Aws::String &bucketName, const Aws::String &key,
+                                Aws::Http::HttpMethod method, uint64_t expirationSeconds) :
+                    mBucketName(bucketName), mKey(key), mMethod(method),
+                    mExpirationSeconds(expirationSeconds) {}
+
+            Aws::String mBucketName;
+            Aws::String mKey;
+            Aws::Http::HttpMethod mMethod;
+            uint64_t mExpirationSeconds;
+        };
+
         bool
         CopyObject(const Aws::String &objectKey, const Aws::String &fromBucket,
                    const Aws::String &toBucket,
@@ -22,6 +37,11 @@ namespace AwsDoc {
                            const Aws::String &fromBucket,
                            const Aws::Client::ClientConfiguration &clientConfig);
 
+        bool DeleteAllObjects(const Aws::String &bucketName,
+                              const Aws::String &prefix,
+                              size_t maxConcurrency,
+                              const Aws::Client::ClientConfiguration &clientConfig);
+
         bool DeleteBucket(const Aws::String &bucketName,
                           const Aws::Client::ClientConfiguration &clientConfig);
 
@@ -49,6 +69,10 @@ namespace AwsDoc {
                        const Aws::String &fromBucket,
                        const Aws::Client::ClientConfiguration &clientConfig);
 
+        bool GetObject(const Aws::String &objectKey,
+                       const Aws::String &fromBucket,
+                       const Aws::S3::S3Client &client);
+
         bool GetWebsiteConfig(const Aws::String &bucketName,
                               const Aws::Client::ClientConfiguration &clientConfig);
 
@@ -60,6 +84,9 @@ namespace AwsDoc {
         bool ListObjects(const Aws::String &bucketName,
                          const Aws::Client::ClientConfiguration &clientConfig);
 
+        bool ListObjects(const Aws::String &bucketName,
+                         const Aws::S3::S3Client &s3_client);
+
         bool ListObjectsWithAWSGlobalRegion(
                 const Aws::Client::ClientConfiguration &clientConfig);
 
@@ -68,11 +95,31 @@ namespace AwsDoc {
                                                   uint64_t expirationSeconds,
                                                   const Aws::Client::ClientConfiguration &clientConfig);
 
+        Aws::String GeneratePreSignedPutObjectURL(const Aws::String &bucketName,
+                                                  const Aws::String &key,
+                                                  uint64_t expirationSeconds,
+                                                  Aws::S3::S3Client &client);
+
         Aws::String GeneratePreSignedGetObjectURL(const Aws::String &bucketName,
                                                   const Aws::String &key,
                                                   uint64_t expirationSeconds,
                                                   const Aws::Client::ClientConfiguration &clientConfig);
 
+        Aws::String GeneratePreSignedGetObjectURL(const Aws::String &bucketName,
+                                                  const Aws::String &key,
+                                                  uint64_t expirationSeconds,
+                                                  Aws::S3::S3Client &client);
+
+        bool GeneratePreSignedURLs(const std::vector<PresignedUrlRequest> &requests,
+                                   std::vector<Aws::String> &urls,
+                                   size_t threadCount,
+                                   const Aws::Client::ClientConfiguration &clientConfig);
+
+        bool GeneratePreSignedURLs(const std::vector<PresignedUrlRequest> &requests,
+                                   std::vector<Aws::String> &urls,
+                                   size_t threadCount,
+                                   Aws::S3::S3Client &client);
+
         bool PutBucketAcl(const Aws::String &bucketName,
                           const Aws::String &ownerID,
                           const Aws::String &granteePermission,
@@ -111,6 +158,11 @@ namespace AwsDoc {
                              const std::string &objectContent,
                              const Aws::Client::ClientConfiguration &clientConfig);
 
+        bool PutObjectBuffer(const Aws::String &bucketName,
+                             const Aws::String &objectName,
+                             const std::string &objectContent,
+                             const Aws::S3::S3Client &s3_client);
+
         bool PutWebsiteConfig(const Aws::String &bucketName,
                               const Aws::String &indexPage,
                               const Aws::String &errorPage,
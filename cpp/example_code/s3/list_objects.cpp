@@ -4,9 +4,10 @@
 #include <iostream>
 #include <aws/core/Aws.h>
 #include <aws/s3/S3Client.h>
-#include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/Object.h>
 #include <awsdoc/s3/s3_examples.h>
+#include <awsdoc/s3/list_objects_pager.h>
+#include <awsdoc/client_registry.h>
 
 /**
  * Before running this C++ code example, set up your development environment, including your credentials.
@@ -25,33 +26,42 @@
 /*!
   \fn ListObjects()
   \param bucketName Name of the S3 bucket.
-  \param clientConfig Aws client configuration.
+  \param clientConfig Aws client configuration. The client is shared with later calls
+         through AwsDoc::ClientRegistry.
  */
 
 // snippet-start:[s3.cpp.list_objects.code]
 bool AwsDoc::S3::ListObjects(const Aws::String &bucketName,
                              const Aws::Client::ClientConfiguration &clientConfig) {
-    Aws::S3::S3Client s3_client(clientConfig);
+    std::shared_ptr<Aws::S3::S3Client> s3_client =
+            AwsDoc::ClientRegistry::getClient<Aws::S3::S3Client>(clientConfig);
 
-    Aws::S3::Model::ListObjectsRequest request;
-    request.WithBucket(bucketName);
-
-    auto outcome = s3_client.ListObjects(request);
+    return ListObjects(bucketName, *s3_client);
+}
 
-    if (!outcome.IsSuccess()) {
-        std::cerr << "Error: ListObjects: " <<
-                  outcome.GetError().GetMessage() << std::endl;
+//! Routine which demonstrates listing the objects in an S3 bucket with an existing client.
+/*!
+  \fn ListObjects()
+  \param bucketName Name of the S3 bucket.
+  \param s3_client An S3 client, which can be shared between calls.
+ */
+bool AwsDoc::S3::ListObjects(const Aws::String &bucketName,
+                             const Aws::S3::S3Client &s3_client) {
+    // The pager follows continuation tokens, so buckets with more than 1000
+    // objects are listed completely. Each page is requested while the
+    // previous page is printed.
+    AwsDoc::S3::ObjectPager pager(s3_client, bucketName);
+
+    for (const Aws::S3::Model::Object &object: pager) {
+        std::cout << object.GetKey() << std::endl;
     }
-    else {
-        Aws::Vector<Aws::S3::Model::Object> objects =
-                outcome.GetResult().GetContents();
 
-        for (Aws::S3::Model::Object &object: objects) {
-            std::cout << object.GetKey() << std::endl;
-        }
+    if (pager.hasError()) {
+        std::cerr << "Error: ListObjectsV2: " <<
+                  pager.getError().GetMessage() << std::endl;
     }
 
-    return outcome.IsSuccess();
+    return !pager.hasError();
 }
 // snippet-end:[s3.cpp.list_objects.code]
 
@@ -83,6 +93,8 @@ int main()
         // clientConfig.region = "us-east-1";
         AwsDoc::S3::ListObjects(bucket_name, clientConfig);
      }
+    // The shared clients must be released before ShutdownAPI.
+    AwsDoc::ClientRegistry::clear();
     Aws::ShutdownAPI(options);
 
     return 0;
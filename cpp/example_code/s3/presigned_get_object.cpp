@@ -46,6 +46,22 @@ Aws::String AwsDoc::S3::GeneratePreSignedGetObjectURL(const Aws::String &bucketN
                                                       uint64_t expirationSeconds,
                                                       const Aws::Client::ClientConfiguration &clientConfig) {
     Aws::S3::S3Client client(clientConfig);
+    return GeneratePreSignedGetObjectURL(bucketName, key, expirationSeconds, client);
+}
+
+//! Routine which demonstrates creating a pre-signed URL to download an object from an
+//! Amazon S3 bucket, using an existing client.
+/*!
+  \param bucketName: Name of the bucket.
+  \param key: Name of an object key.
+  \param expirationSeconds: Expiration in seconds for pre-signed URL.
+  \param client: An S3 client, which can be shared between calls.
+  \return Aws::String: A pre-signed URL.
+*/
+Aws::String AwsDoc::S3::GeneratePreSignedGetObjectURL(const Aws::String &bucketName,
+                                                      const Aws::String &key,
+                                                      uint64_t expirationSeconds,
+                                                      Aws::S3::S3Client &client) {
     return client.GeneratePresignedUrl(bucketName, key, Aws::Http::HttpMethod::HTTP_GET,
                                        expirationSeconds);
 }
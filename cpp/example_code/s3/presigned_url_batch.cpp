@@ -0,0 +1,211 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * Before running this C++ code example, set up your development environment, including your credentials.
+ *
+ * For more information, see the following documentation topic:
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started.html
+ *
+ * For information on the structure of the code examples and how to build and run the examples, see
+ * https://docs.aws.amazon.com/sdk-for-cpp/v1/developer-guide/getting-started-code-examples.html.
+ *
+ * Purpose
+ *
+ * Demonstrates using the AWS SDK for C++ to create many pre-signed URLs for
+ * Amazon Simple Storage Service (Amazon S3) objects with one client, signing
+ * on several threads.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <aws/core/Aws.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/s3/S3Client.h>
+#include "awsdoc/s3/s3_examples.h"
+
+//! Routine which demonstrates creating pre-signed URLs for many Amazon S3 objects.
+/*!
+  \sa GeneratePreSignedURLs()
+  \param requests: The object and operation for each URL.
+  \param urls: A vector to receive the URLs, in the order of the requests.
+  \param threadCount: The number of signing threads, or 0 for one per core.
+  \param clientConfig: Aws client configuration.
+  \return bool: Function succeeded.
+*/
+bool AwsDoc::S3::GeneratePreSignedURLs(const std::vector<PresignedUrlRequest> &requests,
+                                       std::vector<Aws::String> &urls,
+                                       size_t threadCount,
+                                       const Aws::Client::ClientConfiguration &clientConfig) {
+    Aws::S3::S3Client client(clientConfig);
+    return GeneratePreSignedURLs(requests, urls, threadCount, client);
+}
+
+// snippet-start:[cpp.example_code.s3.presigned.batch]
+//! Routine which demonstrates creating pre-signed URLs for many Amazon S3 objects,
+//! using an existing client.
+/*!
+  Signing is done locally, without requests to Amazon S3. Every URL is signed
+  with the same client, so the credentials are resolved once and the signer's
+  cached signing key is reused for each day, Region, and service. The requests
+  are divided into contiguous ranges, one for each thread.
+  \sa GeneratePreSignedURLs()
+  \param requests: The object and operation for each URL.
+  \param urls: A vector to receive the URLs, in the order of the requests.
+  \param threadCount: The number of signing threads, or 0 for one per core.
+  \param client: An S3 client, which can be shared between calls.
+  \return bool: Function succeeded.
+*/
+bool AwsDoc::S3::GeneratePreSignedURLs(const std::vector<PresignedUrlRequest> &requests,
+                                       std::vector<Aws::String> &urls,
+                                       size_t threadCount,
+                                       Aws::S3::S3Client &client) {
+    // Below this, starting a thread costs more than the signing it saves.
+    const size_t MIN_URLS_PER_THREAD = 64;
+
+    urls.assign(requests.size(), Aws::String());
+    if (requests.empty()) {
+        return true;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threadCount = std::max<size_t>(
+            std::min(threadCount,
+                     (requests.size() + MIN_URLS_PER_THREAD - 1) / MIN_URLS_PER_THREAD), 1);
+    const size_t rangeSize = (requests.size() + threadCount - 1) / threadCount;
+
+    std::atomic<size_t> failed(0);
+    auto signRange = [&requests, &urls, &client, &failed](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const PresignedUrlRequest &request = requests[i];
+            urls[i] = client.GeneratePresignedUrl(request.mBucketName, request.mKey,
+                                                  request.mMethod,
+                                                  request.mExpirationSeconds);
+            if (urls[i].empty()) {
+                ++failed;
+            }
+        }
+    };
+
+    // The calling thread signs the first range.
+    std::vector<std::thread> threads;
+    for (size_t begin = rangeSize; begin < requests.size(); begin += rangeSize) {
+        threads.emplace_back(signRange, begin, std::min(begin + rangeSize, requests.size()));
+    }
+    signRange(0, std::min(rangeSize, requests.size()));
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    if (failed > 0) {
+        std::cerr << "Error: failed to create " << failed << " of "
+                  << requests.size() << " pre-signed URLs." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+// snippet-end:[cpp.example_code.s3.presigned.batch]
+
+/*
+ *
+ * main function
+ *
+ * Compares the rate of creating pre-signed URLs with a new client for each URL,
+ * with one client on one thread, and with one client on several threads.
+ * No requests are sent to the bucket, and the objects do not need to exist.
+ *
+ * Prerequisites: Credentials.
+ *
+ * Usage: 'run_presigned_url_batch <bucket_name> [url_count] [thread_count]'
+ *
+ */
+
+#ifndef TESTING_BUILD
+
+// Print the rate of URLs created per second.
+static void printRate(const char *method, size_t count,
+                      std::chrono::steady_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    std::cout << method << ": " << count << " URLs in " << seconds << " seconds, "
+              << static_cast<size_t>(count / std::max(seconds, 1e-9)) << " URLs/sec."
+              << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 2 || argc > 4) {
+        std::cout << R"(
+Usage:
+   run_presigned_url_batch <bucket_name> [url_count] [thread_count]
+Where:
+   bucket_name - Name of S3 bucket. No requests are sent to the bucket.
+   url_count - The number of URLs to create (default 10000).
+   thread_count - The number of signing threads (default one per core).
+)" << std::endl;
+
+        return 1;
+    }
+    Aws::SDKOptions options;
+    Aws::InitAPI(options);
+    {
+        // Creating a client for each URL is slow, so only a sample is timed.
+        const size_t MAX_PER_CALL_CLIENT_URLS = 1000;
+        const uint64_t expirationSeconds = 10 * 60;
+
+        Aws::String bucketName(argv[1]);
+        size_t urlCount = argc > 2 ? std::stoul(argv[2]) : 10000;
+        size_t threadCount = argc > 3 ? std::stoul(argv[3]) : 0;
+
+        Aws::Client::ClientConfiguration clientConfig;
+        // Optional: Set to the AWS Region in which the bucket was created (overrides config file).
+        // clientConfig.region = "us-east-1";
+
+        // Alternate downloads and uploads.
+        std::vector<AwsDoc::S3::PresignedUrlRequest> requests;
+        requests.reserve(urlCount);
+        for (size_t i = 0; i < urlCount; ++i) {
+            requests.emplace_back(bucketName,
+                                  "presigned_url_batch/" + Aws::Utils::StringUtils::to_string(i),
+                                  i % 2 == 0 ? Aws::Http::HttpMethod::HTTP_GET
+                                             : Aws::Http::HttpMethod::HTTP_PUT,
+                                  expirationSeconds);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        size_t sampleCount = std::min(urlCount, MAX_PER_CALL_CLIENT_URLS);
+        for (size_t i = 0; i < sampleCount; ++i) {
+            AwsDoc::S3::GeneratePreSignedGetObjectURL(bucketName, requests[i].mKey,
+                                                      expirationSeconds, clientConfig);
+        }
+        printRate("New client for each URL", sampleCount, start);
+
+        Aws::S3::S3Client client(clientConfig);
+        std::vector<Aws::String> urls;
+
+        start = std::chrono::steady_clock::now();
+        AwsDoc::S3::GeneratePreSignedURLs(requests, urls, 1, client);
+        printRate("One client, one thread", urlCount, start);
+
+        start = std::chrono::steady_clock::now();
+        if (AwsDoc::S3::GeneratePreSignedURLs(requests, urls, threadCount, client)) {
+            printRate("One client, several threads", urlCount, start);
+        }
+
+        if (!urls.empty()) {
+            std::cout << "First URL:\n" << urls.front() << std::endl;
+        }
+    }
+
+    ShutdownAPI(options);
+
+    return 0;
+}
+
+#endif // TESTING_BUILD
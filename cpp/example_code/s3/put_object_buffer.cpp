@@ -7,6 +7,7 @@
 #include <iostream>
 #include <fstream>
 #include <awsdoc/s3/s3_examples.h>
+#include <awsdoc/client_registry.h>
 
 /**
  * Before running this C++ code example, set up your development environment, including your credentials.
@@ -27,7 +28,8 @@
   \param bucketName Name of the bucket.
   \param objectName Name for the object in the bucket.
   \param objectContent String as content for object.
-  \param clientConfig Aws client configuration.
+  \param clientConfig Aws client configuration. The client is shared with later calls
+         through AwsDoc::ClientRegistry.
 */
 
 // snippet-start:[s3.cpp.objects.put_string_into_object_bucket]
@@ -35,8 +37,24 @@ bool AwsDoc::S3::PutObjectBuffer(const Aws::String &bucketName,
                                  const Aws::String &objectName,
                                  const std::string &objectContent,
                                  const Aws::Client::ClientConfiguration &clientConfig) {
-    Aws::S3::S3Client s3_client(clientConfig);
+    std::shared_ptr<Aws::S3::S3Client> s3_client =
+            AwsDoc::ClientRegistry::getClient<Aws::S3::S3Client>(clientConfig);
 
+    return PutObjectBuffer(bucketName, objectName, objectContent, *s3_client);
+}
+
+//! Routine which demonstrates putting a string as an object in an S3 bucket with an existing client.
+/*!
+  \fn PutObject()
+  \param bucketName Name of the bucket.
+  \param objectName Name for the object in the bucket.
+  \param objectContent String as content for object.
+  \param s3_client An S3 client, which can be shared between calls.
+*/
+bool AwsDoc::S3::PutObjectBuffer(const Aws::String &bucketName,
+                                 const Aws::String &objectName,
+                                 const std::string &objectContent,
+                                 const Aws::S3::S3Client &s3_client) {
     Aws::S3::Model::PutObjectRequest request;
     request.SetBucket(bucketName);
     request.SetKey(objectName);
@@ -88,6 +106,8 @@ int main() {
 
         AwsDoc::S3::PutObjectBuffer(bucketName, objectName, objectContent, clientConfig);
     }
+    // The shared clients must be released before ShutdownAPI.
+    AwsDoc::ClientRegistry::clear();
 
     Aws::ShutdownAPI(options);
 
@@ -12,7 +12,12 @@
 #include <aws/s3/model/PutBucketPolicyRequest.h>
 #include <aws/s3/model/PutBucketWebsiteRequest.h>
 #include <aws/core/utils/UUID.h>
+#include "awsdoc/client_registry.h"
+#include <algorithm>
 #include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
 
 Aws::SDKOptions AwsDocTest::S3_GTests::s_options;
 std::unique_ptr<Aws::Client::ClientConfiguration> AwsDocTest::S3_GTests::s_clientConfig;
@@ -69,6 +74,93 @@ private:
     std::shared_ptr<Aws::Http::HttpResponse> mCredentialsResponse;
 };
 
+/*
+ * Subclass MockHttpClient to generate ListObjectsV2 responses from a list of keys,
+ * instead of returning stored responses in order.
+ */
+class AwsDocTest::S3ListMockHTTPClient : public MockHttpClient {
+public:
+    explicit S3ListMockHTTPClient(const std::vector<Aws::String> &keys) :
+            mKeys(keys) {
+        std::sort(mKeys.begin(), mKeys.end());
+    }
+
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        Aws::Http::QueryStringParameterCollection parameters =
+                request->GetUri().GetQueryStringParameters();
+        auto prefixParameter = parameters.find("prefix");
+        const Aws::String prefix = prefixParameter != parameters.end() ?
+                                   prefixParameter->second : "";
+        auto delimiterParameter = parameters.find("delimiter");
+        const Aws::String delimiter = delimiterParameter != parameters.end() ?
+                                      delimiterParameter->second : "";
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRequestedPrefixes.push_back(prefix);
+            mMaxConcurrentRequests = std::max(mMaxConcurrentRequests, ++mConcurrentRequests);
+        }
+
+        // Hold the request briefly, so requests from several threads overlap.
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        Aws::StringStream body;
+        body << R"(<?xml version="1.0" encoding="UTF-8"?>)"
+             << R"(<ListBucketResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">)"
+             << "<Name>test_bucket</Name><Prefix>" << prefix << "</Prefix>"
+             << "<Delimiter>" << delimiter << "</Delimiter>"
+             << "<IsTruncated>false</IsTruncated>";
+        std::set<Aws::String> commonPrefixes;
+        for (const Aws::String &key: mKeys) {
+            if (key.compare(0, prefix.size(), prefix) != 0) {
+                continue;
+            }
+            size_t delimiterPosition = delimiter.empty() ? Aws::String::npos :
+                                       key.find(delimiter, prefix.size());
+            if (delimiterPosition != Aws::String::npos) {
+                commonPrefixes.insert(key.substr(0, delimiterPosition + delimiter.size()));
+            }
+            else {
+                body << "<Contents><Key>" << key << "</Key><Size>1</Size></Contents>";
+            }
+        }
+        for (const Aws::String &commonPrefix: commonPrefixes) {
+            body << "<CommonPrefixes><Prefix>" << commonPrefix << "</Prefix></CommonPrefixes>";
+        }
+        body << "</ListBucketResult>";
+
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->AddHeader("Content-Type", "application/xml");
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+        response->GetResponseBody() << body.str();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mConcurrentRequests;
+        return response;
+    }
+
+    std::vector<Aws::String> getRequestedPrefixes() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mRequestedPrefixes;
+    }
+
+    size_t getMaxConcurrentRequests() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMaxConcurrentRequests;
+    }
+
+private:
+    std::vector<Aws::String> mKeys;
+    mutable std::mutex mMutex;
+    mutable std::vector<Aws::String> mRequestedPrefixes;
+    mutable size_t mConcurrentRequests = 0;
+    mutable size_t mMaxConcurrentRequests = 0;
+};
+
 void AwsDocTest::S3_GTests::SetUpTestSuite() {
     InitAPI(s_options);
 
@@ -82,6 +174,7 @@ void AwsDocTest::S3_GTests::TearDownTestSuite() {
         remove(s_testFilePath.c_str());
     }
 
+    AwsDoc::ClientRegistry::clear();
     ShutdownAPI(s_options);
 
 }
@@ -403,6 +496,8 @@ bool AwsDocTest::S3_GTests::suppressStdOut() {
 }
 
 AwsDocTest::MockHTTP::MockHTTP() {
+    // Shared clients created before the mock would not use it.
+    AwsDoc::ClientRegistry::clear();
     requestTmp = CreateHttpRequest(Aws::Http::URI("https://test.com/"),
                                    Aws::Http::HttpMethod::HTTP_GET,
                                    Aws::Utils::Stream::DefaultResponseStreamFactoryMethod);
@@ -414,6 +509,7 @@ AwsDocTest::MockHTTP::MockHTTP() {
 }
 
 AwsDocTest::MockHTTP::~MockHTTP() {
+    AwsDoc::ClientRegistry::clear();
     Aws::Http::CleanupHttp();
     Aws::Http::InitHttp();
 }
@@ -440,5 +536,22 @@ bool AwsDocTest::MockHTTP::addResponseWithBody(const std::string &fileName,
     return false;
 }
 
+AwsDocTest::MockS3ListService::MockS3ListService(const std::vector<Aws::String> &keys) {
+    mockHttpClient = Aws::MakeShared<S3ListMockHTTPClient>(ALLOCATION_TAG, keys);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockS3ListService::~MockS3ListService() {
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
 
+std::vector<Aws::String> AwsDocTest::MockS3ListService::getRequestedPrefixes() const {
+    return mockHttpClient->getRequestedPrefixes();
+}
 
+size_t AwsDocTest::MockS3ListService::getMaxConcurrentRequests() const {
+    return mockHttpClient->getMaxConcurrentRequests();
+}
@@ -86,6 +86,31 @@ namespace AwsDocTest {
         std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
         std::shared_ptr<Aws::Http::HttpRequest> requestTmp;
     }; // MockHTTP
+
+    class S3ListMockHTTPClient;
+
+    /*
+     * A mock S3 service which answers ListObjectsV2 requests from a list of keys,
+     * splitting them on the delimiter, so requests can be made in any order and
+     * from several threads.
+     */
+    class MockS3ListService {
+    public:
+        explicit MockS3ListService(const std::vector<Aws::String> &keys);
+
+        virtual ~MockS3ListService();
+
+        // The prefixes of the ListObjectsV2 requests.
+        std::vector<Aws::String> getRequestedPrefixes() const;
+
+        // The most ListObjectsV2 requests handled at the same time.
+        size_t getMaxConcurrentRequests() const;
+
+    private:
+
+        std::shared_ptr<S3ListMockHTTPClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockS3ListService
 } // AwsDocTest
 
 #endif //S3_EXAMPLES_S3_GTESTS_H
@@ -0,0 +1,106 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <aws/core/utils/StringUtils.h>
+#include "awsdoc/bulk_deleter.h"
+#include "awsdoc/s3/s3_examples.h"
+#include "S3_GTests.h"
+
+static const int BUCKETS_NEEDED = 1;
+
+namespace AwsDocTest {
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, delete_all_objects_2_) {
+        std::vector<Aws::String> bucketNames = GetCachedS3Buckets(BUCKETS_NEEDED);
+        ASSERT_GE(bucketNames.size(), BUCKETS_NEEDED)
+                                    << "Failed to meet precondition" << std::endl;
+
+        const Aws::String prefix = "delete_all_objects_test/";
+        for (int i = 0; i < 5; ++i) {
+            Aws::String fileName = PutTestFileInBucket(bucketNames[0],
+                                                       prefix + Aws::Utils::StringUtils::to_string(i));
+            ASSERT_TRUE(!fileName.empty()) << "Failed to meet precondition" << std::endl;
+        }
+
+        bool result = AwsDoc::S3::DeleteAllObjects(bucketNames[0], prefix, 2,
+                                                   *s_clientConfig);
+        ASSERT_TRUE(result);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, bulk_deleter_3_) {
+        const size_t KEY_COUNT = 100;
+        const int ALWAYS_RETRIED_KEY = 50;
+        const int FAILED_KEY = 99;
+
+        // Keys which are multiples of 7 are throttled on their first attempt.
+        std::mutex mutex;
+        std::map<int, int> attempts;
+        std::set<int> deletedKeys;
+        size_t largestBatch = 0;
+        auto deleteBatch = [&](const std::vector<int> &keys) {
+            AwsDoc::BulkDeleteResult<int> result;
+            std::lock_guard<std::mutex> lock(mutex);
+            largestBatch = std::max(largestBatch, keys.size());
+            for (int key: keys) {
+                if (key == ALWAYS_RETRIED_KEY) {
+                    result.mRetryKeys.push_back(key);
+                }
+                else if (key % 7 == 0 && attempts[key]++ == 0) {
+                    result.mRetryKeys.push_back(key);
+                    result.mThrottled = true;
+                }
+                else if (key == FAILED_KEY) {
+                    ++result.mFailed;
+                }
+                else {
+                    EXPECT_TRUE(deletedKeys.insert(key).second) << key;
+                }
+            }
+            return result;
+        };
+
+        AwsDoc::BulkDeleterOptions options;
+        options.mMaxConcurrency = 4;
+        options.mBatchSize = 10;
+        options.mMaxRetries = 3;
+        options.mRetryBackoff.mInitialDelay = std::chrono::milliseconds(1);
+        options.mRetryBackoff.mMaxDelay = std::chrono::milliseconds(5);
+        options.mProgressInterval = std::chrono::seconds(0);
+
+        AwsDoc::BulkDeleter<int> deleter(deleteBatch, options);
+        for (size_t key = 0; key < KEY_COUNT; ++key) {
+            deleter.push(static_cast<int>(key));
+        }
+        ASSERT_FALSE(deleter.finish());
+
+        AwsDoc::BulkDeleterMetrics metrics = deleter.getMetrics();
+        ASSERT_EQ(metrics.mQueued, KEY_COUNT);
+        ASSERT_EQ(metrics.mDeleted, KEY_COUNT - 2);
+        ASSERT_EQ(metrics.mFailed, 2u);
+        // 15 keys are throttled once, and ALWAYS_RETRIED_KEY is retried mMaxRetries times.
+        ASSERT_EQ(metrics.mRetriedKeys, 15u + options.mMaxRetries);
+        ASSERT_GT(metrics.mThrottledBatches, 0u);
+        ASSERT_GE(metrics.mBatchesSent, KEY_COUNT / options.mBatchSize);
+        ASSERT_GE(metrics.mConcurrency, 1u);
+        ASSERT_LE(metrics.mConcurrency, options.mMaxConcurrency);
+
+        ASSERT_LE(largestBatch, options.mBatchSize);
+        ASSERT_EQ(deletedKeys.size(), KEY_COUNT - 2);
+        ASSERT_EQ(deletedKeys.count(ALWAYS_RETRIED_KEY), 0u);
+        ASSERT_EQ(deletedKeys.count(FAILED_KEY), 0u);
+    }
+} // namespace AwsDocTest
@@ -10,11 +10,18 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
+#include <mutex>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/core/utils/threading/Executor.h>
 #include "awsdoc/s3/s3_examples.h"
+#include "awsdoc/s3/list_objects_pager.h"
+#include "awsdoc/client_registry.h"
 #include "S3_GTests.h"
 
 static const int BUCKETS_NEEDED = 1;
+static const char ALLOCATION_TAG[] = "list_objects_test";
 
 namespace AwsDocTest {
     // NOLINTNEXTLINE(readability-named-parameter)
@@ -25,4 +32,116 @@ namespace AwsDocTest {
         bool result = AwsDoc::S3::ListObjects(bucketNames[0], *s_clientConfig);
         EXPECT_TRUE(result);
     }
+
+    // Calls with the client configuration share one client from the client
+    // registry, even when each configuration has its own executor.
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, list_objects_shared_client_3_) {
+        const int CALLS = 5;
+        MockHTTP mockHttp;
+        for (int i = 0; i < CALLS; ++i) {
+            bool result = mockHttp.addResponseWithBody("mock_input/ListObjects.xml");
+            ASSERT_TRUE(result) << preconditionError() << std::endl;
+        }
+
+        for (int i = 0; i < CALLS; ++i) {
+            Aws::Client::ClientConfiguration clientConfig(*s_clientConfig);
+            clientConfig.executor = Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>(
+                    ALLOCATION_TAG, 1);
+            ASSERT_TRUE(AwsDoc::S3::ListObjects("test_bucket", clientConfig));
+        }
+
+        EXPECT_EQ(AwsDoc::ClientRegistry::size(), 1u);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, list_objects_pager_3_) {
+        MockHTTP mockHttp;
+        bool result = mockHttp.addResponseWithBody("mock_input/ListObjectsV2Page1.xml");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/ListObjectsV2Page2.xml");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+
+        Aws::S3::S3Client s3Client(*s_clientConfig);
+        std::vector<Aws::String> keys;
+        {
+            AwsDoc::S3::ObjectPager pager(s3Client, "test_bucket", "", 2);
+            for (const Aws::S3::Model::Object &object: pager) {
+                keys.push_back(object.GetKey());
+            }
+
+            EXPECT_FALSE(pager.hasError());
+            EXPECT_EQ(pager.pageCount(), 2u);
+        }
+
+        ASSERT_EQ(keys.size(), 3u);
+        EXPECT_EQ(keys[0], "images/image-1.jpg");
+        EXPECT_EQ(keys[2], "images/image-3.jpg");
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, list_objects_parallel_3_) {
+        MockHTTP mockHttp;
+        bool result = mockHttp.addResponseWithBody("mock_input/ListObjectsV2Prefixes.xml");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/ListObjectsV2Page1.xml");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+        result = mockHttp.addResponseWithBody("mock_input/ListObjectsV2Page2.xml");
+        ASSERT_TRUE(result) << preconditionError() << std::endl;
+
+        Aws::S3::S3Client s3Client(*s_clientConfig);
+        std::mutex keysMutex;
+        std::vector<Aws::String> keys;
+
+        // The mock HTTP client returns responses in order, so list one prefix at a time.
+        result = AwsDoc::S3::ListObjectsParallel(
+                s3Client, "test_bucket", "", "/", 1,
+                [&keysMutex, &keys](const Aws::S3::Model::Object &object) {
+                    std::lock_guard<std::mutex> lock(keysMutex);
+                    keys.push_back(object.GetKey());
+                });
+
+        EXPECT_TRUE(result);
+        EXPECT_EQ(keys.size(), 4u);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, list_objects_parallel_threads_3_) {
+        const std::vector<Aws::String> objectKeys = {
+                "readme.txt", "a/1.txt", "a/2.txt", "a/x/1.txt", "a/x/y/1.txt",
+                "a/x/y/2.txt", "b/1.txt", "b/z/w/1.txt", "c/v/1.txt", "c/v/2.txt"};
+        MockS3ListService mockS3ListService(objectKeys);
+
+        // Fixed credentials, so no credential requests are sent to the mock service.
+        Aws::S3::S3Client s3Client(
+                Aws::Auth::AWSCredentials("AKIDEXAMPLE",
+                                          "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY"),
+                Aws::MakeShared<Aws::S3::S3EndpointProvider>(ALLOCATION_TAG),
+                *s_clientConfig);
+        std::mutex keysMutex;
+        std::vector<Aws::String> keys;
+
+        bool result = AwsDoc::S3::ListObjectsParallel(
+                s3Client, "test_bucket", "", "/", 4,
+                [&keysMutex, &keys](const Aws::S3::Model::Object &object) {
+                    std::lock_guard<std::mutex> lock(keysMutex);
+                    keys.push_back(object.GetKey());
+                });
+        EXPECT_TRUE(result);
+
+        // Every object is listed once.
+        std::vector<Aws::String> expectedKeys = objectKeys;
+        std::sort(expectedKeys.begin(), expectedKeys.end());
+        std::sort(keys.begin(), keys.end());
+        EXPECT_EQ(keys, expectedKeys);
+
+        // Prefixes below the first level are listed separately.
+        std::vector<Aws::String> prefixes = mockS3ListService.getRequestedPrefixes();
+        std::sort(prefixes.begin(), prefixes.end());
+        std::vector<Aws::String> expectedPrefixes = {
+                "", "a/", "a/x/", "a/x/y/", "b/", "b/z/", "b/z/w/", "c/", "c/v/"};
+        EXPECT_EQ(prefixes, expectedPrefixes);
+
+        EXPECT_GT(mockS3ListService.getMaxConcurrentRequests(), 1u);
+    }
 } // namespace AwsDocTest
@@ -0,0 +1,52 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Test types are indicated by the test label ending.
+ *
+ * _1_ Requires credentials, permissions, and AWS resources.
+ * _2_ Requires credentials and permissions.
+ * _3_ Does not require credentials.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/s3/S3Client.h>
+#include "awsdoc/s3/s3_examples.h"
+#include "S3_GTests.h"
+
+static const char ALLOCATION_TAG[] = "presigned_url_batch_test";
+
+namespace AwsDocTest {
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(S3_GTests, presigned_url_batch_3_) {
+        // Signing does not send requests, so fixed credentials are enough.
+        Aws::S3::S3Client client(
+                Aws::Auth::AWSCredentials("AKIDEXAMPLE",
+                                          "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY"),
+                Aws::MakeShared<Aws::S3::S3EndpointProvider>(ALLOCATION_TAG),
+                *s_clientConfig);
+
+        std::vector<AwsDoc::S3::PresignedUrlRequest> requests;
+        for (int i = 0; i < 500; ++i) {
+            requests.emplace_back("test-bucket",
+                                  "test_key_" + Aws::Utils::StringUtils::to_string(i),
+                                  i % 2 == 0 ? Aws::Http::HttpMethod::HTTP_GET
+                                             : Aws::Http::HttpMethod::HTTP_PUT,
+                                  600);
+        }
+
+        std::vector<Aws::String> urls;
+        bool result = AwsDoc::S3::GeneratePreSignedURLs(requests, urls, 4, client);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(urls.size(), requests.size());
+
+        for (size_t i = 0; i < urls.size(); ++i) {
+            // Each URL is in the position of its request.
+            EXPECT_NE(urls[i].find("/" + requests[i].mKey + "?"), Aws::String::npos) << urls[i];
+            EXPECT_NE(urls[i].find("X-Amz-Signature="), Aws::String::npos) << urls[i];
+            EXPECT_NE(urls[i].find("X-Amz-Expires=600"), Aws::String::npos) << urls[i];
+        }
+    }
+} // namespace AwsDocTest
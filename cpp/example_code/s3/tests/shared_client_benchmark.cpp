@@ -0,0 +1,131 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+/**
+ *  shared_client_benchmark.cpp
+ *
+ *  The code in this file compares the per-call latency of ListObjects when a
+ *  client is constructed for every call with the client configuration overload,
+ *  which reuses a client from the client registry. The requests are answered by
+ *  a mock HTTP client, so no AWS resources are used.
+ *
+ * To run the example, refer to the instructions in the README.
+ *
+ */
+
+#include "awsdoc/s3/s3_examples.h"
+#include "awsdoc/client_registry.h"
+#include <aws/core/Aws.h>
+#include <aws/core/http/HttpClientFactory.h>
+#include <aws/core/http/standard/StandardHttpResponse.h>
+#include <aws/core/utils/DateTime.h>
+#include <aws/s3/S3Client.h>
+#include <aws/testing/mocks/http/MockHttpClient.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+static const char ALLOCATION_TAG[] = "S3_SHARED_CLIENT_BENCHMARK";
+
+/*
+ * Subclass MockHttpClient to answer credential requests with mock credentials,
+ * and every other request with a ListObjects response.
+ */
+class ListObjectsMockHTTPClient : public MockHttpClient {
+public:
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+
+        if (request->GetURIString().find("/credentials/") != std::string::npos) {
+            Aws::Utils::DateTime expiration =
+                    Aws::Utils::DateTime::Now() + std::chrono::milliseconds(60000);
+            response->AddHeader("Content-Type", "text/json");
+            response->GetResponseBody() << "{"
+                                        << R"("AccessKeyId":"ABCDEFGHIJK",)"
+                                        << R"("SecretAccessKey":"ABCDEFGHIJK",)"
+                                        << R"("Token":"ABCDEFGHIJK==","Expiration":")"
+                                        << expiration.ToGmtString(Aws::Utils::DateFormat::ISO_8601)
+                                        << "\"}";
+        }
+        else {
+            response->AddHeader("Content-Type", "application/xml");
+            response->GetResponseBody()
+                    << R"(<?xml version="1.0" encoding="UTF-8"?>)"
+                    << R"(<ListBucketResult xmlns="http://s3.amazonaws.com/doc/2006-03-01/">)"
+                    << "<Name>test_bucket</Name><IsTruncated>false</IsTruncated>"
+                    << "<Contents><Key>my-image.jpg</Key><Size>434234</Size></Contents>"
+                    << "</ListBucketResult>";
+        }
+
+        return response;
+    }
+};
+
+/*
+ *
+ *  main function
+ *
+ *  Usage: 'run_shared_client_benchmark [calls]'
+ *
+ */
+
+int main(int argc, char **argv) {
+    int calls = 50;
+    if (argc > 1) {
+        calls = std::max(1, std::atoi(argv[1]));
+    }
+
+    Aws::SDKOptions options;
+    InitAPI(options);
+    int exitCode = 0;
+    {
+        std::shared_ptr<MockHttpClient> mockHttpClient = Aws::MakeShared<ListObjectsMockHTTPClient>(
+                ALLOCATION_TAG);
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(
+                ALLOCATION_TAG);
+        mockHttpClientFactory->SetClient(mockHttpClient);
+        Aws::Http::SetHttpClientFactory(mockHttpClientFactory);
+
+        Aws::Client::ClientConfiguration clientConfig;
+        clientConfig.region = "us-east-1";
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls && exitCode == 0; ++i) {
+            Aws::S3::S3Client s3Client(clientConfig);
+            if (!AwsDoc::S3::ListObjects("test_bucket", s3Client)) {
+                exitCode = 1;
+            }
+        }
+        double perCallClientMicros = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count() / calls;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls && exitCode == 0; ++i) {
+            if (!AwsDoc::S3::ListObjects("test_bucket", clientConfig)) {
+                exitCode = 1;
+            }
+        }
+        double sharedClientMicros = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count() / calls;
+
+        if (exitCode == 0) {
+            std::cout << "ListObjects latency per call, new client: " << perCallClientMicros
+                      << " us, shared client: " << sharedClientMicros << " us." << std::endl;
+        }
+        else {
+            std::cerr << "A ListObjects call failed." << std::endl;
+        }
+
+        AwsDoc::ClientRegistry::clear();
+        Aws::Http::CleanupHttp();
+        Aws::Http::InitHttp();
+    }
+    ShutdownAPI(options);
+
+    return exitCode;
+}
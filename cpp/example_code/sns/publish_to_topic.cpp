@@ -15,7 +15,10 @@
 #include <aws/core/Aws.h>
 #include <aws/sns/SNSClient.h>
 #include <aws/sns/model/PublishRequest.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include "awsdoc/sns_batch_publisher.h"
 #include "sns_samples.h"
 
 // snippet-start:[sns.cpp.publish_to_topic.code]
@@ -51,11 +54,56 @@ bool AwsDoc::SNS::publishToTopic(const Aws::String &message,
 }
 // snippet-end:[sns.cpp.publish_to_topic.code]
 
+// snippet-start:[sns.cpp.publish_batch_to_topic.code]
+//! Send messages to an Amazon SNS topic in batches.
+/*!
+  \param messages: The messages to publish.
+  \param topicARN: The ARN for an Amazon SNS topic.
+  \param messageGroupId: The message group ID for a FIFO topic, ignored if empty.
+  \param clientConfiguration: AWS client configuration.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::SNS::publishBatchToTopic(const Aws::Vector<Aws::String> &messages,
+                                      const Aws::String &topicARN,
+                                      const Aws::String &messageGroupId,
+                                      const Aws::Client::ClientConfiguration &clientConfiguration) {
+    BatchPublisher::Options options;
+    // Each in-flight batch holds a connection.
+    Aws::Client::ClientConfiguration publisherConfiguration(clientConfiguration);
+    publisherConfiguration.maxConnections = std::max<unsigned>(
+            publisherConfiguration.maxConnections,
+            static_cast<unsigned>(options.mMaxInFlightBatches));
+    Aws::SNS::SNSClient snsClient(publisherConfiguration);
+
+    BatchPublisher publisher(snsClient, topicARN, options);
+    for (const Aws::String &message: messages) {
+        publisher.publish(message, messageGroupId);
+    }
+    bool result = publisher.flush();
+
+    const BatchPublisher::Metrics metrics = publisher.getMetrics();
+    std::cout << "Published " << metrics.mPublished << " of " << messages.size()
+              << " messages in " << metrics.mBatchesSent << " batches, with "
+              << metrics.mRetriedEntries << " retried entries." << std::endl;
+    std::cout << "Latency (ms): p50 " << metrics.mLatencyP50Ms << ", p90 "
+              << metrics.mLatencyP90Ms << ", p99 " << metrics.mLatencyP99Ms
+              << ", max " << metrics.mLatencyMaxMs << std::endl;
+    if (!result) {
+        std::cerr << "Error: " << metrics.mFailed << " messages were not published."
+                  << std::endl;
+    }
+
+    return result;
+}
+// snippet-end:[sns.cpp.publish_batch_to_topic.code]
+
 /*
  *
  *  main function
  *
- *  Usage: 'run_publish_to_topic <message_value> <topic_arn_value>'
+ *  Usage: 'run_publish_to_topic <message_value> <topic_arn_value> [<count> [<message_group_id>]]'
+ *
+ *  With a count, the message is published count times using PublishBatch.
  *
  *  Prerequisites: An existing SNS topic and its ARN.
  *
@@ -64,9 +112,9 @@ bool AwsDoc::SNS::publishToTopic(const Aws::String &message,
 #ifndef TESTING_BUILD
 
 int main(int argc, char **argv) {
-    if (argc != 3) {
+    if (argc < 3 || argc > 5) {
         std::cout << "Usage: run_publish_to_topic <message_value> <topic_arn_value>"
-                  << std::endl;
+                  << " [<count> [<message_group_id>]]" << std::endl;
         return 1;
     }
 
@@ -80,7 +128,15 @@ int main(int argc, char **argv) {
         // Optional: Set to the AWS Region (overrides config file).
         // clientConfig.region = "us-east-1";
 
-        AwsDoc::SNS::publishToTopic(message, topicArn, clientConfig);
+        if (argc > 3) {
+            Aws::Vector<Aws::String> messages(std::max(std::atoi(argv[3]), 1), message);
+            Aws::String messageGroupId(argc > 4 ? argv[4] : "");
+            AwsDoc::SNS::publishBatchToTopic(messages, topicArn, messageGroupId,
+                                             clientConfig);
+        }
+        else {
+            AwsDoc::SNS::publishToTopic(message, topicArn, clientConfig);
+        }
     }
 
     Aws::ShutdownAPI(options);
@@ -91,6 +91,19 @@ namespace AwsDoc {
                             const Aws::String &topicARN,
                             const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Send messages to an Amazon SNS topic in batches.
+        /*!
+          \param messages: The messages to publish.
+          \param topicARN: The ARN for an Amazon SNS topic.
+          \param messageGroupId: The message group ID for a FIFO topic, ignored if empty.
+          \param clientConfiguration: AWS client configuration.
+          \return bool: Function succeeded.
+         */
+        bool publishBatchToTopic(const Aws::Vector<Aws::String> &messages,
+                                 const Aws::String &topicARN,
+                                 const Aws::String &messageGroupId,
+                                 const Aws::Client::ClientConfiguration &clientConfiguration);
+
         //! Set the default settings for sending SMS messages.
         /*!
           \param smsType: The type of SMS message that you will send by default.
@@ -10,6 +10,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <map>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/sns/SNSClient.h>
+#include "awsdoc/sns_batch_publisher.h"
 #include "sns_samples.h"
 #include "sns_gtests.h"
 
@@ -24,4 +28,78 @@ namespace AwsDocTest {
         ASSERT_TRUE(result);
     }
 
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(SNS_GTests, publish_batch_to_topic_3_) {
+        const size_t MESSAGE_COUNT = 25;
+        const size_t MAX_BATCH_ENTRIES = AwsDoc::SNS::BatchPublisher::MAX_BATCH_ENTRIES;
+
+        // One entry fails, and it is then sent again in a new batch.
+        MockSNSService mockSNSService({"Message 3"}, {});
+        Aws::Vector<Aws::String> messages;
+        for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+            messages.push_back("Message " + std::to_string(i));
+        }
+
+        Aws::String topicARN = "arn:aws:sns:us-test:123456789012:MyTopic";
+        bool result = AwsDoc::SNS::publishBatchToTopic(messages, topicARN, "",
+                                                       *s_clientConfig);
+        ASSERT_TRUE(result);
+
+        // Every message is sent once, except the failed one, which is sent twice.
+        std::map<Aws::String, size_t> sendCounts;
+        for (const std::vector<Aws::String> &batch: mockSNSService.getPublishBatches()) {
+            EXPECT_LE(batch.size(), MAX_BATCH_ENTRIES);
+            for (const Aws::String &message: batch) {
+                ++sendCounts[message];
+            }
+        }
+        ASSERT_EQ(sendCounts.size(), MESSAGE_COUNT);
+        for (const Aws::String &message: messages) {
+            EXPECT_EQ(sendCounts[message], message == "Message 3" ? 2u : 1u) << message;
+        }
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(SNS_GTests, publish_batch_to_fifo_topic_3_) {
+        const size_t MESSAGE_COUNT = 12;
+
+        // The second entry of the group fails once, so it is sent again with the
+        // later entries of the group in its batch. The last entry is rejected.
+        MockSNSService mockSNSService({"Message 1"}, {"Message 11"});
+        Aws::Auth::AWSCredentials credentials("MOCK_ACCESS_KEY", "MOCK_SECRET_KEY");
+        Aws::SNS::SNSClient snsClient(credentials, *s_clientConfig);
+
+        AwsDoc::SNS::BatchPublisher::Metrics metrics;
+        {
+            // A long batch delay, so the first batch is sent only when it is full.
+            AwsDoc::SNS::BatchPublisher::Options options;
+            options.mMaxBatchDelay = std::chrono::seconds(5);
+            AwsDoc::SNS::BatchPublisher publisher(
+                    snsClient, "arn:aws:sns:us-test:123456789012:MyTopic.fifo", options);
+            for (size_t i = 0; i < MESSAGE_COUNT; ++i) {
+                publisher.publish("Message " + std::to_string(i), "Gtest_group");
+            }
+            ASSERT_FALSE(publisher.flush());
+            metrics = publisher.getMetrics();
+        }
+
+        auto messageRange = [](size_t first, size_t last) {
+            std::vector<Aws::String> range;
+            for (size_t i = first; i <= last; ++i) {
+                range.push_back("Message " + std::to_string(i));
+            }
+            return range;
+        };
+        std::vector<std::vector<Aws::String>> batches = mockSNSService.getPublishBatches();
+        ASSERT_EQ(batches.size(), 3u);
+        EXPECT_EQ(batches[0], messageRange(0, 9));
+        EXPECT_EQ(batches[1], messageRange(1, 9));
+        EXPECT_EQ(batches[2], messageRange(10, 11));
+
+        EXPECT_EQ(metrics.mPublished, MESSAGE_COUNT - 1);
+        EXPECT_EQ(metrics.mFailed, 1u);
+        EXPECT_EQ(metrics.mBatchesSent, 3u);
+        EXPECT_EQ(metrics.mRetriedEntries, 9u);
+    }
+
 } // namespace AwsDocTest
@@ -10,7 +10,11 @@
 #include <aws/sns/model/SubscribeRequest.h>
 #include <aws/sns/model/UnsubscribeRequest.h>
 #include <aws/core/utils/UUID.h>
+#include <aws/core/utils/StringUtils.h>
 #include <aws/testing/mocks/http/MockHttpClient.h>
+#include <iterator>
+#include <map>
+#include <mutex>
 
 namespace AwsDocTest {
     static const char ALLOCATION_TAG[] = "SNS_GTEST";
@@ -69,6 +73,103 @@ namespace AwsDocTest {
     };
 }
 
+/*
+ * Subclass MockHttpClient to generate SNS responses, instead of returning
+ * stored responses, so a test can make any number of requests. The SDK sends
+ * SNS requests with the AWS query protocol.
+ */
+class AwsDocTest::SNSServiceMockHTTPClient : public MockHttpClient {
+public:
+    SNSServiceMockHTTPClient(const std::set<Aws::String> &failOnce,
+                             const std::set<Aws::String> &rejected) :
+            mFailOnce(failOnce), mRejected(rejected) {}
+
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->AddHeader("Content-Type", "text/xml");
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+
+        // The parameters, for example "PublishBatchRequestEntries.member.1.Message".
+        std::map<Aws::String, Aws::String> parameters;
+        std::shared_ptr<Aws::IOStream> content = request->GetContentBody();
+        if (content) {
+            content->clear();
+            content->seekg(0);
+            Aws::String body((std::istreambuf_iterator<char>(*content)),
+                             std::istreambuf_iterator<char>());
+            for (const Aws::String &parameter: Aws::Utils::StringUtils::Split(body, '&')) {
+                size_t equals = parameter.find('=');
+                if (equals != Aws::String::npos) {
+                    parameters[parameter.substr(0, equals)] =
+                            Aws::Utils::StringUtils::URLDecode(
+                                    parameter.substr(equals + 1).c_str());
+                }
+            }
+        }
+
+        if (parameters["Action"] != "PublishBatch") {
+            response->SetResponseCode(Aws::Http::HttpResponseCode::BAD_REQUEST);
+            return response;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<Aws::String> messages;
+        Aws::StringStream successful;
+        Aws::StringStream failed;
+        for (size_t member = 1;; ++member) {
+            const Aws::String prefix = "PublishBatchRequestEntries.member." +
+                                       std::to_string(member) + ".";
+            auto id = parameters.find(prefix + "Id");
+            if (id == parameters.end()) {
+                break;
+            }
+            const Aws::String &message = parameters[prefix + "Message"];
+            messages.push_back(message);
+
+            if (mRejected.count(message) > 0) {
+                failed << "<member><Id>" << id->second << "</Id>"
+                       << "<Code>InvalidParameter</Code><Message>Rejected</Message>"
+                       << "<SenderFault>true</SenderFault></member>";
+            }
+            else if (mFailOnce.count(message) > 0 && mFailed.insert(message).second) {
+                failed << "<member><Id>" << id->second << "</Id>"
+                       << "<Code>InternalError</Code><Message>Internal error</Message>"
+                       << "<SenderFault>false</SenderFault></member>";
+            }
+            else {
+                successful << "<member><Id>" << id->second << "</Id>"
+                           << "<MessageId>message-" << member << "</MessageId></member>";
+            }
+        }
+        mPublishBatches.push_back(messages);
+
+        response->GetResponseBody()
+                << R"(<PublishBatchResponse xmlns="http://sns.amazonaws.com/doc/2010-03-31/">)"
+                << "<PublishBatchResult><Successful>" << successful.str()
+                << "</Successful><Failed>" << failed.str() << "</Failed></PublishBatchResult>"
+                << "<ResponseMetadata><RequestId>request-" << mPublishBatches.size()
+                << "</RequestId></ResponseMetadata></PublishBatchResponse>";
+
+        return response;
+    }
+
+    std::vector<std::vector<Aws::String>> getPublishBatches() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPublishBatches;
+    }
+
+private:
+    const std::set<Aws::String> mFailOnce;
+    const std::set<Aws::String> mRejected;
+    mutable std::mutex mMutex;
+    mutable std::set<Aws::String> mFailed;
+    mutable std::vector<std::vector<Aws::String>> mPublishBatches;
+};
+
 void AwsDocTest::SNS_GTests::SetUpTestSuite() {
     InitAPI(s_options);
 
@@ -304,3 +405,21 @@ bool AwsDocTest::MockHTTP::addResponseWithBody(const std::string &fileName,
 
     return false;
 }
+
+AwsDocTest::MockSNSService::MockSNSService(const std::set<Aws::String> &failOnce,
+                                           const std::set<Aws::String> &rejected) {
+    mockHttpClient = Aws::MakeShared<SNSServiceMockHTTPClient>(ALLOCATION_TAG, failOnce,
+                                                               rejected);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockSNSService::~MockSNSService() {
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
+
+std::vector<std::vector<Aws::String>> AwsDocTest::MockSNSService::getPublishBatches() const {
+    return mockHttpClient->getPublishBatches();
+}
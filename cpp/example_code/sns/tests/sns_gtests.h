@@ -7,6 +7,8 @@
 
 #include <aws/core/Aws.h>
 #include <memory>
+#include <set>
+#include <vector>
 #include <gtest/gtest.h>
 #include <aws/core/http/standard/StandardHttpRequest.h>
 
@@ -85,6 +87,30 @@ namespace AwsDocTest {
         std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
         std::shared_ptr<Aws::Http::HttpRequest> requestTmp;
     }; // MockHTTP
+
+    class SNSServiceMockHTTPClient;
+
+    /*
+     * A mock SNS service, for tests which make many requests. PublishBatch
+     * accepts every entry, except that the messages in failOnce fail with an
+     * internal error the first time they are sent, and the messages in rejected
+     * always fail with a sender fault. The messages of each request are recorded.
+     */
+    class MockSNSService {
+    public:
+        MockSNSService(const std::set<Aws::String> &failOnce,
+                       const std::set<Aws::String> &rejected);
+
+        virtual ~MockSNSService();
+
+        // The messages of each PublishBatch request, in order.
+        std::vector<std::vector<Aws::String>> getPublishBatches() const;
+
+    private:
+
+        std::shared_ptr<SNSServiceMockHTTPClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockSNSService
 } // AwsDocTest
 
 #endif //S3_EXAMPLES_S3_GTESTS_H
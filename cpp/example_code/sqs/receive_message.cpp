@@ -18,6 +18,10 @@
 #include <aws/sqs/model/ReceiveMessageRequest.h>
 #include <iostream>
 // snippet-end:[sqs.cpp.receive_message.inc]
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include "awsdoc/sqs_message_consumer.h"
 #include "sqs_samples.h"
 
 // snippet-start:[cpp.example_code.sqs.ReceiveMessage]
@@ -64,11 +68,63 @@ bool AwsDoc::SQS::receiveMessage(const Aws::String &queueUrl,
 }
 // snippet-end:[cpp.example_code.sqs.ReceiveMessage]
 
+//! Receive and delete all the messages in an Amazon SQS queue using
+//! multiple receiver and worker threads.
+/*!
+  \param queueUrl: An Amazon SQS queue URL.
+  \param receiverThreads: The number of threads receiving messages.
+  \param workerThreads: The number of threads processing messages.
+  \param clientConfiguration: AWS client configuration.
+  \return bool: Function succeeded.
+ */
+bool AwsDoc::SQS::consumeMessages(const Aws::String &queueUrl,
+                                  size_t receiverThreads,
+                                  size_t workerThreads,
+                                  const Aws::Client::ClientConfiguration &clientConfiguration) {
+    // Receivers, the heartbeat, and the delete batcher each hold a connection.
+    Aws::Client::ClientConfiguration consumerConfiguration(clientConfiguration);
+    consumerConfiguration.maxConnections = std::max<unsigned>(
+            consumerConfiguration.maxConnections,
+            static_cast<unsigned>(receiverThreads + 2));
+    Aws::SQS::SQSClient sqsClient(consumerConfiguration);
+
+    MessageConsumer::Options options;
+    options.mReceiverThreads = receiverThreads;
+    options.mWorkerThreads = workerThreads;
+    options.mWaitTimeSeconds = 1;
+    options.mStopWhenEmpty = true;
+
+    std::mutex outputMutex;
+    MessageConsumer consumer(sqsClient, queueUrl,
+                             [&outputMutex](const Aws::SQS::Model::Message &message) {
+                                 std::lock_guard<std::mutex> lock(outputMutex);
+                                 std::cout << "  MessageId: " << message.GetMessageId()
+                                           << std::endl;
+                                 return true;
+                             }, options);
+    consumer.start();
+    consumer.wait();
+
+    const MessageConsumer::Metrics metrics = consumer.getMetrics();
+    std::cout << "Received " << metrics.mReceived << " messages, deleted "
+              << metrics.mDeleted << " (" << metrics.mThroughput
+              << " messages/s)." << std::endl;
+    if (metrics.mDeleteErrors > 0) {
+        std::cerr << "Error: " << metrics.mDeleteErrors
+                  << " messages could not be deleted from queue " << queueUrl
+                  << std::endl;
+    }
+
+    return metrics.mDeleteErrors == 0;
+}
+
 /*
 *
 *  main function
 *
-*  Usage: 'run_receive_message <queue_url>'
+*  Usage: 'run_receive_message <queue_url> [--drain [receivers] [workers]]'
+*
+*  With --drain, all the messages in the queue are received and deleted.
 *
 *  Prerequisites: An existing Amazon SQS queue.
 *
@@ -77,8 +133,10 @@ bool AwsDoc::SQS::receiveMessage(const Aws::String &queueUrl,
 #ifndef TESTING_BUILD
 
 int main(int argc, char **argv) {
-    if (argc != 2) {
-        std::cout << "Usage: run_receive_message <queue_url>" << std::endl;
+    const Aws::String DRAIN_OPTION("--drain");
+    if (argc < 2 || (argc > 2 && argv[2] != DRAIN_OPTION)) {
+        std::cout << "Usage: run_receive_message <queue_url> [--drain [receivers] [workers]]"
+                  << std::endl;
         return 1;
     }
 
@@ -92,7 +150,14 @@ int main(int argc, char **argv) {
         // clientConfig.region = "us-east-1";
         // snippet-end:[cpp.example_code.sqs.ReceiveMessage.config]
 
-        AwsDoc::SQS::receiveMessage(queue_url, clientConfig);
+        if (argc > 2) {
+            size_t receivers = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 2;
+            size_t workers = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 8;
+            AwsDoc::SQS::consumeMessages(queue_url, receivers, workers, clientConfig);
+        }
+        else {
+            AwsDoc::SQS::receiveMessage(queue_url, clientConfig);
+        }
     }
     Aws::ShutdownAPI(options);
     return 0;
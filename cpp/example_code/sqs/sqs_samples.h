@@ -103,6 +103,20 @@ namespace AwsDoc {
         bool receiveMessage(const Aws::String &queueUrl,
                             const Aws::Client::ClientConfiguration &clientConfiguration);
 
+        //! Receive and delete all the messages in an Amazon SQS queue using
+        //! multiple receiver and worker threads.
+        /*!
+          \param queueUrl: An Amazon SQS queue URL.
+          \param receiverThreads: The number of threads receiving messages.
+          \param workerThreads: The number of threads processing messages.
+          \param clientConfiguration: AWS client configuration.
+          \return bool: Function succeeded.
+         */
+        bool consumeMessages(const Aws::String &queueUrl,
+                             size_t receiverThreads,
+                             size_t workerThreads,
+                             const Aws::Client::ClientConfiguration &clientConfiguration);
+
         //! Receive a message from an Amazon SQS queue specifying the wait time.
         /*!
           \param queueUrl: An Amazon SQS queue URL.
@@ -10,9 +10,17 @@
  */
 
 #include <gtest/gtest.h>
+#include <aws/core/auth/AWSCredentials.h>
+#include <aws/sqs/SQSClient.h>
+#include <aws/sqs/SQSEndpointProvider.h>
+#include <algorithm>
+#include <thread>
+#include "awsdoc/sqs_message_consumer.h"
 #include "sqs_samples.h"
 #include "sqs_gtests.h"
 
+static const char ALLOCATION_TAG[] = "receive_message_test";
+
 namespace AwsDocTest {
     // NOLINTNEXTLINE(readability-named-parameter)
     TEST_F(SQS_GTests, receive_message_2_) {
@@ -22,4 +30,68 @@ namespace AwsDocTest {
         ASSERT_TRUE(result);
     }
 
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(SQS_GTests, consume_messages_2_) {
+        Aws::String queueUrl = getCachedQueueUrl();
+        ASSERT_FALSE(queueUrl.empty()) << preconditionError() << std::endl;
+        auto result = AwsDoc::SQS::consumeMessages(queueUrl, 2, 4, *s_clientConfig);
+        ASSERT_TRUE(result);
+    }
+
+    // NOLINTNEXTLINE(readability-named-parameter)
+    TEST_F(SQS_GTests, message_consumer_3_) {
+        const size_t MESSAGE_COUNT = 35;
+        MockSQSService mockSQSService(MESSAGE_COUNT);
+
+        // Fixed credentials, so no credential requests are sent to the mock service.
+        Aws::SQS::SQSClient sqsClient(
+                Aws::Auth::AWSCredentials("AKIDEXAMPLE",
+                                          "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY"),
+                Aws::MakeShared<Aws::SQS::SQSEndpointProvider>(ALLOCATION_TAG),
+                *s_clientConfig);
+
+        // The first message is handled for longer than its visibility timeout,
+        // so the heartbeat must extend it.
+        AwsDoc::SQS::MessageConsumer::Options options;
+        options.mReceiverThreads = 1;
+        options.mWorkerThreads = 4;
+        options.mBufferCapacity = 10;
+        options.mWaitTimeSeconds = 0;
+        options.mVisibilityTimeoutSeconds = 3;
+        options.mHeartbeatInterval = std::chrono::seconds(1);
+        options.mStopWhenEmpty = true;
+        AwsDoc::SQS::MessageConsumer consumer(
+                sqsClient, "https://sqs.us-east-1.amazonaws.com/123456789012/test-queue",
+                [](const Aws::SQS::Model::Message &message) {
+                    if (message.GetMessageId() == "message-0") {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(3500));
+                    }
+                    return true;
+                }, options);
+        consumer.start();
+        consumer.wait();
+
+        AwsDoc::SQS::MessageConsumer::Metrics metrics = consumer.getMetrics();
+        EXPECT_EQ(metrics.mReceived, MESSAGE_COUNT);
+        EXPECT_EQ(metrics.mProcessed, MESSAGE_COUNT);
+        EXPECT_EQ(metrics.mDeleted, MESSAGE_COUNT);
+        EXPECT_EQ(metrics.mDeleteErrors, 0u);
+        EXPECT_EQ(metrics.mInFlight, 0u);
+
+        // Receipt handles are deleted in batches of at most 10.
+        const size_t maxBatchEntries = AwsDoc::SQS::MessageConsumer::MAX_BATCH_ENTRIES;
+        std::vector<size_t> deleteBatchSizes = mockSQSService.getDeleteBatchSizes();
+        size_t deleted = 0;
+        for (size_t batchSize: deleteBatchSizes) {
+            EXPECT_GE(batchSize, 1u);
+            EXPECT_LE(batchSize, maxBatchEntries);
+            deleted += batchSize;
+        }
+        EXPECT_EQ(deleted, MESSAGE_COUNT);
+
+        std::vector<Aws::String> extended = mockSQSService.getExtendedReceiptHandles();
+        EXPECT_NE(std::find(extended.begin(), extended.end(), "receipt-0"), extended.end());
+        EXPECT_GE(metrics.mVisibilityExtensions, 1u);
+    }
+
 } // namespace AwsDocTest
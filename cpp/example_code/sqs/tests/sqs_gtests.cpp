@@ -12,10 +12,106 @@
 #include <aws/sqs/model/ReceiveMessageRequest.h>
 #include <aws/sqs/model/SendMessageRequest.h>
 #include <aws/sqs/model/GetQueueAttributesRequest.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <aws/testing/mocks/http/MockHttpClient.h>
+#include <algorithm>
+#include <mutex>
 
 Aws::SDKOptions AwsDocTest::SQS_GTests::s_options;
 Aws::String AwsDocTest::SQS_GTests::s_cachedQueueUrl;
 std::unique_ptr<Aws::Client::ClientConfiguration> AwsDocTest::SQS_GTests::s_clientConfig;
+static const char ALLOCATION_TAG[] = "SQS_GTEST";
+
+/*
+ * Subclass MockHttpClient to generate SQS responses, instead of returning
+ * stored responses, so a test can make any number of requests. The SDK sends
+ * SQS requests with the AWS JSON protocol.
+ */
+class AwsDocTest::SQSServiceMockHTTPClient : public MockHttpClient {
+public:
+    explicit SQSServiceMockHTTPClient(size_t messageCount) :
+            mMessageCount(messageCount) {}
+
+    std::shared_ptr<Aws::Http::HttpResponse>
+    MakeRequest(const std::shared_ptr<Aws::Http::HttpRequest> &request,
+                Aws::Utils::RateLimits::RateLimiterInterface *,
+                Aws::Utils::RateLimits::RateLimiterInterface *) const override {
+        std::shared_ptr<Aws::Http::Standard::StandardHttpResponse> response = Aws::MakeShared<Aws::Http::Standard::StandardHttpResponse>(
+                ALLOCATION_TAG, request);
+        response->AddHeader("Content-Type", "application/x-amz-json-1.0");
+        response->SetResponseCode(Aws::Http::HttpResponseCode::OK);
+
+        Aws::String target;
+        if (request->HasHeader("x-amz-target")) {
+            target = request->GetHeaderValue("x-amz-target");
+        }
+        Aws::Utils::Json::JsonValue json;
+        std::shared_ptr<Aws::IOStream> content = request->GetContentBody();
+        if (content) {
+            content->clear();
+            content->seekg(0);
+            json = Aws::Utils::Json::JsonValue(*content);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (target.find(".ReceiveMessage") != Aws::String::npos) {
+            size_t count = std::min<size_t>(
+                    json.View().GetInteger("MaxNumberOfMessages"), mMessageCount - mSentCount);
+            Aws::StringStream body;
+            body << R"({"Messages":[)";
+            for (size_t i = 0; i < count; ++i, ++mSentCount) {
+                body << (i > 0 ? "," : "")
+                     << R"({"MessageId":"message-)" << mSentCount
+                     << R"(","ReceiptHandle":"receipt-)" << mSentCount
+                     << R"(","Body":"Message )" << mSentCount << R"("})";
+            }
+            body << "]}";
+            response->GetResponseBody() << body.str();
+        }
+        else if (target.find(".DeleteMessageBatch") != Aws::String::npos ||
+                 target.find(".ChangeMessageVisibilityBatch") != Aws::String::npos) {
+            const bool isDelete = target.find(".DeleteMessageBatch") != Aws::String::npos;
+            Aws::Utils::Array<Aws::Utils::Json::JsonView> entries =
+                    json.View().GetArray("Entries");
+            Aws::StringStream body;
+            body << R"({"Successful":[)";
+            for (size_t i = 0; i < entries.GetLength(); ++i) {
+                body << (i > 0 ? "," : "") << R"({"Id":")"
+                     << entries[i].GetString("Id") << R"("})";
+                if (!isDelete) {
+                    mExtendedReceiptHandles.push_back(entries[i].GetString("ReceiptHandle"));
+                }
+            }
+            body << R"(],"Failed":[]})";
+            if (isDelete) {
+                mDeleteBatchSizes.push_back(entries.GetLength());
+            }
+            response->GetResponseBody() << body.str();
+        }
+        else {
+            response->SetResponseCode(Aws::Http::HttpResponseCode::BAD_REQUEST);
+        }
+
+        return response;
+    }
+
+    std::vector<size_t> getDeleteBatchSizes() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mDeleteBatchSizes;
+    }
+
+    std::vector<Aws::String> getExtendedReceiptHandles() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mExtendedReceiptHandles;
+    }
+
+private:
+    const size_t mMessageCount;
+    mutable std::mutex mMutex;
+    mutable size_t mSentCount = 0;
+    mutable std::vector<size_t> mDeleteBatchSizes;
+    mutable std::vector<Aws::String> mExtendedReceiptHandles;
+};
 
 void AwsDocTest::SQS_GTests::SetUpTestSuite() {
     InitAPI(s_options);
@@ -257,3 +353,23 @@ bool AwsDocTest::SQS_GTests::sendMessage(const Aws::String &queueUrl,
 
     return outcome.IsSuccess();
 }
+
+AwsDocTest::MockSQSService::MockSQSService(size_t messageCount) {
+    mockHttpClient = Aws::MakeShared<SQSServiceMockHTTPClient>(ALLOCATION_TAG, messageCount);
+    mockHttpClientFactory = Aws::MakeShared<MockHttpClientFactory>(ALLOCATION_TAG);
+    mockHttpClientFactory->SetClient(mockHttpClient);
+    SetHttpClientFactory(mockHttpClientFactory);
+}
+
+AwsDocTest::MockSQSService::~MockSQSService() {
+    Aws::Http::CleanupHttp();
+    Aws::Http::InitHttp();
+}
+
+std::vector<size_t> AwsDocTest::MockSQSService::getDeleteBatchSizes() const {
+    return mockHttpClient->getDeleteBatchSizes();
+}
+
+std::vector<Aws::String> AwsDocTest::MockSQSService::getExtendedReceiptHandles() const {
+    return mockHttpClient->getExtendedReceiptHandles();
+}
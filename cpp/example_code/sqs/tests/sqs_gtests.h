@@ -9,6 +9,8 @@
 #include <memory>
 #include <gtest/gtest.h>
 
+class MockHttpClientFactory;
+
 namespace AwsDocTest {
 
     class MyStringBuffer : public std::stringbuf {
@@ -67,6 +69,32 @@ namespace AwsDocTest {
 
         static Aws::String s_cachedQueueUrl;
     }; // SQS_GTests
+
+    class SQSServiceMockHTTPClient;
+
+    /*
+     * A mock SQS service, for tests which make many requests. ReceiveMessage
+     * returns messageCount messages and then no messages. DeleteMessageBatch and
+     * ChangeMessageVisibilityBatch succeed for every entry, and their entries are
+     * recorded.
+     */
+    class MockSQSService {
+    public:
+        explicit MockSQSService(size_t messageCount);
+
+        virtual ~MockSQSService();
+
+        // The number of entries in each DeleteMessageBatch request.
+        std::vector<size_t> getDeleteBatchSizes() const;
+
+        // The receipt handles in the ChangeMessageVisibilityBatch requests.
+        std::vector<Aws::String> getExtendedReceiptHandles() const;
+
+    private:
+
+        std::shared_ptr<SQSServiceMockHTTPClient> mockHttpClient;
+        std::shared_ptr<MockHttpClientFactory> mockHttpClientFactory;
+    }; // MockSQSService
 } // AwsDocTest
 
 #endif //S3_EXAMPLES_S3_GTESTS_H